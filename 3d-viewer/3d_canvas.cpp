@@ -115,10 +115,8 @@ EDA_3D_CANVAS::~EDA_3D_CANVAS()
     delete m_glRC;
 
     // Free the list of parsers list
-    for( unsigned int i = 0; i < m_model_parsers_list.size(); i++ )
-        if( m_model_parsers_list[i] )
-            delete m_model_parsers_list[i];
-
+    for( MODEL_PARSER_MAP::iterator it = m_model_parsers.begin(); it != m_model_parsers.end(); ++it )
+        delete it->second;
 }
 
 
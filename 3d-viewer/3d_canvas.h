@@ -46,6 +46,7 @@
 #include <modelparsers.h>
 #include <class_module.h>
 #include <CBBox.h>
+#include <hashtables.h>
 
 class BOARD_DESIGN_SETTINGS;
 class EDA_3D_FRAME;
@@ -104,9 +105,11 @@ private:
 
     S3D_VERTEX      m_lightPos;
 
-    /// Stores the list of parsers for each new file name (dont repeat files already loaded)
-    std::vector<S3D_MODEL_PARSER *> m_model_parsers_list;
-    std::vector<wxString> m_model_filename_list;
+    /// Map of the parser of each model file name (each file is loaded only once),
+    /// NULL for files without parser
+    typedef boost::unordered_map< wxString, S3D_MODEL_PARSER*, WXSTRING_HASH > MODEL_PARSER_MAP;
+
+    MODEL_PARSER_MAP    m_model_parsers;
 
     void create_and_render_shadow_buffer( GLuint *aDst_gl_texture,
             GLuint aTexture_size, bool aDraw_body, int aBlurPasses );
@@ -329,12 +332,15 @@ private:
                                  bool aIsRenderingJustTransparentObjects );
 
     /**
-     * function read3DComponentShape
-     * read the 3D component shape(s) of the footprint (physical shape).
-     * @param module
-     * @return true if load was succeeded, false otherwise
+     * function read3DComponentShapes
+     * reads the 3D component shapes of all footprints of the board (physical shapes).
+     * Each model file is read only once, the different files in parallel (when built
+     * with OpenMP), and the meshes are stored in a S3D_MODEL_CACHE.
      */
-    bool read3DComponentShape( MODULE* module );
+    void read3DComponentShapes();
+
+    /// Deletes the model parsers, after the masters using them are reset
+    void clearModelParsers();
 
     /**
      * function generateFakeShadowsTextures
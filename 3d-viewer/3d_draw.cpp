@@ -44,6 +44,7 @@
 #include <class_pcb_text.h>
 #include <colors_selection.h>
 #include <convert_basic_shapes_to_polygon.h>
+#include <polygon_set.h>
 #define GLM_FORCE_RADIANS
 #include <gal/opengl/glm/gtc/matrix_transform.hpp>
 #include <gal/opengl/opengl_compositor.h>
@@ -56,6 +57,8 @@
 #include <info3d_visu.h>
 #include <trackball.h>
 #include <3d_draw_basic_functions.h>
+#include <3d_layer_geometry.h>
+#include <3d_model_cache.h>
 
 #include <CImage.h>
 #include <reporter.h>
@@ -690,6 +693,64 @@ void EDA_3D_CANVAS::buildShadowList( GLuint aFrontList, GLuint aBacklist, GLuint
 }
 
 
+/* The polygons of a copper layer, collected by the GUI thread, and the triangles
+ * built from them by a worker thread
+ */
+struct COPPER_LAYER_3D
+{
+    LAYER_ID            m_Layer;
+    int                 m_Zpos;
+    int                 m_Thickness;
+    float               m_ZNormal;
+    CPOLYGONS_LIST      m_Polys;        // tracks, pads, texts (and zones if holes are removed)
+    CPOLYGONS_LIST      m_ZonesPolys;   // zones, if holes are not removed from zones
+    CPOLYGONS_LIST      m_Holes;        // holes of blind and buried vias
+    S3D_LAYER_GEOMETRY  m_Geometry;
+};
+
+
+/* Merges the polygons of aLayer, removes the holes and builds the triangles.
+ * No GL call here: this is called from worker threads.
+ */
+static void buildCopperLayerGeometry( COPPER_LAYER_3D& aLayer, const CPOLYGONS_LIST& aThroughHoles,
+                                      double aBiuTo3Dunits )
+{
+    // m_Polys contains polygons to merge. Many overlaps .
+    // Calculate merged polygons
+    if( aLayer.m_Polys.GetCornersCount() == 0 )
+        return;
+
+    POLYGON_SET currLayerPolyset;
+    POLYGON_SET polysetHoles;
+
+    // Add polygons, without holes
+    currLayerPolyset.AddOutlines( aLayer.m_Polys );
+
+    // Add through holes and holes of this layer
+    polysetHoles.AddOutlines( aThroughHoles );
+    polysetHoles.AddOutlines( aLayer.m_Holes );
+
+    // Merge polygons, and remove holes.  The triangles are built from the outlines
+    // and holes, no need to fracture the polygons
+    currLayerPolyset.BooleanSubtract( polysetHoles );
+
+    // If holes are removed from copper zones, m_Polys contains all polygons
+    // to draw (tracks+zones+texts).
+    aLayer.m_Geometry.AddSolidHorizontalPolygonSet( currLayerPolyset, aLayer.m_Zpos,
+                                                    aLayer.m_Thickness, aBiuTo3Dunits,
+                                                    aLayer.m_ZNormal );
+
+    // If holes are not removed from copper zones (for calculation time reasons,
+    // the zone polygons are stored in m_ZonesPolys and have to be drawn now:
+    if( aLayer.m_ZonesPolys.GetCornersCount() )
+    {
+        aLayer.m_Geometry.AddSolidHorizontalPolyPolygons( aLayer.m_ZonesPolys, aLayer.m_Zpos,
+                                                          aLayer.m_Thickness, aBiuTo3Dunits,
+                                                          aLayer.m_ZNormal );
+    }
+}
+
+
 void EDA_3D_CANVAS::buildBoard3DView( GLuint aBoardList, GLuint aBodyOnlyList,
                                       REPORTER* aErrorMessages, REPORTER* aActivity  )
 {
@@ -717,10 +778,6 @@ void EDA_3D_CANVAS::buildBoard3DView( GLuint aBoardList, GLuint aBodyOnlyList,
                                                 // a fine representation
     double          correctionFactorLQ = 1.0 / cos( M_PI / (segcountLowQuality * 2.0) );
 
-    CPOLYGONS_LIST  bufferPolys;
-    bufferPolys.reserve( 500000 );              // Reserve for large board: tracks mainly
-                                                // + zones when holes are removed from zones
-
     CPOLYGONS_LIST  bufferPcbOutlines;          // stores the board main outlines
     CPOLYGONS_LIST  allLayerHoles;              // Contains through holes, calculated only once
     allLayerHoles.reserve( 20000 );
@@ -738,21 +795,69 @@ void EDA_3D_CANVAS::buildBoard3DView( GLuint aBoardList, GLuint aBodyOnlyList,
         }
     }
 
-    CPOLYGONS_LIST  bufferZonesPolys;
-    bufferZonesPolys.reserve( 300000 );             // Reserve for large board ( copper zones mainly )
-                                                    // when holes are not removed from zones
+    int copper_thickness = GetPrm3DVisu().GetCopperThicknessBIU();
+
+    // Build the through holes list, used by all copper layers and the board body
+    for( TRACK* track = pcb->m_Track;  track;  track = track->Next() )
+    {
+        if( track->Type() != PCB_VIA_T )
+            continue;
+
+        VIA *via = static_cast<VIA*>( track );
+
+        if( via->GetViaType() == VIA_THROUGH )
+            TransformCircleToPolygon( allLayerHoles, via->GetStart(),
+                                      ( via->GetDrillValue() + copper_thickness ) / 2,
+                                      segcountLowQuality );
+    }
+
+    for( MODULE* module = pcb->m_Modules;  module;  module = module->Next() )
+    {
+        for( D_PAD* pad = module->Pads(); pad; pad = pad->Next() )
+        {
+            // Calculate a factor to apply to segcount for large holes ( > 1 mm)
+            // (bigger pad drill size -> more segments) because holes in pads can have
+            // very different sizes and optimizing this segcount gives a better look
+            // Mainly mounting holes have a size bigger thon 1 mm
+            wxSize padHole = pad->GetDrillSize();
+
+            if( ! padHole.x )       // Not drilled pad like SMD pad
+                continue;
+
+            // we use the hole diameter to calculate the seg count.
+            // for round holes, padHole.x == padHole.y
+            // for oblong holes, the diameter is the smaller of (padHole.x, padHole.y)
+            int diam = std::min( padHole.x, padHole.y );
+            double segFactor = (double)diam / Millimeter2iu( 1.0 );
+
+            int segcount = (int)(segcountLowQuality * segFactor);
+
+            // Clamp segcount between segcountLowQuality and 48.
+            // 48 segm for a circle is a very good approx.
+            segcount = Clamp( segcountLowQuality, segcount, 48 );
 
-    CPOLYGONS_LIST  currLayerHoles;                 // Contains holes for the current layer
-    bool            throughHolesListBuilt = false;  // flag to build the through hole polygon list only once
+            // The hole in the body is inflated by copper thickness.
+            int inflate = copper_thickness;
 
+            // If not plated, no copper.
+            if( pad->GetAttribute () == PAD_HOLE_NOT_PLATED )
+                inflate = 0;
+
+            pad->BuildPadDrillShapePolygon( allLayerHoles, inflate, segcount );
+        }
+    }
+
+    // Converting board items to polygons uses static variables (texts): collect the
+    // polygons of each copper layer here, and build the triangles in worker threads.
     LSET            cu_set = LSET::AllCuMask( GetPrm3DVisu().m_CopperLayersCount );
 
+    std::vector<COPPER_LAYER_3D> copperLayers;
+    copperLayers.reserve( cu_set.count() );
+
 #if 1
     LAYER_ID        cu_seq[MAX_CU_LAYERS];          // preferred sequence, could have called CuStack()
                                                     // but I assume that's backwards
 
-    glNewList( aBoardList, GL_COMPILE );
-
     for( unsigned i=0; i < DIM( cu_seq ); ++i )
         cu_seq[i] = ToLAYER_ID( B_Cu - i );
 
@@ -771,9 +876,13 @@ void EDA_3D_CANVAS::buildBoard3DView( GLuint aBoardList, GLuint aBodyOnlyList,
         if( aActivity )
             aActivity->Report( wxString::Format( _( "Build layer %s" ), LSET::Name( layer ) ) );
 
-        bufferPolys.RemoveAllContours();
-        bufferZonesPolys.RemoveAllContours();
-        currLayerHoles.RemoveAllContours();
+        copperLayers.push_back( COPPER_LAYER_3D() );
+
+        COPPER_LAYER_3D& copperLayer = copperLayers.back();
+        CPOLYGONS_LIST&  bufferPolys = copperLayer.m_Polys;
+        CPOLYGONS_LIST&  currLayerHoles = copperLayer.m_Holes;
+
+        copperLayer.m_Layer = layer;
 
         // Draw tracks:
         for( TRACK* track = pcb->m_Track;  track;  track = track->Next() )
@@ -785,22 +894,14 @@ void EDA_3D_CANVAS::buildBoard3DView( GLuint aBoardList, GLuint aBodyOnlyList,
                                                          0, segcountforcircle,
                                                          correctionFactor );
 
-            // Add via hole
+            // Add blind or buried via hole (through holes are already in allLayerHoles)
             if( track->Type() == PCB_VIA_T )
             {
                 VIA *via = static_cast<VIA*>( track );
-                VIATYPE_T viatype = via->GetViaType();
-                int holediameter = via->GetDrillValue();
-                int thickness = GetPrm3DVisu().GetCopperThicknessBIU();
-                int hole_outer_radius = (holediameter + thickness) / 2;
-
-                if( viatype != VIA_THROUGH )
-                    TransformCircleToPolygon( currLayerHoles,
-                                              via->GetStart(), hole_outer_radius,
-                                              segcountLowQuality );
-                else if( !throughHolesListBuilt )
-                    TransformCircleToPolygon( allLayerHoles,
-                                              via->GetStart(), hole_outer_radius,
+
+                if( via->GetViaType() != VIA_THROUGH )
+                    TransformCircleToPolygon( currLayerHoles, via->GetStart(),
+                                              ( via->GetDrillValue() + copper_thickness ) / 2,
                                               segcountLowQuality );
             }
         }
@@ -808,7 +909,6 @@ void EDA_3D_CANVAS::buildBoard3DView( GLuint aBoardList, GLuint aBodyOnlyList,
         // draw pads
         for( MODULE* module = pcb->m_Modules;  module;  module = module->Next() )
         {
-            int thickness = GetPrm3DVisu().GetCopperThicknessBIU();
             // Note: NPTH pads are not drawn on copper layers when the pad
             // has same shape as its hole
             module->TransformPadsShapesWithClearanceToPolygon( layer,
@@ -823,52 +923,13 @@ void EDA_3D_CANVAS::buildBoard3DView( GLuint aBoardList, GLuint aBodyOnlyList,
                                                                      0,
                                                                      segcountforcircle,
                                                                      correctionFactor );
-
-            // Add pad hole, if any
-            if( !throughHolesListBuilt )
-            {
-                D_PAD* pad = module->Pads();
-
-                for( ; pad; pad = pad->Next() )
-                {
-                    // Calculate a factor to apply to segcount for large holes ( > 1 mm)
-                    // (bigger pad drill size -> more segments) because holes in pads can have
-                    // very different sizes and optimizing this segcount gives a better look
-                    // Mainly mounting holes have a size bigger thon 1 mm
-                    wxSize padHole = pad->GetDrillSize();
-
-                    if( ! padHole.x )       // Not drilled pad like SMD pad
-                        continue;
-
-                    // we use the hole diameter to calculate the seg count.
-                    // for round holes, padHole.x == padHole.y
-                    // for oblong holes, the diameter is the smaller of (padHole.x, padHole.y)
-                    int diam = std::min( padHole.x, padHole.y );
-                    double segFactor = (double)diam / Millimeter2iu( 1.0 );
-
-                    int segcount = (int)(segcountLowQuality * segFactor);
-
-                    // Clamp segcount between segcountLowQuality and 48.
-                    // 48 segm for a circle is a very good approx.
-                    segcount = Clamp( segcountLowQuality, segcount, 48 );
-
-                    // The hole in the body is inflated by copper thickness.
-                    int inflate = thickness;
-
-                    // If not plated, no copper.
-                    if( pad->GetAttribute () == PAD_HOLE_NOT_PLATED )
-                        inflate = 0;
-
-                    pad->BuildPadDrillShapePolygon( allLayerHoles, inflate, segcount );
-                }
-            }
         }
 
         // Draw copper zones. Note:
         // * if the holes are removed from copper zones
         // the polygons are stored in bufferPolys (which contains all other polygons)
         // * if the holes are NOT removed from copper zones
-        // the polygons are stored in bufferZonesPolys
+        // the polygons are stored in m_ZonesPolys
         if( isEnabled( FL_ZONE ) )
         {
             for( int ii = 0; ii < pcb->GetAreaCount(); ii++ )
@@ -879,7 +940,7 @@ void EDA_3D_CANVAS::buildBoard3DView( GLuint aBoardList, GLuint aBodyOnlyList,
                 if( zonelayer == layer )
                 {
                     zone->TransformSolidAreasShapesToPolygonSet(
-                        remove_Holes ? bufferPolys : bufferZonesPolys,
+                        remove_Holes ? bufferPolys : copperLayer.m_ZonesPolys,
                         segcountLowQuality, correctionFactorLQ );
                 }
             }
@@ -908,36 +969,37 @@ void EDA_3D_CANVAS::buildBoard3DView( GLuint aBoardList, GLuint aBodyOnlyList,
             }
         }
 
-        // bufferPolys contains polygons to merge. Many overlaps .
-        // Calculate merged polygons
-        if( bufferPolys.GetCornersCount() == 0 )
-            continue;
-
-        KI_POLYGON_SET  currLayerPolyset;
-        KI_POLYGON_SET  polysetHoles;
+        copperLayer.m_Thickness = GetPrm3DVisu().GetLayerObjectThicknessBIU( layer );
+        copperLayer.m_Zpos = GetPrm3DVisu().GetLayerZcoordBIU( layer );
 
-        // Add polygons, without holes
-        bufferPolys.ExportTo( currLayerPolyset );
+        // When using thickness it will draw first the top and then botton (with z inverted)
+        // If we are not using thickness, then the znormal must face the layer direction
+        // because it will draw just one plane
+        copperLayer.m_ZNormal = 1.0f;
 
-        // Add through holes (created only once) in current polygon holes list
-        currLayerHoles.Append( allLayerHoles );
+        if( !copperLayer.m_Thickness )
+            copperLayer.m_ZNormal = Get3DLayer_Z_Orientation( layer );
+    }
 
-        if( currLayerHoles.GetCornersCount() > 0 )
-            currLayerHoles.ExportTo( polysetHoles );
+    // Merge the polygons, remove the holes and build the triangles of each layer
+    double biuTo3Dunits = GetPrm3DVisu().m_BiuTo3Dunits;
 
-        // Merge polygons, and remove holes
-        currLayerPolyset -= polysetHoles;
+    #ifdef USE_OPENMP
+    #pragma omp parallel for schedule(dynamic)
+    #endif /* USE_OPENMP */
 
-        int thickness = GetPrm3DVisu().GetLayerObjectThicknessBIU( layer );
-        int zpos = GetPrm3DVisu().GetLayerZcoordBIU( layer );
+    for( int ii = 0; ii < (int) copperLayers.size(); ii++ )
+        buildCopperLayerGeometry( copperLayers[ii], allLayerHoles, biuTo3Dunits );
 
-        float zNormal = 1.0f; // When using thickness it will draw first the top and then botton (with z inverted)
+    // Only the GL calls have to be made by the GUI thread
+    glNewList( aBoardList, GL_COMPILE );
 
-        // If we are not using thickness, then the znormal must face the layer direction
-        // because it will draw just one plane
-        if( !thickness )
-            zNormal = Get3DLayer_Z_Orientation( layer );
+    for( unsigned ii = 0; ii < copperLayers.size(); ii++ )
+    {
+        const COPPER_LAYER_3D& copperLayer = copperLayers[ii];
 
+        if( copperLayer.m_Geometry.IsEmpty() )
+            continue;
 
         if( realistic_mode )
         {
@@ -945,29 +1007,11 @@ void EDA_3D_CANVAS::buildBoard3DView( GLuint aBoardList, GLuint aBodyOnlyList,
         }
         else
         {
-            EDA_COLOR_T color = g_ColorsSettings.GetLayerColor( layer );
+            EDA_COLOR_T color = g_ColorsSettings.GetLayerColor( copperLayer.m_Layer );
             SetGLColor( color );
         }
 
-        bufferPolys.RemoveAllContours();
-        bufferPolys.ImportFrom( currLayerPolyset );
-
-        // If holes are removed from copper zones, bufferPolys contains all polygons
-        // to draw (tracks+zones+texts).
-        Draw3D_SolidHorizontalPolyPolygons( bufferPolys, zpos, thickness,
-                                            GetPrm3DVisu().m_BiuTo3Dunits, useTextures,
-                                            zNormal );
-
-        // If holes are not removed from copper zones (for calculation time reasons,
-        // the zone polygons are stored in bufferZonesPolys and have to be drawn now:
-        if( bufferZonesPolys.GetCornersCount() )
-        {
-            Draw3D_SolidHorizontalPolyPolygons( bufferZonesPolys, zpos, thickness,
-                                    GetPrm3DVisu().m_BiuTo3Dunits, useTextures,
-                                    zNormal );
-        }
-
-        throughHolesListBuilt = true;
+        Draw3D_LayerGeometry( copperLayer.m_Geometry, useTextures );
     }
 
     if( aActivity )
@@ -1013,8 +1057,6 @@ void EDA_3D_CANVAS::buildBoard3DView( GLuint aBoardList, GLuint aBodyOnlyList,
         SetGLColor( color, 0.7 );
     }
 
-    float copper_thickness = GetPrm3DVisu().GetCopperThicknessBIU();
-
     // a small offset between substrate and external copper layer to avoid artifacts
     // when drawing copper items on board
     float epsilon = Millimeter2iu( 0.01 );
@@ -1029,27 +1071,24 @@ void EDA_3D_CANVAS::buildBoard3DView( GLuint aBoardList, GLuint aBodyOnlyList,
     zpos += (copper_thickness + epsilon) / 2.0f;
     board_thickness -= copper_thickness + epsilon;
 
-    KI_POLYGON_SET  currLayerPolyset;
-    KI_POLYGON_SET  polysetHoles;
+    POLYGON_SET currLayerPolyset;
+    POLYGON_SET polysetHoles;
 
     // Add polygons, without holes
-    bufferPcbOutlines.ExportTo( currLayerPolyset );
+    currLayerPolyset.AddOutlines( bufferPcbOutlines );
 
     // Build holes list
-    allLayerHoles.ExportTo( polysetHoles );
+    polysetHoles.AddOutlines( allLayerHoles );
 
     // remove holes
-    currLayerPolyset -= polysetHoles;
+    currLayerPolyset.BooleanSubtract( polysetHoles );
 
-    bufferPcbOutlines.RemoveAllContours();
-    bufferPcbOutlines.ImportFrom( currLayerPolyset );
+    S3D_LAYER_GEOMETRY bodyGeometry;
 
-    if( bufferPcbOutlines.GetCornersCount() )
-    {
-        Draw3D_SolidHorizontalPolyPolygons( bufferPcbOutlines, zpos + board_thickness / 2.0,
-                                            board_thickness, GetPrm3DVisu().m_BiuTo3Dunits, useTextures,
-                                            1.0f );
-    }
+    bodyGeometry.AddSolidHorizontalPolygonSet( currLayerPolyset, zpos + board_thickness / 2.0,
+                                               board_thickness, GetPrm3DVisu().m_BiuTo3Dunits,
+                                               1.0f );
+    Draw3D_LayerGeometry( bodyGeometry, useTextures );
 
     glEndList();
 }
@@ -1119,8 +1158,8 @@ void EDA_3D_CANVAS::buildTechLayers3DView( REPORTER* aErrorMessages, REPORTER* a
 
     // draw graphic items, on technical layers
 
-    KI_POLYGON_SET  brdpolysetHoles;
-    allLayerHoles.ExportTo( brdpolysetHoles );
+    POLYGON_SET brdpolysetHoles;
+    brdpolysetHoles.AddOutlines( allLayerHoles );
 
     static const LAYER_ID teckLayerList[] = {
         B_Adhes,
@@ -1215,31 +1254,32 @@ void EDA_3D_CANVAS::buildTechLayers3DView( REPORTER* aErrorMessages, REPORTER* a
         // Calculate merged polygons and remove pads and vias holes
         if( bufferPolys.GetCornersCount() == 0 )
             continue;
-        KI_POLYGON_SET  currLayerPolyset;
-        KI_POLYGON_SET  polyset;
+        POLYGON_SET currLayerPolyset;
+        POLYGON_SET polyset;
 
         // Solder mask layers are "negative" layers.
         // Shapes should be removed from the full board area.
         if( layer == B_Mask || layer == F_Mask )
         {
-            bufferPcbOutlines.ExportTo( currLayerPolyset );
+            currLayerPolyset.AddOutlines( bufferPcbOutlines );
             bufferPolys.Append( allLayerHoles );
-            bufferPolys.ExportTo( polyset );
-            currLayerPolyset -= polyset;
+            polyset.AddOutlines( bufferPolys );
+            currLayerPolyset.BooleanSubtract( polyset );
         }
         // Remove holes from Solder paste layers and siklscreen
         else if( layer == B_Paste || layer == F_Paste
                  || layer == B_SilkS || layer == F_SilkS  )
         {
-            bufferPolys.ExportTo( currLayerPolyset );
-            currLayerPolyset -= brdpolysetHoles;
+            currLayerPolyset.AddOutlines( bufferPolys );
+            currLayerPolyset.BooleanSubtract( brdpolysetHoles );
         }
         else    // usuall layers, merge polys built from each item shape:
         {
-            bufferPolys.ExportTo( polyset );
-            currLayerPolyset += polyset;
+            currLayerPolyset.AddOutlines( bufferPolys );
         }
 
+        currLayerPolyset.Fracture();
+
         int         thickness = 0;
 
         if( layer != B_Mask && layer != F_Mask )
@@ -1267,7 +1307,7 @@ void EDA_3D_CANVAS::buildTechLayers3DView( REPORTER* aErrorMessages, REPORTER* a
         }
 
         bufferPolys.RemoveAllContours();
-        bufferPolys.ImportFrom( currLayerPolyset );
+        currLayerPolyset.ExportTo( bufferPolys );
 
         float zNormal = 1.0f; // When using thickness it will draw first the top and then botton (with z inverted)
 
@@ -1363,10 +1403,9 @@ void EDA_3D_CANVAS::buildBoard3DAuxLayers( REPORTER* aErrorMessages, REPORTER* a
         // Calculate merged polygons and remove pads and vias holes
         if( bufferPolys.GetCornersCount() == 0 )
             continue;
-        KI_POLYGON_SET  currLayerPolyset;
-        KI_POLYGON_SET  polyset;
-        bufferPolys.ExportTo( polyset );
-        currLayerPolyset += polyset;
+        POLYGON_SET currLayerPolyset;
+        currLayerPolyset.AddOutlines( bufferPolys );
+        currLayerPolyset.Fracture();
 
         int         thickness = GetPrm3DVisu().GetLayerObjectThicknessBIU( layer );
         int         zpos = GetPrm3DVisu().GetLayerZcoordBIU( layer );
@@ -1380,7 +1419,7 @@ void EDA_3D_CANVAS::buildBoard3DAuxLayers( REPORTER* aErrorMessages, REPORTER* a
             zpos -= thickness/2 ;
 
         bufferPolys.RemoveAllContours();
-        bufferPolys.ImportFrom( currLayerPolyset );
+        currLayerPolyset.ExportTo( bufferPolys );
 
         float zNormal = 1.0f; // When using thickness it will draw first the top and then botton (with z inverted)
 
@@ -1590,16 +1629,11 @@ void EDA_3D_CANVAS::buildFootprintShape3DList( GLuint aOpaqueList,
     if( aActivity )
         aActivity->Report( _( "Load 3D Shapes" ) );
 
-    // clean the parser list if it have any already loaded files
-    m_model_parsers_list.clear();
-    m_model_filename_list.clear();
-
     BOARD* pcb = GetBoard();
 
-    for( MODULE* module = pcb->m_Modules; module; module = module->Next() )
-        read3DComponentShape( module );
+    read3DComponentShapes();
 
-    DBG( printf( "  read3DComponentShape total time %f ms\n", (double) (GetRunningMicroSecs() - strtime) / 1000.0 ) );
+    DBG( printf( "  read3DComponentShapes total time %f ms\n", (double) (GetRunningMicroSecs() - strtime) / 1000.0 ) );
 
     DBG( strtime = GetRunningMicroSecs() );
 
@@ -1644,57 +1678,83 @@ void EDA_3D_CANVAS::buildFootprintShape3DList( GLuint aOpaqueList,
 }
 
 
-bool EDA_3D_CANVAS::read3DComponentShape( MODULE* module )
+void EDA_3D_CANVAS::clearModelParsers()
 {
-    if( module )
+    for( MODULE* module = GetBoard()->m_Modules; module; module = module->Next() )
     {
-        S3D_MASTER* shape3D = module->Models();
+        for( S3D_MASTER* shape3D = module->Models(); shape3D; shape3D = shape3D->Next() )
+            shape3D->m_parser = NULL;
+    }
 
-        for( ; shape3D; shape3D = shape3D->Next() )
+    for( MODEL_PARSER_MAP::iterator it = m_model_parsers.begin(); it != m_model_parsers.end(); ++it )
+        delete it->second;
+
+    m_model_parsers.clear();
+}
+
+
+void EDA_3D_CANVAS::read3DComponentShapes()
+{
+    // clean the parser list if it have any already loaded files
+    clearModelParsers();
+
+    BOARD* pcb = GetBoard();
+
+    // Create a parser for each new file name, the master of the first footprint using
+    // the file reads it
+    std::vector<S3D_MODEL_PARSER*> parsers;
+
+    for( MODULE* module = pcb->m_Modules; module; module = module->Next() )
+    {
+        for( S3D_MASTER* shape3D = module->Models(); shape3D; shape3D = shape3D->Next() )
         {
-            if( shape3D->Is3DType( S3D_MASTER::FILE3D_VRML ) )
-            {
-                bool found = false;
+            if( !shape3D->Is3DType( S3D_MASTER::FILE3D_VRML ) )
+                continue;
 
-                unsigned int i;
-                wxString shape_filename = shape3D->GetShape3DFullFilename();
+            wxString shape_filename = shape3D->GetShape3DFullFilename();
 
-                // Search for already loaded files
-                for( i = 0; i < m_model_filename_list.size(); i++ )
-                {
-                    if( shape_filename.Cmp(m_model_filename_list[i]) == 0 )
-                    {
-                        found = true;
-                        break;
-                    }
-                }
+            if( m_model_parsers.find( shape_filename ) != m_model_parsers.end() )
+                continue;
 
-                if( found == false )
-                {
-                    // Create a new parser
-                    S3D_MODEL_PARSER *newParser = S3D_MODEL_PARSER::Create( shape3D, shape3D->GetShape3DExtension() );
-
-                    if( newParser )
-                    {
-                        // Read file
-                        if( shape3D->ReadData( newParser ) == 0 )
-                        {
-                            // Store this couple filename / parsed file
-                            m_model_filename_list.push_back( shape_filename );
-                            m_model_parsers_list.push_back( newParser );
-                        }
-                    }
-                }
-                else
-                {
-                    // Reusing file
-                    shape3D->m_parser = m_model_parsers_list[i];
-                }
-            }
+            S3D_MODEL_PARSER* newParser = S3D_MODEL_PARSER::Create( shape3D,
+                                                        shape3D->GetShape3DExtension() );
+
+            m_model_parsers[shape_filename] = newParser;
+
+            if( newParser )
+                parsers.push_back( newParser );
         }
     }
 
-    return true;
+    // Read the files, from the cache when possible
+    bool smoothShapes = g_Parm_3D_Visu.IsRealisticMode()
+                        && g_Parm_3D_Visu.GetFlag( FL_RENDER_SMOOTH_NORMALS );
+    S3D_MODEL_CACHE cache( smoothShapes );
+
+    // The parsers switch to the C locale: do it once for all threads
+    LOCALE_IO toggle;
+
+    #ifdef USE_OPENMP
+    #pragma omp parallel for schedule(dynamic)
+    #endif /* USE_OPENMP */
+
+    for( int ii = 0; ii < (int) parsers.size(); ii++ )
+        parsers[ii]->GetMaster()->ReadData( parsers[ii], &cache );
+
+    // Footprints using a file already read share its parser
+    for( MODULE* module = pcb->m_Modules; module; module = module->Next() )
+    {
+        for( S3D_MASTER* shape3D = module->Models(); shape3D; shape3D = shape3D->Next() )
+        {
+            if( !shape3D->Is3DType( S3D_MASTER::FILE3D_VRML ) )
+                continue;
+
+            S3D_MODEL_PARSER* parser = m_model_parsers[shape3D->GetShape3DFullFilename()];
+
+            if( parser && parser->GetMaster()->m_parser == parser )
+                shape3D->m_parser = parser;
+        }
+    }
 }
 
 
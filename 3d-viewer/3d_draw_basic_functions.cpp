@@ -33,26 +33,14 @@
 #include <3d_viewer.h>
 #include <info3d_visu.h>
 #include <3d_draw_basic_functions.h>
+#include <3d_layer_geometry.h>
 #include <modelparsers.h>
 
 // Number of segments to approximate a circle by segments
 #define SEGM_PER_CIRCLE 24
 
-#ifndef CALLBACK
-#define CALLBACK
-#endif
-
-// Variables used to pass a value to call back openGL functions
+// Variable used to calculate the texture coordinates
 static float s_textureScale;
-static double s_currentZpos;
-static double s_biuTo3Dunits;
-bool s_useTextures;
-
-// CALLBACK functions for GLU_TESS
-static void CALLBACK    tessBeginCB( GLenum which );
-static void CALLBACK    tessEndCB();
-static void CALLBACK    tessErrorCB( GLenum errorCode );
-static void CALLBACK    tessCPolyPt2Vertex( const GLvoid* data );
 
 void TransfertToGLlist( std::vector< S3D_VERTEX >& aVertices, double aBiuTo3DUnits );
 
@@ -135,7 +123,7 @@ void SetGLTexture( GLuint text_id, float scale )
 {
     glEnable( GL_TEXTURE_2D );
     glBindTexture( GL_TEXTURE_2D, text_id );
-    s_textureScale = scale;     // for Tess callback functions
+    s_textureScale = scale;     // for Draw3D_LayerGeometry
 }
 
 
@@ -152,89 +140,50 @@ void Draw3D_SolidHorizontalPolyPolygons( const CPOLYGONS_LIST& aPolysList,
                                          bool aUseTextures,
                                          float aNormal_Z_Orientation )
 {
-    // for Tess callback functions:
-    s_biuTo3Dunits = aBiuTo3DUnits;
-    s_useTextures = aUseTextures;
-
-    GLUtesselator* tess = gluNewTess();
-
-    gluTessCallback( tess, GLU_TESS_BEGIN, ( void (CALLBACK*) () )tessBeginCB );
-    gluTessCallback( tess, GLU_TESS_END, ( void (CALLBACK*) () )tessEndCB );
-    gluTessCallback( tess, GLU_TESS_ERROR, ( void (CALLBACK*) () )tessErrorCB );
-    gluTessCallback( tess, GLU_TESS_VERTEX, ( void (CALLBACK*) () )tessCPolyPt2Vertex );
-
-    GLdouble v_data[3];
-    double   zpos = ( aZpos + (aThickness / 2.0) ) * aBiuTo3DUnits;
-    s_currentZpos = zpos;     // for Tess callback functions
-    v_data[2]     = zpos;
+    S3D_LAYER_GEOMETRY geometry;
 
-    // Set normal toward positive Z axis, for a solid object on the top side
+    geometry.AddSolidHorizontalPolyPolygons( aPolysList, aZpos, aThickness, aBiuTo3DUnits,
+                                             aNormal_Z_Orientation );
+    Draw3D_LayerGeometry( geometry, aUseTextures );
+}
 
-    //gluTessProperty( tess, GLU_TESS_BOUNDARY_ONLY, GL_TRUE );
-    //gluTessProperty( tess, GLU_TESS_WINDING_RULE, GLU_TESS_WINDING_ODD );
 
-    glNormal3f( 0.0, 0.0, aNormal_Z_Orientation );
+void Draw3D_LayerGeometry( const S3D_LAYER_GEOMETRY& aGeometry, bool aUseTextures )
+{
+    if( aGeometry.IsEmpty() )
+        return;
 
-    // Draw solid areas contained in this list
-    CPOLYGONS_LIST polylist = aPolysList;    // temporary copy for gluTessVertex
+    const std::vector<float>&    vertices = aGeometry.GetVertices();
+    const std::vector<unsigned>& indices = aGeometry.GetIndices();
+    std::vector<float>           texCoords;
 
-    int startContour;
+    glEnableClientState( GL_VERTEX_ARRAY );
+    glEnableClientState( GL_NORMAL_ARRAY );
+    glVertexPointer( 3, GL_FLOAT, 0, &vertices[0] );
+    glNormalPointer( GL_FLOAT, 0, &aGeometry.GetNormals()[0] );
 
-    for( int side = 0; side < 2; side++ )
+    if( aUseTextures )
     {
-        startContour = 1;
+        texCoords.reserve( vertices.size() / 3 * 2 );
 
-        for( unsigned ii = 0; ii < polylist.GetCornersCount(); ii++ )
+        for( unsigned ii = 0; ii < vertices.size(); ii += 3 )
         {
-            if( startContour == 1 )
-            {
-                gluTessBeginPolygon( tess, NULL );
-                gluTessBeginContour( tess );
-                startContour = 0;
-            }
-
-            v_data[0]   = polylist.GetX( ii ) * aBiuTo3DUnits;
-            v_data[1]   = -polylist.GetY( ii ) * aBiuTo3DUnits;
-            // gluTessVertex store pointers on data, not data, so do not store
-            // different corners values in a temporary variable
-            // but send pointer on each CPolyPt value in polylist
-            // before calling gluDeleteTess
-            gluTessVertex( tess, v_data, &polylist[ii] );
-
-
-            if( polylist.IsEndContour( ii ) )
-            {
-                gluTessEndContour( tess );
-                gluTessEndPolygon( tess );
-                startContour = 1;
-            }
+            texCoords.push_back( vertices[ii] * s_textureScale );
+            texCoords.push_back( vertices[ii + 1] * s_textureScale );
         }
 
-        if( aThickness == 0 )
-            break;
-
-        // Prepare the bottom side of solid areas
-        zpos = ( aZpos - (aThickness / 2.0) ) * aBiuTo3DUnits;
-        s_currentZpos = zpos;     // for Tess callback functions
-        v_data[2] = zpos;
-
-        glNormal3f( 0.0, 0.0, -aNormal_Z_Orientation );
+        glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+        glTexCoordPointer( 2, GL_FLOAT, 0, &texCoords[0] );
     }
 
-    if( startContour == 0 )
-    {
-        gluTessEndContour( tess );
-        gluTessEndPolygon( tess );
-    }
+    // Inside a display list, the arrays are copied by glDrawElements
+    glDrawElements( GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, &indices[0] );
 
-    gluDeleteTess( tess );
+    if( aUseTextures )
+        glDisableClientState( GL_TEXTURE_COORD_ARRAY );
 
-    if( aThickness == 0 )
-        return;
-
-    // Build the 3D data : vertical side
-    Draw3D_VerticalPolygonalCylinder( polylist, aThickness, aZpos - (aThickness / 2.0),
-                                      true, aBiuTo3DUnits );
+    glDisableClientState( GL_NORMAL_ARRAY );
+    glDisableClientState( GL_VERTEX_ARRAY );
 }
 
 
@@ -400,47 +349,3 @@ void Draw3D_ArcSegment( const wxPoint&  aCenterPos, const wxPoint& aStartPoint,
 
     Draw3D_SolidHorizontalPolyPolygons( cornerBuffer, aZpos, aThickness, aBiuTo3DUnits, false, 1.0f );
 }
-
-
-// /////////////////////////////////////////////////////////////////////////////
-// GLU_TESS CALLBACKS
-// /////////////////////////////////////////////////////////////////////////////
-
-void CALLBACK tessBeginCB( GLenum which )
-{
-    glBegin( which );
-}
-
-
-void CALLBACK tessEndCB()
-{
-    glEnd();
-}
-
-
-void CALLBACK tessCPolyPt2Vertex( const GLvoid* data )
-{
-    // cast back to double type
-    const CPolyPt* ptr = (const CPolyPt*) data;
-
-    if( s_useTextures )
-    {
-        glTexCoord2f( ptr->x * s_biuTo3Dunits * s_textureScale,
-                      -ptr->y * s_biuTo3Dunits * s_textureScale);
-    }
-
-    glVertex3d( ptr->x * s_biuTo3Dunits, -ptr->y * s_biuTo3Dunits, s_currentZpos );
-}
-
-
-void CALLBACK tessErrorCB( GLenum errorCode )
-{
-#if defined(DEBUG)
-    const GLubyte* errorStr;
-
-    errorStr = gluErrorString( errorCode );
-
-    // DEBUG //
-    DBG( printf( "Tess ERROR: %s\n", errorStr ); )
-#endif
-}
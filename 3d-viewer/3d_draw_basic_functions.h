@@ -31,6 +31,8 @@
 // angle increment to draw a circle, approximated by segments
 #define ANGLE_INC( x ) ( 3600 / (x) )
 
+class S3D_LAYER_GEOMETRY;
+
 /** draw all solid polygons found in aPolysList
  * @param aPolysList = the poligon list to draw
  * @param aZpos = z position in board internal units
@@ -48,6 +50,12 @@ void    Draw3D_SolidHorizontalPolyPolygons( const CPOLYGONS_LIST& aPolysList,
                                             bool aUseTextures,
                                             float aNormal_Z_Orientation );
 
+/** draw the triangles of aGeometry, using OpenGL vertex arrays
+ * @param aGeometry = the triangles, built by S3D_LAYER_GEOMETRY (usually in a worker thread)
+ * @param aUseTextures = true to use the current texture (see SetGLTexture())
+ */
+void    Draw3D_LayerGeometry( const S3D_LAYER_GEOMETRY& aGeometry, bool aUseTextures );
+
 /** draw the solid polygon found in aPolysList
  * The first polygonj is the main polygon, others are holes
  * @param aPolysList = the polygon with holes to draw
@@ -0,0 +1,312 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2015 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file 3d_layer_geometry.cpp
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+
+#ifdef __WXMAC__
+#  ifdef __DARWIN__
+#    include <OpenGL/glu.h>
+#  else
+#    include <glu.h>
+#  endif
+#else
+#  include <GL/glu.h>
+#endif
+
+#include <PolyLine.h>
+#include <polygon_set.h>
+#include <3d_layer_geometry.h>
+
+#ifndef CALLBACK
+#define CALLBACK
+#endif
+
+
+/* The triangles of the polygons of a layer, in the XY plane, before they are
+ * put at the Z position of the top and bottom sides.
+ * This is the polygon data given to the GLU_TESS callbacks, so a tesselator
+ * can run in each thread (no static variables).
+ * Vertex data given to gluTessVertex() is the index of the vertex in m_points.
+ */
+struct TESS_RESULT
+{
+    std::vector<double>     m_points;       // x, y in 3D units
+    std::vector<unsigned>   m_triangles;    // indices of m_points, 3 by triangle
+};
+
+
+// CALLBACK functions for GLU_TESS
+static void CALLBACK tessBeginCB( GLenum which, void* aResult )
+{
+    // Nothing to do: because an edge flag callback is registered, the tesselator
+    // outputs only GL_TRIANGLES
+}
+
+
+static void CALLBACK tessEdgeFlagCB( GLboolean aFlag, void* aResult )
+{
+}
+
+
+static void CALLBACK tessVertexCB( void* aVertex, void* aResult )
+{
+    TESS_RESULT* result = (TESS_RESULT*) aResult;
+
+    result->m_triangles.push_back( (unsigned) (size_t) aVertex );
+}
+
+
+static void CALLBACK tessCombineCB( GLdouble aCoords[3], void* aVertexData[4],
+                                    GLfloat aWeight[4], void** aOutData, void* aResult )
+{
+    // Intersection of edges: a new vertex has to be created
+    TESS_RESULT* result = (TESS_RESULT*) aResult;
+    size_t       index = result->m_points.size() / 2;
+
+    result->m_points.push_back( aCoords[0] );
+    result->m_points.push_back( aCoords[1] );
+
+    *aOutData = (void*) index;
+}
+
+
+static void CALLBACK tessErrorCB( GLenum aErrorCode, void* aResult )
+{
+#if defined(DEBUG)
+    printf( "Tess ERROR: %s\n", gluErrorString( aErrorCode ) );
+#endif
+}
+
+
+void S3D_LAYER_GEOMETRY::Clear()
+{
+    m_vertices.clear();
+    m_normals.clear();
+    m_indices.clear();
+}
+
+
+unsigned S3D_LAYER_GEOMETRY::addVertex( double aX, double aY, double aZ,
+                                        float aNx, float aNy, float aNz )
+{
+    unsigned index = m_vertices.size() / 3;
+
+    m_vertices.push_back( aX );
+    m_vertices.push_back( aY );
+    m_vertices.push_back( aZ );
+
+    m_normals.push_back( aNx );
+    m_normals.push_back( aNy );
+    m_normals.push_back( aNz );
+
+    return index;
+}
+
+
+void S3D_LAYER_GEOMETRY::AddSolidHorizontalPolyPolygons( const CPOLYGONS_LIST& aPolysList,
+                                                         int aZpos, int aThickness,
+                                                         double aBiuTo3DUnits,
+                                                         float aNormal_Z_Orientation )
+{
+    addSolidPolygons( aPolysList, false, aZpos, aThickness, aBiuTo3DUnits,
+                      aNormal_Z_Orientation );
+}
+
+
+void S3D_LAYER_GEOMETRY::AddSolidHorizontalPolygonSet( const POLYGON_SET& aPolygons,
+                                                       int aZpos, int aThickness,
+                                                       double aBiuTo3DUnits,
+                                                       float aNormal_Z_Orientation )
+{
+    CPOLYGONS_LIST contours;
+
+    aPolygons.ExportTo( contours );
+    addSolidPolygons( contours, true, aZpos, aThickness, aBiuTo3DUnits,
+                      aNormal_Z_Orientation );
+}
+
+
+void S3D_LAYER_GEOMETRY::addSolidPolygons( const CPOLYGONS_LIST& aPolysList, bool aOnePolygon,
+                                           int aZpos, int aThickness, double aBiuTo3DUnits,
+                                           float aNormal_Z_Orientation )
+{
+    unsigned cornerCount = aPolysList.GetCornersCount();
+
+    if( cornerCount == 0 )
+        return;
+
+    TESS_RESULT result;
+
+    result.m_points.reserve( cornerCount * 2 );
+    result.m_triangles.reserve( cornerCount * 3 );
+
+    for( unsigned ii = 0; ii < cornerCount; ii++ )
+    {
+        result.m_points.push_back( aPolysList.GetX( ii ) * aBiuTo3DUnits );
+        result.m_points.push_back( -aPolysList.GetY( ii ) * aBiuTo3DUnits );
+    }
+
+    GLUtesselator* tess = gluNewTess();
+
+    gluTessCallback( tess, GLU_TESS_BEGIN_DATA, ( void (CALLBACK*) () )tessBeginCB );
+    gluTessCallback( tess, GLU_TESS_EDGE_FLAG_DATA, ( void (CALLBACK*) () )tessEdgeFlagCB );
+    gluTessCallback( tess, GLU_TESS_VERTEX_DATA, ( void (CALLBACK*) () )tessVertexCB );
+    gluTessCallback( tess, GLU_TESS_COMBINE_DATA, ( void (CALLBACK*) () )tessCombineCB );
+    gluTessCallback( tess, GLU_TESS_ERROR_DATA, ( void (CALLBACK*) () )tessErrorCB );
+    gluTessNormal( tess, 0.0, 0.0, 1.0 );
+
+    // Outlines have a positive orientation and holes a negative one in a POLYGON_SET
+    if( aOnePolygon )
+        gluTessProperty( tess, GLU_TESS_WINDING_RULE, GLU_TESS_WINDING_NONZERO );
+
+    GLdouble v_data[3];
+    bool     startPolygon = true;
+    bool     startContour = true;
+
+    v_data[2] = 0.0;
+
+    for( unsigned ii = 0; ii < cornerCount; ii++ )
+    {
+        if( startPolygon )
+        {
+            gluTessBeginPolygon( tess, &result );
+            startPolygon = false;
+        }
+
+        if( startContour )
+        {
+            gluTessBeginContour( tess );
+            startContour = false;
+        }
+
+        // gluTessVertex copies the coordinates, but keeps the vertex data (the index)
+        v_data[0] = result.m_points[ii * 2];
+        v_data[1] = result.m_points[ii * 2 + 1];
+        gluTessVertex( tess, v_data, (void*) (size_t) ii );
+
+        if( aPolysList.IsEndContour( ii ) )
+        {
+            gluTessEndContour( tess );
+            startContour = true;
+
+            if( !aOnePolygon )
+            {
+                gluTessEndPolygon( tess );
+                startPolygon = true;
+            }
+        }
+    }
+
+    if( !startContour )
+        gluTessEndContour( tess );
+
+    if( !startPolygon )
+        gluTessEndPolygon( tess );
+
+    gluDeleteTess( tess );
+
+    // The top side, then the bottom side for solid objects
+    unsigned pointCount = result.m_points.size() / 2;
+    double   zpos = ( aZpos + (aThickness / 2.0) ) * aBiuTo3DUnits;
+    float    normal_z = aNormal_Z_Orientation;
+
+    m_vertices.reserve( m_vertices.size() + pointCount * 6 + cornerCount * 12 );
+    m_normals.reserve( m_normals.size() + pointCount * 6 + cornerCount * 12 );
+    m_indices.reserve( m_indices.size() + result.m_triangles.size() * 2 + cornerCount * 6 );
+
+    for( int side = 0; side < 2; side++ )
+    {
+        unsigned first = m_vertices.size() / 3;
+
+        for( unsigned ii = 0; ii < pointCount; ii++ )
+            addVertex( result.m_points[ii * 2], result.m_points[ii * 2 + 1], zpos,
+                       0.0f, 0.0f, normal_z );
+
+        for( unsigned ii = 0; ii < result.m_triangles.size(); ii++ )
+            m_indices.push_back( first + result.m_triangles[ii] );
+
+        if( aThickness == 0 )
+            return;
+
+        zpos = ( aZpos - (aThickness / 2.0) ) * aBiuTo3DUnits;
+        normal_z = -aNormal_Z_Orientation;
+    }
+
+    addVerticalSides( aPolysList, ( aZpos - (aThickness / 2.0) ) * aBiuTo3DUnits,
+                      ( aZpos + (aThickness / 2.0) ) * aBiuTo3DUnits, aBiuTo3DUnits );
+}
+
+
+void S3D_LAYER_GEOMETRY::addVerticalSides( const CPOLYGONS_LIST& aPolysList,
+                                           double aZbottom, double aZtop,
+                                           double aBiuTo3DUnits )
+{
+    unsigned cornerCount = aPolysList.GetCornersCount();
+    unsigned startContour = 0;
+
+    for( unsigned ii = 0; ii < cornerCount; ii++ )
+    {
+        unsigned jj = ii + 1;
+
+        if( aPolysList.IsEndContour( ii ) || jj >= cornerCount )
+        {
+            jj = startContour;
+            startContour = ii + 1;
+        }
+
+        double x0 = aPolysList.GetX( ii ) * aBiuTo3DUnits;
+        double y0 = -aPolysList.GetY( ii ) * aBiuTo3DUnits;
+        double x1 = aPolysList.GetX( jj ) * aBiuTo3DUnits;
+        double y1 = -aPolysList.GetY( jj ) * aBiuTo3DUnits;
+
+        // The normal of the side, horizontal and orthogonal to the edge
+        double nx = y0 - y1;
+        double ny = x1 - x0;
+        double len = sqrt( nx * nx + ny * ny );
+
+        if( len < 0.000001 )    // null edge (happens in linked holes)
+            continue;
+
+        nx /= len;
+        ny /= len;
+
+        unsigned first = addVertex( x0, y0, aZbottom, nx, ny, 0.0f );
+        addVertex( x0, y0, aZtop, nx, ny, 0.0f );
+        addVertex( x1, y1, aZtop, nx, ny, 0.0f );
+        addVertex( x1, y1, aZbottom, nx, ny, 0.0f );
+
+        m_indices.push_back( first );
+        m_indices.push_back( first + 1 );
+        m_indices.push_back( first + 2 );
+
+        m_indices.push_back( first );
+        m_indices.push_back( first + 2 );
+        m_indices.push_back( first + 3 );
+    }
+}
@@ -0,0 +1,114 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2015 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file 3d_layer_geometry.h
+ */
+
+#ifndef _3D_LAYER_GEOMETRY_H_
+#define _3D_LAYER_GEOMETRY_H_
+
+#include <vector>
+
+class CPOLYGONS_LIST;
+class POLYGON_SET;
+
+
+/**
+ * Class S3D_LAYER_GEOMETRY
+ * stores the triangles of solid horizontal polygons (the shapes of a board layer) as
+ * plain vertex, normal and index arrays.
+ * The triangles are calculated without any OpenGL call (the GLU tesselator does not
+ * need a GL context), so layers can be built in worker threads; only sending the arrays
+ * to OpenGL (see Draw3D_LayerGeometry()) must be done by the GUI thread.
+ */
+class S3D_LAYER_GEOMETRY
+{
+public:
+    S3D_LAYER_GEOMETRY() {}
+
+    void Clear();
+
+    bool IsEmpty() const { return m_indices.empty(); }
+
+    unsigned GetTriangleCount() const { return m_indices.size() / 3; }
+
+    /// Vertex coordinates in 3D units, 3 values (x, y, z) by vertex
+    const std::vector<float>& GetVertices() const { return m_vertices; }
+
+    /// Vertex normals, 3 values (x, y, z) by vertex
+    const std::vector<float>& GetNormals() const { return m_normals; }
+
+    /// Vertex indices, 3 by triangle
+    const std::vector<unsigned>& GetIndices() const { return m_indices; }
+
+    /**
+     * Function AddSolidHorizontalPolyPolygons
+     * adds the triangles of all solid polygons found in aPolysList.  Each contour is a
+     * polygon, holes have to be linked to their outline (see POLYGON_SET::Fracture()).
+     * @param aPolysList = the polygon list
+     * @param aZpos = z position in board internal units
+     * @param aThickness = thickness in board internal units
+     * @param aBiuTo3DUnits = board internal units to 3D units scaling value
+     * @param aNormal_Z_Orientation = the normal Z orientation of the top side
+     * If aThickness = 0, a polygon area is built in a XY plane at Z position = aZpos.
+     * If aThickness > 0, a solid object is built, with its vertical sides.
+     *  The top side is located at aZpos + aThickness / 2
+     *  The bottom side is located at aZpos - aThickness / 2
+     */
+    void AddSolidHorizontalPolyPolygons( const CPOLYGONS_LIST& aPolysList,
+                                         int aZpos, int aThickness, double aBiuTo3DUnits,
+                                         float aNormal_Z_Orientation );
+
+    /**
+     * Function AddSolidHorizontalPolygonSet
+     * adds the triangles of the polygons of aPolygons, like AddSolidHorizontalPolyPolygons().
+     * The outlines and holes are given to the tesselator as contours of one polygon, so
+     * aPolygons does not need to be fractured (which is slow for large copper areas), and
+     * no vertical side is built for the links between holes and outlines.
+     */
+    void AddSolidHorizontalPolygonSet( const POLYGON_SET& aPolygons,
+                                       int aZpos, int aThickness, double aBiuTo3DUnits,
+                                       float aNormal_Z_Orientation );
+
+private:
+    /// Adds the triangles of aPolysList, each contour being a polygon, or all the
+    /// contours being one polygon (non zero winding rule) if aOnePolygon is true
+    void addSolidPolygons( const CPOLYGONS_LIST& aPolysList, bool aOnePolygon,
+                           int aZpos, int aThickness, double aBiuTo3DUnits,
+                           float aNormal_Z_Orientation );
+
+    /// Adds a vertex, returns its index
+    unsigned addVertex( double aX, double aY, double aZ,
+                        float aNx, float aNy, float aNz );
+
+    /// Adds the vertical sides of the polygons of aPolysList, from aZbottom to aZtop
+    void addVerticalSides( const CPOLYGONS_LIST& aPolysList, double aZbottom, double aZtop,
+                           double aBiuTo3DUnits );
+
+    std::vector<float>      m_vertices;
+    std::vector<float>      m_normals;
+    std::vector<unsigned>   m_indices;
+};
+
+#endif  // _3D_LAYER_GEOMETRY_H_
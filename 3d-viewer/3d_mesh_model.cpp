@@ -161,6 +161,32 @@ void S3D_MESH::openGL_RenderAllChilds(  bool aIsRenderingJustNonTransparentObjec
 }
 
 
+void S3D_MESH::CalcNormalsAllChilds( bool aSmoothShapes )
+{
+    if( m_CoordIndex.size() > 0 )
+        calcNormals( aSmoothShapes );
+
+    for( unsigned int idx = 0; idx < childs.size(); idx++ )
+        childs[idx]->CalcNormalsAllChilds( aSmoothShapes );
+}
+
+
+void S3D_MESH::calcNormals( bool aSmoothShapes )
+{
+    calcPointNormalized();
+    calcPerFaceNormals();
+
+    if( aSmoothShapes )
+    {
+        if( (m_PerVertexNormalsNormalized.size() > 0) &&
+            g_Parm_3D_Visu.GetFlag( FL_RENDER_USE_MODEL_NORMALS ) )
+            perVertexNormalsVerify_and_Repair();
+        else
+            calcPerPointNormals();
+    }
+}
+
+
 void S3D_MESH::openGL_Render( bool aIsRenderingJustNonTransparentObjects,
                               bool aIsRenderingJustTransparentObjects )
 {
@@ -234,18 +260,7 @@ void S3D_MESH::openGL_Render( bool aIsRenderingJustNonTransparentObjects,
     glRotatef( m_rotation[3], m_rotation[0], m_rotation[1], m_rotation[2] );
     glScalef( m_scale.x, m_scale.y, m_scale.z );
 
-    calcPointNormalized();
-    calcPerFaceNormals();
-
-    if( smoothShapes )
-    {
-        if( (m_PerVertexNormalsNormalized.size() > 0) &&
-            g_Parm_3D_Visu.GetFlag( FL_RENDER_USE_MODEL_NORMALS ) )
-            perVertexNormalsVerify_and_Repair();
-        else
-            calcPerPointNormals();
-
-    }
+    calcNormals( smoothShapes );
 /*
 #if defined(DEBUG)
     // Debug Normals
@@ -57,6 +57,14 @@ public:
     void openGL_RenderAllChilds( bool aIsRenderingJustNonTransparentObjects,
                                  bool aIsRenderingJustTransparentObjects );
 
+    /**
+     * Function CalcNormalsAllChilds
+     * calculates the normals of this mesh and of its childs, as they are calculated
+     * when rendering the mesh, so it can be done before, from any thread.
+     * @param aSmoothShapes = true to calculate the normals of vertices.
+     */
+    void CalcNormalsAllChilds( bool aSmoothShapes );
+
     S3D_MATERIAL                    *m_Materials;
 
     // Point and index list
@@ -95,6 +103,8 @@ private:
     bool isPerVertexNormalsVerified;
     void perVertexNormalsVerify_and_Repair();
 
+    void calcNormals( bool aSmoothShapes );
+
     void calcBBox();
     void calcBBoxAllChilds();
 
@@ -102,6 +112,8 @@ private:
 
     void openGL_Render( bool aIsRenderingJustNonTransparentObjects,
                         bool aIsRenderingJustTransparentObjects );
+
+    friend class S3D_MODEL_CACHE;   // reads and writes the calculated normals
 };
 
 #endif
@@ -0,0 +1,547 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2015 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file 3d_model_cache.cpp
+ */
+
+#include <fctsys.h>
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <wx/filename.h>
+#include <wx/stdpaths.h>
+#include <wx/utils.h>
+
+#include <3d_struct.h>
+#include <info3d_visu.h>
+#include <modelparsers.h>
+#include <3d_model_cache.h>
+
+
+/* Cache file format (native byte order and sizes, the cache is not shared between machines):
+ *  header: CACHE_MAGIC, CACHE_VERSION, options
+ *  material count, then for each material: name, m_ColorPerVertex and the color lists
+ *  mesh count, then for each mesh: its material index (-1 for none), data, normals and
+ *  the indices of its childs, which are always lower than the index of the mesh
+ *  root mesh count, then the indices of S3D_MODEL_PARSER::childs
+ */
+static const char       CACHE_MAGIC[8] = { 'K', 'i', 'C', 'a', 'd', '3', 'D', 'C' };
+static const uint32_t   CACHE_VERSION = 2;     // 2: models with VRML Inline nodes are not cached
+
+
+/// Buffered writing of the cache data
+class CACHE_WRITER
+{
+public:
+    void Put( const void* aData, size_t aSize )
+    {
+        m_buffer.append( (const char*) aData, aSize );
+    }
+
+    void PutInt( int32_t aValue ) { Put( &aValue, sizeof( aValue ) ); }
+
+    void PutString( const wxString& aString )
+    {
+        std::string utf8 = TO_UTF8( aString );
+
+        PutInt( utf8.size() );
+        Put( utf8.data(), utf8.size() );
+    }
+
+    template <typename T>
+    void PutVector( const std::vector<T>& aVector )
+    {
+        PutInt( aVector.size() );
+
+        if( aVector.size() )
+            Put( &aVector[0], aVector.size() * sizeof( T ) );
+    }
+
+    template <typename T>
+    void PutVectors( const std::vector< std::vector<T> >& aVectors )
+    {
+        PutInt( aVectors.size() );
+
+        for( unsigned ii = 0; ii < aVectors.size(); ii++ )
+            PutVector( aVectors[ii] );
+    }
+
+    const std::string& GetBuffer() const { return m_buffer; }
+
+private:
+    std::string m_buffer;
+};
+
+
+/// Reading of the cache data, checking it does not go past the end of the data
+class CACHE_READER
+{
+public:
+    CACHE_READER( const std::string& aBuffer ) :
+        m_buffer( aBuffer ),
+        m_pos( 0 )
+    {}
+
+    bool Get( void* aData, size_t aSize )
+    {
+        if( aSize > m_buffer.size() - m_pos )
+            return false;
+
+        memcpy( aData, m_buffer.data() + m_pos, aSize );
+        m_pos += aSize;
+        return true;
+    }
+
+    bool GetInt( int32_t& aValue ) { return Get( &aValue, sizeof( aValue ) ); }
+
+    /// Reads a count of items of aItemSize bytes, which must fit in the remaining data
+    bool GetCount( unsigned& aCount, size_t aItemSize )
+    {
+        int32_t count;
+
+        if( !GetInt( count ) || count < 0 )
+            return false;
+
+        aCount = count;
+
+        return aCount <= ( m_buffer.size() - m_pos ) / std::max( aItemSize, (size_t) 1 );
+    }
+
+    bool GetString( wxString& aString )
+    {
+        unsigned size;
+
+        if( !GetCount( size, 1 ) )
+            return false;
+
+        aString = FROM_UTF8( std::string( m_buffer.data() + m_pos, size ).c_str() );
+        m_pos += size;
+        return true;
+    }
+
+    template <typename T>
+    bool GetVector( std::vector<T>& aVector )
+    {
+        unsigned count;
+
+        if( !GetCount( count, sizeof( T ) ) )
+            return false;
+
+        aVector.resize( count );
+
+        return count == 0 || Get( &aVector[0], count * sizeof( T ) );
+    }
+
+    template <typename T>
+    bool GetVectors( std::vector< std::vector<T> >& aVectors )
+    {
+        unsigned count;
+
+        if( !GetCount( count, sizeof( int32_t ) ) )
+            return false;
+
+        aVectors.resize( count );
+
+        for( unsigned ii = 0; ii < count; ii++ )
+        {
+            if( !GetVector( aVectors[ii] ) )
+                return false;
+        }
+
+        return true;
+    }
+
+    bool AtEnd() const { return m_pos == m_buffer.size(); }
+
+private:
+    const std::string&  m_buffer;
+    size_t              m_pos;
+};
+
+
+/// The meshes and materials of a model, numbered to be written
+struct CACHE_INDEX
+{
+    std::map<const S3D_MESH*, int>      m_meshIndex;
+    std::vector<const S3D_MESH*>        m_meshes;
+    std::map<const S3D_MATERIAL*, int>  m_materialIndex;
+    std::vector<const S3D_MATERIAL*>    m_materials;
+
+    /// Numbers aMesh after its childs, so childs always have a lower index
+    int AddMesh( const S3D_MESH* aMesh )
+    {
+        std::map<const S3D_MESH*, int>::iterator it = m_meshIndex.find( aMesh );
+
+        if( it != m_meshIndex.end() )
+            return it->second;
+
+        for( unsigned ii = 0; ii < aMesh->childs.size(); ii++ )
+            AddMesh( aMesh->childs[ii].get() );
+
+        if( aMesh->m_Materials && !m_materialIndex.count( aMesh->m_Materials ) )
+        {
+            m_materialIndex[aMesh->m_Materials] = m_materials.size();
+            m_materials.push_back( aMesh->m_Materials );
+        }
+
+        int index = m_meshes.size();
+
+        m_meshIndex[aMesh] = index;
+        m_meshes.push_back( aMesh );
+
+        return index;
+    }
+};
+
+
+/// 64 bits FNV-1a hash
+static void hashData( uint64_t& aHash, const void* aData, size_t aSize )
+{
+    const unsigned char* data = (const unsigned char*) aData;
+
+    for( size_t ii = 0; ii < aSize; ii++ )
+    {
+        aHash ^= data[ii];
+        aHash *= 1099511628211ULL;
+    }
+}
+
+
+static bool readFile( const wxString& aFileName, std::string& aContent )
+{
+    FILE* file = wxFopen( aFileName, wxT( "rb" ) );
+
+    if( !file )
+        return false;
+
+    char    buffer[65536];
+    size_t  size;
+
+    aContent.clear();
+
+    while( ( size = fread( buffer, 1, sizeof( buffer ), file ) ) > 0 )
+        aContent.append( buffer, size );
+
+    bool ok = !ferror( file );
+
+    fclose( file );
+    return ok;
+}
+
+
+S3D_MODEL_CACHE::S3D_MODEL_CACHE( bool aSmoothShapes ) :
+    m_smoothShapes( aSmoothShapes )
+{
+    m_cacheDir = GetCacheDir();
+
+    // The normals calculated from the model depend on these options
+    m_options = ( aSmoothShapes ? 1 : 0 ) |
+                ( g_Parm_3D_Visu.GetFlag( FL_RENDER_USE_MODEL_NORMALS ) ? 2 : 0 );
+}
+
+
+wxString S3D_MODEL_CACHE::GetCacheDir()
+{
+    wxFileName cachepath;
+
+#if !defined( __WINDOWS__ ) && !defined( __WXMAC__ )
+    wxString envstr;
+
+    if( !wxGetEnv( wxT( "XDG_CACHE_HOME" ), &envstr ) || envstr.IsEmpty() )
+    {
+        // XDG_CACHE_HOME is not set, so use the fallback
+        cachepath.AssignDir( wxGetHomeDir() );
+        cachepath.AppendDir( wxT( ".cache" ) );
+    }
+    else
+    {
+        cachepath.AssignDir( envstr );
+    }
+
+    cachepath.AppendDir( wxT( "kicad" ) );
+#else
+    cachepath.AssignDir( wxStandardPaths::Get().GetUserLocalDataDir() );
+#endif
+
+    cachepath.AppendDir( wxT( "3d" ) );
+
+    if( !cachepath.DirExists() && !cachepath.Mkdir( 0777, wxPATH_MKDIR_FULL ) )
+        return wxEmptyString;
+
+    return cachepath.GetPath();
+}
+
+
+wxString S3D_MODEL_CACHE::GetCacheFileName( const wxString& aModelFileName ) const
+{
+    std::string content;
+
+    if( m_cacheDir.IsEmpty() || !readFile( aModelFileName, content ) )
+        return wxEmptyString;
+
+    uint64_t hash = 14695981039346656037ULL;
+
+    hashData( hash, content.data(), content.size() );
+    hashData( hash, &m_options, sizeof( m_options ) );
+
+    wxFileName fn( m_cacheDir, wxString::Format( wxT( "%08x%08x" ),
+                                                 unsigned( hash >> 32 ), unsigned( hash ) ),
+                   wxT( "3dc" ) );
+
+    return fn.GetFullPath();
+}
+
+
+bool S3D_MODEL_CACHE::Write( const wxString& aCacheFileName, const S3D_MODEL_PARSER* aParser ) const
+{
+    CACHE_INDEX index;
+    CACHE_WRITER out;
+
+    for( unsigned ii = 0; ii < aParser->childs.size(); ii++ )
+        index.AddMesh( aParser->childs[ii].get() );
+
+    out.Put( CACHE_MAGIC, sizeof( CACHE_MAGIC ) );
+    out.PutInt( CACHE_VERSION );
+    out.PutInt( m_options );
+
+    out.PutInt( index.m_materials.size() );
+
+    for( unsigned ii = 0; ii < index.m_materials.size(); ii++ )
+    {
+        const S3D_MATERIAL* material = index.m_materials[ii];
+
+        out.PutString( material->m_Name );
+        out.PutInt( material->m_ColorPerVertex );
+        out.PutVector( material->m_AmbientColor );
+        out.PutVector( material->m_DiffuseColor );
+        out.PutVector( material->m_EmissiveColor );
+        out.PutVector( material->m_SpecularColor );
+        out.PutVector( material->m_Shininess );
+        out.PutVector( material->m_Transparency );
+    }
+
+    out.PutInt( index.m_meshes.size() );
+
+    for( unsigned ii = 0; ii < index.m_meshes.size(); ii++ )
+    {
+        const S3D_MESH* mesh = index.m_meshes[ii];
+
+        out.PutInt( mesh->m_Materials ? index.m_materialIndex[mesh->m_Materials] : -1 );
+
+        out.PutVector( mesh->m_Point );
+        out.PutVectors( mesh->m_CoordIndex );
+        out.PutVectors( mesh->m_NormalIndex );
+        out.PutVector( mesh->m_PerFaceColor );
+        out.PutVector( mesh->m_PerFaceNormalsNormalized );
+        out.PutVector( mesh->m_PerVertexNormalsNormalized );
+        out.PutVector( mesh->m_MaterialIndexPerFace );
+        out.PutVectors( mesh->m_MaterialIndexPerVertex );
+
+        out.Put( &mesh->m_translation, sizeof( mesh->m_translation ) );
+        out.Put( &mesh->m_rotation, sizeof( mesh->m_rotation ) );
+        out.Put( &mesh->m_scale, sizeof( mesh->m_scale ) );
+
+        // Normals calculated from the model
+        out.PutInt( mesh->isPointNormalizedComputed );
+        out.PutInt( mesh->isPerFaceNormalsComputed );
+        out.PutInt( mesh->isPerPointNormalsComputed );
+        out.PutInt( mesh->isPerVertexNormalsVerified );
+        out.PutVector( mesh->m_PointNormalized );
+        out.PutVector( mesh->m_PerFaceNormalsRaw_X_PerFaceSquaredArea );
+        out.PutVectors( mesh->m_PerFaceVertexNormals );
+
+        out.PutInt( mesh->childs.size() );
+
+        for( unsigned jj = 0; jj < mesh->childs.size(); jj++ )
+            out.PutInt( index.m_meshIndex[mesh->childs[jj].get()] );
+    }
+
+    out.PutInt( aParser->childs.size() );
+
+    for( unsigned ii = 0; ii < aParser->childs.size(); ii++ )
+        out.PutInt( index.m_meshIndex[aParser->childs[ii].get()] );
+
+    // Write a temporary file and rename it, so other threads or programs never
+    // read a partially written cache file
+    wxString tmpFileName = wxString::Format( wxT( "%s.%lu.%p" ), GetChars( aCacheFileName ),
+                                             wxGetProcessId(), aParser );
+    FILE*    file = wxFopen( tmpFileName, wxT( "wb" ) );
+
+    if( !file )
+        return false;
+
+    const std::string& buffer = out.GetBuffer();
+    bool ok = fwrite( buffer.data(), 1, buffer.size(), file ) == buffer.size();
+
+    if( fclose( file ) != 0 )
+        ok = false;
+
+    if( ok )
+        ok = wxRenameFile( tmpFileName, aCacheFileName, true );
+
+    if( !ok )
+        wxRemoveFile( tmpFileName );
+
+    return ok;
+}
+
+
+bool S3D_MODEL_CACHE::Read( const wxString& aCacheFileName, S3D_MODEL_PARSER* aParser ) const
+{
+    std::string buffer;
+
+    if( !wxFileName::FileExists( aCacheFileName ) || !readFile( aCacheFileName, buffer ) )
+        return false;
+
+    CACHE_READER in( buffer );
+    char         magic[sizeof( CACHE_MAGIC )];
+    int32_t      version;
+    int32_t      options;
+
+    if( !in.Get( magic, sizeof( magic ) ) || memcmp( magic, CACHE_MAGIC, sizeof( magic ) ) ||
+        !in.GetInt( version ) || version != (int32_t) CACHE_VERSION ||
+        !in.GetInt( options ) || options != (int32_t) m_options )
+        return false;
+
+    // The materials are owned by the master, as the ones created by the parsers
+    S3D_MASTER*                 master = aParser->GetMaster();
+    std::vector<S3D_MATERIAL*>  materials;
+    unsigned                    count;
+    bool                        ok = in.GetCount( count, sizeof( int32_t ) );
+
+    for( unsigned ii = 0; ok && ii < count; ii++ )
+    {
+        wxString name;
+        int32_t  colorPerVertex;
+
+        if( !in.GetString( name ) || !in.GetInt( colorPerVertex ) )
+        {
+            ok = false;
+            break;
+        }
+
+        S3D_MATERIAL* material = new S3D_MATERIAL( master, name );
+
+        materials.push_back( material );
+
+        material->m_ColorPerVertex = colorPerVertex;
+
+        ok = in.GetVector( material->m_AmbientColor ) &&
+             in.GetVector( material->m_DiffuseColor ) &&
+             in.GetVector( material->m_EmissiveColor ) &&
+             in.GetVector( material->m_SpecularColor ) &&
+             in.GetVector( material->m_Shininess ) &&
+             in.GetVector( material->m_Transparency );
+    }
+
+    S3D_MESH_PTRS meshes;
+
+    if( ok )
+        ok = in.GetCount( count, sizeof( int32_t ) );
+
+    for( unsigned ii = 0; ok && ii < count; ii++ )
+    {
+        S3D_MESH_PTR    mesh( new S3D_MESH() );
+        int32_t         materialIdx;
+        int32_t         flags[4];
+        unsigned        childCount;
+
+        meshes.push_back( mesh );
+
+        ok = in.GetInt( materialIdx ) &&
+             materialIdx >= -1 && materialIdx < (int) materials.size() &&
+             in.GetVector( mesh->m_Point ) &&
+             in.GetVectors( mesh->m_CoordIndex ) &&
+             in.GetVectors( mesh->m_NormalIndex ) &&
+             in.GetVector( mesh->m_PerFaceColor ) &&
+             in.GetVector( mesh->m_PerFaceNormalsNormalized ) &&
+             in.GetVector( mesh->m_PerVertexNormalsNormalized ) &&
+             in.GetVector( mesh->m_MaterialIndexPerFace ) &&
+             in.GetVectors( mesh->m_MaterialIndexPerVertex ) &&
+             in.Get( &mesh->m_translation, sizeof( mesh->m_translation ) ) &&
+             in.Get( &mesh->m_rotation, sizeof( mesh->m_rotation ) ) &&
+             in.Get( &mesh->m_scale, sizeof( mesh->m_scale ) ) &&
+             in.Get( flags, sizeof( flags ) ) &&
+             in.GetVector( mesh->m_PointNormalized ) &&
+             in.GetVector( mesh->m_PerFaceNormalsRaw_X_PerFaceSquaredArea ) &&
+             in.GetVectors( mesh->m_PerFaceVertexNormals ) &&
+             in.GetCount( childCount, sizeof( int32_t ) );
+
+        if( !ok )
+            break;
+
+        if( materialIdx >= 0 )
+            mesh->m_Materials = materials[materialIdx];
+
+        mesh->isPointNormalizedComputed  = flags[0];
+        mesh->isPerFaceNormalsComputed   = flags[1];
+        mesh->isPerPointNormalsComputed  = flags[2];
+        mesh->isPerVertexNormalsVerified = flags[3];
+
+        for( unsigned jj = 0; ok && jj < childCount; jj++ )
+        {
+            int32_t child;
+
+            // Childs are written before their parent: this also prevents loops
+            ok = in.GetInt( child ) && child >= 0 && child < (int) ii;
+
+            if( ok )
+                mesh->childs.push_back( meshes[child] );
+        }
+    }
+
+    S3D_MESH_PTRS roots;
+
+    if( ok )
+        ok = in.GetCount( count, sizeof( int32_t ) );
+
+    for( unsigned ii = 0; ok && ii < count; ii++ )
+    {
+        int32_t root;
+
+        ok = in.GetInt( root ) && root >= 0 && root < (int) meshes.size();
+
+        if( ok )
+            roots.push_back( meshes[root] );
+    }
+
+    // The materials are given to the master only if the whole file is valid
+    if( !ok || !in.AtEnd() )
+    {
+        for( unsigned ii = 0; ii < materials.size(); ii++ )
+            delete materials[ii];
+
+        return false;
+    }
+
+    for( unsigned ii = 0; ii < materials.size(); ii++ )
+        master->Insert( materials[ii] );
+
+    aParser->childs.swap( roots );
+
+    return true;
+}
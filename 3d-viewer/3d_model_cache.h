@@ -0,0 +1,100 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2015 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file 3d_model_cache.h
+ * @brief a disk cache of the meshes read from 3D model files.
+ */
+
+#ifndef _3D_MODEL_CACHE_H_
+#define _3D_MODEL_CACHE_H_
+
+#include <wx/string.h>
+
+class S3D_MODEL_PARSER;
+
+
+/**
+ * Class S3D_MODEL_CACHE
+ * stores the meshes of a model file (S3D_MODEL_PARSER::childs, their materials
+ * and their normals, once calculated) in a binary file of the cache directory,
+ * so the model file does not need to be parsed again.
+ *
+ * A cache file is named from a hash of the content of the model file and of the
+ * options used to calculate the normals: a modified model file gets a new cache
+ * file, and the same model installed in several libraries is cached only once.
+ * Models that read other files (S3D_MODEL_PARSER::HasReadOtherFiles()) must not be
+ * written to the cache, as their meshes do not depend only on that content.
+ *
+ * Read() and Write() can be called from worker threads.
+ */
+class S3D_MODEL_CACHE
+{
+public:
+    /**
+     * Constructor
+     * @param aSmoothShapes = true if the normals of vertices are calculated
+     * (see S3D_MESH::CalcNormalsAllChilds()).
+     */
+    S3D_MODEL_CACHE( bool aSmoothShapes );
+
+    /// @return true if the normals of vertices are calculated for the cached meshes
+    bool GetSmoothShapes() const { return m_smoothShapes; }
+
+    /**
+     * Function GetCacheFileName
+     * @return the full file name of the cache file of \a aModelFileName, or an
+     *  empty string if the model file cannot be read or there is no cache directory.
+     */
+    wxString GetCacheFileName( const wxString& aModelFileName ) const;
+
+    /**
+     * Function Read
+     * reads the meshes of \a aCacheFileName into \a aParser, and the materials into
+     * the master of \a aParser.
+     * @return false if the cache file does not exist or is not valid, and then neither
+     *  \a aParser nor its master are modified.
+     */
+    bool Read( const wxString& aCacheFileName, S3D_MODEL_PARSER* aParser ) const;
+
+    /**
+     * Function Write
+     * writes the meshes of \a aParser to \a aCacheFileName.
+     * @return false if the file cannot be written.
+     */
+    bool Write( const wxString& aCacheFileName, const S3D_MODEL_PARSER* aParser ) const;
+
+    /**
+     * Function GetCacheDir
+     * @return the directory of the 3D model cache files, created if needed, or an
+     *  empty string if it cannot be created.
+     */
+    static wxString GetCacheDir();
+
+private:
+    wxString    m_cacheDir;
+    bool        m_smoothShapes;
+    unsigned    m_options;      ///< options the normals are calculated with
+};
+
+#endif  // _3D_MODEL_CACHE_H_
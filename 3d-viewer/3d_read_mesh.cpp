@@ -39,6 +39,7 @@
 #include <info3d_visu.h>
 #include "3d_struct.h"
 #include "modelparsers.h"
+#include "3d_model_cache.h"
 
 
 S3D_MODEL_PARSER *S3D_MODEL_PARSER::Create( S3D_MASTER* aMaster,
@@ -53,7 +54,7 @@ S3D_MODEL_PARSER *S3D_MODEL_PARSER::Create( S3D_MASTER* aMaster,
  }
 
 
-int S3D_MASTER::ReadData( S3D_MODEL_PARSER* aParser )
+int S3D_MASTER::ReadData( S3D_MODEL_PARSER* aParser, S3D_MODEL_CACHE* aCache )
 {
     if( m_Shape3DFullFilename.IsEmpty() || aParser == NULL )
         return -1;
@@ -69,8 +70,32 @@ int S3D_MASTER::ReadData( S3D_MODEL_PARSER* aParser )
     if( wxFileName::FileExists( filename ) )
     {
         wxFileName fn( filename );
+        wxString   cacheFilename;
+        bool       loaded = false;
 
-        if( aParser->Load( filename ) )
+        if( aCache )
+        {
+            cacheFilename = aCache->GetCacheFileName( filename );
+            loaded = !cacheFilename.IsEmpty() && aCache->Read( cacheFilename, aParser );
+        }
+
+        if( !loaded && aParser->Load( filename ) )
+        {
+            loaded = true;
+
+            // The cache file is named from the content of the model file only, so models
+            // reading other files (VRML Inline nodes) are not cached
+            if( !cacheFilename.IsEmpty() && !aParser->HasReadOtherFiles() )
+            {
+                // Store the meshes with their normals, which take most of the time
+                for( unsigned int idx = 0; idx < aParser->childs.size(); idx++ )
+                    aParser->childs[idx]->CalcNormalsAllChilds( aCache->GetSmoothShapes() );
+
+                aCache->Write( cacheFilename, aParser );
+            }
+        }
+
+        if( loaded )
         {
             // Invalidate bounding boxes
             m_fastAABBox.Reset();
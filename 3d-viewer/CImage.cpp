@@ -30,6 +30,8 @@
 #include "CImage.h"
 #include <wx/image.h>                                                           // Used for save an image to disk
 #include <string.h>                                                             // For memcpy
+#include <algorithm>
+#include <vector>
 
 #ifndef CLAMP
 #define CLAMP(n, min, max) {if (n < min) n=min; else if (n > max) n = max;}
@@ -364,44 +366,118 @@ static const S_FILTER FILTERS[] =   {
 };// Filters
 
 
-//!TODO: This functions can be optimized slipting it between the edges and
-//       do it without use the getpixel function.
-//       Optimization can be done to m_pixels[ix + iy * m_width]
-//       but keep in mind the parallel process of the algorithm
+/// @return aV clamped to 0 .. aSize - 1, as wrapCoords() does with WRAP_CLAMP
+static inline int clampCoord( int aV, int aSize )
+{
+    return ( aV < 0 ) ? 0 : ( ( aV >= aSize - 1 ) ? aSize - 1 : aV );
+}
+
+
 void CIMAGE::EfxFilter( CIMAGE *aInImg, E_FILTER aFilterType )
 {
-    S_FILTER filter = FILTERS[aFilterType];
+    const S_FILTER& filter = FILTERS[aFilterType];
 
     aInImg->m_wraping = WRAP_CLAMP;
     m_wraping = WRAP_CLAMP;
 
+    // The coordinates are clamped separately in x and y, so the 5x5 filter is the sum
+    // of the vertical filters kernel[sx][0..4], shifted by sx - 2 pixels in x.
+    // Each different vertical filter is applied once on a line, then the shifted lines
+    // are added: the integer sums are the same as the ones of the 5x5 filter, without
+    // the clamping of each coordinate, and the inner loops can be vectorized.
+    int lineOf[5];      // index of the vertical filter of each kernel[sx], -1 if null
+    int lineKernel[5];  // sx of the kernel of each vertical filter
+    int lineCount = 0;
+
+    for( int sx = 0; sx < 5; sx++ )
+    {
+        lineOf[sx] = -1;
+
+        if( !filter.kernel[sx][0] && !filter.kernel[sx][1] && !filter.kernel[sx][2] &&
+            !filter.kernel[sx][3] && !filter.kernel[sx][4] )
+            continue;
+
+        for( int line = 0; line < lineCount && lineOf[sx] < 0; line++ )
+        {
+            if( !memcmp( filter.kernel[lineKernel[line]], filter.kernel[sx], 5 ) )
+                lineOf[sx] = line;
+        }
+
+        if( lineOf[sx] < 0 )
+        {
+            lineKernel[lineCount] = sx;
+            lineOf[sx] = lineCount++;
+        }
+    }
+
+    const int inWidth  = aInImg->m_width;
+    const int inHeight = aInImg->m_height;
+    const int width    = m_width;
+
+    // Output pixels whose 5 taps are inside the input line
+    const int xStart = std::min( 2, width );
+    const int xEnd   = std::max( xStart, std::min( width, inWidth - 2 ) );
+
     #ifdef USE_OPENMP
     #pragma omp parallel for
     #endif /* USE_OPENMP */
-    
-    for( int iy = 0; iy < (int)m_height; iy++)
+
+    for( int iy = 0; iy < (int)m_height; iy++ )
     {
-        for( int ix = 0; ix < (int)m_width; ix++ )
+        std::vector<int> lines( lineCount * inWidth + width );
+        int* sums = &lines[lineCount * inWidth];
+
+        const unsigned char* src[5];
+
+        for( int sy = 0; sy < 5; sy++ )
+            src[sy] = aInImg->m_pixels + clampCoord( iy + sy - 2, inHeight ) * inWidth;
+
+        for( int line = 0; line < lineCount; line++ )
+        {
+            const signed char* k = filter.kernel[lineKernel[line]];
+            const int k0 = k[0], k1 = k[1], k2 = k[2], k3 = k[3], k4 = k[4];
+            int* dst = &lines[line * inWidth];
+
+            for( int ix = 0; ix < inWidth; ix++ )
+                dst[ix] = k0 * src[0][ix] + k1 * src[1][ix] + k2 * src[2][ix] +
+                          k3 * src[3][ix] + k4 * src[4][ix];
+        }
+
+        for( int ix = 0; ix < width; ix++ )
+            sums[ix] = 0;
+
+        for( int sx = 0; sx < 5; sx++ )
         {
-            int v = 0;
-
-            for( int sy = 0; sy < 5; sy++ )
-            {
-                for( int sx = 0; sx < 5; sx++ )
-                {
-                    int factor = filter.kernel[sx][sy];
-                    unsigned char pixelv = aInImg->Getpixel( ix + sx - 2, iy + sy - 2 );
-                    v += pixelv * factor;
-                }
-            }
-            
+            if( lineOf[sx] < 0 )
+                continue;
+
+            const int* line = &lines[lineOf[sx] * inWidth];
+            const int  shift = sx - 2;
+
+            // Clamped borders, then the inner part without clamping
+            for( int ix = 0; ix < xStart; ix++ )
+                sums[ix] += line[clampCoord( ix + shift, inWidth )];
+
+            for( int ix = xEnd; ix < width; ix++ )
+                sums[ix] += line[clampCoord( ix + shift, inWidth )];
+
+            for( int ix = xStart; ix < xEnd; ix++ )
+                sums[ix] += line[ix + shift];
+        }
+
+        unsigned char* dst = m_pixels + iy * width;
+
+        for( int ix = 0; ix < width; ix++ )
+        {
+            int v = sums[ix];
+
             v /= filter.div;
 
             v += filter.offset;
 
             CLAMP(v, 0, 255);
 
-            m_pixels[ix + iy * m_width] = v;
+            dst[ix] = v;
         }
     }
 }
@@ -37,6 +37,7 @@
 
 class S3D_MASTER;
 class X3D_MODEL_PARSER;
+class VRML_READER;
 
 /**
  * abstract class S3D_MODEL_PARSER
@@ -46,7 +47,8 @@ class S3D_MODEL_PARSER
 {
 public:
     S3D_MODEL_PARSER( S3D_MASTER* aMaster ) :
-        master( aMaster )
+        master( aMaster ),
+        readOtherFiles( false )
     {}
 
     virtual ~S3D_MODEL_PARSER(){}
@@ -76,10 +78,27 @@ public:
         return false;
     };
 
+    /**
+     * Function SetReadOtherFiles
+     * notes that the model refers to other files (e.g. VRML Inline nodes), so its meshes
+     * do not depend only on the content of the model file.
+     */
+    void SetReadOtherFiles()
+    {
+        readOtherFiles = true;
+    }
+
+    /// @return true if the model refers to other files (see SetReadOtherFiles())
+    bool HasReadOtherFiles() const
+    {
+        return readOtherFiles;
+    }
+
     S3D_MESH_PTRS childs;
 
 private:
     S3D_MASTER* master;
+    bool        readOtherFiles;
 };
 
 
@@ -124,8 +143,6 @@ private:
     S3D_MESH_PTR             m_model;
 
     std::vector< wxString > vrml_materials;
-    std::vector< wxString > vrml_points;
-    std::vector< wxString > vrml_coord_indexes;
 
     void readTransform( wxXmlNode* aTransformNode );
     void readMaterial( wxXmlNode* aMatNode );
@@ -206,7 +223,7 @@ private:
     bool                      m_normalPerVertex;
     bool                      colorPerVertex;
     S3D_MESH_PTR              m_model;                  ///< It stores the current model that the parsing is adding data
-    FILE*                     m_file;
+    VRML_READER*              m_file;                   ///< The reader of the file being loaded
     wxFileName                m_Filename;
     VRML2_COORDINATE_MAP      m_defCoordinateMap;
     VRML2_DEF_GROUP_MAP       m_defGroupMap;            ///< Stores a list of labels for groups and meshs that will be used later by the USE keyword
@@ -261,7 +278,7 @@ private:
     bool                     m_normalPerVertex;
     bool                     colorPerVertex;
     S3D_MESH_PTR             m_model;
-    FILE*                    m_file;
+    VRML_READER*             m_file;
     wxString                 m_Filename;
     S3D_MODEL_PARSER*        m_ModelParser;
     S3D_MASTER*              m_Master;
@@ -30,7 +30,121 @@
 #include "vrml_aux.h"
 
 
-bool GetString( FILE* File, char* aDstString, size_t maxDstLen )
+VRML_READER::VRML_READER()
+{
+    m_buffer.push_back( 0 );
+    m_begin = m_pos = m_end = &m_buffer[0];
+}
+
+
+bool VRML_READER::Open( const wxString& aFilename )
+{
+    FILE* file = wxFopen( aFilename, wxT( "rb" ) );
+
+    if( file == NULL )
+        return false;
+
+    m_buffer.clear();
+
+    // Read by big blocks, the size of the file is not needed
+    size_t size = 0;
+    size_t len;
+
+    do
+    {
+        m_buffer.resize( size + 65536 );
+        len = fread( &m_buffer[size], 1, 65536, file );
+        size += len;
+    } while( len == 65536 );
+
+    fclose( file );
+
+    m_buffer.resize( size + 1 );
+    m_buffer[size] = 0;
+
+    m_begin = m_pos = &m_buffer[0];
+    m_end = m_begin + size;
+
+    return true;
+}
+
+
+void VRML_READER::SetText( const wxString& aText )
+{
+    std::string text = TO_UTF8( aText );
+
+    m_buffer.assign( text.begin(), text.end() );
+    m_buffer.push_back( 0 );
+
+    m_begin = m_pos = &m_buffer[0];
+    m_end = m_begin + text.size();
+}
+
+
+void VRML_READER::SkipSpaces()
+{
+    while( m_pos < m_end && ( *m_pos == ' ' || *m_pos == '\t' || *m_pos == '\n' ||
+                              *m_pos == '\r' || *m_pos == '\f' || *m_pos == '\v' ) )
+        ++m_pos;
+}
+
+
+bool VRML_READER::ReadInt( int& aValue )
+{
+    SkipSpaces();
+
+    const char* cp = m_pos;
+    bool negative = false;
+
+    if( *cp == '-' || *cp == '+' )
+        negative = *cp++ == '-';
+
+    if( *cp < '0' || *cp > '9' )
+        return false;
+
+    int value = 0;
+
+    for( ; *cp >= '0' && *cp <= '9'; ++cp )
+        value = value * 10 + ( *cp - '0' );
+
+    aValue = negative ? -value : value;
+    m_pos = cp;
+
+    return true;
+}
+
+
+bool VRML_READER::ReadFloat( double& aValue )
+{
+    SkipSpaces();
+
+    // The buffer ends by a 0, so ParseDouble() does not read past the content
+    const char* end;
+    double      value = ParseDouble( m_pos, &end );
+
+    if( end == m_pos )
+        return false;
+
+    aValue = value;
+    m_pos = end;
+
+    return true;
+}
+
+
+bool VRML_READER::ReadFloat( float& aValue )
+{
+    double value;
+
+    if( !ReadFloat( value ) )
+        return false;
+
+    aValue = value;
+    return true;
+}
+
+
+bool GetString( VRML_READER* File, char* aDstString, size_t maxDstLen )
 {
 
     if( (!aDstString) || (maxDstLen == 0) )
@@ -38,7 +152,7 @@ bool GetString( FILE* File, char* aDstString, size_t maxDstLen )
 
     int c;
 
-    while( ( c = fgetc( File ) ) != EOF )
+    while( ( c = File->GetChar() ) != EOF )
     {
         if( c == '\"' )
         {
@@ -51,7 +165,7 @@ bool GetString( FILE* File, char* aDstString, size_t maxDstLen )
         return false;
     }
 
-    while( (( c = fgetc( File ) ) != EOF) && (maxDstLen > 0) )
+    while( (( c = File->GetChar() ) != EOF) && (maxDstLen > 0) )
     {
         if( c == '\"' )
         {
@@ -76,15 +190,15 @@ bool GetString( FILE* File, char* aDstString, size_t maxDstLen )
 }
 
 
-static int SkipGetChar ( FILE* File );
+static int SkipGetChar ( VRML_READER* File );
 
 
-static int SkipGetChar( FILE* File )
+static int SkipGetChar( VRML_READER* File )
 {
     int    c;
     bool    re_parse;
 
-    if( ( c = fgetc( File ) ) == EOF )
+    if( ( c = File->GetChar() ) == EOF )
     {
         // DBG( printf( "EOF\n" ) );
         return EOF;
@@ -101,7 +215,7 @@ static int SkipGetChar( FILE* File )
             // DBG( printf( "Skipping space \\t or { or [\n" ) );
             do
             {
-                if( ( c = fgetc( File ) ) == EOF )
+                if( ( c = File->GetChar() ) == EOF )
                 {
                     // DBG( printf( "EOF\n" ) );
 
@@ -117,7 +231,7 @@ static int SkipGetChar( FILE* File )
                 // DBG( printf( "Skipping # \\n or \\r or 0, 0x%02X\n", c ) );
                 do
                 {
-                    if( ( c = fgetc( File ) ) == EOF )
+                    if( ( c = File->GetChar() ) == EOF )
                     {
                         // DBG( printf( "EOF\n" ) );
                         return EOF;
@@ -126,7 +240,7 @@ static int SkipGetChar( FILE* File )
             }
             else
             {
-                if( ( c = fgetc( File ) ) == EOF )
+                if( ( c = File->GetChar() ) == EOF )
                 {
                     // DBG( printf( "EOF\n" ) );
                     return EOF;
@@ -141,7 +255,7 @@ static int SkipGetChar( FILE* File )
 }
 
 
-bool GetNextTag( FILE* File, char* tag, size_t len )
+bool GetNextTag( VRML_READER* File, char* tag, size_t len )
 {
     int c = SkipGetChar( File );
 
@@ -156,22 +270,21 @@ bool GetNextTag( FILE* File, char* tag, size_t len )
     // DBG( printf( "tag[0] %c\n", tag[0] ) );
     if( (c != '}') && (c != ']') )
     {
-        len--;
         char* dst = &tag[1];
+        char* end = &tag[len - 1];
 
-        while( fscanf( File, "%c", dst ) && len > 0 )
+        while( dst < end && ( c = File->GetChar() ) != EOF )
         {
-            if( (*dst == ' ') || (*dst == '[') || (*dst == '{')
-                || (*dst == '\t') || (*dst == '\n')|| (*dst == '\r') )
+            if( (c == ' ') || (c == '[') || (c == '{')
+                || (c == '\t') || (c == '\n')|| (c == '\r') )
             {
-                *dst = 0;
                 break;
             }
 
-            dst++;
-            len--;
+            *dst++ = c;
         }
 
+        *dst = 0;
 
         // DBG( printf( "tag %s\n", tag ) );
         c = SkipGetChar( File );
@@ -179,7 +292,7 @@ bool GetNextTag( FILE* File, char* tag, size_t len )
         if( c != EOF )
         {
             // Puts again the read char in the buffer
-            ungetc( c, File );
+            File->UngetChar();
         }
     }
 
@@ -187,12 +300,12 @@ bool GetNextTag( FILE* File, char* tag, size_t len )
 }
 
 
-int Read_NotImplemented( FILE* File, char closeChar )
+int Read_NotImplemented( VRML_READER* File, char closeChar )
 {
     int c;
 
     // DBG( printf( "look for %c\n", closeChar) );
-    while( ( c = fgetc( File ) ) != EOF )
+    while( ( c = File->GetChar() ) != EOF )
     {
         if( c == '{' )
         {
@@ -216,7 +329,7 @@ int Read_NotImplemented( FILE* File, char closeChar )
 }
 
 
-int ParseVertexList( FILE* File, std::vector<glm::vec3>& dst_vector )
+int ParseVertexList( VRML_READER* File, std::vector<glm::vec3>& dst_vector )
 {
     // DBG( printf( "      ParseVertexList\n" ) );
 
@@ -233,38 +346,32 @@ int ParseVertexList( FILE* File, std::vector<glm::vec3>& dst_vector )
 }
 
 
-bool ParseVertex( FILE* File, glm::vec3& dst_vertex )
+bool ParseVertex( VRML_READER* File, glm::vec3& dst_vertex )
 {
-    float   a, b, c;
-    int     ret = fscanf( File, "%e %e %e", &a, &b, &c );
-
-    dst_vertex.x    = a;
-    dst_vertex.y    = b;
-    dst_vertex.z    = c;
+    bool ret = File->ReadFloat( dst_vertex.x )
+               && File->ReadFloat( dst_vertex.y )
+               && File->ReadFloat( dst_vertex.z );
 
     int s = SkipGetChar( File );
 
     if( s != EOF )
     {
         // Puts again the read char in the buffer
-        ungetc( s, File );
+        File->UngetChar();
     }
 
     // DBG( printf( "ret%d(%.9f,%.9f,%.9f)", ret, a,b,c) );
 
-    return ret == 3;
+    return ret;
 }
 
 
-bool ParseFloat( FILE* aFile, float *aDstFloat, float aDefaultValue )
+bool ParseFloat( VRML_READER* aFile, float *aDstFloat, float aDefaultValue )
 {
-    float   value;
-    int     ret = fscanf( aFile, "%e", &value );
+    bool ret = aFile->ReadFloat( *aDstFloat );
 
-    if( ret == 1 )
-        *aDstFloat = value;
-    else
+    if( !ret )
         *aDstFloat = aDefaultValue;
 
-    return ret == 1;
+    return ret;
 }
@@ -50,64 +50,153 @@
 #endif
 #include <wx/glcanvas.h>
 
+
+/**
+ * Class VRML_READER
+ * gives the content of a VRML file, or of a text, to the VRML and X3D parsers.
+ * The whole file is read in memory at once, so characters are read without any
+ * stdio call, and numbers are converted without scanf: ReadFloat() uses
+ * ParseDouble(), ReadInt() converts the digits itself.
+ */
+class VRML_READER
+{
+public:
+    VRML_READER();
+
+    /**
+     * Function Open
+     * reads the whole file \a aFilename.
+     * @return bool - false if the file cannot be read
+     */
+    bool Open( const wxString& aFilename );
+
+    /**
+     * Function SetText
+     * uses \a aText (for instance the value of a X3D attribute) as content.
+     */
+    void SetText( const wxString& aText );
+
+    /// @return the next char, or EOF at the end of the content
+    int GetChar()
+    {
+        return m_pos < m_end ? (unsigned char) *m_pos++ : EOF;
+    }
+
+    /// Puts back the last char returned by GetChar() (if it was not EOF)
+    void UngetChar()
+    {
+        if( m_pos > m_begin )
+            --m_pos;
+    }
+
+    /**
+     * Function SkipChar
+     * reads the next char if it is \a aChar, like a char in a scanf format.
+     * @return bool - true if the char was read
+     */
+    bool SkipChar( char aChar )
+    {
+        if( m_pos < m_end && *m_pos == aChar )
+        {
+            ++m_pos;
+            return true;
+        }
+
+        return false;
+    }
+
+    /// Skips white space, like a space in a scanf format
+    void SkipSpaces();
+
+    /**
+     * Function ReadInt
+     * reads a decimal integer after white space, like fscanf( "%d" ).
+     * @return bool - true if an integer was read; if not, nothing but white space is read
+     */
+    bool ReadInt( int& aValue );
+
+    /**
+     * Function ReadFloat
+     * reads a decimal number after white space, like fscanf( "%f" ), but always with
+     * '.' as decimal separator.
+     * @return bool - true if a number was read; if not, nothing but white space is read
+     */
+    bool ReadFloat( float& aValue );
+    bool ReadFloat( double& aValue );
+
+    /// @return true if there is nothing but white space until the end of the content
+    bool AtEnd()
+    {
+        SkipSpaces();
+        return m_pos >= m_end;
+    }
+
+private:
+    std::vector<char>   m_buffer;       ///< the content, followed by a 0
+    const char*         m_begin;
+    const char*         m_pos;          ///< the next char to read
+    const char*         m_end;
+};
+
+
 /**
  * Function GetEpoxyThicknessBIU
  * skip a VRML block and eventualy internal blocks until it find the close char
- * @param File file to read from
+ * @param File reader of the file to read from
  * @param closeChar the expected close char of the block
  * @return int - -1 if failed, 0 if OK
  */
-int Read_NotImplemented( FILE* File, char closeChar);
+int Read_NotImplemented( VRML_READER* File, char closeChar);
 
 
 /**
  * Function ParseVertexList
  * parse a vertex list
- * @param File file to read from
+ * @param File reader of the file to read from
  * @param dst_vector destination vector list
  * @return int - -1 if failed, 0 if OK
  */
-int ParseVertexList( FILE* File, std::vector< glm::vec3 > &dst_vector);
+int ParseVertexList( VRML_READER* File, std::vector< glm::vec3 > &dst_vector);
 
 
 /**
  * Function ParseVertex
  * parse a vertex
- * @param File file to read from
+ * @param File reader of the file to read from
  * @param dst_vertex destination vector
  * @return bool - return true if the 3 elements are read
  */
-bool ParseVertex( FILE* File, glm::vec3 &dst_vertex );
+bool ParseVertex( VRML_READER* File, glm::vec3 &dst_vertex );
 
 
 /**
  * Function ParseFloat
  * parse a float value
- * @param aFile file to read from
+ * @param aFile reader of the file to read from
  * @param aDstFloat destination float
  * @param aDefaultValue = the default value, when the actual value cannot be read
  * @return bool - Return true if the float was read without error
  */
-bool ParseFloat( FILE* aFile, float *aDstFloat, float aDefaultValue );
+bool ParseFloat( VRML_READER* aFile, float *aDstFloat, float aDefaultValue );
 
 /**
  * Function GetNextTag
  * parse the next tag
- * @param File file to read from
+ * @param File reader of the file to read from
  * @param tag destination pointer
  * @param len max length of storage
  * @return bool - true if succeeded, false if EOF
  */
-bool GetNextTag( FILE* File, char* tag, size_t len );
+bool GetNextTag( VRML_READER* File, char* tag, size_t len );
 
 /**
  * Function GetString
  * parse a string, it expects starting by " and end with "
- * @param File file to read from
+ * @param File reader of the file to read from
  * @param aDstString destination pointer
  * @param maxDstLen max length of storage
  * @return bool - true if successful read the string, false if failed to get a string
  */
-bool GetString( FILE* File, char* aDstString, size_t maxDstLen );
+bool GetString( VRML_READER* File, char* aDstString, size_t maxDstLen );
 
 #endif
@@ -39,6 +39,7 @@
 #include <3d_struct.h>
 #include <modelparsers.h>
 #include <xnode.h>
+#include <vrml_aux.h>
 
 /**
  * Trace mask used to enable or disable the trace output of the X3D parser code.
@@ -436,21 +437,20 @@ void X3D_MODEL_PARSER::readIndexedFaceSet( wxXmlNode* aFaceNode,
     GetNodeProperties( coordinates[0], coordinate_properties );
 
     // Save points to vector as doubles
-    wxStringTokenizer point_tokens( coordinate_properties[ wxT( "point" ) ] );
+    VRML_READER point_reader;
     double point = 0.0;
 
-    while( point_tokens.HasMoreTokens() )
+    point_reader.SetText( coordinate_properties[ wxT( "point" ) ] );
+
+    while( point_reader.ReadFloat( point ) )
     {
-        if( point_tokens.GetNextToken().ToDouble( &point ) )
-        {
-            points.push_back( point );
-        }
-        else
-        {
-            wxLogTrace( traceX3DParser, wxT( "Error converting to double" ) );
-        }
+        points.push_back( point );
+        point_reader.SkipChar( ',' );
     }
 
+    if( !point_reader.AtEnd() )
+        wxLogTrace( traceX3DParser, wxT( "Error converting to double" ) );
+
     if( points.size() % 3 != 0 )
     {
         // DBG( printf( "Number of points is incorrect" ) );
@@ -460,8 +460,7 @@ void X3D_MODEL_PARSER::readIndexedFaceSet( wxXmlNode* aFaceNode,
     /* Create 3D vertex from 3 points and
      * apply transforms in order of SCALE, ROTATION, TRANSLATION
      */
-    wxString vrml_pointlist;
-    std::vector<S3D_VERTEX> triplets;
+    m_model->m_Point.reserve( m_model->m_Point.size() + points.size() / 3 );
 
     for( unsigned id = 0; id < points.size() / 3; id++ )
     {
@@ -481,13 +480,8 @@ void X3D_MODEL_PARSER::readIndexedFaceSet( wxXmlNode* aFaceNode,
         point.z += translation.z;
 
         m_model->m_Point.push_back( point );
-
-        // VRML
-        vrml_pointlist.Append( wxString::Format( wxT( "%f %f %f\n" ), point.x, point.y, point.z ) );
     }
 
-    vrml_points.push_back( vrml_pointlist );
-
 
     /* Step 3: Read all color points
      * ---------------------------- */
@@ -503,21 +497,20 @@ void X3D_MODEL_PARSER::readIndexedFaceSet( wxXmlNode* aFaceNode,
         GetNodeProperties( color[0], color_properties );
 
         // Save points to vector as doubles
-        wxStringTokenizer colorpoint_tokens( color_properties[ wxT( "color" ) ] );
+        VRML_READER colorpoint_reader;
         double color_point = 0.0;
 
-        while( colorpoint_tokens.HasMoreTokens() )
+        colorpoint_reader.SetText( color_properties[ wxT( "color" ) ] );
+
+        while( colorpoint_reader.ReadFloat( color_point ) )
         {
-            if( colorpoint_tokens.GetNextToken().ToDouble( &color_point ) )
-            {
-                color_points.push_back( color_point );
-            }
-            else
-            {
-                wxLogTrace( traceX3DParser, wxT( "Error converting to double" ) );
-            }
+            color_points.push_back( color_point );
+            colorpoint_reader.SkipChar( ',' );
         }
 
+        if( !colorpoint_reader.AtEnd() )
+            wxLogTrace( traceX3DParser, wxT( "Error converting to double" ) );
+
         if( color_points.size() % 3 != 0 )
         {
             // DBG( printf( "Number of points is incorrect" ) );
@@ -546,19 +539,18 @@ void X3D_MODEL_PARSER::readIndexedFaceSet( wxXmlNode* aFaceNode,
     PROPERTY_MAP faceset_properties;
     GetNodeProperties( aFaceNode, faceset_properties );
 
-    wxString coordIndex_str = faceset_properties[ wxT( "coordIndex" ) ];
-    wxStringTokenizer index_tokens( coordIndex_str );
+    VRML_READER index_reader;
 
-    wxString vrml_coord_indx_list;
+    index_reader.SetText( faceset_properties[ wxT( "coordIndex" ) ] );
 
     std::vector<int> coord_list;
     coord_list.clear();
 
-    while( index_tokens.HasMoreTokens() )
-    {
-        long index = 0;
+    int index = 0;
 
-        index_tokens.GetNextToken().ToLong( &index );
+    while( index_reader.ReadInt( index ) )
+    {
+        index_reader.SkipChar( ',' );
 
         // -1 marks the end of polygon
         if( index < 0 )
@@ -568,14 +560,10 @@ void X3D_MODEL_PARSER::readIndexedFaceSet( wxXmlNode* aFaceNode,
             m_model->m_CoordIndex.push_back( coord_list );
 
             coord_list.clear();
-            vrml_coord_indx_list.Append( wxT( "-1\n" ) );
         }
         else
         {
             coord_list.push_back( index );
-            vrml_coord_indx_list.Append( wxString::Format( wxT( "%ld " ), index ) );
         }
     }
-
-    vrml_coord_indexes.push_back( vrml_coord_indx_list );
 }
@@ -150,6 +150,8 @@ set( sourceFileHeader
  * your DSN lexer.
  */
 
+#include <cstring>
+
 #include <${result}_lexer.h>
 
 using namespace ${enum};
@@ -240,6 +242,9 @@ class ${LEXERCLASS} : public DSNLEXER
     static const KEYWORD  keywords[];
     static const unsigned keyword_count;
 
+    /// Auto generated keyword lookup, a switch on the length and the first character
+    static int findKeyword( const char* aText, unsigned aLength );
+
 public:
     /**
      * Constructor ( const std::string&, const wxString& )
@@ -248,7 +253,7 @@ public:
      *   If left empty, then _(\"clipboard\") is used.
      */
     ${LEXERCLASS}( const std::string& aSExpression, const wxString& aSource = wxEmptyString ) :
-        DSNLEXER( keywords, keyword_count, aSExpression, aSource )
+        DSNLEXER( keywords, keyword_count, aSExpression, aSource, findKeyword )
     {
     }
 
@@ -262,7 +267,7 @@ public:
      * @param aFilename is the name of the opened file, needed for error reporting.
      */
     ${LEXERCLASS}( FILE* aFile, const wxString& aFilename ) :
-        DSNLEXER( keywords, keyword_count, aFile, aFilename )
+        DSNLEXER( keywords, keyword_count, aFile, aFilename, findKeyword )
     {
     }
 
@@ -278,7 +283,7 @@ public:
      *  STRING_LINE_READER or FILE_LINE_READER.  No ownership is taken of aLineReader.
      */
     ${LEXERCLASS}( LINE_READER* aLineReader ) :
-        DSNLEXER( keywords, keyword_count, aLineReader )
+        DSNLEXER( keywords, keyword_count, aLineReader, findKeyword )
     {
     }
 
@@ -385,3 +390,90 @@ const char* ${LEXERCLASS}::TokenName( T aTok )
 }
 "
 )
+
+
+# Generate the keyword lookup: a switch on the token length, then on its first
+# character, so a token is compared to at most a few keywords and no hashing is
+# needed.  Build a list of "length:first character:token" entries sorted by
+# length and first character, then emit one case per group.
+
+set( keywordEntries "" )
+
+foreach( token ${tokens} )
+    string( LENGTH "${token}" tokenLength )
+    string( SUBSTRING "${token}" 0 1 firstChar )
+
+    # zero pad the length so the lexicographic sort is also a numeric one
+    if( tokenLength LESS 10 )
+        set( tokenLength "00${tokenLength}" )
+    elseif( tokenLength LESS 100 )
+        set( tokenLength "0${tokenLength}" )
+    endif()
+
+    list( APPEND keywordEntries "${tokenLength}:${firstChar}:${token}" )
+endforeach()
+
+list( SORT keywordEntries )
+
+file( APPEND "${outCppFile}"
+"
+
+int ${LEXERCLASS}::findKeyword( const char* aText, unsigned aLength )
+{
+    switch( aLength )
+    {
+"
+)
+
+set( curLength "" )
+set( curChar "" )
+
+foreach( entry ${keywordEntries} )
+    string( REGEX REPLACE "^([0-9]+):.*$" "\\1" entryLength "${entry}" )
+    string( REGEX REPLACE "^[0-9]+:(.):.*$" "\\1" entryChar "${entry}" )
+    string( REGEX REPLACE "^[0-9]+:.:(.*)$" "\\1" token "${entry}" )
+
+    if( NOT entryLength STREQUAL curLength )
+        if( NOT curLength STREQUAL "" )
+            file( APPEND "${outCppFile}" "            break;\n        }\n        break;\n\n" )
+        endif()
+
+        math( EXPR tokenLength "${entryLength}" )
+        file( APPEND "${outCppFile}" "    case ${tokenLength}:\n        switch( aText[0] )\n        {\n" )
+
+        set( curLength "${entryLength}" )
+        set( curChar "" )
+    endif()
+
+    if( NOT entryChar STREQUAL curChar )
+        if( NOT curChar STREQUAL "" )
+            file( APPEND "${outCppFile}" "            break;\n" )
+        endif()
+
+        file( APPEND "${outCppFile}" "        case '${entryChar}':\n" )
+        set( curChar "${entryChar}" )
+    endif()
+
+    # the first character is already known to match
+    if( tokenLength EQUAL 1 )
+        file( APPEND "${outCppFile}" "            return T_${token};\n" )
+    else()
+        math( EXPR restLength "${tokenLength} - 1" )
+        string( SUBSTRING "${token}" 1 -1 rest )
+        file( APPEND "${outCppFile}"
+            "            if( !memcmp( aText + 1, \"${rest}\", ${restLength} ) )\n"
+            "                return T_${token};\n" )
+    endif()
+endforeach()
+
+if( NOT curLength STREQUAL "" )
+    file( APPEND "${outCppFile}" "            break;\n        }\n        break;\n" )
+endif()
+
+file( APPEND "${outCppFile}"
+"    }
+
+    return T_SYMBOL;        // not a keyword, some arbitrary symbol.
+}
+"
+)
@@ -0,0 +1,209 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2015 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file background_file_writer.cpp
+ */
+
+#include <stdio.h>
+#include <wx/filefn.h>
+#include <wx/intl.h>
+
+#include <macros.h>
+#include <richio.h>
+#include <background_file_writer.h>
+
+
+BACKGROUND_FILE_WRITER::BACKGROUND_FILE_WRITER( wxEvtHandler* aHandler, int aId ) :
+    m_handler( aHandler ),
+    m_id( aId ),
+    m_thread( NULL ),
+    m_busy( false ),
+    m_snapshot( NULL ),
+    m_status( WRITE_OK )
+{
+}
+
+
+BACKGROUND_FILE_WRITER::~BACKGROUND_FILE_WRITER()
+{
+    Wait();
+}
+
+
+bool BACKGROUND_FILE_WRITER::IsBusy()
+{
+    boost::mutex::scoped_lock lock( m_lock );
+
+    return m_busy;
+}
+
+
+bool BACKGROUND_FILE_WRITER::Start( SNAPSHOT* aSnapshot, const wxString& aFileName )
+{
+    if( IsBusy() )
+    {
+        delete aSnapshot;
+        return false;
+    }
+
+    // The previous thread is finished, release it
+    if( m_thread )
+    {
+        m_thread->join();
+        delete m_thread;
+        m_thread = NULL;
+    }
+
+    delete m_snapshot;
+    m_snapshot = aSnapshot;
+    m_formatError.clear();
+    m_fileName = TO_UTF8( aFileName );
+    m_tempFileName = m_fileName + ".tmp";
+    m_status = WRITE_OK;
+    m_busy = true;
+
+    m_thread = new boost::thread( &BACKGROUND_FILE_WRITER::run, this );
+
+    return true;
+}
+
+
+wxString BACKGROUND_FILE_WRITER::Wait()
+{
+    if( m_thread )
+    {
+        m_thread->join();
+        delete m_thread;
+        m_thread = NULL;
+    }
+
+    // The snapshot may hold items which must be destroyed in the main thread
+    delete m_snapshot;
+    m_snapshot = NULL;
+
+    // Messages are built here, in the main thread
+    wxString msg;
+
+    switch( m_status )
+    {
+    case FORMAT_FAILED:
+        msg.Printf( _( "Error saving file '%s'.\n%s" ),
+                    GetChars( FROM_UTF8( m_fileName.c_str() ) ),
+                    GetChars( FROM_UTF8( m_formatError.c_str() ) ) );
+        break;
+
+    case OPEN_FAILED:
+        msg.Printf( _( "Unable to create file '%s'" ),
+                    GetChars( FROM_UTF8( m_tempFileName.c_str() ) ) );
+        break;
+
+    case WRITE_FAILED:
+        msg.Printf( _( "Unable to write file '%s'" ),
+                    GetChars( FROM_UTF8( m_tempFileName.c_str() ) ) );
+        break;
+
+    case RENAME_FAILED:
+        msg.Printf( _( "Unable to rename file '%s' to '%s'" ),
+                    GetChars( FROM_UTF8( m_tempFileName.c_str() ) ),
+                    GetChars( FROM_UTF8( m_fileName.c_str() ) ) );
+        break;
+
+    default:
+        break;
+    }
+
+    m_status = WRITE_OK;
+    m_formatError.clear();
+
+    return msg;
+}
+
+
+void BACKGROUND_FILE_WRITER::run()
+{
+    // No wxLog and no translations here: they are not thread safe.
+    // Local wxStrings are built from the UTF8 names, they are not shared.
+    wxString    tempFileName = FROM_UTF8( m_tempFileName.c_str() );
+    wxString    fileName = FROM_UTF8( m_fileName.c_str() );
+    STATUS      status = WRITE_OK;
+    std::string content;
+
+    // The document is formatted in memory, so a formatting error leaves no file behind
+    try
+    {
+        STRING_FORMATTER formatter;
+
+        m_snapshot->Format( &formatter );
+        formatter.SwapString( content );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        status = FORMAT_FAILED;
+        m_formatError = TO_UTF8( ioe.errorText );
+    }
+    catch( const std::exception& e )
+    {
+        status = FORMAT_FAILED;
+        m_formatError = e.what();
+    }
+
+    if( status == WRITE_OK )
+    {
+        FILE* fp = wxFopen( tempFileName, wxT( "wt" ) );
+
+        if( !fp )
+        {
+            status = OPEN_FAILED;
+        }
+        else
+        {
+            size_t written = fwrite( content.data(), 1, content.size(), fp );
+
+            if( fclose( fp ) != 0 || written != content.size() )
+            {
+                status = WRITE_FAILED;
+                wxRemoveFile( tempFileName );
+            }
+            else if( !wxRenameFile( tempFileName, fileName, true ) )
+            {
+                status = RENAME_FAILED;
+                wxRemoveFile( tempFileName );
+            }
+        }
+    }
+
+    // Release the memory now, the formatted text can be big
+    std::string().swap( content );
+
+    {
+        boost::mutex::scoped_lock lock( m_lock );
+
+        m_status = status;
+        m_busy = false;
+    }
+
+    // QueueEvent() is thread safe, the event is processed in the main thread
+    if( m_handler )
+        m_handler->QueueEvent( new wxThreadEvent( wxEVT_THREAD, m_id ) );
+}
@@ -43,6 +43,7 @@ BASE_SCREEN::BASE_SCREEN( KICAD_T aType ) :
     EDA_ITEM( aType )
 {
     m_UndoRedoCountMax = 10;     // undo/Redo command Max depth, 10 is a reasonable value
+    m_UndoRedoMemoryMax = 0;     // no memory budget, screens which can estimate it set one
     m_FirstRedraw      = true;
     m_ScreenNumber     = 1;
     m_NumberOfScreens  = 1;      // Hierarchy: Root: ScreenNumber = 1
@@ -411,27 +412,44 @@ void BASE_SCREEN::ClearUndoRedoList()
 }
 
 
-void BASE_SCREEN::PushCommandToUndoList( PICKED_ITEMS_LIST* aNewitem )
+void BASE_SCREEN::trimUndoORRedoList( UNDO_REDO_CONTAINER& aList )
 {
-    m_UndoList.PushCommand( aNewitem );
-
     // Delete the extra items, if count max reached
-    int extraitems = GetUndoCommandCount() - m_UndoRedoCountMax;
+    int extraitems = (int) aList.m_CommandsList.size() - (int) m_UndoRedoCountMax;
 
     if( extraitems > 0 ) // Delete the extra items
-        ClearUndoORRedoList( m_UndoList, extraitems );
+        ClearUndoORRedoList( aList, extraitems );
+
+    if( m_UndoRedoMemoryMax == 0 )
+        return;
+
+    // Delete the oldest items until the list fits in its memory budget,
+    // but never the most recent one
+    size_t memsize = aList.GetMemorySize();
+    int    lastitem = (int) aList.m_CommandsList.size() - 1;
+    int    count = 0;
+
+    while( count < lastitem && memsize > m_UndoRedoMemoryMax )
+        memsize -= aList.m_CommandsList[count++]->m_MemorySize;
+
+    if( count > 0 )
+        ClearUndoORRedoList( aList, count );
 }
 
 
-void BASE_SCREEN::PushCommandToRedoList( PICKED_ITEMS_LIST* aNewitem )
+void BASE_SCREEN::PushCommandToUndoList( PICKED_ITEMS_LIST* aNewitem )
 {
-    m_RedoList.PushCommand( aNewitem );
+    aNewitem->m_MemorySize = GetCommandMemorySize( *aNewitem );
+    m_UndoList.PushCommand( aNewitem );
+    trimUndoORRedoList( m_UndoList );
+}
 
-    // Delete the extra items, if count max reached
-    int extraitems = GetRedoCommandCount() - m_UndoRedoCountMax;
 
-    if( extraitems > 0 ) // Delete the extra items
-        ClearUndoORRedoList( m_RedoList, extraitems );
+void BASE_SCREEN::PushCommandToRedoList( PICKED_ITEMS_LIST* aNewitem )
+{
+    aNewitem->m_MemorySize = GetCommandMemorySize( *aNewitem );
+    m_RedoList.PushCommand( aNewitem );
+    trimUndoORRedoList( m_RedoList );
 }
 
 
@@ -43,6 +43,7 @@ ITEM_PICKER::ITEM_PICKER( EDA_ITEM* aItem, UNDO_REDO_T aUndoRedoStatus )
 PICKED_ITEMS_LIST::PICKED_ITEMS_LIST()
 {
     m_Status = UR_UNSPECIFIED;
+    m_MemorySize = 0;
 }
 
 PICKED_ITEMS_LIST::~PICKED_ITEMS_LIST()
@@ -198,6 +199,30 @@ EDA_ITEM* PICKED_ITEMS_LIST::GetPickedItemLink( unsigned int aIdx ) const
 }
 
 
+EDA_ITEM* PICKED_ITEMS_LIST::GetPickedItemOwnedData( unsigned int aIdx ) const
+{
+    if( aIdx >= m_ItemsList.size() )
+        return NULL;
+
+    // Must match the items deleted by ClearListAndDeleteItems()
+    switch( m_ItemsList[aIdx].GetStatus() )
+    {
+    case UR_CHANGED:
+    case UR_EXCHANGE_T:
+        return m_ItemsList[aIdx].GetLink();
+
+    case UR_WIRE_IMAGE:     // head of the owned list of wires
+    case UR_DELETED:
+    case UR_LIBEDIT:
+    case UR_MODEDIT:
+        return m_ItemsList[aIdx].GetItem();
+
+    default:
+        return NULL;
+    }
+}
+
+
 UNDO_REDO_T PICKED_ITEMS_LIST::GetPickedItemStatus( unsigned int aIdx ) const
 {
     if( aIdx < m_ItemsList.size() )
@@ -347,3 +372,14 @@ PICKED_ITEMS_LIST* UNDO_REDO_CONTAINER::PopCommand()
 }
 
 
+size_t UNDO_REDO_CONTAINER::GetMemorySize() const
+{
+    size_t size = 0;
+
+    for( unsigned ii = 0; ii < m_CommandsList.size(); ii++ )
+        size += m_CommandsList[ii]->m_MemorySize;
+
+    return size;
+}
+
+
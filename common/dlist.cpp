@@ -53,6 +53,7 @@ void DHEAD::DeleteAll()
     first = 0;
     last  = 0;
     count = 0;
+    ++revision;
 }
 
 
@@ -82,6 +83,7 @@ void DHEAD::append( EDA_ITEM* aNewElement )
     aNewElement->SetList( this );
 
     ++count;
+    ++revision;
 }
 
 
@@ -108,6 +110,8 @@ void DHEAD::append( DHEAD& aList )
         }
 
         count += aList.count;
+        ++revision;
+        ++aList.revision;
 
         aList.count = 0;
         aList.first = NULL;
@@ -153,6 +157,7 @@ void DHEAD::insert( EDA_ITEM* aNewElement, EDA_ITEM* aAfterMe )
         aNewElement->SetList( this );
 
         ++count;
+        ++revision;
     }
 }
 
@@ -187,6 +192,7 @@ void DHEAD::remove( EDA_ITEM* aElement )
     aElement->SetList( 0 );
 
     --count;
+    ++revision;
 }
 
 #if defined(DEBUG)
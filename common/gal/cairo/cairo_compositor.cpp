@@ -136,6 +136,9 @@ void CAIRO_COMPOSITOR::DrawBuffer( unsigned int aBufferHandle )
     cairo_get_matrix( m_mainContext, &m_matrix );
     cairo_identity_matrix( m_mainContext );
 
+    // Buffers may have been modified directly by tile contexts
+    cairo_surface_mark_dirty( m_buffers[aBufferHandle - 1].surface );
+
     // Draw the selected buffer contents
     cairo_set_source_surface( m_mainContext, m_buffers[aBufferHandle - 1].surface, 0.0, 0.0 );
     cairo_paint( m_mainContext );
@@ -145,6 +148,39 @@ void CAIRO_COMPOSITOR::DrawBuffer( unsigned int aBufferHandle )
 }
 
 
+cairo_t* CAIRO_COMPOSITOR::CreateTileContext( unsigned int aBufferHandle, int aX, int aY,
+                                              int aWidth, int aHeight ) const
+{
+    wxASSERT_MSG( aBufferHandle <= m_buffers.size(), wxT( "Tried to use a not existing buffer" ) );
+    wxASSERT( aX >= 0 && aY >= 0 );
+    wxASSERT( aX + aWidth <= (int) m_width && aY + aHeight <= (int) m_height );
+
+    // The tile shares pixel storage with the buffer, so there is nothing to copy afterwards
+    unsigned char* data = (unsigned char*) m_buffers[aBufferHandle - 1].bitmap.get() +
+                          aY * m_stride + aX * 4;
+
+    cairo_surface_t* surface = cairo_image_surface_create_for_data( data, CAIRO_FORMAT_ARGB32,
+                                                                    aWidth, aHeight, m_stride );
+
+    // Make the tile use the buffer device coordinates
+    cairo_surface_set_device_offset( surface, -aX, -aY );
+
+    cairo_t* context = cairo_create( surface );
+    cairo_surface_destroy( surface );   // context keeps the reference
+#ifdef __WXDEBUG__
+    cairo_status_t status = cairo_status( context );
+    wxASSERT_MSG( status == CAIRO_STATUS_SUCCESS, wxT( "Cairo context creation error" ) );
+#endif /* __WXDEBUG__ */
+
+    // Use the same settings as the buffer
+    cairo_set_antialias( context, CAIRO_ANTIALIAS_SUBPIXEL );
+    cairo_set_line_join( context, CAIRO_LINE_JOIN_ROUND );
+    cairo_set_line_cap( context, CAIRO_LINE_CAP_ROUND );
+
+    return context;
+}
+
+
 void CAIRO_COMPOSITOR::clean()
 {
     CAIRO_BUFFERS::const_iterator it;
@@ -33,6 +33,10 @@
 
 #include <limits>
 
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif /* USE_OPENMP */
+
 using namespace KIGFX;
 
 
@@ -43,16 +47,12 @@ CAIRO_GAL::CAIRO_GAL( wxWindow* aParent, wxEvtHandler* aMouseListener,
         wxEvtHandler* aPaintListener, const wxString& aName ) :
     wxWindow( aParent, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxEXPAND, aName )
 {
+    isOffscreen   = false;
     parentWindow  = aParent;
     mouseListener = aMouseListener;
     paintListener = aPaintListener;
 
-    // Initialize the flags
-    isGrouping          = false;
-    isInitialized       = false;
-    isDeleteSavedPixels = false;
-    validCompositor     = false;
-    groupCounter        = 0;
+    init();
 
     // Connecting the event handlers
     Connect( wxEVT_PAINT,       wxPaintEventHandler( CAIRO_GAL::onPaint ) );
@@ -76,12 +76,26 @@ CAIRO_GAL::CAIRO_GAL( wxWindow* aParent, wxEvtHandler* aMouseListener,
     SetSize( aParent->GetSize() );
     screenSize = VECTOR2I( aParent->GetSize() );
 
-    cursorPixels = NULL;
-    cursorPixelsSaved = NULL;
     initCursor();
 
-    // Grid color settings are different in Cairo and OpenGL
-    SetGridColor( COLOR4D( 0.1, 0.1, 0.1, 0.8 ) );
+    // Allocate memory for pixel storage
+    allocateBitmaps();
+
+    initSurface();
+}
+
+
+CAIRO_GAL::CAIRO_GAL( int aWidth, int aHeight ) :
+    wxWindow()      // two-step creation, Create() is never called so there is no native window
+{
+    isOffscreen   = true;
+    parentWindow  = NULL;
+    mouseListener = NULL;
+    paintListener = NULL;
+
+    init();
+
+    screenSize = VECTOR2I( aWidth, aHeight );
 
     // Allocate memory for pixel storage
     allocateBitmaps();
@@ -90,6 +104,35 @@ CAIRO_GAL::CAIRO_GAL( wxWindow* aParent, wxEvtHandler* aMouseListener,
 }
 
 
+void CAIRO_GAL::init()
+{
+    // Initialize the flags
+    isGrouping          = false;
+    isInitialized       = false;
+    isDeleteSavedPixels = false;
+    validCompositor     = false;
+    groupCounter        = 0;
+    currentGroup        = NULL;
+    currentGroupNumber  = -1;
+    isRecordingFrame    = false;
+
+    cairo_matrix_init_identity( &groupMatrix );
+
+#ifdef USE_OPENMP
+    // Tiles are worth the recording overhead only if they can be drawn in parallel
+    isTiledRendering    = omp_get_max_threads() > 1;
+#else
+    isTiledRendering    = false;
+#endif /* USE_OPENMP */
+
+    cursorPixels = NULL;
+    cursorPixelsSaved = NULL;
+
+    // Grid color settings are different in Cairo and OpenGL
+    SetGridColor( COLOR4D( 0.1, 0.1, 0.1, 0.8 ) );
+}
+
+
 CAIRO_GAL::~CAIRO_GAL()
 {
     deinitSurface();
@@ -112,8 +155,34 @@ void CAIRO_GAL::BeginDrawing()
     compositor->SetMainContext( context );
     compositor->SetBuffer( mainBuffer );
 
-    // Cairo grouping prevents display of overlapping items on the same layer in the lighter color
-    cairo_push_group( currentContext );
+    if( isTiledRendering )
+    {
+        storePath();
+
+        // From now on drawing commands are recorded and replayed on tiles in EndDrawing()
+        isRecordingFrame    = true;
+        isGrouping          = true;
+        currentGroup        = &frameCommands;
+        currentGroupNumber  = -1;
+        cairo_matrix_init_identity( &groupMatrix );
+        groupMatrixStack.clear();
+
+        // Save the state that is valid at the beginning of the recorded commands
+        frameState.isFillEnabled    = isFillEnabled;
+        frameState.isStrokeEnabled  = isStrokeEnabled;
+        frameState.fillColor        = fillColor;
+        frameState.strokeColor      = strokeColor;
+
+        GROUP_ELEMENT groupElement;
+        groupElement.command = CMD_SET_TARGET;
+        groupElement.intArgument = mainBuffer;
+        frameCommands.push_back( groupElement );
+    }
+    else
+    {
+        // Cairo grouping prevents display of overlapping items on the same layer in the lighter color
+        cairo_push_group( currentContext );
+    }
 }
 
 
@@ -122,14 +191,32 @@ void CAIRO_GAL::EndDrawing()
     // Force remaining objects to be drawn
     Flush();
 
-    // Cairo grouping prevents display of overlapping items on the same layer in the lighter color
-    cairo_pop_group_to_source( currentContext );
-    cairo_paint_with_alpha( currentContext, LAYER_ALPHA );
+    if( isRecordingFrame )
+    {
+        isRecordingFrame    = false;
+        isGrouping          = false;
+        currentGroup        = NULL;
+
+        drawFrameTiles();
+    }
+    else
+    {
+        // Cairo grouping prevents display of overlapping items on the same layer in the lighter color
+        cairo_pop_group_to_source( currentContext );
+        cairo_paint_with_alpha( currentContext, LAYER_ALPHA );
+    }
 
     // Merge buffers on the screen
     compositor->DrawBuffer( mainBuffer );
     compositor->DrawBuffer( overlayBuffer );
 
+    // The image stays in bitmapBuffer when there is no window to show it
+    if( isOffscreen )
+    {
+        deinitSurface();
+        return;
+    }
+
     // This code was taken from the wxCairo example - it's not the most efficient one
     // Here is a good place for optimizations
 
@@ -314,12 +401,16 @@ void CAIRO_GAL::ResizeScreen( int aWidth, int aHeight )
 
     validCompositor = false;
 
-    SetSize( wxSize( aWidth, aHeight ) );
+    if( !isOffscreen )
+        SetSize( wxSize( aWidth, aHeight ) );
 }
 
 
 bool CAIRO_GAL::Show( bool aShow )
 {
+    if( isOffscreen )
+        return false;
+
     bool s = wxWindow::Show( aShow );
 
     if( aShow )
@@ -338,6 +429,12 @@ void CAIRO_GAL::Flush()
 void CAIRO_GAL::ClearScreen( const COLOR4D& aColor )
 {
     backgroundColor = aColor;
+
+    // Buffers are cleared by ClearTarget() and the main surface gets the background color
+    // in initSurface(), so there is nothing to be recorded
+    if( isRecordingFrame )
+        return;
+
     cairo_set_source_rgb( currentContext, aColor.r, aColor.g, aColor.b );
     cairo_rectangle( currentContext, 0.0, 0.0, screenSize.x, screenSize.y );
     cairo_fill( currentContext );
@@ -438,7 +535,15 @@ void CAIRO_GAL::SetLayerDepth( double aLayerDepth )
 {
     super::SetLayerDepth( aLayerDepth );
 
-    if( isInitialized )
+    if( isRecordingFrame )
+    {
+        storePath();
+
+        GROUP_ELEMENT groupElement;
+        groupElement.command = CMD_SET_LAYER;
+        frameCommands.push_back( groupElement );
+    }
+    else if( isInitialized )
     {
         storePath();
 
@@ -462,7 +567,26 @@ void CAIRO_GAL::Transform( const MATRIX3x3D& aTransformation )
                        aTransformation.m_data[0][2],
                        aTransformation.m_data[1][2] );
 
-    cairo_transform( currentContext, &cairoTransformation );
+    if( isGrouping )
+    {
+        storePath();
+
+        GROUP_ELEMENT groupElement;
+        groupElement.command = CMD_TRANSFORM;
+        groupElement.arguments[0] = cairoTransformation.xx;
+        groupElement.arguments[1] = cairoTransformation.yx;
+        groupElement.arguments[2] = cairoTransformation.xy;
+        groupElement.arguments[3] = cairoTransformation.yy;
+        groupElement.arguments[4] = cairoTransformation.x0;
+        groupElement.arguments[5] = cairoTransformation.y0;
+        currentGroup->push_back( groupElement );
+
+        recordTransform( cairoTransformation );
+    }
+    else
+    {
+        cairo_transform( currentContext, &cairoTransformation );
+    }
 }
 
 
@@ -476,6 +600,10 @@ void CAIRO_GAL::Rotate( double aAngle )
         groupElement.command = CMD_ROTATE;
         groupElement.arguments[0] = aAngle;
         currentGroup->push_back( groupElement );
+
+        cairo_matrix_t matrix;
+        cairo_matrix_init_rotate( &matrix, aAngle );
+        recordTransform( matrix );
     }
     else
     {
@@ -495,6 +623,10 @@ void CAIRO_GAL::Translate( const VECTOR2D& aTranslation )
         groupElement.arguments[0] = aTranslation.x;
         groupElement.arguments[1] = aTranslation.y;
         currentGroup->push_back( groupElement );
+
+        cairo_matrix_t matrix;
+        cairo_matrix_init_translate( &matrix, aTranslation.x, aTranslation.y );
+        recordTransform( matrix );
     }
     else
     {
@@ -514,6 +646,10 @@ void CAIRO_GAL::Scale( const VECTOR2D& aScale )
         groupElement.arguments[0] = aScale.x;
         groupElement.arguments[1] = aScale.y;
         currentGroup->push_back( groupElement );
+
+        cairo_matrix_t matrix;
+        cairo_matrix_init_scale( &matrix, aScale.x, aScale.y );
+        recordTransform( matrix );
     }
     else
     {
@@ -531,6 +667,8 @@ void CAIRO_GAL::Save()
         GROUP_ELEMENT groupElement;
         groupElement.command = CMD_SAVE;
         currentGroup->push_back( groupElement );
+
+        groupMatrixStack.push_back( groupMatrix );
     }
     else
     {
@@ -548,6 +686,12 @@ void CAIRO_GAL::Restore()
         GROUP_ELEMENT groupElement;
         groupElement.command = CMD_RESTORE;
         currentGroup->push_back( groupElement );
+
+        if( !groupMatrixStack.empty() )
+        {
+            groupMatrix = groupMatrixStack.back();
+            groupMatrixStack.pop_back();
+        }
     }
     else
     {
@@ -567,8 +711,12 @@ int CAIRO_GAL::BeginGroup()
     GROUP group;
     int groupNumber = getNewGroupNumber();
     groups.insert( std::make_pair( groupNumber, group ) );
-    currentGroup = &groups[groupNumber];
-    isGrouping   = true;
+    currentGroup       = &groups[groupNumber];
+    currentGroupNumber = groupNumber;
+    isGrouping         = true;
+
+    cairo_matrix_init_identity( &groupMatrix );
+    groupMatrixStack.clear();
 
     return groupNumber;
 }
@@ -577,100 +725,272 @@ int CAIRO_GAL::BeginGroup()
 void CAIRO_GAL::EndGroup()
 {
     storePath();
+
+    cairo_matrix_init_identity( &groupMatrix );
+    groupMatrixStack.clear();
+
+    if( isRecordingFrame )
+    {
+        // Get back to recording the frame
+        currentGroup       = &frameCommands;
+        currentGroupNumber = -1;
+        return;
+    }
+
     isGrouping = false;
+    currentGroupNumber = -1;
 
     deinitSurface();
 }
 
 
 void CAIRO_GAL::DrawGroup( int aGroupNumber )
+{
+    storePath();
+
+    if( isRecordingFrame && currentGroup == &frameCommands )
+    {
+        // The group is going to be drawn on tiles in EndDrawing()
+        GROUP_ELEMENT groupElement;
+        groupElement.command = CMD_CALL_GROUP;
+        groupElement.intArgument = aGroupNumber;
+        frameCommands.push_back( groupElement );
+        return;
+    }
+
+    std::map<int, GROUP>::const_iterator group = groups.find( aGroupNumber );
+
+    if( group == groups.end() )
+        return;
+
+    REPLAY_STATE state;
+    state.context           = currentContext;
+    state.isFillEnabled     = isFillEnabled;
+    state.isStrokeEnabled   = isStrokeEnabled;
+    state.fillColor         = fillColor;
+    state.strokeColor       = strokeColor;
+    state.isTransformed     = false;
+    state.clip              = NULL;
+
+    replayGroup( group->second, state );
+
+    // Group commands change the current drawing settings
+    isFillEnabled   = state.isFillEnabled;
+    isStrokeEnabled = state.isStrokeEnabled;
+    fillColor       = state.fillColor;
+    strokeColor     = state.strokeColor;
+}
+
+
+void CAIRO_GAL::replayGroup( const GROUP& aGroup, REPLAY_STATE& aState ) const
 {
     // This method implements a small Virtual Machine - all stored commands
     // are executed; nested calling is also possible
+    cairo_t* ctx = aState.context;
 
-    storePath();
-
-    for( GROUP::iterator it = groups[aGroupNumber].begin();
-         it != groups[aGroupNumber].end(); ++it )
+    for( GROUP::const_iterator it = aGroup.begin(); it != aGroup.end(); ++it )
     {
         switch( it->command )
         {
         case CMD_SET_FILL:
-            isFillEnabled = it->boolArgument;
+            aState.isFillEnabled = it->boolArgument;
             break;
 
         case CMD_SET_STROKE:
-            isStrokeEnabled = it->boolArgument;
+            aState.isStrokeEnabled = it->boolArgument;
             break;
 
         case CMD_SET_FILLCOLOR:
-            fillColor = COLOR4D( it->arguments[0], it->arguments[1], it->arguments[2],
-                                 it->arguments[3] );
+            aState.fillColor = COLOR4D( it->arguments[0], it->arguments[1], it->arguments[2],
+                                        it->arguments[3] );
             break;
 
         case CMD_SET_STROKECOLOR:
-            strokeColor = COLOR4D( it->arguments[0], it->arguments[1], it->arguments[2],
-                                   it->arguments[3] );
+            aState.strokeColor = COLOR4D( it->arguments[0], it->arguments[1], it->arguments[2],
+                                          it->arguments[3] );
             break;
 
         case CMD_SET_LINE_WIDTH:
             {
                 // Make lines appear at least 1 pixel wide, no matter of zoom
                 double x = 1.0, y = 1.0;
-                cairo_device_to_user_distance( currentContext, &x, &y );
+                cairo_device_to_user_distance( ctx, &x, &y );
                 double minWidth = std::min( fabs( x ), fabs( y ) );
-                cairo_set_line_width( currentContext, std::max( it->arguments[0], minWidth ) );
+                cairo_set_line_width( ctx, std::max( it->arguments[0], minWidth ) );
             }
             break;
 
 
         case CMD_STROKE_PATH:
-            cairo_set_source_rgb( currentContext, strokeColor.r, strokeColor.g, strokeColor.b );
-            cairo_append_path( currentContext, it->cairoPath );
-            cairo_stroke( currentContext );
+            cairo_set_source_rgb( ctx, aState.strokeColor.r, aState.strokeColor.g,
+                                  aState.strokeColor.b );
+            cairo_append_path( ctx, it->cairoPath );
+            cairo_stroke( ctx );
             break;
 
         case CMD_FILL_PATH:
-            cairo_set_source_rgb( currentContext, fillColor.r, fillColor.g, fillColor.b );
-            cairo_append_path( currentContext, it->cairoPath );
-            cairo_fill( currentContext );
+            cairo_set_source_rgb( ctx, aState.fillColor.r, aState.fillColor.g,
+                                  aState.fillColor.b );
+            cairo_append_path( ctx, it->cairoPath );
+            cairo_fill( ctx );
             break;
 
         case CMD_TRANSFORM:
             cairo_matrix_t matrix;
             cairo_matrix_init( &matrix, it->arguments[0], it->arguments[1], it->arguments[2],
                                it->arguments[3], it->arguments[4], it->arguments[5] );
-            cairo_transform( currentContext, &matrix );
+            cairo_transform( ctx, &matrix );
+            aState.isTransformed = true;
             break;
 
         case CMD_ROTATE:
-            cairo_rotate( currentContext, it->arguments[0] );
+            cairo_rotate( ctx, it->arguments[0] );
+            aState.isTransformed = true;
             break;
 
         case CMD_TRANSLATE:
-            cairo_translate( currentContext, it->arguments[0], it->arguments[1] );
+            cairo_translate( ctx, it->arguments[0], it->arguments[1] );
+            aState.isTransformed = true;
             break;
 
         case CMD_SCALE:
-            cairo_scale( currentContext, it->arguments[0], it->arguments[1] );
+            cairo_scale( ctx, it->arguments[0], it->arguments[1] );
+            aState.isTransformed = true;
             break;
 
         case CMD_SAVE:
-            cairo_save( currentContext );
+            cairo_save( ctx );
+            aState.transformStack.push_back( aState.isTransformed );
             break;
 
         case CMD_RESTORE:
-            cairo_restore( currentContext );
+            cairo_restore( ctx );
+
+            if( !aState.transformStack.empty() )
+            {
+                aState.isTransformed = aState.transformStack.back();
+                aState.transformStack.pop_back();
+            }
             break;
 
         case CMD_CALL_GROUP:
-            DrawGroup( it->intArgument );
+            {
+                std::map<int, GROUP>::const_iterator group = groups.find( it->intArgument );
+
+                if( group == groups.end() )
+                    break;
+
+                // Skip groups that do not touch the drawn tile
+                if( aState.clip && !aState.isTransformed )
+                {
+                    std::map<int, BOX2D>::const_iterator extents =
+                        groupExtents.find( it->intArgument );
+
+                    if( extents != groupExtents.end() &&
+                        !extents->second.Intersects( *aState.clip ) )
+                        break;
+                }
+
+                replayGroup( group->second, aState );
+            }
+            break;
+
+        case CMD_SET_LAYER:
+            // Cairo grouping prevents display of overlapping items on the same layer
+            // in the lighter color
+            if( ctx )
+            {
+                cairo_pop_group_to_source( ctx );
+                cairo_paint_with_alpha( ctx, LAYER_ALPHA );
+                cairo_push_group( ctx );
+            }
+            break;
+
+        case CMD_SET_TARGET:
+            {
+                cairo_matrix_t matrix = cairoWorldScreenMatrix;
+
+                if( ctx )
+                {
+                    cairo_get_matrix( ctx, &matrix );
+                    cairo_pop_group_to_source( ctx );
+                    cairo_paint_with_alpha( ctx, LAYER_ALPHA );
+                }
+
+                cairo_t*& tileContext = aState.contexts[it->intArgument];
+
+                if( !tileContext )
+                {
+                    tileContext = compositor->CreateTileContext( it->intArgument,
+                                                                 aState.tile[0], aState.tile[1],
+                                                                 aState.tile[2], aState.tile[3] );
+                }
+
+                ctx = aState.context = tileContext;
+                cairo_set_matrix( ctx, &matrix );
+                cairo_push_group( ctx );
+            }
             break;
         }
     }
 }
 
 
+void CAIRO_GAL::drawTile( int aX, int aY, int aWidth, int aHeight ) const
+{
+    // Tile area in world coordinates, enlarged to cover antialiasing and the minimal line width
+    const int margin = 2;
+    VECTOR2D start = screenWorldMatrix * VECTOR2D( aX - margin, aY - margin );
+    VECTOR2D end   = screenWorldMatrix * VECTOR2D( aX + aWidth + margin, aY + aHeight + margin );
+    BOX2D    clip( start, end - start );
+
+    REPLAY_STATE state  = frameState;
+    state.context       = NULL;
+    state.isTransformed = false;
+    state.clip          = &clip;
+    state.tile[0]       = aX;
+    state.tile[1]       = aY;
+    state.tile[2]       = aWidth;
+    state.tile[3]       = aHeight;
+
+    replayGroup( frameCommands, state );
+
+    // Finish the last layer
+    if( state.context )
+    {
+        cairo_pop_group_to_source( state.context );
+        cairo_paint_with_alpha( state.context, LAYER_ALPHA );
+    }
+
+    for( std::map<unsigned int, cairo_t*>::iterator it = state.contexts.begin();
+         it != state.contexts.end(); ++it )
+    {
+        cairo_destroy( it->second );
+    }
+}
+
+
+void CAIRO_GAL::drawFrameTiles()
+{
+    const int tilesX = ( screenSize.x + TILE_SIZE - 1 ) / TILE_SIZE;
+    const int tilesY = ( screenSize.y + TILE_SIZE - 1 ) / TILE_SIZE;
+    const int tilesCount = tilesX * tilesY;
+
+    // Tiles do not share any pixels, so they can be drawn independently
+    #pragma omp parallel for schedule( dynamic )
+    for( int i = 0; i < tilesCount; ++i )
+    {
+        int x = ( i % tilesX ) * TILE_SIZE;
+        int y = ( i / tilesX ) * TILE_SIZE;
+
+        drawTile( x, y, std::min( TILE_SIZE, screenSize.x - x ),
+                  std::min( TILE_SIZE, screenSize.y - y ) );
+    }
+
+    clearGroup( frameCommands );
+}
+
+
 void CAIRO_GAL::ChangeGroupColor( int aGroupNumber, const COLOR4D& aNewColor )
 {
     storePath();
@@ -701,9 +1021,19 @@ void CAIRO_GAL::DeleteGroup( int aGroupNumber )
     storePath();
 
     // Delete the Cairo paths
+    clearGroup( groups[aGroupNumber] );
+
+    // Delete the group
+    groups.erase( aGroupNumber );
+    groupExtents.erase( aGroupNumber );
+}
+
+
+void CAIRO_GAL::clearGroup( GROUP& aGroup )
+{
     std::deque<GROUP_ELEMENT>::iterator it, end;
 
-    for( it = groups[aGroupNumber].begin(), end = groups[aGroupNumber].end(); it != end; ++it )
+    for( it = aGroup.begin(), end = aGroup.end(); it != end; ++it )
     {
         if( it->command == CMD_FILL_PATH || it->command == CMD_STROKE_PATH )
         {
@@ -711,8 +1041,7 @@ void CAIRO_GAL::DeleteGroup( int aGroupNumber )
         }
     }
 
-    // Delete the group
-    groups.erase( aGroupNumber );
+    aGroup.clear();
 }
 
 
@@ -763,6 +1092,19 @@ void CAIRO_GAL::SetTarget( RENDER_TARGET aTarget )
     if( !validCompositor )
         return;
 
+    if( isRecordingFrame )
+    {
+        storePath();
+
+        GROUP_ELEMENT groupElement;
+        groupElement.command = CMD_SET_TARGET;
+        groupElement.intArgument = ( aTarget == TARGET_OVERLAY ) ? overlayBuffer : mainBuffer;
+        frameCommands.push_back( groupElement );
+
+        currentTarget = aTarget;
+        return;
+    }
+
     // Cairo grouping prevents display of overlapping items on the same layer in the lighter color
     if( isInitialized )
     {
@@ -844,6 +1186,15 @@ void CAIRO_GAL::drawGridLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndP
 {
     cairo_move_to( currentContext, aStartPoint.x, aStartPoint.y );
     cairo_line_to( currentContext, aEndPoint.x, aEndPoint.y );
+
+    if( isRecordingFrame )
+    {
+        // DrawGrid() sets the grid color as the stroke color, so it is enough to store the path
+        isElementAdded = true;
+        storePath();
+        return;
+    }
+
     cairo_set_source_rgb( currentContext, gridColor.r, gridColor.g, gridColor.b );
     cairo_stroke( currentContext );
 }
@@ -875,6 +1226,9 @@ void CAIRO_GAL::storePath()
             // Copy the actual path, append it to the global path list
             // then check, if the path needs to be stroked/filled and
             // add this command to the group list;
+            if( currentGroupNumber >= 0 )
+                updateGroupExtents();
+
             if( isStrokeEnabled )
             {
                 GROUP_ELEMENT groupElement;
@@ -897,6 +1251,51 @@ void CAIRO_GAL::storePath()
 }
 
 
+void CAIRO_GAL::recordTransform( const cairo_matrix_t& aMatrix )
+{
+    // New transformations are applied before the ones recorded earlier (as in cairo_transform())
+    cairo_matrix_multiply( &groupMatrix, &aMatrix, &groupMatrix );
+}
+
+
+void CAIRO_GAL::updateGroupExtents()
+{
+    double x1, y1, x2, y2;
+    cairo_path_extents( currentContext, &x1, &y1, &x2, &y2 );
+
+    // Strokes go beyond the path
+    if( isStrokeEnabled )
+    {
+        x1 -= lineWidth / 2.0;
+        y1 -= lineWidth / 2.0;
+        x2 += lineWidth / 2.0;
+        y2 += lineWidth / 2.0;
+    }
+
+    // Paths are expressed in the group coordinates, find their bounding box in world coordinates
+    double xs[] = { x1, x2, x1, x2 };
+    double ys[] = { y1, y1, y2, y2 };
+    BOX2D  extents;
+
+    for( int i = 0; i < 4; ++i )
+    {
+        cairo_matrix_transform_point( &groupMatrix, &xs[i], &ys[i] );
+
+        if( i == 0 )
+            extents = BOX2D( VECTOR2D( xs[i], ys[i] ), VECTOR2D( 0.0, 0.0 ) );
+        else
+            extents.Merge( VECTOR2D( xs[i], ys[i] ) );
+    }
+
+    std::map<int, BOX2D>::iterator it = groupExtents.find( currentGroupNumber );
+
+    if( it == groupExtents.end() )
+        groupExtents.insert( std::make_pair( currentGroupNumber, extents ) );
+    else
+        it->second.Merge( extents );
+}
+
+
 void CAIRO_GAL::onPaint( wxPaintEvent& WXUNUSED( aEvent ) )
 {
     PostPaint();
@@ -913,6 +1312,10 @@ void CAIRO_GAL::skipMouseEvent( wxMouseEvent& aEvent )
 
 void CAIRO_GAL::initCursor()
 {
+    // The cursor is drawn only on the screen
+    if( isOffscreen )
+        return;
+
     if( cursorPixels )
         delete cursorPixels;
 
@@ -36,6 +36,9 @@
 #include <confirm.h>
 #include <wx/log.h>
 #include <list>
+#include <algorithm>
+#include <cstring>
+#include <climits>
 #ifdef __WXDEBUG__
 #include <profile.h>
 #endif /* __WXDEBUG__ */
@@ -52,6 +55,8 @@ CACHED_CONTAINER::CACHED_CONTAINER( unsigned int aSize ) :
     m_chunkSize = 0;
     m_chunkOffset = 0;
     m_itemSize = 0;
+
+    memset( &m_stats, 0, sizeof( m_stats ) );
 }
 
 
@@ -61,7 +66,8 @@ void CACHED_CONTAINER::SetItem( VERTEX_ITEM* aItem )
 
     m_item      = aItem;
     m_itemSize  = m_item->GetSize();
-    m_chunkSize = m_itemSize;
+    // Stored items always own a chunk of their size class
+    m_chunkSize = getSizeClass( m_itemSize );
 
     if( m_itemSize == 0 )
         m_items.insert( m_item ); // The item was not stored before
@@ -80,15 +86,14 @@ void CACHED_CONTAINER::FinishItem()
     wxASSERT( m_item->GetSize() == m_itemSize );
 
     // Finishing the previously edited item
-    if( m_itemSize < m_chunkSize )
-    {
-        // There is some not used but reserved memory left, so we should return it to the pool
-        int itemOffset = m_item->GetOffset();
+    unsigned int itemChunkSize = getSizeClass( m_itemSize );
 
-        // Add the not used memory back to the pool
-        m_freeChunks.insert( CHUNK( m_chunkSize - m_itemSize, itemOffset + m_itemSize ) );
-        m_freeSpace += ( m_chunkSize - m_itemSize );
-        // mergeFreeChunks();   // veery slow and buggy
+    if( itemChunkSize < m_chunkSize )
+    {
+        // There is some not used but reserved memory left, so we should return it to the pool.
+        // The item keeps a chunk of its size class, so it can be replaced by a similar one later.
+        freeChunk( m_chunkOffset + itemChunkSize, m_chunkSize - itemChunkSize );
+        m_chunkSize = itemChunkSize;
     }
 
 #if CACHED_CONTAINER_TEST > 1
@@ -109,18 +114,17 @@ VERTEX* CACHED_CONTAINER::Allocate( unsigned int aSize )
     if( m_itemSize + aSize > m_chunkSize )
     {
         // There is not enough space in the currently reserved chunk, so we have to resize it
+        unsigned int newChunkSize = getSizeClass( ( 2 * m_itemSize ) + aSize );
+        unsigned int newChunkOffset = reallocate( newChunkSize );
 
-        // Reserve a bigger memory chunk for the current item and
-        // make it multiple of 3 to store triangles
-        m_chunkSize = ( 2 * m_itemSize ) + aSize + ( 3 - aSize % 3 );
-        // Save the current size before reallocating
-        m_chunkOffset = reallocate( m_chunkSize );
-
-        if( m_chunkOffset > m_currentSize )
+        if( newChunkOffset == UINT_MAX )
         {
             m_failed = true;
             return NULL;
         }
+
+        m_chunkSize   = newChunkSize;
+        m_chunkOffset = newChunkOffset;
     }
 
     VERTEX* reserved = &m_vertices[m_chunkOffset + m_itemSize];
@@ -148,18 +152,17 @@ void CACHED_CONTAINER::Delete( VERTEX_ITEM* aItem )
     wxASSERT( aItem != NULL );
     wxASSERT( m_items.find( aItem ) != m_items.end() );
 
-    int size   = aItem->GetSize();
-    int offset = aItem->GetOffset();
+    unsigned int size   = aItem->GetSize();
+    unsigned int offset = aItem->GetOffset();
 
 #if CACHED_CONTAINER_TEST > 1
     wxLogDebug( wxT( "Removing 0x%08lx (size %d offset %d)" ), (long) aItem, size, offset );
 #endif
 
-    // Insert a free memory chunk entry in the place where item was stored
+    // Return the slot where item was stored to the pool
     if( size > 0 )
     {
-        m_freeChunks.insert( CHUNK( size, offset ) );
-        m_freeSpace += size;
+        freeChunk( offset, getSizeClass( size ) );
         // Indicate that the item is not stored in the container anymore
         aItem->setSize( 0 );
     }
@@ -170,9 +173,10 @@ void CACHED_CONTAINER::Delete( VERTEX_ITEM* aItem )
     test();
 #endif
 
-    // Dynamic memory freeing, there is no point in holding
-    // a large amount of memory when there is no use for it
-    if( m_freeSpace > ( m_currentSize / 2 ) && m_currentSize > m_initialSize )
+    // Dynamic memory freeing, there is no point in holding a large amount of memory when there
+    // is no use for it. Shrinking requires a compaction, so it is done only when most of
+    // the container is free, otherwise deleting and adding items would keep resizing it.
+    if( m_freeSpace > ( m_currentSize / 4 ) * 3 && m_currentSize > m_initialSize )
     {
         resizeContainer( m_currentSize / 2 );
     }
@@ -203,11 +207,38 @@ void CACHED_CONTAINER::Clear()
 
 
     // Now there is only free space left
+    m_freeSlots.clear();
     m_freeChunks.clear();
     m_freeChunks.insert( CHUNK( m_freeSpace, 0 ) );
 }
 
 
+double CACHED_CONTAINER::GetFragmentation() const
+{
+    if( m_freeSpace == 0 )
+        return 0.0;
+
+    unsigned int largest = 0;
+
+    // Free chunks are sorted by their size
+    if( !m_freeChunks.empty() )
+        largest = m_freeChunks.rbegin()->first;
+
+    FREE_SLOT_MAP::const_reverse_iterator it;
+
+    for( it = m_freeSlots.rbegin(); it != m_freeSlots.rend(); ++it )
+    {
+        if( !it->second.empty() )
+        {
+            largest = std::max( largest, it->first );
+            break;
+        }
+    }
+
+    return 1.0 - (double) largest / m_freeSpace;
+}
+
+
 unsigned int CACHED_CONTAINER::reallocate( unsigned int aSize )
 {
     wxASSERT( aSize > 0 );
@@ -216,69 +247,89 @@ unsigned int CACHED_CONTAINER::reallocate( unsigned int aSize )
     wxLogDebug( wxT( "Resize 0x%08lx from %d to %d" ), (long) m_item, m_itemSize, aSize );
 #endif
 
-    // Is there enough space to store vertices?
-    if( m_freeSpace < aSize )
+    unsigned int chunkOffset = allocateChunk( aSize );
+
+    if( chunkOffset == UINT_MAX )
+        return UINT_MAX;
+
+    wxASSERT( chunkOffset + aSize <= m_currentSize );
+
+    // Check if the item was previously stored in the container
+    if( m_itemSize > 0 )
     {
-        bool result;
+#if CACHED_CONTAINER_TEST > 3
+        wxLogDebug( wxT( "Moving 0x%08lx from 0x%08x to 0x%08x" ),
+                    (long) m_item, m_chunkOffset, chunkOffset );
+#endif
+        // The item was reallocated, so we have to copy all the old data to the new place
+        memcpy( &m_vertices[chunkOffset], &m_vertices[m_chunkOffset],
+                m_itemSize * VertexSize );
+    }
 
-        // Would it be enough to double the current space?
-        if( aSize < m_freeSpace + m_currentSize )
-        {
-            // Yes: exponential growing
-            result = resizeContainer( m_currentSize * 2 );
-        }
-        else
-        {
-            // No: grow to the nearest bigger power of 2
-            result = resizeContainer( getPowerOf2( m_currentSize * 2 + aSize ) );
-        }
+    // Free the space previously used by the chunk
+    if( m_chunkSize > 0 )
+        freeChunk( m_chunkOffset, m_chunkSize );
 
-        if( !result )
-            return UINT_MAX;
+    m_item->setOffset( chunkOffset );
+
+    return chunkOffset;
+}
+
+
+unsigned int CACHED_CONTAINER::allocateChunk( unsigned int aSize )
+{
+    wxASSERT( aSize > 0 && aSize == getSizeClass( aSize ) );
+
+    ++m_stats.allocations;
+
+    // The best fit is a slot left by an item of the same size class
+    FREE_SLOT_MAP::iterator slots = m_freeSlots.find( aSize );
+
+    if( slots != m_freeSlots.end() && !slots->second.empty() )
+    {
+        unsigned int offset = slots->second.back();
+        slots->second.pop_back();
+        m_freeSpace -= aSize;
+        ++m_stats.slotReuses;
+
+        return offset;
     }
 
     // Look for the free space chunk of at least given size
     FREE_CHUNK_MAP::iterator newChunk = m_freeChunks.lower_bound( aSize );
 
+    if( newChunk == m_freeChunks.end() && m_freeSpace >= aSize )
+    {
+        // There is enough free space, but it is scattered among slots of other sizes.
+        // Try to find a big enough space by merging neighbouring chunks.
+        releaseFreeSlots();
+        newChunk = m_freeChunks.lower_bound( aSize );
+    }
+
     if( newChunk == m_freeChunks.end() )
     {
-        // In the case when there is enough space to store the vertices,
-        // but the free space is not continous we should defragment the container
-        if( !defragment() )
-            return UINT_MAX;
+        // There is no place for the chunk, so the container has to be enlarged. Exponential
+        // growing is used, unless the added space would not be enough to store the chunk.
+        unsigned int newSize = m_currentSize * 2;
 
-        // Update the current offset
-        m_chunkOffset = m_item->GetOffset();
+        if( newSize - m_currentSize < aSize )
+            newSize = getPowerOf2( m_currentSize + aSize );
+
+        if( newSize == 0 || !resizeContainer( newSize ) )
+            return UINT_MAX;
 
-        // We can take the first free chunk, as there is only one after defragmentation
-        // and we can be sure that it provides enough space to store the object
-        newChunk = m_freeChunks.begin();
+        // The space added at the end of the container is big enough
+        newChunk = m_freeChunks.lower_bound( aSize );
+        wxASSERT( newChunk != m_freeChunks.end() );
     }
 
-    // Parameters of the allocated cuhnk
+    // Parameters of the allocated chunk
     unsigned int chunkSize   = newChunk->first;
     unsigned int chunkOffset = newChunk->second;
 
     wxASSERT( chunkSize >= aSize );
     wxASSERT( chunkOffset < m_currentSize );
 
-    // Check if the item was previously stored in the container
-    if( m_itemSize > 0 )
-    {
-#if CACHED_CONTAINER_TEST > 3
-        wxLogDebug( wxT( "Moving 0x%08x from 0x%08x to 0x%08x" ),
-                    (int) m_item, oldChunkOffset, chunkOffset );
-#endif
-        // The item was reallocated, so we have to copy all the old data to the new place
-        memcpy( &m_vertices[chunkOffset], &m_vertices[m_chunkOffset],
-                m_itemSize * VertexSize );
-
-        // Free the space previously used by the chunk
-        wxASSERT( m_itemSize > 0 );
-        m_freeChunks.insert( CHUNK( m_itemSize, m_chunkOffset ) );
-        m_freeSpace += m_itemSize;
-    }
-
     // Remove the allocated chunk from the free space pool
     m_freeChunks.erase( newChunk );
 
@@ -289,21 +340,51 @@ unsigned int CACHED_CONTAINER::reallocate( unsigned int aSize )
     }
 
     m_freeSpace -= aSize;
-    // mergeFreeChunks();   // veery slow and buggy
-
-    m_item->setOffset( chunkOffset );
 
     return chunkOffset;
 }
 
 
+void CACHED_CONTAINER::freeChunk( unsigned int aOffset, unsigned int aSize )
+{
+    wxASSERT( aSize > 0 );
+    wxASSERT( aOffset + aSize <= m_currentSize );
+
+    // Chunks of a size class are kept aside, so they are reused by items of the same size
+    if( aSize == getSizeClass( aSize ) )
+        m_freeSlots[aSize].push_back( aOffset );
+    else
+        m_freeChunks.insert( CHUNK( aSize, aOffset ) );
+
+    m_freeSpace += aSize;
+}
+
+
+void CACHED_CONTAINER::releaseFreeSlots()
+{
+    FREE_SLOT_MAP::const_iterator it, it_end;
+
+    for( it = m_freeSlots.begin(), it_end = m_freeSlots.end(); it != it_end; ++it )
+    {
+        const std::vector<unsigned int>& offsets = it->second;
+
+        for( unsigned int i = 0; i < offsets.size(); ++i )
+            m_freeChunks.insert( CHUNK( it->first, offsets[i] ) );
+    }
+
+    m_freeSlots.clear();
+    mergeFreeChunks();
+    ++m_stats.coalescings;
+}
+
+
 bool CACHED_CONTAINER::defragment( VERTEX* aTarget )
 {
 #if CACHED_CONTAINER_TEST > 0
     wxLogDebug( wxT( "Defragmenting" ) );
 
     prof_counter totalTime;
-    prof_start( &totalTime, false );
+    prof_start( &totalTime );
 #endif
 
     if( aTarget == NULL )
@@ -318,38 +399,54 @@ bool CACHED_CONTAINER::defragment( VERTEX* aTarget )
         }
     }
 
-    int newOffset = 0;
+    unsigned int newOffset = 0;
     ITEMS::iterator it, it_end;
 
     for( it = m_items.begin(), it_end = m_items.end(); it != it_end; ++it )
     {
-        VERTEX_ITEM* item = *it;
-        int itemOffset    = item->GetOffset();
-        int itemSize      = item->GetSize();
+        VERTEX_ITEM* item     = *it;
+        unsigned int itemSize = item->GetSize();
+
+        if( itemSize == 0 )
+            continue;
 
         // Move an item to the new container
-        memcpy( &aTarget[newOffset], &m_vertices[itemOffset], itemSize * VertexSize );
+        memcpy( &aTarget[newOffset], &m_vertices[item->GetOffset()], itemSize * VertexSize );
 
         // Update new offset
         item->setOffset( newOffset );
 
-        // Move to the next free space
-        newOffset += itemSize;
+        // The currently modified item gets a chunk of its size class as well
+        if( item == m_item )
+        {
+            m_chunkOffset = newOffset;
+            m_chunkSize   = getSizeClass( itemSize );
+        }
+
+        // Move to the next free space, keeping the item slot of its size class
+        newOffset += getSizeClass( itemSize );
+        m_stats.movedVertices += itemSize;
     }
 
     free( m_vertices );
     m_vertices = aTarget;
 
     // Now there is only one big chunk of free memory
+    wxASSERT( newOffset <= m_currentSize );
+    m_freeSpace = m_currentSize - newOffset;
+    m_freeSlots.clear();
     m_freeChunks.clear();
-    wxASSERT( m_freeSpace > 0 );
-    m_freeChunks.insert( CHUNK( m_freeSpace, m_currentSize - m_freeSpace ) );
+
+    if( m_freeSpace > 0 )
+        m_freeChunks.insert( CHUNK( m_freeSpace, newOffset ) );
+
+    ++m_stats.defragmentations;
 
 #if CACHED_CONTAINER_TEST > 0
     prof_end( &totalTime );
 
     wxLogDebug( wxT( "Defragmented the container storing %d vertices / %.1f ms" ),
-                m_currentSize - m_freeSpace, (double) totalTime.value / 1000.0 );
+                m_currentSize - m_freeSpace, totalTime.msecs() );
 #endif
 
     return true;
@@ -363,7 +460,7 @@ void CACHED_CONTAINER::mergeFreeChunks()
 
 #if CACHED_CONTAINER_TEST > 0
     prof_counter totalTime;
-    prof_start( &totalTime, false );
+    prof_start( &totalTime );
 #endif
 
     // Reversed free chunks map - this one stores chunk size with its offset as the key
@@ -409,7 +506,7 @@ void CACHED_CONTAINER::mergeFreeChunks()
 #if CACHED_CONTAINER_TEST > 0
     prof_end( &totalTime );
 
-    wxLogDebug( wxT( "Merged free chunks / %.1f ms" ), (double) totalTime.value / 1000.0 );
+    wxLogDebug( wxT( "Merged free chunks / %.1f ms" ), totalTime.msecs() );
 #endif
 
     test();
@@ -441,13 +538,10 @@ bool CACHED_CONTAINER::resizeContainer( unsigned int aNewSize )
             return false;
         }
 
-        // Defragment directly to the new, smaller container
+        // Defragment directly to the new, smaller container,
+        // it recomputes the free space for the new size
+        m_currentSize = aNewSize;
         defragment( newContainer );
-
-        // We have to correct freeChunks after defragmentation
-        m_freeChunks.clear();
-        wxASSERT( aNewSize - reservedSpace() > 0 );
-        m_freeChunks.insert( CHUNK( aNewSize - reservedSpace(), reservedSpace() ) );
     }
     else
     {
@@ -462,12 +556,14 @@ bool CACHED_CONTAINER::resizeContainer( unsigned int aNewSize )
 
         // Add an entry for the new memory chunk at the end of the container
         m_freeChunks.insert( CHUNK( aNewSize - m_currentSize, m_currentSize ) );
-    }
 
-    m_vertices = newContainer;
+        m_vertices = newContainer;
 
-    m_freeSpace   += ( aNewSize - m_currentSize );
-    m_currentSize = aNewSize;
+        m_freeSpace   += ( aNewSize - m_currentSize );
+        m_currentSize = aNewSize;
+    }
+
+    ++m_stats.resizes;
 
     return true;
 }
@@ -484,10 +580,24 @@ unsigned int CACHED_CONTAINER::getPowerOf2( unsigned int aNumber ) const
 }
 
 
+unsigned int CACHED_CONTAINER::getSizeClass( unsigned int aSize ) const
+{
+    if( aSize <= 32 )
+        return ( aSize + 3 ) & ~3u;
+
+    unsigned int step = getPowerOf2( aSize ) / 8;
+
+    if( step == 0 )     // Too big to be rounded
+        return aSize;
+
+    return ( ( aSize + step - 1 ) / step ) * step;
+}
+
+
 #ifdef CACHED_CONTAINER_TEST
 void CACHED_CONTAINER::showFreeChunks()
 {
-    FreeChunkMap::iterator it;
+    FREE_CHUNK_MAP::iterator it;
 
     wxLogDebug( wxT( "Free chunks:" ) );
 
@@ -500,12 +610,19 @@ void CACHED_CONTAINER::showFreeChunks()
         wxLogDebug( wxT( "[0x%08x-0x%08x] (size %d)" ),
                     offset, offset + size - 1, size );
     }
+
+    FREE_SLOT_MAP::iterator its;
+
+    for( its = m_freeSlots.begin(); its != m_freeSlots.end(); ++its )
+    {
+        wxLogDebug( wxT( "%d free slots of size %d" ), (int) its->second.size(), its->first );
+    }
 }
 
 
 void CACHED_CONTAINER::showReservedChunks()
 {
-    Items::iterator it;
+    ITEMS::iterator it;
 
     wxLogDebug( wxT( "Reserved chunks:" ) );
 
@@ -526,16 +643,21 @@ void CACHED_CONTAINER::test()
 {
     // Free space check
     unsigned int freeSpace = 0;
-    FreeChunkMap::iterator itf;
+    FREE_CHUNK_MAP::iterator itf;
 
     for( itf = m_freeChunks.begin(); itf != m_freeChunks.end(); ++itf )
         freeSpace += getChunkSize( *itf );
 
+    FREE_SLOT_MAP::iterator its;
+
+    for( its = m_freeSlots.begin(); its != m_freeSlots.end(); ++its )
+        freeSpace += its->first * its->second.size();
+
     wxASSERT( freeSpace == m_freeSpace );
 
     // Reserved space check
     /*unsigned int reservedSpace = 0;
-    Items::iterator itr;
+    ITEMS::iterator itr;
     for( itr = m_items.begin(); itr != m_items.end(); ++itr )
         reservedSpace += ( *itr )->GetSize();
     reservedSpace += m_itemSize;    // Add the current chunk size
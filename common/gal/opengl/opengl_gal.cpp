@@ -95,15 +95,6 @@ OPENGL_GAL::OPENGL_GAL( wxWindow* aParent, wxEvtHandler* aMouseListener,
     // Grid color settings are different in Cairo and OpenGL
     SetGridColor( COLOR4D( 0.8, 0.8, 0.8, 0.1 ) );
 
-    // Tesselator initialization
-    tesselator = gluNewTess();
-    InitTesselatorCallbacks( tesselator );
-
-    if( tesselator == NULL )
-        throw std::runtime_error( "Could not create the tesselator" );
-
-    gluTessProperty( tesselator, GLU_TESS_WINDING_RULE, GLU_TESS_WINDING_POSITIVE );
-
     currentManager = &nonCachedManager;
 }
 
@@ -112,7 +103,6 @@ OPENGL_GAL::~OPENGL_GAL()
 {
     glFlush();
 
-    gluDeleteTess( tesselator );
     ClearCache();
 }
 
@@ -211,7 +201,27 @@ void OPENGL_GAL::EndDrawing()
 }
 
 
-void OPENGL_GAL::DrawLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
+VERTEX_GAL::VERTEX_GAL() :
+    currentManager( NULL )
+{
+    // Tesselator initialization
+    tesselator = gluNewTess();
+    InitTesselatorCallbacks( tesselator );
+
+    if( tesselator == NULL )
+        throw std::runtime_error( "Could not create the tesselator" );
+
+    gluTessProperty( tesselator, GLU_TESS_WINDING_RULE, GLU_TESS_WINDING_POSITIVE );
+}
+
+
+VERTEX_GAL::~VERTEX_GAL()
+{
+    gluDeleteTess( tesselator );
+}
+
+
+void VERTEX_GAL::DrawLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
 {
     const VECTOR2D  startEndVector = aEndPoint - aStartPoint;
     double          lineAngle = startEndVector.Angle();
@@ -229,7 +239,7 @@ void OPENGL_GAL::DrawLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoin
 }
 
 
-void OPENGL_GAL::DrawSegment( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint,
+void VERTEX_GAL::DrawSegment( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint,
                               double aWidth )
 {
     VECTOR2D startEndVector = aEndPoint - aStartPoint;
@@ -274,7 +284,7 @@ void OPENGL_GAL::DrawSegment( const VECTOR2D& aStartPoint, const VECTOR2D& aEndP
 }
 
 
-void OPENGL_GAL::DrawCircle( const VECTOR2D& aCenterPoint, double aRadius )
+void VERTEX_GAL::DrawCircle( const VECTOR2D& aCenterPoint, double aRadius )
 {
     if( isFillEnabled )
     {
@@ -332,7 +342,7 @@ void OPENGL_GAL::DrawCircle( const VECTOR2D& aCenterPoint, double aRadius )
 }
 
 
-void OPENGL_GAL::DrawArc( const VECTOR2D& aCenterPoint, double aRadius, double aStartAngle,
+void VERTEX_GAL::DrawArc( const VECTOR2D& aCenterPoint, double aRadius, double aStartAngle,
                           double aEndAngle )
 {
     if( aRadius <= 0 )
@@ -395,7 +405,7 @@ void OPENGL_GAL::DrawArc( const VECTOR2D& aCenterPoint, double aRadius, double a
 }
 
 
-void OPENGL_GAL::DrawRectangle( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
+void VERTEX_GAL::DrawRectangle( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
 {
     // Compute the diagonal points of the rectangle
     VECTOR2D diagonalPointA( aEndPoint.x, aStartPoint.y );
@@ -432,7 +442,7 @@ void OPENGL_GAL::DrawRectangle( const VECTOR2D& aStartPoint, const VECTOR2D& aEn
 }
 
 
-void OPENGL_GAL::DrawPolyline( std::deque<VECTOR2D>& aPointList )
+void VERTEX_GAL::DrawPolyline( std::deque<VECTOR2D>& aPointList )
 {
     if( aPointList.empty() )
         return;
@@ -460,7 +470,7 @@ void OPENGL_GAL::DrawPolyline( std::deque<VECTOR2D>& aPointList )
 }
 
 
-void OPENGL_GAL::DrawPolygon( const std::deque<VECTOR2D>& aPointList )
+void VERTEX_GAL::DrawPolygon( const std::deque<VECTOR2D>& aPointList )
 {
     // Any non convex polygon needs to be tesselated
     // for this purpose the GLU standard functions are used
@@ -492,7 +502,7 @@ void OPENGL_GAL::DrawPolygon( const std::deque<VECTOR2D>& aPointList )
 }
 
 
-void OPENGL_GAL::DrawCurve( const VECTOR2D& aStartPoint, const VECTOR2D& aControlPointA,
+void VERTEX_GAL::DrawCurve( const VECTOR2D& aStartPoint, const VECTOR2D& aControlPointA,
                             const VECTOR2D& aControlPointB, const VECTOR2D& aEndPoint )
 {
     // FIXME The drawing quality needs to be improved
@@ -579,31 +589,31 @@ void OPENGL_GAL::Transform( const MATRIX3x3D& aTransformation )
 }
 
 
-void OPENGL_GAL::Rotate( double aAngle )
+void VERTEX_GAL::Rotate( double aAngle )
 {
     currentManager->Rotate( aAngle, 0.0f, 0.0f, 1.0f );
 }
 
 
-void OPENGL_GAL::Translate( const VECTOR2D& aVector )
+void VERTEX_GAL::Translate( const VECTOR2D& aVector )
 {
     currentManager->Translate( aVector.x, aVector.y, 0.0f );
 }
 
 
-void OPENGL_GAL::Scale( const VECTOR2D& aScale )
+void VERTEX_GAL::Scale( const VECTOR2D& aScale )
 {
     currentManager->Scale( aScale.x, aScale.y, 0.0f );
 }
 
 
-void OPENGL_GAL::Save()
+void VERTEX_GAL::Save()
 {
     currentManager->PushMatrix();
 }
 
 
-void OPENGL_GAL::Restore()
+void VERTEX_GAL::Restore()
 {
     currentManager->PopMatrix();
 }
@@ -660,6 +670,149 @@ void OPENGL_GAL::ClearCache()
 }
 
 
+/**
+ * Class OPENGL_GAL::CACHE_WORKER
+ * tessellates groups to a VERTEX_MANAGER keeping its vertices in system memory. There are no
+ * OpenGL calls involved, so a worker may be used on any thread. Groups are stored one after
+ * another and they are moved to the cached target by OPENGL_GAL::MergeCacheGroup().
+ */
+class OPENGL_GAL::CACHE_WORKER : public VERTEX_GAL
+{
+public:
+    CACHE_WORKER( const GAL& aSource ) :
+        vertices( false ), isGrouping( false )
+    {
+        currentManager = &vertices;
+        Reset( aSource );
+    }
+
+    /**
+     * Function Reset()
+     * removes all groups, and copies the view settings of aSource.
+     * @param aSource is the GAL the groups are going to be merged to.
+     */
+    void Reset( const GAL& aSource )
+    {
+        wxASSERT( !isGrouping );
+
+        vertices.Clear();
+        groups.clear();
+
+        // Some items are drawn depending on the current scale
+        screenSize          = aSource.GetScreenPixelSize();
+        worldScreenMatrix   = aSource.GetWorldScreenMatrix();
+        screenWorldMatrix   = aSource.GetScreenWorldMatrix();
+        worldScale          = aSource.GetWorldScale();
+        zoomFactor          = aSource.GetZoomFactor();
+        lookAtPoint         = aSource.GetLookAtPoint();
+        SetDepthRange( VECTOR2D( aSource.GetMinDepth(), aSource.GetMaxDepth() ) );
+    }
+
+    /**
+     * Function GetGroupVertices()
+     * returns vertices of a group.
+     * @param aGroupNumber is the group number.
+     * @param aSize is set to the number of vertices of the group.
+     */
+    const VERTEX* GetGroupVertices( int aGroupNumber, unsigned int& aSize ) const
+    {
+        const GROUP& group = groups[aGroupNumber];
+        aSize = group.size;
+
+        return aSize > 0 ? vertices.GetVertices( group.offset ) : NULL;
+    }
+
+    virtual int BeginGroup()
+    {
+        wxASSERT( !isGrouping );
+        isGrouping = true;
+
+        GROUP group = { vertices.GetVertexCount(), 0 };
+        groups.push_back( group );
+
+        return groups.size() - 1;
+    }
+
+    virtual void EndGroup()
+    {
+        wxASSERT( isGrouping );
+        isGrouping = false;
+
+        GROUP& group = groups.back();
+        group.size = vertices.GetVertexCount() - group.offset;
+    }
+
+    // Workers only tessellate, there is nothing to be displayed
+    virtual void BeginDrawing() {}
+    virtual void EndDrawing() {}
+    virtual void ResizeScreen( int aWidth, int aHeight ) {}
+    virtual bool Show( bool aShow ) { return false; }
+    virtual void Flush() {}
+    virtual void ClearScreen( const COLOR4D& aColor ) {}
+    virtual void Transform( const MATRIX3x3D& aTransformation ) {}
+    virtual void DrawGroup( int aGroupNumber ) {}
+    virtual void ChangeGroupColor( int aGroupNumber, const COLOR4D& aNewColor ) {}
+    virtual void ChangeGroupDepth( int aGroupNumber, int aDepth ) {}
+    virtual void DeleteGroup( int aGroupNumber ) {}
+    virtual void ClearCache() {}
+    virtual void SaveScreen() {}
+    virtual void RestoreScreen() {}
+    virtual void SetTarget( RENDER_TARGET aTarget ) {}
+    virtual RENDER_TARGET GetTarget() const { return TARGET_CACHED; }
+    virtual void ClearTarget( RENDER_TARGET aTarget ) {}
+    virtual void DrawCursor( const VECTOR2D& aCursorPosition ) {}
+
+protected:
+    virtual void drawGridLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint ) {}
+
+private:
+    ///> Range of vertices belonging to a group
+    struct GROUP
+    {
+        unsigned int offset;
+        unsigned int size;
+    };
+
+    VERTEX_MANAGER          vertices;       ///< Storage for the tessellated groups
+    std::vector<GROUP>      groups;         ///< Groups, indexed by group numbers
+    bool                    isGrouping;     ///< Was a group started?
+};
+
+
+GAL* OPENGL_GAL::CreateCacheWorker() const
+{
+    return new CACHE_WORKER( *this );
+}
+
+
+void OPENGL_GAL::ResetCacheWorker( GAL* aWorker ) const
+{
+    static_cast<CACHE_WORKER*>( aWorker )->Reset( *this );
+}
+
+
+int OPENGL_GAL::MergeCacheGroup( const GAL* aWorker, int aGroupNumber )
+{
+    const CACHE_WORKER* worker = static_cast<const CACHE_WORKER*>( aWorker );
+
+    unsigned int size;
+    const VERTEX* vertices = worker->GetGroupVertices( aGroupNumber, size );
+
+    int groupNumber = BeginGroup();
+    cachedManager.CopyVertices( vertices, size );
+    EndGroup();
+
+    return groupNumber;
+}
+
+
+const CACHED_CONTAINER* OPENGL_GAL::GetCachedContainer() const
+{
+    // cachedManager is constructed with aCached set, so it always uses a CACHED_CONTAINER
+    return static_cast<const CACHED_CONTAINER*>( cachedManager.GetContainer() );
+}
+
+
 void OPENGL_GAL::SaveScreen()
 {
     wxASSERT_MSG( false, wxT( "Not implemented yet" ) );
@@ -757,7 +910,7 @@ void OPENGL_GAL::drawGridLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEnd
 }
 
 
-void OPENGL_GAL::drawLineQuad( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
+void VERTEX_GAL::drawLineQuad( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint )
 {
     /* Helper drawing:                   ____--- v3       ^
      *                           ____---- ...   \          \
@@ -807,7 +960,7 @@ void OPENGL_GAL::drawLineQuad( const VECTOR2D& aStartPoint, const VECTOR2D& aEnd
 }
 
 
-void OPENGL_GAL::drawSemiCircle( const VECTOR2D& aCenterPoint, double aRadius, double aAngle )
+void VERTEX_GAL::drawSemiCircle( const VECTOR2D& aCenterPoint, double aRadius, double aAngle )
 {
     if( isFillEnabled )
     {
@@ -823,7 +976,7 @@ void OPENGL_GAL::drawSemiCircle( const VECTOR2D& aCenterPoint, double aRadius, d
 }
 
 
-void OPENGL_GAL::drawFilledSemiCircle( const VECTOR2D& aCenterPoint, double aRadius,
+void VERTEX_GAL::drawFilledSemiCircle( const VECTOR2D& aCenterPoint, double aRadius,
                                        double aAngle )
 {
     Save();
@@ -852,7 +1005,7 @@ void OPENGL_GAL::drawFilledSemiCircle( const VECTOR2D& aCenterPoint, double aRad
 }
 
 
-void OPENGL_GAL::drawStrokedSemiCircle( const VECTOR2D& aCenterPoint, double aRadius,
+void VERTEX_GAL::drawStrokedSemiCircle( const VECTOR2D& aCenterPoint, double aRadius,
                                         double aAngle )
 {
     double outerRadius = aRadius + ( lineWidth / 2 );
@@ -1046,7 +1199,7 @@ void OPENGL_GAL::OPENGL_TEST::error(const std::string& aError )
 void CALLBACK VertexCallback( GLvoid* aVertexPtr, void* aData )
 {
     GLdouble* vertex = static_cast<GLdouble*>( aVertexPtr );
-    OPENGL_GAL::TessParams* param = static_cast<OPENGL_GAL::TessParams*>( aData );
+    VERTEX_GAL::TessParams* param = static_cast<VERTEX_GAL::TessParams*>( aData );
     VERTEX_MANAGER* vboManager = param->vboManager;
 
     if( vboManager )
@@ -1059,7 +1212,7 @@ void CALLBACK CombineCallback( GLdouble coords[3],
                                GLfloat weight[4], GLdouble** dataOut, void* aData )
 {
     GLdouble* vertex = new GLdouble[3];
-    OPENGL_GAL::TessParams* param = static_cast<OPENGL_GAL::TessParams*>( aData );
+    VERTEX_GAL::TessParams* param = static_cast<VERTEX_GAL::TessParams*>( aData );
 
     // Save the pointer so we can delete it later
     param->intersectPoints.push_back( boost::shared_array<GLdouble>( vertex ) );
@@ -34,6 +34,7 @@
 #include <gal/opengl/gpu_manager.h>
 #include <gal/opengl/vertex_item.h>
 #include <confirm.h>
+#include <cstring>
 
 using namespace KIGFX;
 
@@ -83,6 +84,23 @@ void VERTEX_MANAGER::Vertices( const VERTEX aVertices[], unsigned int aSize ) co
 }
 
 
+void VERTEX_MANAGER::CopyVertices( const VERTEX aVertices[], unsigned int aSize ) const
+{
+    if( aSize == 0 )
+        return;
+
+    VERTEX* newVertex = m_container->Allocate( aSize );
+
+    if( newVertex == NULL )
+    {
+        DisplayError( NULL, wxT( "Vertex allocation error" ) );
+        return;
+    }
+
+    memcpy( newVertex, aVertices, aSize * sizeof(VERTEX) );
+}
+
+
 void VERTEX_MANAGER::SetItem( VERTEX_ITEM& aItem ) const
 {
     m_container->SetItem( &aItem );
@@ -147,6 +165,18 @@ VERTEX* VERTEX_MANAGER::GetVertices( const VERTEX_ITEM& aItem ) const
 }
 
 
+VERTEX* VERTEX_MANAGER::GetVertices( unsigned int aOffset ) const
+{
+    return m_container->GetVertices( aOffset );
+}
+
+
+unsigned int VERTEX_MANAGER::GetVertexCount() const
+{
+    return m_container->GetUsedSize();
+}
+
+
 void VERTEX_MANAGER::SetShader( SHADER& aShader ) const
 {
     m_gpu->SetShader( aShader );
@@ -25,6 +25,7 @@
 
 
 #include <cstdarg>
+#include <algorithm>
 
 #include <richio.h>
 
@@ -434,10 +435,15 @@ int OUTPUTFORMATTER::Print( int nestLevel, const char* fmt, ... ) throw( IO_ERRO
     int result = 0;
     int total  = 0;
 
-    for( int i=0; i<nestLevel;  ++i )
+    // write the indentation directly, it is most of the output of deeply nested files
+    static const char spaces[] = "                                ";
+
+    for( int count = nestLevel * NESTWIDTH;  count > 0;  count -= result )
     {
+        result = std::min( count, int( sizeof( spaces ) - 1 ) );
+
         // no error checking needed, an exception indicates an error.
-        result = sprint( "%*c", NESTWIDTH, ' ' );
+        write( spaces, result );
 
         total += result;
     }
@@ -550,6 +556,9 @@ FILE_OUTPUTFORMATTER::FILE_OUTPUTFORMATTER( const wxString& aFileName,
                             m_filename.GetData() );
         THROW_IO_ERROR( msg );
     }
+
+    // the formatter writes many small pieces, use a bigger buffer than the default one
+    setvbuf( m_fp, NULL, _IOFBF, FILE_OUTPUTFMTBUFZ );
 }
 
 
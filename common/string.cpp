@@ -26,6 +26,12 @@
  * @brief Some useful functions to handle strings.
  */
 
+#include <errno.h>
+#include <math.h>
+#include <stdint.h>
+#include <locale>
+#include <sstream>
+
 #include <fctsys.h>
 #include <macros.h>
 #include <richio.h>                        // StrPrintf
@@ -186,6 +192,153 @@ char* StrPurge( char* text )
 }
 
 
+/// Powers of ten which are exactly representable by a double
+static const double exactPowersOf10[] =
+{
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+
+static inline bool isDecimalDigit( char c )
+{
+    return c >= '0' && c <= '9';
+}
+
+
+double ParseDouble( const char* aText, const char** aEnd )
+{
+    const char* cp = aText;
+
+    while( *cp == ' ' || *cp == '\t' || *cp == '\n' || *cp == '\r' || *cp == '\f' || *cp == '\v' )
+        ++cp;
+
+    const char* start = cp;
+    bool        negative = false;
+
+    if( *cp == '-' || *cp == '+' )
+        negative = *cp++ == '-';
+
+    // Gather up to 19 significant digits, they always fit in 64 bits.  The value is
+    // mantissa * 10^exponent.
+    uint64_t    mantissa = 0;
+    int         digits = 0;
+    int         exponent = 0;
+    bool        anyDigit = false;
+    bool        truncated = false;
+
+    for( ; isDecimalDigit( *cp ); ++cp )
+    {
+        anyDigit = true;
+
+        if( digits < 19 )
+        {
+            mantissa = mantissa * 10 + ( *cp - '0' );
+
+            if( mantissa )
+                ++digits;
+        }
+        else
+        {
+            ++exponent;
+            truncated |= *cp != '0';
+        }
+    }
+
+    if( *cp == '.' )
+    {
+        for( ++cp; isDecimalDigit( *cp ); ++cp )
+        {
+            anyDigit = true;
+
+            if( digits < 19 )
+            {
+                mantissa = mantissa * 10 + ( *cp - '0' );
+                --exponent;
+
+                if( mantissa )
+                    ++digits;
+            }
+            else
+            {
+                truncated |= *cp != '0';
+            }
+        }
+    }
+
+    if( !anyDigit )
+    {
+        if( aEnd )
+            *aEnd = aText;
+
+        return 0.0;
+    }
+
+    if( *cp == 'e' || *cp == 'E' )
+    {
+        // the exponent is used only if it has digits, like strtod() does
+        const char* ep = cp + 1;
+        bool        negativeExp = false;
+
+        if( *ep == '-' || *ep == '+' )
+            negativeExp = *ep++ == '-';
+
+        if( isDecimalDigit( *ep ) )
+        {
+            int exp = 0;
+
+            for( ; isDecimalDigit( *ep ); ++ep )
+            {
+                if( exp < 100000 )
+                    exp = exp * 10 + ( *ep - '0' );
+            }
+
+            exponent += negativeExp ? -exp : exp;
+            cp = ep;
+        }
+    }
+
+    if( aEnd )
+        *aEnd = cp;
+
+    if( mantissa == 0 && !truncated )
+        return negative ? -0.0 : 0.0;
+
+    // Both the mantissa and the power of ten are exact doubles here, so a single
+    // multiplication or division gives the correctly rounded result.
+    if( !truncated && mantissa <= ( (uint64_t) 1 << 53 ) && exponent >= -22 && exponent <= 22 )
+    {
+        double value = (double) mantissa;
+
+        if( exponent < 0 )
+            value /= exactPowersOf10[-exponent];
+        else
+            value *= exactPowersOf10[exponent];
+
+        return negative ? -value : value;
+    }
+
+    // Rare numbers having too many digits or a big exponent: let the C++ library
+    // round them, in the classic locale.
+    std::istringstream  stream( std::string( start, cp - start ) );
+    double              value = 0.0;
+
+    stream.imbue( std::locale::classic() );
+    stream >> value;
+
+    if( stream.fail() )
+    {
+        // overflow or underflow, return the same as strtod()
+        errno = ERANGE;
+
+        if( fabs( value ) > 1.0 )
+            value = negative ? -HUGE_VAL : HUGE_VAL;
+    }
+
+    return value;
+}
+
+
 char* GetLine( FILE* File, char* Line, int* LineNum, int SizeLine )
 {
     do {
@@ -33,10 +33,11 @@
 #include <gal/definitions.h>
 #include <gal/graphics_abstraction_layer.h>
 #include <painter.h>
-
-#ifdef PROFILE
 #include <profile.h>
-#endif /* PROFILE  */
+
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif /* USE_OPENMP */
 
 using namespace KIGFX;
 
@@ -49,6 +50,8 @@ VIEW::VIEW( bool aIsDynamic ) :
 {
     m_needsUpdate.reserve( 32768 );
 
+    ResetStats();
+
     // Redraw everything at the beginning
     MarkDirty();
 
@@ -63,6 +66,8 @@ VIEW::VIEW( bool aIsDynamic ) :
 
 VIEW::~VIEW()
 {
+    clearCacheWorkers();
+
     BOOST_FOREACH( LAYER_MAP::value_type& l, m_layers )
         delete l.second.items;
 }
@@ -138,6 +143,9 @@ void VIEW::Remove( VIEW_ITEM* aItem )
             m_gal->DeleteGroup( prevGroup );
     }
 
+    if( m_lodProxies.erase( aItem ) )
+        deleteLodProxy( aItem );
+
     aItem->deleteGroups();
 }
 
@@ -247,6 +255,9 @@ void VIEW::CopySettings( const VIEW* aOtherView )
 
 void VIEW::SetGAL( GAL* aGal )
 {
+    // cache workers are specific to the GAL that created them
+    clearCacheWorkers();
+
     m_gal = aGal;
 
     // clear group numbers, so everything is going to be recached
@@ -403,6 +414,9 @@ void VIEW::UpdateLayerColor( int aLayer )
     updateItemsColor visitor( aLayer, m_painter, m_gal );
     m_layers[aLayer].items->Query( r, visitor );
     MarkTargetDirty( m_layers[aLayer].target );
+
+    // LOD proxies take colors of the items they represent, so they have to be recreated
+    clearLodProxies();
 }
 
 
@@ -424,6 +438,7 @@ void VIEW::UpdateAllLayersColor()
         l->items->Query( r, visitor );
     }
 
+    clearLodProxies();
     MarkDirty();
 }
 
@@ -551,6 +566,7 @@ void VIEW::UpdateAllLayersOrder()
         ChangeLayerDepth( l.first, l.second.renderingOrder );
     }
 
+    clearLodProxies();
     MarkDirty();
 }
 
@@ -558,25 +574,51 @@ void VIEW::UpdateAllLayersOrder()
 struct VIEW::drawItem
 {
     drawItem( VIEW* aView, int aLayer ) :
-        view( aView ), layer( aLayer )
+        view( aView ), layer( aLayer ), pixelSize( std::fabs( aView->ToWorld( 1.0 ) ) )
     {
     }
 
     bool operator()( VIEW_ITEM* aItem )
     {
         // Conditions that have te be fulfilled for an item to be drawn
-        bool drawCondition = aItem->isRenderable() &&
-                             aItem->ViewGetLOD( layer ) < view->m_scale;
-        if( !drawCondition )
+        if( !aItem->isRenderable() )
+            return true;
+
+        if( aItem->ViewGetLOD( layer ) >= view->m_scale )
+        {
+            view->m_stats.culledItems[layer]++;
             return true;
+        }
+
+        int minSize = aItem->ViewGetMinScreenSize( layer );
+
+        if( minSize > 0 )
+        {
+            const BOX2I bbox = aItem->ViewBBox();
+
+            // The item is too small to be seen, draw its proxy instead (if there is any)
+            if( std::max( bbox.GetWidth(), bbox.GetHeight() ) < minSize * pixelSize )
+            {
+                view->m_stats.culledItems[layer]++;
+                VIEW_ITEM* proxy = aItem->ViewGetLODProxy( layer );
+
+                if( proxy && proxy->isRenderable() )
+                    proxies.insert( LOD_PROXY_MAP::value_type( proxy, aItem ) );
+
+                return true;
+            }
+        }
 
         view->draw( aItem, layer );
+        view->m_stats.drawnItems[layer]++;
 
         return true;
     }
 
     VIEW* view;
     int layer, layers[VIEW_MAX_LAYERS];
+    double pixelSize;           ///< size of a single pixel in world units
+    LOD_PROXY_MAP proxies;      ///< proxies of the items that were too small to be drawn
 };
 
 
@@ -591,11 +633,69 @@ void VIEW::redrawRect( const BOX2I& aRect )
             m_gal->SetTarget( l->target );
             m_gal->SetLayerDepth( l->renderingOrder );
             l->items->Query( aRect, drawFunc );
+
+            BOOST_FOREACH( const LOD_PROXY_MAP::value_type& proxy, drawFunc.proxies )
+                drawLodProxy( proxy.first, proxy.second, l->id );
+        }
+    }
+}
+
+
+void VIEW::drawLodProxy( VIEW_ITEM* aProxy, VIEW_ITEM* aItem, int aLayer )
+{
+    const BOX2I   bbox  = aProxy->ViewBBox();
+    const COLOR4D color = m_painter->GetSettings()->GetColor( aItem, aLayer );
+    int group = -1;
+
+    if( IsCached( aLayer ) )
+    {
+        group = aProxy->getGroup( lodProxyKey( aLayer ) );
+
+        if( group >= 0 )
+        {
+            m_gal->DrawGroup( group );
+            return;
+        }
+
+        group = m_gal->BeginGroup();
+        aProxy->setGroup( lodProxyKey( aLayer ), group );
+        m_lodProxies.insert( aProxy );
+    }
+
+    m_gal->SetIsStroke( false );
+    m_gal->SetIsFill( true );
+    m_gal->SetFillColor( color );
+    m_gal->DrawRectangle( VECTOR2D( bbox.GetOrigin() ), VECTOR2D( bbox.GetEnd() ) );
+
+    if( group >= 0 )
+        m_gal->EndGroup();
+}
+
+
+void VIEW::deleteLodProxy( VIEW_ITEM* aProxy )
+{
+    for( int i = 0; i < aProxy->m_groupsSize; ++i )
+    {
+        VIEW_ITEM::GroupPair& group = aProxy->m_groups[i];
+
+        if( group.first >= VIEW_MAX_LAYERS && group.second >= 0 )
+        {
+            m_gal->DeleteGroup( group.second );
+            group.second = -1;
         }
     }
 }
 
 
+void VIEW::clearLodProxies()
+{
+    BOOST_FOREACH( VIEW_ITEM* proxy, m_lodProxies )
+        deleteLodProxy( proxy );
+
+    m_lodProxies.clear();
+}
+
+
 void VIEW::draw( VIEW_ITEM* aItem, int aLayer, bool aImmediate )
 {
     if( IsCached( aLayer ) && !aImmediate )
@@ -724,6 +824,7 @@ void VIEW::Clear()
 
     m_gal->ClearCache();
     m_needsUpdate.clear();
+    m_lodProxies.clear();
 }
 
 
@@ -748,10 +849,11 @@ void VIEW::ClearTargets()
 
 void VIEW::Redraw()
 {
-#ifdef PROFILE
     prof_counter totalRealTime;
     prof_start( &totalRealTime );
-#endif /* PROFILE */
+
+    std::fill( m_stats.drawnItems, m_stats.drawnItems + VIEW_MAX_LAYERS, 0 );
+    std::fill( m_stats.culledItems, m_stats.culledItems + VIEW_MAX_LAYERS, 0 );
 
     VECTOR2D screenSize = m_gal->GetScreenPixelSize();
     BOX2I    rect( ToWorld( VECTOR2D( 0, 0 ) ),
@@ -765,9 +867,13 @@ void VIEW::Redraw()
     markTargetClean( TARGET_NONCACHED );
     markTargetClean( TARGET_OVERLAY );
 
-#ifdef PROFILE
     prof_end( &totalRealTime );
 
+    m_stats.frames++;
+    m_stats.lastRedrawTime = totalRealTime.usecs();
+    m_stats.redrawTime += totalRealTime.usecs();
+
+#ifdef PROFILE
     wxLogDebug( wxT( "Redraw: %.1f ms" ), totalRealTime.msecs() );
 #endif /* PROFILE */
 }
@@ -809,6 +915,9 @@ void VIEW::clearGroupCache()
         VIEW_LAYER* l = &( ( *i ).second );
         l->items->Query( r, visitor );
     }
+
+    // Group ids were dropped together with the rest of the cache
+    m_lodProxies.clear();
 }
 
 
@@ -820,6 +929,24 @@ void VIEW::invalidateItem( VIEW_ITEM* aItem, int aUpdateFlags )
     else if( aUpdateFlags & VIEW_ITEM::GEOMETRY )
         updateBbox( aItem );
 
+    // Cached LOD proxies covering the item may not match its new shape or color anymore
+    if( m_lodProxies.erase( aItem ) )
+        deleteLodProxy( aItem );
+
+    if( aUpdateFlags & ( VIEW_ITEM::GEOMETRY | VIEW_ITEM::LAYERS | VIEW_ITEM::COLOR ) )
+    {
+        int layers[VIEW_MAX_LAYERS], layers_count;
+        aItem->ViewGetLayers( layers, layers_count );
+
+        for( int i = 0; i < layers_count; ++i )
+        {
+            VIEW_ITEM* proxy = aItem->ViewGetLODProxy( layers[i] );
+
+            if( proxy && m_lodProxies.erase( proxy ) )
+                deleteLodProxy( proxy );
+        }
+    }
+
     int layers[VIEW_MAX_LAYERS], layers_count;
     aItem->ViewGetLayers( layers, layers_count );
 
@@ -979,10 +1106,126 @@ void VIEW::RecacheAllItems( bool aImmediately )
 
     r.SetMaximum();
 
-#ifdef PROFILE
     prof_counter totalRealTime;
     prof_start( &totalRealTime );
+
+    clearLodProxies();
+
+    // Drawing items takes most of the time, so it is split between threads when possible
+    if( !aImmediately || !recacheParallel() )
+    {
+        for( LAYER_MAP_ITER i = m_layers.begin(); i != m_layers.end(); ++i )
+        {
+            VIEW_LAYER* l = &( ( *i ).second );
+
+            if( IsCached( l->id ) )
+            {
+                m_gal->SetTarget( l->target );
+                m_gal->SetLayerDepth( l->renderingOrder );
+                recacheItem visitor( this, m_gal, l->id, aImmediately );
+                l->items->Query( r, visitor );
+                MarkTargetDirty( l->target );
+            }
+        }
+    }
+
+    prof_end( &totalRealTime );
+
+    m_stats.recacheCalls++;
+    m_stats.recacheTime += totalRealTime.usecs();
+
+#ifdef PROFILE
+    wxLogDebug( wxT( "RecacheAllItems::immediately: %u %.1f ms" ),
+                aImmediately, totalRealTime.msecs() );
 #endif /* PROFILE */
+}
+
+
+///> Item to be drawn to the GAL cache by one of threads
+struct CACHE_JOB
+{
+    VIEW_ITEM*  item;
+    int         layer;
+    int         depth;
+    int         worker;     ///< Index of the thread that has drawn the item
+    int         group;      ///< Group number in the worker, -1 if the painter could not draw it
+};
+
+
+struct VIEW::collectCacheJobs
+{
+    collectCacheJobs( GAL* aGal, int aLayer, int aDepth, std::vector<CACHE_JOB>& aJobs ) :
+        gal( aGal ), layer( aLayer ), depth( aDepth ), jobs( aJobs )
+    {
+    }
+
+    bool operator()( VIEW_ITEM* aItem )
+    {
+        // Remove previously cached group
+        int group = aItem->getGroup( layer );
+
+        if( group >= 0 )
+            gal->DeleteGroup( group );
+
+        aItem->setGroup( layer, -1 );
+
+        CACHE_JOB job = { aItem, layer, depth, -1, -1 };
+        jobs.push_back( job );
+
+        return true;
+    }
+
+    GAL* gal;
+    int layer, depth;
+    std::vector<CACHE_JOB>& jobs;
+};
+
+
+bool VIEW::recacheParallel()
+{
+#ifdef USE_OPENMP
+    const int threads = omp_get_max_threads();
+
+    if( threads < 2 )
+        return false;
+
+    // GALs and painters keep drawing state, so every thread needs its own pair.
+    // They are kept for the next recache, as creating a GAL loads the stroke font.
+    if( (int) m_cacheWorkers.size() != threads )
+    {
+        clearCacheWorkers();
+
+        for( int i = 0; i < threads; ++i )
+        {
+            GAL* worker = m_gal->CreateCacheWorker();
+            PAINTER* painter = worker ? m_painter->Clone( worker ) : NULL;
+
+            if( !painter )
+            {
+                delete worker;
+                clearCacheWorkers();
+                return false;
+            }
+
+            m_cacheWorkers.push_back( worker );
+            m_cachePainters.push_back( painter );
+        }
+    }
+    else
+    {
+        // Forget the groups of the previous recache, and follow the view and
+        // display settings changes
+        for( int i = 0; i < threads; ++i )
+        {
+            m_gal->ResetCacheWorker( m_cacheWorkers[i] );
+            m_cachePainters[i]->ApplySettings( m_painter->GetSettings() );
+        }
+    }
+
+    std::vector<CACHE_JOB> jobs;
+    BOX2I r;
+
+    r.SetMaximum();
 
     for( LAYER_MAP_ITER i = m_layers.begin(); i != m_layers.end(); ++i )
     {
@@ -990,25 +1233,85 @@ void VIEW::RecacheAllItems( bool aImmediately )
 
         if( IsCached( l->id ) )
         {
-            m_gal->SetTarget( l->target );
-            m_gal->SetLayerDepth( l->renderingOrder );
-            recacheItem visitor( this, m_gal, l->id, aImmediately );
+            collectCacheJobs visitor( m_gal, l->id, l->renderingOrder, jobs );
             l->items->Query( r, visitor );
             MarkTargetDirty( l->target );
         }
     }
 
-#ifdef PROFILE
-    prof_end( &totalRealTime );
+    // Tessellate items to private buffers of the workers
+    #pragma omp parallel for schedule(dynamic, 64)
+    for( int i = 0; i < (int) jobs.size(); ++i )
+    {
+        CACHE_JOB& job = jobs[i];
+        int thread = omp_get_thread_num();
+        GAL* gal = m_cacheWorkers[thread];
 
-    wxLogDebug( wxT( "RecacheAllItems::immediately: %u %.1f ms" ),
-                aImmediately, totalRealTime.msecs() );
-#endif /* PROFILE */
+        gal->SetLayerDepth( job.depth );
+        int group = gal->BeginGroup();
+
+        if( m_cachePainters[thread]->Draw( job.item, job.layer ) )
+        {
+            job.worker = thread;
+            job.group  = group;
+        }
+
+        gal->EndGroup();
+    }
+
+    // Move the results to the cache, keeping the original order of items
+    m_gal->SetTarget( TARGET_CACHED );
+
+    for( unsigned int i = 0; i < jobs.size(); ++i )
+    {
+        const CACHE_JOB& job = jobs[i];
+        int group;
+
+        if( job.group >= 0 )
+        {
+            group = m_gal->MergeCacheGroup( m_cacheWorkers[job.worker], job.group );
+        }
+        else
+        {
+            // Items unknown to the painter are drawn by themselves, in this thread
+            m_gal->SetLayerDepth( job.depth );
+            group = m_gal->BeginGroup();
+            job.item->ViewDraw( job.layer, m_gal );
+            m_gal->EndGroup();
+        }
+
+        job.item->setGroup( job.layer, group );
+    }
+
+    // The tessellated items are not needed any more
+    for( unsigned int i = 0; i < m_cacheWorkers.size(); ++i )
+        m_gal->ResetCacheWorker( m_cacheWorkers[i] );
+
+    return true;
+#else
+    return false;
+#endif /* USE_OPENMP */
+}
+
+
+void VIEW::clearCacheWorkers()
+{
+    for( unsigned int i = 0; i < m_cacheWorkers.size(); ++i )
+    {
+        delete m_cachePainters[i];
+        delete m_cacheWorkers[i];
+    }
+
+    m_cacheWorkers.clear();
+    m_cachePainters.clear();
 }
 
 
 void VIEW::UpdateItems()
 {
+    prof_counter totalRealTime;
+    prof_start( &totalRealTime );
+
     // Update items that need this
     BOOST_FOREACH( VIEW_ITEM* item, m_needsUpdate )
     {
@@ -1017,10 +1320,32 @@ void VIEW::UpdateItems()
         invalidateItem( item, item->viewRequiredUpdate() );
     }
 
+    prof_end( &totalRealTime );
+
+    m_stats.updateCalls++;
+    m_stats.updatedItems += m_needsUpdate.size();
+    m_stats.updateTime += totalRealTime.usecs();
+
     m_needsUpdate.clear();
 }
 
 
+void VIEW::ResetStats()
+{
+    m_stats.frames          = 0;
+    m_stats.redrawTime      = 0;
+    m_stats.lastRedrawTime  = 0;
+    m_stats.recacheCalls    = 0;
+    m_stats.recacheTime     = 0;
+    m_stats.updateCalls     = 0;
+    m_stats.updatedItems    = 0;
+    m_stats.updateTime      = 0;
+
+    std::fill( m_stats.drawnItems, m_stats.drawnItems + VIEW_MAX_LAYERS, 0 );
+    std::fill( m_stats.culledItems, m_stats.culledItems + VIEW_MAX_LAYERS, 0 );
+}
+
+
 struct VIEW::extentsVisitor
 {
     BOX2I extents;
@@ -52,6 +52,7 @@ void SCH_EDIT_FRAME::DeleteAnnotation( bool aCurrentSheetOnly )
     {
         SCH_SCREENS ScreenList;
         ScreenList.ClearAnnotation();
+        m_foundItems.SetForceSearch();
     }
 
     // Update the references for the sheet that is currently being displayed.
@@ -178,6 +179,9 @@ void SCH_EDIT_FRAME::AnnotateComponents( bool              aAnnotateSchematic,
 
     OnModify();
 
+    // The references of all the sheets can have been changed.
+    m_foundItems.SetForceSearch();
+
     // Update on screen references, that can be modified by previous calculations:
     m_CurrentSheet->UpdateAllScreenReferences();
     SetSheetNumberAndCount();
@@ -125,7 +125,10 @@ void SCH_EDIT_FRAME::backAnnotateFootprints( const std::string& aChangedSetOfRef
     }
 
     if( isChanged )
+    {
         OnModify();
+        m_foundItems.SetForceSearch();
+    }
 }
 
 
@@ -260,5 +263,6 @@ bool SCH_EDIT_FRAME::LoadCmpToFootprintLinkFile()
     }
 
     OnModify();
+    m_foundItems.SetForceSearch();
     return true;
 }
@@ -32,6 +32,8 @@
 #define _CLASS_NETLIST_OBJECT_H_
 
 
+#include <boost/unordered_map.hpp>
+
 #include <sch_sheet_path.h>
 #include <lib_pin.h>      // LIB_PIN::PinStringNum( m_PinNum )
 
@@ -261,12 +263,51 @@ public:
  */
 class NETLIST_OBJECT_LIST : public std::vector <NETLIST_OBJECT*>
 {
+    /**
+     * Struct SHEET_ITEM_KEY
+     * what the connections between the items of a sheet depend on.
+     */
+    struct SHEET_ITEM_KEY
+    {
+        NETLIST_ITEM_T  m_Type;
+        wxPoint         m_Start;
+        wxPoint         m_End;
+
+        bool operator==( const SHEET_ITEM_KEY& aKey ) const
+        {
+            return m_Type == aKey.m_Type && m_Start == aKey.m_Start && m_End == aKey.m_End;
+        }
+    };
+
+    /**
+     * Struct SHEET_CONNECTIONS
+     * the net codes given by connectSheetItems() to the items of a sheet, numbered
+     * from 1, to give them again to the same items without searching the connections.
+     */
+    struct SHEET_CONNECTIONS
+    {
+        std::vector<SHEET_ITEM_KEY> m_Keys;         // the items, in list order
+        std::vector<int>            m_NetCodes;     // net code of each item, or 0
+        std::vector<int>            m_BusNetCodes;  // bus net code of each item, or 0
+        int                         m_NetCodeCount;
+        int                         m_BusNetCodeCount;
+        bool                        m_Used;         // used by the last BuildNetListInfo()
+    };
+
+    typedef boost::unordered_map< const SCH_SCREEN*, std::vector<SHEET_CONNECTIONS> >
+        SHEET_CONNECTIONS_MAP;
+
     bool m_isOwner;         // = true if the objects in list are owned my me, and therefore
                             // the memory should be freed by the destructor and the list cleared
     int m_lastNetCode;      // Used in intermediate calculation: last net code created
     int m_lastBusNetCode;   // Used in intermediate calculation:
                             // last net code created for bus members
 
+    /// The connections of the sheets found by the last BuildNetListInfo(), by screen
+    /// (a screen has more than one entry when its instances have different items,
+    /// like different units of a component).
+    SHEET_CONNECTIONS_MAP m_sheetConnections;
+
 public:
     /**
      * Constructor.
@@ -294,6 +335,9 @@ public:
      * the master function of tgis class.
      * Build the list of connected objects (pins, labels ...) and
      * all info to generate netlists or run ERC diags
+     * The connections found inside each sheet are kept: a sheet whose items did not
+     * change since the previous call is not searched again, only the connections
+     * between sheets (labels, hierarchical pins) are.
      * @param aSheets = the flattened sheet list
      * @return true if OK, false is not item found
      */
@@ -390,8 +434,26 @@ private:
      * Propagate aNewNetCode to items having an internal netcode aOldNetCode
      * used to interconnect group of items already physically connected,
      * when a new connection is found between aOldNetCode and aNewNetCode
+     * Only items from index aIdxStart to aIdxEnd - 1 can have the net code aOldNetCode
+     */
+    void propageNetCode( int aOldNetCode, int aNewNetCode, bool aIsBus,
+                         unsigned aIdxStart, unsigned aIdxEnd );
+
+    /**
+     * Function connectSheet
+     * gives net codes to the items of a sheet, from index aIdxStart to aIdxEnd - 1,
+     * from their physical connections (wires, junctions ...).  The net codes given the
+     * last time to the same items of \a aScreen are reused if any, otherwise they are
+     * searched by connectSheetItems() and kept.
+     */
+    void connectSheet( const SCH_SCREEN* aScreen, unsigned aIdxStart, unsigned aIdxEnd );
+
+    /**
+     * Function connectSheetItems
+     * searches the physical connections between the items of a sheet, from index
+     * aIdxStart to aIdxEnd - 1, and gives them new net codes.
      */
-    void propageNetCode( int aOldNetCode, int aNewNetCode, bool aIsBus );
+    void connectSheetItems( unsigned aIdxStart, unsigned aIdxEnd );
 
     /*
      * This function merges the net codes of groups of objects already connected
@@ -420,16 +482,18 @@ private:
      */
     void sheetLabelConnect( NETLIST_OBJECT* aSheetLabel );
 
-    void pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus, int start );
+    void pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus,
+                              unsigned aIdxStart, unsigned aIdxEnd );
 
     /*
      * Search connections betweena junction and segments
      * Propagate the junction net code to objects connected by this junction.
      * The junction must have a valid net code
      * The list of objects is expected sorted by sheets.
-     * Search is done from index aIdxStart to the last element of list
+     * Search is done from index aIdxStart to aIdxEnd - 1, the items of the sheet
      */
-    void segmentToPointConnect( NETLIST_OBJECT* aJonction, bool aIsBus, int aIdxStart );
+    void segmentToPointConnect( NETLIST_OBJECT* aJonction, bool aIsBus,
+                                unsigned aIdxStart, unsigned aIdxEnd );
 
     void connectBusLabels();
 
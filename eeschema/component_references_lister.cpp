@@ -250,38 +250,69 @@ int SCH_REFERENCE_LIST::GetLastReference( int aIndex, int aMinValue )
 }
 
 
-int SCH_REFERENCE_LIST::CreateFirstFreeRefId( std::vector<int>& aIdList, int aFirstValue )
+/// @return a key of \a aText: texts are equal for Cmp_KEEPCASE() if they have the same key
+static wxString keepCaseKey( const wxString& aText )
 {
-    int expectedId = aFirstValue;
+#ifdef KICAD_KEEPCASE
+    return aText;
+#else
+    return aText.Lower();
+#endif
+}
 
-    // We search for expected Id a value >= aFirstValue.
-    // Skip existing Id < aFirstValue
-    unsigned ii = 0;
 
-    for( ; ii < aIdList.size(); ii++ )
+void SCH_REFERENCE_LIST::PREFIX_NUMBERS::StartGroup( int aFirstValue )
+{
+    for( unsigned ii = 0; ii < m_FreedNumRefs.size(); ii++ )
     {
-        if( expectedId <= aIdList[ii] )
-            break;
+        std::map<int, int>::iterator it = m_NumRefs.find( m_FreedNumRefs[ii] );
+
+        if( --it->second == 0 )
+            m_NumRefs.erase( it );
     }
 
-    // Ids are sorted by increasing value, from aFirstValue
-    // So we search from aFirstValue the first not used value, i.e. the first hole in list.
-    for( ; ii < aIdList.size(); ii++ )
+    m_FreedNumRefs.clear();
+    m_FirstFreeId = aFirstValue;
+}
+
+
+int SCH_REFERENCE_LIST::CreateFirstFreeRefId( PREFIX_NUMBERS& aNumbers )
+{
+    // Numbers are only added to m_NumRefs inside a group, so the first free number
+    // can only increase.
+    while( aNumbers.m_NumRefs.count( aNumbers.m_FirstFreeId ) )
+        aNumbers.m_FirstFreeId++;
+
+    return aNumbers.m_FirstFreeId;
+}
+
+
+void SCH_REFERENCE_LIST::setAnnotation( PREFIX_NUMBERS_MAP& aPrefixes, SCH_REFERENCE& aItem,
+                                        int aNumRef, int aUnit, bool aIsNew )
+{
+    PREFIX_NUMBERS& numbers = aPrefixes[aItem.m_Ref];
+
+    if( !aItem.m_IsNew )
     {
-        if( expectedId != aIdList[ii] )    // This id is not yet used.
-        {
-            // Insert this free Id, in order to keep list sorted
-            aIdList.insert( aIdList.begin() + ii, expectedId );
-            return expectedId;
-        }
+        std::map<std::pair<int, int>, int>::iterator it =
+            numbers.m_Units.find( std::make_pair( aItem.m_NumRef, aItem.m_Unit ) );
+
+        if( --it->second == 0 )
+            numbers.m_Units.erase( it );
+    }
 
-        expectedId++;
+    if( aNumRef != aItem.m_NumRef )
+    {
+        numbers.m_NumRefs[aNumRef]++;
+        numbers.m_FreedNumRefs.push_back( aItem.m_NumRef );
     }
 
-    // All existing Id are tested, and all values are found in use.
-    // So Create a new one.
-    aIdList.push_back( expectedId );
-    return expectedId;
+    aItem.m_NumRef = aNumRef;
+    aItem.m_Unit   = aUnit;
+    aItem.m_IsNew  = aIsNew;
+
+    if( !aIsNew )
+        numbers.m_Units[ std::make_pair( aNumRef, aUnit ) ]++;
 }
 
 
@@ -297,6 +328,49 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId,
     // Components with an invisible reference (power...) always are re-annotated.
     ResetHiddenReferences();
 
+    // Index the list, instead of searching it for each component:
+    // the reference numbers in use and the annotated units, by prefix,
+    PREFIX_NUMBERS_MAP prefixes;
+
+    // the components by instance (component and sheet path),
+    typedef std::pair<SCH_COMPONENT*, wxString> INSTANCE_KEY;
+    std::map<INSTANCE_KEY, std::vector<unsigned> > instances;
+
+    // and the components by reference prefix, value and library name.
+    typedef std::pair<std::string, std::pair<wxString, wxString> > UNIT_KEY;
+    std::map<UNIT_KEY, std::vector<unsigned> > units;
+
+    for( unsigned ii = 0; ii < componentFlatList.size(); ii++ )
+    {
+        SCH_REFERENCE&  item = componentFlatList[ii];
+        PREFIX_NUMBERS& numbers = prefixes[item.m_Ref];
+
+        numbers.m_NumRefs[item.m_NumRef]++;
+
+        if( !item.m_IsNew )
+            numbers.m_Units[ std::make_pair( item.m_NumRef, item.m_Unit ) ]++;
+
+        instances[ INSTANCE_KEY( item.GetComp(), item.GetSheetPath().Path() ) ].push_back( ii );
+        units[ UNIT_KEY( item.m_Ref, std::make_pair( keepCaseKey( item.m_Value->GetText() ),
+                         keepCaseKey( item.m_RootCmp->GetPartName() ) ) ) ].push_back( ii );
+    }
+
+    // The locked lists by instance: the first list of the map having the instance.
+    std::map<INSTANCE_KEY, SCH_REFERENCE_LIST*> lockedInstances;
+
+    BOOST_FOREACH( SCH_MULTI_UNIT_REFERENCE_MAP::value_type& pair, aLockedUnitMap )
+    {
+        unsigned n_refs = pair.second.GetCount();
+        for( unsigned thisRefI = 0; thisRefI < n_refs; ++thisRefI )
+        {
+            SCH_REFERENCE &thisRef = pair.second[thisRefI];
+
+            lockedInstances.insert( std::make_pair(
+                INSTANCE_KEY( thisRef.GetComp(), thisRef.GetSheetPath().Path() ),
+                &pair.second ) );
+        }
+    }
+
     /* calculate index of the first component with the same reference prefix
      * than the current component.  All components having the same reference
      * prefix will receive a reference number with consecutive values:
@@ -320,10 +394,9 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId,
     if( aUseSheetNum )
         minRefId = componentFlatList[first].m_SheetNum * aSheetIntervalId + 1;
 
-    // This is the list of all Id already in use for a given reference prefix.
-    // Will be refilled for each new reference prefix.
-    std::vector<int>idList;
-    GetRefsInUse( first, idList, minRefId );
+    // This is the list of all Id already in use for the current reference prefix.
+    PREFIX_NUMBERS* idList = &prefixes[componentFlatList[first].m_Ref];
+    idList->StartGroup( minRefId );
 #endif
     for( unsigned ii = 0; ii < componentFlatList.size(); ii++ )
     {
@@ -332,21 +405,12 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId,
 
         // Check whether this component is in aLockedUnitMap.
         SCH_REFERENCE_LIST* lockedList = NULL;
-        BOOST_FOREACH( SCH_MULTI_UNIT_REFERENCE_MAP::value_type& pair, aLockedUnitMap )
-        {
-            unsigned n_refs = pair.second.GetCount();
-            for( unsigned thisRefI = 0; thisRefI < n_refs; ++thisRefI )
-            {
-                SCH_REFERENCE &thisRef = pair.second[thisRefI];
+        std::map<INSTANCE_KEY, SCH_REFERENCE_LIST*>::iterator locked =
+            lockedInstances.find( INSTANCE_KEY( componentFlatList[ii].GetComp(),
+                                                componentFlatList[ii].GetSheetPath().Path() ) );
 
-                if( thisRef.IsSameInstance( componentFlatList[ii] ) )
-                {
-                    lockedList = &pair.second;
-                    break;
-                }
-            }
-            if( lockedList != NULL ) break;
-        }
+        if( locked != lockedInstances.end() )
+            lockedList = locked->second;
 
         if(  ( componentFlatList[first].CompareRef( componentFlatList[ii] ) != 0 )
           || ( aUseSheetNum && ( componentFlatList[first].m_SheetNum != componentFlatList[ii].m_SheetNum ) )  )
@@ -368,26 +432,28 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId,
             if( aUseSheetNum )
                 minRefId = componentFlatList[ii].m_SheetNum * aSheetIntervalId + 1;
 
-            GetRefsInUse( first, idList, minRefId );
+            idList = &prefixes[componentFlatList[first].m_Ref];
+            idList->StartGroup( minRefId );
 #endif
         }
 
         // Annotation of one part per package components (trivial case).
         if( componentFlatList[ii].GetLibComponent()->GetUnitCount() <= 1 )
         {
+            int numRef = componentFlatList[ii].m_NumRef;
+
             if( componentFlatList[ii].m_IsNew )
             {
 #ifdef USE_OLD_ALGO
                 LastReferenceNumber++;
 #else
-                LastReferenceNumber = CreateFirstFreeRefId( idList, minRefId );
+                LastReferenceNumber = CreateFirstFreeRefId( *idList );
 #endif
-                componentFlatList[ii].m_NumRef = LastReferenceNumber;
+                numRef = LastReferenceNumber;
             }
 
-            componentFlatList[ii].m_Unit  = 1;
+            setAnnotation( prefixes, componentFlatList[ii], numRef, 1, false );
             componentFlatList[ii].m_Flag  = 1;
-            componentFlatList[ii].m_IsNew = false;
             continue;
         }
 
@@ -399,13 +465,14 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId,
 #ifdef USE_OLD_ALGO
             LastReferenceNumber++;
 #else
-            LastReferenceNumber = CreateFirstFreeRefId( idList, minRefId );
+            LastReferenceNumber = CreateFirstFreeRefId( *idList );
 #endif
-            componentFlatList[ii].m_NumRef = LastReferenceNumber;
+            int unit = componentFlatList[ii].m_Unit;
 
             if( !componentFlatList[ii].IsUnitsLocked() )
-                componentFlatList[ii].m_Unit = 1;
+                unit = 1;
 
+            setAnnotation( prefixes, componentFlatList[ii], LastReferenceNumber, unit, true );
             componentFlatList[ii].m_Flag = 1;
         }
 
@@ -420,21 +487,31 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId,
                 if( thisRef.IsSameInstance( componentFlatList[ii] ) )
                 {
                     // This is the component we're currently annotating. Hold the unit!
-                    componentFlatList[ii].m_Unit = thisRef.m_Unit;
+                    setAnnotation( prefixes, componentFlatList[ii],
+                                   componentFlatList[ii].m_NumRef, thisRef.m_Unit,
+                                   componentFlatList[ii].m_IsNew );
                 }
 
                 if( thisRef.CompareValue( componentFlatList[ii] ) != 0 ) continue;
                 if( thisRef.CompareLibName( componentFlatList[ii] ) != 0 ) continue;
 
                 // Find the matching component
-                for( unsigned jj = ii + 1; jj < componentFlatList.size(); jj++ )
+                std::map<INSTANCE_KEY, std::vector<unsigned> >::iterator instance =
+                    instances.find( INSTANCE_KEY( thisRef.GetComp(),
+                                                  thisRef.GetSheetPath().Path() ) );
+
+                if( instance == instances.end() )
+                    continue;
+
+                std::vector<unsigned>&          candidates = instance->second;
+                std::vector<unsigned>::iterator jj = std::upper_bound( candidates.begin(),
+                                                                       candidates.end(), ii );
+
+                if( jj != candidates.end() )
                 {
-                    if( ! thisRef.IsSameInstance( componentFlatList[jj] ) ) continue;
-                    componentFlatList[jj].m_NumRef = componentFlatList[ii].m_NumRef;
-                    componentFlatList[jj].m_Unit = thisRef.m_Unit;
-                    componentFlatList[jj].m_IsNew = false;
-                    componentFlatList[jj].m_Flag = 1;
-                    break;
+                    setAnnotation( prefixes, componentFlatList[*jj],
+                                   componentFlatList[ii].m_NumRef, thisRef.m_Unit, false );
+                    componentFlatList[*jj].m_Flag = 1;
                 }
             }
         }
@@ -445,42 +522,41 @@ void SCH_REFERENCE_LIST::Annotate( bool aUseSheetNum, int aSheetIntervalId,
             * we search for others parts that have the same value and the same
             * reference prefix (ref without ref number)
             */
+            SCH_REFERENCE&         ref = componentFlatList[ii];
+            PREFIX_NUMBERS&        numbers = prefixes[ref.m_Ref];
+            std::vector<unsigned>& candidates = units[ UNIT_KEY( ref.m_Ref,
+                std::make_pair( keepCaseKey( ref.m_Value->GetText() ),
+                                keepCaseKey( ref.m_RootCmp->GetPartName() ) ) ) ];
+
             for( Unit = 1; Unit <= NumberOfUnits; Unit++ )
             {
                 if( componentFlatList[ii].m_Unit == Unit )
                     continue;
 
-                int found = FindUnit( ii, Unit );
-
-                if( found >= 0 )
-                    continue; // this unit exists for this reference (unit already annotated)
+                // this unit exists for this reference (unit already annotated)
+                if( numbers.m_Units.count( std::make_pair( ref.m_NumRef, Unit ) ) )
+                    continue;
 
                 // Search a component to annotate ( same prefix, same value, not annotated)
-                for( unsigned jj = ii + 1; jj < componentFlatList.size(); jj++ )
-                {
-                    if( componentFlatList[jj].m_Flag )    // already tested
-                        continue;
+                std::vector<unsigned>::iterator jj = std::upper_bound( candidates.begin(),
+                                                                       candidates.end(), ii );
 
-                    if( componentFlatList[ii].CompareRef( componentFlatList[jj] ) != 0 )
-                        continue;
-
-                    if( componentFlatList[jj].CompareValue( componentFlatList[ii] ) != 0 )
-                        continue;
+                for( ; jj != candidates.end(); ++jj )
+                {
+                    SCH_REFERENCE& candidate = componentFlatList[*jj];
 
-                    if( componentFlatList[jj].CompareLibName( componentFlatList[ii] ) != 0 )
+                    if( candidate.m_Flag )    // already tested
                         continue;
 
-                    if( !componentFlatList[jj].m_IsNew )
+                    if( !candidate.m_IsNew )
                         continue;
 
                     // Component without reference number found, annotate it if possible
-                    if( !componentFlatList[jj].IsUnitsLocked()
-                        || ( componentFlatList[jj].m_Unit == Unit ) )
+                    if( !candidate.IsUnitsLocked() || ( candidate.m_Unit == Unit ) )
                     {
-                        componentFlatList[jj].m_NumRef = componentFlatList[ii].m_NumRef;
-                        componentFlatList[jj].m_Unit   = Unit;
-                        componentFlatList[jj].m_Flag   = 1;
-                        componentFlatList[jj].m_IsNew  = false;
+                        setAnnotation( prefixes, candidate, componentFlatList[ii].m_NumRef,
+                                       Unit, false );
+                        candidate.m_Flag = 1;
                         break;
                     }
                 }
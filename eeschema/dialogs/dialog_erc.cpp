@@ -475,6 +475,7 @@ void DIALOG_ERC::TestErc( wxArrayString* aMessagesList )
     unsigned nextNet = lastNet = 0;
     int NetNbItems = 0;
     int MinConn    = NOC;
+    ERC_PIN_INDEX pinIndex( objectsConnectedList );
 
     for( unsigned net = 0; net < objectsConnectedList->size(); net++ )
     {
@@ -525,7 +526,7 @@ void DIALOG_ERC::TestErc( wxArrayString* aMessagesList )
         case NET_PIN:
 
             // Look for ERC problems between pins:
-            TestOthersItems( objectsConnectedList, net, nextNet, &NetNbItems, &MinConn );
+            TestOthersItems( &pinIndex, net, nextNet, &NetNbItems, &MinConn );
             break;
         }
 
@@ -176,43 +176,51 @@ int TestDuplicateSheetNames( bool aCreateMarker )
 {
     SCH_SCREEN* screen;
     SCH_ITEM*   item;
-    SCH_ITEM*   test_item;
     int         err_count = 0;
     SCH_SCREENS screenList;      // Created the list of screen
 
+    typedef std::vector<SCH_SHEET*> SHEETS;
+
     for( screen = screenList.GetFirst(); screen != NULL; screen = screenList.GetNext() )
     {
+        // The sheets of the screen grouped by name (not case sensitive), and for each
+        // sheet its group and its rank in the group.
+        boost::unordered_map<wxString, SHEETS, WXSTRING_HASH> sheetsByName;
+        std::vector< std::pair<SHEETS*, unsigned> > sheetGroups;
+
         for( item = screen->GetDrawItems(); item != NULL; item = item->Next() )
         {
-            // search for a sheet;
             if( item->Type() != SCH_SHEET_T )
                 continue;
 
-            for(  test_item = item->Next(); test_item != NULL; test_item = test_item->Next() )
-            {
-                if( test_item->Type() != SCH_SHEET_T )
-                    continue;
+            SHEETS* group = &sheetsByName[ ( (SCH_SHEET*) item )->GetName().Lower() ];
+            sheetGroups.push_back( std::make_pair( group, (unsigned) group->size() ) );
+            group->push_back( (SCH_SHEET*) item );
+        }
 
-                // We have found a second sheet: compare names
-                if( ( (SCH_SHEET*) item )->GetName().CmpNoCase(
-                        ( ( SCH_SHEET* ) test_item )->GetName() ) == 0 )
+        // Each sheet is compared to the next ones: a sheet gets an error for each
+        // previous sheet with the same name.
+        for( unsigned ii = 0; ii < sheetGroups.size(); ii++ )
+        {
+            const SHEETS& group = *sheetGroups[ii].first;
+
+            for( unsigned jj = sheetGroups[ii].second + 1; jj < group.size(); jj++ )
+            {
+                if( aCreateMarker )
                 {
-                    if( aCreateMarker )
-                    {
-                        /* Create a new marker type ERC error*/
-                        SCH_MARKER* marker = new SCH_MARKER();
-                        marker->SetTimeStamp( GetNewTimeStamp() );
-                        marker->SetData( ERCE_DUPLICATE_SHEET_NAME,
-                                         ( (SCH_SHEET*) test_item )->GetPosition(),
-                                         _( "Duplicate sheet name" ),
-                                         ( (SCH_SHEET*) test_item )->GetPosition() );
-                        marker->SetMarkerType( MARK_ERC );
-                        marker->SetErrorLevel( ERR );
-                        screen->Append( marker );
-                    }
-
-                    err_count++;
+                    /* Create a new marker type ERC error*/
+                    SCH_MARKER* marker = new SCH_MARKER();
+                    marker->SetTimeStamp( GetNewTimeStamp() );
+                    marker->SetData( ERCE_DUPLICATE_SHEET_NAME,
+                                     group[jj]->GetPosition(),
+                                     _( "Duplicate sheet name" ),
+                                     group[jj]->GetPosition() );
+                    marker->SetMarkerType( MARK_ERC );
+                    marker->SetErrorLevel( ERR );
+                    screen->Append( marker );
                 }
+
+                err_count++;
             }
         }
     }
@@ -354,139 +362,213 @@ void Diagnose( NETLIST_OBJECT* aNetItemRef, NETLIST_OBJECT* aNetItemTst,
 }
 
 
-void TestOthersItems( NETLIST_OBJECT_LIST* aList,
-                      unsigned aNetItemRef, unsigned aNetStart,
-                      int* aNetNbItems, int* aMinConnexion )
+ERC_PIN_INDEX::ERC_PIN_INDEX( NETLIST_OBJECT_LIST* aList ) :
+    m_list( aList ),
+    m_netStart( 0 ),
+    m_netEnd( 0 ),
+    m_hasNoConnect( false ),
+    m_pinCounts( PIN_NMAX, 0 ),
+    m_instancesIndexed( false )
 {
-    unsigned netItemTst = aNetStart;
-    int jj;
-    int erc = OK;
+}
 
-    /* Analysis of the table of connections. */
-    int ref_elect_type = aList->GetItem( aNetItemRef )->m_ElectricalType;
+
+void ERC_PIN_INDEX::SelectNet( unsigned aNetStart )
+{
+    if( aNetStart == m_netStart && m_netEnd > m_netStart )
+        return;
+
+    int net = m_list->GetItemNet( aNetStart );
+
+    for( m_netEnd = aNetStart + 1; m_netEnd < m_list->size(); m_netEnd++ )
+    {
+        if( m_list->GetItemNet( m_netEnd ) != net )
+            break;
+    }
+
+    m_netStart = aNetStart;
+    m_hasNoConnect = false;
+    m_pinCounts.assign( PIN_NMAX, 0 );
+    m_pinRanks.assign( m_netEnd - m_netStart, 0 );
+
+    std::vector<unsigned> pins;
+
+    for( unsigned item = m_netStart; item < m_netEnd; item++ )
+    {
+        if( m_list->GetItemType( item ) == NET_NOCONNECT )
+            m_hasNoConnect = true;
+
+        if( m_list->GetItemType( item ) != NET_PIN )
+            continue;
+
+        m_pinRanks[item - m_netStart] = pins.size();
+        m_pinCounts[ m_list->GetItem( item )->m_ElectricalType ]++;
+        pins.push_back( item );
+    }
+
+    // Built from the last pin: the row of a rank is the row of the next rank, but for
+    // the type of the pin of this rank.
+    m_nextPins.resize( ( pins.size() + 1 ) * PIN_NMAX );
+    std::fill( m_nextPins.end() - PIN_NMAX, m_nextPins.end(), (unsigned) m_list->size() );
+
+    for( int rank = int( pins.size() ) - 1; rank >= 0; rank-- )
+    {
+        unsigned* row = &m_nextPins[rank * PIN_NMAX];
+
+        std::copy( row + PIN_NMAX, row + 2 * PIN_NMAX, row );
+        row[ m_list->GetItem( pins[rank] )->m_ElectricalType ] = pins[rank];
+    }
+}
+
+
+int ERC_PIN_INDEX::GetMinConnection( unsigned aPin ) const
+{
+    int ref_elect_type = m_list->GetItem( aPin )->m_ElectricalType;
     int local_minconn = NOC;
 
     if( ref_elect_type == PIN_NC )
         local_minconn = NPI;
 
-    /* Test pins connected to NetItemRef */
-    for( ; ; netItemTst++ )
+    if( m_hasNoConnect )
+        local_minconn = std::max( NET_NC, local_minconn );
+
+    for( int jj = 0; jj < PIN_NMAX; jj++ )
     {
-        if( aNetItemRef == netItemTst )
-            continue;
+        int count = m_pinCounts[jj];
 
-        // We examine only a given net. We stop the search if the net changes
-        if( ( netItemTst >= aList->size() ) // End of list
-            || ( aList->GetItemNet( aNetItemRef ) !=
-                 aList->GetItemNet( netItemTst ) ) ) // End of net
-        {
-            /* End net code found: minimum connection test. */
-            if( ( *aMinConnexion < NET_NC ) && ( local_minconn < NET_NC ) )
-            {
-                /* Not connected or not driven pin. */
-                bool seterr = true;
+        if( jj == ref_elect_type )
+            count--;        // aPin itself
 
-                if( local_minconn == NOC &&
-                    aList->GetItemType( aNetItemRef ) == NET_PIN )
-                {
-                    /* This pin is not connected: for multiple part per
-                     * package, and duplicated pin,
-                     * search for an other instance of this pin
-                     * this will be flagged only if all instances of this pin
-                     * are not connected
-                     * TODO test also if instances connected are connected to
-                     * the same net
-                     */
-                    for( unsigned duplicate = 0; duplicate < aList->size(); duplicate++ )
-                    {
-                        if( aList->GetItemType( duplicate ) != NET_PIN )
-                            continue;
-
-                        if( duplicate == aNetItemRef )
-                            continue;
-
-                        if( aList->GetItem( aNetItemRef )->m_PinNum !=
-                            aList->GetItem( duplicate )->m_PinNum )
-                            continue;
-
-                        if( ( (SCH_COMPONENT*) aList->GetItem( aNetItemRef )->
-                             m_Link )->GetRef( &aList->GetItem( aNetItemRef )-> m_SheetPath ) !=
-                            ( (SCH_COMPONENT*) aList->GetItem( duplicate )->m_Link )
-                           ->GetRef( &aList->GetItem( duplicate )->m_SheetPath ) )
-                            continue;
-
-                        // Same component and same pin. Do dot create error for this pin
-                        // if the other pin is connected (i.e. if duplicate net has an other
-                        // item)
-                        if( (duplicate > 0)
-                          && ( aList->GetItemNet( duplicate ) ==
-                               aList->GetItemNet( duplicate - 1 ) ) )
-                            seterr = false;
-
-                        if( (duplicate < aList->size() - 1)
-                          && ( aList->GetItemNet( duplicate ) ==
-                               aList->GetItemNet( duplicate + 1 ) ) )
-                            seterr = false;
-                    }
-                }
+        if( count > 0 )
+            local_minconn = std::max( MinimalReq[ref_elect_type][jj], local_minconn );
+    }
 
-                if( seterr )
-                    Diagnose( aList->GetItem( aNetItemRef ), NULL, local_minconn, WAR );
+    return local_minconn;
+}
 
-                *aMinConnexion = DRV;   // inhibiting other messages of this
-                                       // type for the net.
-            }
-            return;
-        }
 
-        switch( aList->GetItemType( netItemTst ) )
+int ERC_PIN_INDEX::GetPinCountAfter( unsigned aPin ) const
+{
+    unsigned pinCount = m_nextPins.size() / PIN_NMAX - 1;
+
+    return pinCount - m_pinRanks[aPin - m_netStart] - 1;
+}
+
+
+unsigned ERC_PIN_INDEX::GetFirstConflict( unsigned aPin ) const
+{
+    int             ref_elect_type = m_list->GetItem( aPin )->m_ElectricalType;
+    const unsigned* next = &m_nextPins[( m_pinRanks[aPin - m_netStart] + 1 ) * PIN_NMAX];
+    unsigned        conflict = m_list->size();
+
+    for( int jj = 0; jj < PIN_NMAX; jj++ )
+    {
+        if( DiagErc[ref_elect_type][jj] != OK )
+            conflict = std::min( next[jj], conflict );
+    }
+
+    return conflict;
+}
+
+
+bool ERC_PIN_INDEX::isConnected( unsigned aItem ) const
+{
+    if( aItem > 0 && m_list->GetItemNet( aItem ) == m_list->GetItemNet( aItem - 1 ) )
+        return true;
+
+    if( aItem < m_list->size() - 1
+      && m_list->GetItemNet( aItem ) == m_list->GetItemNet( aItem + 1 ) )
+        return true;
+
+    return false;
+}
+
+
+wxString ERC_PIN_INDEX::instanceKey( unsigned aPin ) const
+{
+    NETLIST_OBJECT* pin = m_list->GetItem( aPin );
+    wxString        key = pin->GetComponentParent()->GetRef( &pin->m_SheetPath );
+
+    key << wxT( '\t' ) << pin->m_PinNum;
+
+    return key;
+}
+
+
+bool ERC_PIN_INDEX::IsOtherInstanceConnected( unsigned aPin )
+{
+    if( !m_instancesIndexed )
+    {
+        for( unsigned item = 0; item < m_list->size(); item++ )
         {
-        case NET_ITEM_UNSPECIFIED:
-        case NET_SEGMENT:
-        case NET_BUS:
-        case NET_JUNCTION:
-        case NET_LABEL:
-        case NET_HIERLABEL:
-        case NET_BUSLABELMEMBER:
-        case NET_HIERBUSLABELMEMBER:
-        case NET_SHEETBUSLABELMEMBER:
-        case NET_SHEETLABEL:
-        case NET_GLOBLABEL:
-        case NET_GLOBBUSLABELMEMBER:
-        case NET_PINLABEL:
-            break;
+            if( m_list->GetItemType( item ) == NET_PIN
+              && m_list->GetItem( item )->GetComponentParent() && isConnected( item ) )
+                m_connectedInstances[ instanceKey( item ) ]++;
+        }
 
-        case NET_NOCONNECT:
-            local_minconn = std::max( NET_NC, local_minconn );
-            break;
+        m_instancesIndexed = true;
+    }
 
-        case NET_PIN:
-            jj = aList->GetItem( netItemTst )->m_ElectricalType;
-            local_minconn = std::max( MinimalReq[ref_elect_type][jj], local_minconn );
+    if( !m_list->GetItem( aPin )->GetComponentParent() )
+        return false;
 
-            if( netItemTst <= aNetItemRef )
-                break;
+    boost::unordered_map<wxString, int, WXSTRING_HASH>::const_iterator it =
+        m_connectedInstances.find( instanceKey( aPin ) );
 
-            *aNetNbItems += 1;
+    if( it == m_connectedInstances.end() )
+        return false;
 
-            if( erc == OK )
-            {
-                erc = DiagErc[ref_elect_type][jj];
+    return it->second > ( isConnected( aPin ) ? 1 : 0 );
+}
 
-                if( erc != OK )
-                {
-                    if( aList->GetConnectionType( netItemTst ) == UNCONNECTED )
-                    {
-                        Diagnose( aList->GetItem( aNetItemRef ),
-                                  aList->GetItem( netItemTst ),
-                                  0, erc );
-                        aList->SetConnectionType( netItemTst, NOCONNECT_SYMBOL_PRESENT );
-                    }
-                }
-            }
 
-            break;
+void TestOthersItems( ERC_PIN_INDEX* aPinIndex,
+                      unsigned aNetItemRef, unsigned aNetStart,
+                      int* aNetNbItems, int* aMinConnexion )
+{
+    NETLIST_OBJECT_LIST* list = aPinIndex->GetList();
+
+    aPinIndex->SelectNet( aNetStart );
+
+    /* Test pins connected to NetItemRef: only the pins after NetItemRef are counted,
+     * and only the first of them in conflict with NetItemRef is diagnosed.
+     */
+    *aNetNbItems += aPinIndex->GetPinCountAfter( aNetItemRef );
+
+    unsigned netItemTst = aPinIndex->GetFirstConflict( aNetItemRef );
+
+    if( netItemTst < list->size() && list->GetConnectionType( netItemTst ) == UNCONNECTED )
+    {
+        int ref_elect_type = list->GetItem( aNetItemRef )->m_ElectricalType;
+        int jj = list->GetItem( netItemTst )->m_ElectricalType;
+
+        Diagnose( list->GetItem( aNetItemRef ), list->GetItem( netItemTst ),
+                  0, DiagErc[ref_elect_type][jj] );
+        list->SetConnectionType( netItemTst, NOCONNECT_SYMBOL_PRESENT );
+    }
+
+    /* Minimum connection test. */
+    int local_minconn = aPinIndex->GetMinConnection( aNetItemRef );
+
+    if( ( *aMinConnexion < NET_NC ) && ( local_minconn < NET_NC ) )
+    {
+        /* Not connected or not driven pin. */
+        bool seterr = true;
+
+        if( local_minconn == NOC && list->GetItemType( aNetItemRef ) == NET_PIN )
+        {
+            /* This pin is not connected: for multiple part per package, and duplicated
+             * pin, this will be flagged only if all instances of this pin are not
+             * connected.
+             * TODO test also if instances connected are connected to the same net
+             */
+            seterr = !aPinIndex->IsOtherInstanceConnected( aNetItemRef );
         }
+
+        if( seterr )
+            Diagnose( list->GetItem( aNetItemRef ), NULL, local_minconn, WAR );
+
+        *aMinConnexion = DRV;   // inhibiting other messages of this type for the net.
     }
 }
 
@@ -30,6 +30,9 @@
 #ifndef _ERC_H
 #define _ERC_H
 
+#include <vector>
+#include <hashtables.h>
+
 
 class EDA_DRAW_PANEL;
 class NETLIST_OBJECT;
@@ -82,11 +85,82 @@ extern bool WriteDiagnosticERC( const wxString& aFullFileName );
 extern void Diagnose( NETLIST_OBJECT* NetItemRef, NETLIST_OBJECT* NetItemTst,
                       int MinConnexion, int Diag );
 
+/**
+ * Class ERC_PIN_INDEX
+ * indexes the pins of a NETLIST_OBJECT_LIST sorted by net, for TestOthersItems().
+ * The pins of a net are gathered by electrical type once, when the net is selected,
+ * and the instances of the component pins (multiple parts per package) once for the
+ * whole list, when first needed.  So the ERC of a net is linear in its item count,
+ * instead of scanning the net for each of its pins, and the whole list for each
+ * unconnected pin.
+ */
+class ERC_PIN_INDEX
+{
+public:
+    ERC_PIN_INDEX( NETLIST_OBJECT_LIST* aList );
+
+    NETLIST_OBJECT_LIST* GetList() const { return m_list; }
+
+    /**
+     * Function SelectNet
+     * gathers the pins of the net starting at item \a aNetStart, if it is not the
+     * current net.
+     */
+    void SelectNet( unsigned aNetStart );
+
+    /**
+     * Function GetMinConnection
+     * @return the connection state of the current net seen from its pin \a aPin (see
+     *  MinimalReq): NOC if no other pin nor no connect symbol is in the net.
+     */
+    int GetMinConnection( unsigned aPin ) const;
+
+    /// @return the count of pins after \a aPin in the current net
+    int GetPinCountAfter( unsigned aPin ) const;
+
+    /**
+     * Function GetFirstConflict
+     * @return the first pin after \a aPin in the current net, whose electrical type is
+     *  not OK with the type of \a aPin (see DiagErc), or the list size if there is none.
+     */
+    unsigned GetFirstConflict( unsigned aPin ) const;
+
+    /**
+     * Function IsOtherInstanceConnected
+     * @return true if an other instance of \a aPin (same pin number of a component with
+     *  the same reference) is connected to an item.
+     */
+    bool IsOtherInstanceConnected( unsigned aPin );
+
+private:
+    /// @return true if \a aItem is not alone in its net
+    bool isConnected( unsigned aItem ) const;
+
+    /// @return the key of the instances of \a aPin in m_connectedInstances
+    wxString instanceKey( unsigned aPin ) const;
+
+    NETLIST_OBJECT_LIST*  m_list;
+    unsigned              m_netStart;       ///< first item of the current net
+    unsigned              m_netEnd;         ///< item after the current net
+    bool                  m_hasNoConnect;   ///< the current net has a no connect symbol
+    std::vector<int>      m_pinCounts;      ///< pin count of the current net, by type
+    std::vector<unsigned> m_pinRanks;       ///< rank of the pins, by item of the current net
+
+    /// by pin rank and electrical type: the first pin of this type from this rank
+    std::vector<unsigned> m_nextPins;
+
+    bool                  m_instancesIndexed;
+
+    /// count of the connected instances of the component pins, by instanceKey()
+    boost::unordered_map<wxString, int, WXSTRING_HASH> m_connectedInstances;
+};
+
 /**
  * Perform ERC testing for electrical conflicts between \a NetItemRef and other items
  * on the same net.
+ * @param aPinIndex = the index of the list of items.
  */
-extern void TestOthersItems( NETLIST_OBJECT_LIST* aList,
+extern void TestOthersItems( ERC_PIN_INDEX* aPinIndex,
                              unsigned aNetItemRef, unsigned aNetStart,
                              int* aNetNbItems, int* aMinConnexion );
 
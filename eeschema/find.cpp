@@ -356,6 +356,13 @@ void SCH_EDIT_FRAME::OnFindReplace( wxFindDialogEvent& aEvent )
 
     if( aEvent.GetEventType() == wxEVT_COMMAND_FIND_REPLACE_ALL )
     {
+        // The items are replaced in one pass, and only the last replaced item is shown.
+        SCH_FIND_COLLECTOR_DATA lastData;
+        wxString                lastText;
+        SCH_SHEET_PATH          initialSheet = *m_CurrentSheet;
+
+        sheet = NULL;
+
         while( ( item = (SCH_ITEM*) m_foundItems.GetItem( data ) ) != NULL )
         {
             SCH_ITEM* undoItem = data.GetParent();
@@ -364,17 +371,26 @@ void SCH_EDIT_FRAME::OnFindReplace( wxFindDialogEvent& aEvent )
             if( undoItem == NULL )
                 undoItem = item;
 
-            SetUndoItem( undoItem );
+            // The found items are grouped by sheet.
+            if( sheet == NULL || sheet->PathHumanReadable() != data.GetSheetPath() )
+            {
+                sheet = schematic.GetSheet( data.GetSheetPath() );
 
-            sheet = schematic.GetSheet( data.GetSheetPath() );
+                wxCHECK_RET( sheet != NULL,
+                             wxT( "Could not find sheet path " ) + data.GetSheetPath() );
 
-            wxCHECK_RET( sheet != NULL, wxT( "Could not find sheet path " ) + data.GetSheetPath() );
+                // The undo commands are saved in the current screen.
+                setFindReplaceSheet( sheet );
+            }
+
+            SetUndoItem( undoItem );
 
             if( m_foundItems.ReplaceItem( sheet ) )
             {
                 OnModify();
                 SaveUndoItemInUndoList( undoItem );
-                updateFindReplaceView( aEvent );
+                lastData = data;
+                lastText = m_foundItems.GetText();
             }
 
             m_foundItems.IncrementIndex();
@@ -382,6 +398,25 @@ void SCH_EDIT_FRAME::OnFindReplace( wxFindDialogEvent& aEvent )
             if( m_foundItems.PassedEnd() )
                 break;
         }
+
+        if( !lastText.IsEmpty() )
+        {
+            sheet = schematic.GetSheet( lastData.GetSheetPath() );
+
+            wxCHECK_RET( sheet != NULL,
+                         wxT( "Could not find sheet path " ) + lastData.GetSheetPath() );
+
+            setFindReplaceSheet( sheet );
+            SetCrossHairPosition( lastData.GetPosition() );
+            RedrawScreen( lastData.GetPosition(), !( aEvent.GetFlags() & FR_NO_WARP_CURSOR ) );
+            SetStatusText( lastText );
+        }
+        else if( m_CurrentSheet->PathHumanReadable() != initialSheet.PathHumanReadable() )
+        {
+            // Nothing was replaced, go back to the sheet shown before the search
+            *m_CurrentSheet = initialSheet;
+            DisplayCurrentSheet();
+        }
     }
     else
     {
@@ -418,6 +453,18 @@ void SCH_EDIT_FRAME::OnFindReplace( wxFindDialogEvent& aEvent )
 }
 
 
+void SCH_EDIT_FRAME::setFindReplaceSheet( SCH_SHEET_PATH* aSheet )
+{
+    if( aSheet->PathHumanReadable() != m_CurrentSheet->PathHumanReadable() )
+    {
+        aSheet->LastScreen()->SetZoom( GetScreen()->GetZoom() );
+        *m_CurrentSheet = *aSheet;
+        m_CurrentSheet->UpdateAllScreenReferences();
+        SetScreen( aSheet->LastScreen() );
+    }
+}
+
+
 void SCH_EDIT_FRAME::updateFindReplaceView( wxFindDialogEvent& aEvent )
 {
     wxString                msg;
@@ -447,13 +494,7 @@ void SCH_EDIT_FRAME::updateFindReplaceView( wxFindDialogEvent& aEvent )
                 item->SetForceVisible( true );
         }
 
-        if( sheet->PathHumanReadable() != m_CurrentSheet->PathHumanReadable() )
-        {
-            sheet->LastScreen()->SetZoom( GetScreen()->GetZoom() );
-            *m_CurrentSheet = *sheet;
-            m_CurrentSheet->UpdateAllScreenReferences();
-            SetScreen( sheet->LastScreen() );
-        }
+        setFindReplaceSheet( sheet );
 
         // careful here
         SetCrossHairPosition( data.GetPosition() );
@@ -366,6 +366,7 @@ bool SCH_EDIT_FRAME::RescueCacheConflicts( bool aRunningOnDemand )
             GetScreen()->SchematicCleanUp( NULL, &dc );
             m_canvas->Refresh( true );
             OnModify();
+            m_foundItems.SetForceSearch();
 
             return true;
         }
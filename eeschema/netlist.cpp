@@ -159,6 +159,13 @@ NETLIST_OBJECT_LIST * SCH_EDIT_FRAME::BuildNetListBase()
 }
 
 
+// Comparison function to sort the sheets of the hierarchy by path
+static bool sortSheetsByPath( const SCH_SHEET_PATH* aSheet1, const SCH_SHEET_PATH* aSheet2 )
+{
+    return aSheet1->Cmp( *aSheet2 ) < 0;
+}
+
+
 bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
 {
     s_NetObjectslist.SetOwner( true );
@@ -166,122 +173,63 @@ bool NETLIST_OBJECT_LIST::BuildNetListInfo( SCH_SHEET_LIST& aSheets )
 
     SCH_SHEET_PATH* sheet;
 
-    // Fill list with connected items from the flattened sheet list
+    // Sort sheets by path, so the list of objects is sorted by sheet, and the
+    // objects of a sheet are in the drawing order.
+    std::vector<SCH_SHEET_PATH*> sheets;
+
     for( sheet = aSheets.GetFirst(); sheet != NULL;
          sheet = aSheets.GetNext() )
-    {
-        for( SCH_ITEM* item = sheet->LastScreen()->GetDrawItems(); item; item = item->Next() )
-        {
-            item->GetNetListItem( *this, sheet );
-        }
-    }
+        sheets.push_back( sheet );
 
-    if( size() == 0 )
-        return false;
+    std::sort( sheets.begin(), sheets.end(), sortSheetsByPath );
 
-    // Sort objects by Sheet
-    SortListbySheet();
+    SHEET_CONNECTIONS_MAP::iterator it;
+
+    for( it = m_sheetConnections.begin(); it != m_sheetConnections.end(); ++it )
+    {
+        for( unsigned ii = 0; ii < it->second.size(); ii++ )
+            it->second[ii].m_Used = false;
+    }
 
-    sheet = &(GetItem( 0 )->m_SheetPath);
     m_lastNetCode = m_lastBusNetCode = 1;
 
-    for( unsigned ii = 0, istart = 0; ii < size(); ii++ )
+    // Fill list with connected items from the flattened sheet list,
+    // and connect the items of each sheet
+    for( unsigned ii = 0; ii < sheets.size(); ii++ )
     {
-        NETLIST_OBJECT* net_item = GetItem( ii );
+        SCH_SCREEN* screen = sheets[ii]->LastScreen();
+        unsigned    istart = size();
 
-        if( net_item->m_SheetPath != *sheet )   // Sheet change
+        for( SCH_ITEM* item = screen->GetDrawItems(); item; item = item->Next() )
         {
-            sheet  = &(net_item->m_SheetPath);
-            istart = ii;
+            item->GetNetListItem( *this, sheets[ii] );
         }
 
-        switch( net_item->m_Type )
-        {
-        case NET_ITEM_UNSPECIFIED:
-            wxMessageBox( wxT( "BuildNetListBase() error" ) );
-            break;
-
-        case NET_PIN:
-        case NET_PINLABEL:
-        case NET_SHEETLABEL:
-        case NET_NOCONNECT:
-            if( net_item->GetNet() != 0 )
-                break;
-
-        case NET_SEGMENT:
-            // Test connections point to point type without bus.
-            if( net_item->GetNet() == 0 )
-            {
-                net_item->SetNet( m_lastNetCode );
-                m_lastNetCode++;
-            }
-
-            pointToPointConnect( net_item, IS_WIRE, istart );
-            break;
-
-        case NET_JUNCTION:
-            // Control of the junction outside BUS.
-            if( net_item->GetNet() == 0 )
-            {
-                net_item->SetNet( m_lastNetCode );
-                m_lastNetCode++;
-            }
-
-            segmentToPointConnect( net_item, IS_WIRE, istart );
-
-            // Control of the junction, on BUS.
-            if( net_item->m_BusNetCode == 0 )
-            {
-                net_item->m_BusNetCode = m_lastBusNetCode;
-                m_lastBusNetCode++;
-            }
-
-            segmentToPointConnect( net_item, IS_BUS, istart );
-            break;
-
-        case NET_LABEL:
-        case NET_HIERLABEL:
-        case NET_GLOBLABEL:
-            // Test connections type junction without bus.
-            if( net_item->GetNet() == 0 )
-            {
-                net_item->SetNet( m_lastNetCode );
-                m_lastNetCode++;
-            }
-
-            segmentToPointConnect( net_item, IS_WIRE, istart );
-            break;
-
-        case NET_SHEETBUSLABELMEMBER:
-            if( net_item->m_BusNetCode != 0 )
-                break;
-
-        case NET_BUS:
-            // Control type connections point to point mode bus
-            if( net_item->m_BusNetCode == 0 )
-            {
-                net_item->m_BusNetCode = m_lastBusNetCode;
-                m_lastBusNetCode++;
-            }
-
-            pointToPointConnect( net_item, IS_BUS, istart );
-            break;
+        connectSheet( screen, istart, size() );
+    }
 
-        case NET_BUSLABELMEMBER:
-        case NET_HIERBUSLABELMEMBER:
-        case NET_GLOBBUSLABELMEMBER:
-            // Control connections similar has on BUS
-            if( net_item->GetNet() == 0 )
-            {
-                net_item->m_BusNetCode = m_lastBusNetCode;
-                m_lastBusNetCode++;
-            }
+    // Forget the connections of modified and deleted sheets
+    for( it = m_sheetConnections.begin(); it != m_sheetConnections.end(); )
+    {
+        std::vector<SHEET_CONNECTIONS>& connections = it->second;
 
-            segmentToPointConnect( net_item, IS_BUS, istart );
-            break;
+        for( unsigned ii = 0; ii < connections.size(); )
+        {
+            if( connections[ii].m_Used )
+                ii++;
+            else
+                connections.erase( connections.begin() + ii );
         }
+
+        if( connections.empty() )
+            it = m_sheetConnections.erase( it );
+        else
+            ++it;
     }
 
+    if( size() == 0 )
+        return false;
+
 #if defined(NETLIST_DEBUG) && defined(DEBUG)
     std::cout << "\n\nafter sheet local\n\n";
     DumpNetTable();
@@ -564,6 +512,171 @@ void NETLIST_OBJECT_LIST::findBestNetNameForEachNet()
 }
 
 
+void NETLIST_OBJECT_LIST::connectSheet( const SCH_SCREEN* aScreen,
+                                        unsigned aIdxStart, unsigned aIdxEnd )
+{
+    std::vector<SHEET_ITEM_KEY> keys( aIdxEnd - aIdxStart );
+
+    for( unsigned ii = aIdxStart; ii < aIdxEnd; ii++ )
+    {
+        SHEET_ITEM_KEY& key = keys[ii - aIdxStart];
+
+        key.m_Type  = GetItem( ii )->m_Type;
+        key.m_Start = GetItem( ii )->m_Start;
+        key.m_End   = GetItem( ii )->m_End;
+    }
+
+    std::vector<SHEET_CONNECTIONS>& screenConnections = m_sheetConnections[aScreen];
+
+    for( unsigned jj = 0; jj < screenConnections.size(); jj++ )
+    {
+        SHEET_CONNECTIONS& connections = screenConnections[jj];
+
+        if( connections.m_Keys != keys )
+            continue;
+
+        // Same items as the last time: give the same net codes
+        for( unsigned ii = aIdxStart; ii < aIdxEnd; ii++ )
+        {
+            NETLIST_OBJECT* net_item = GetItem( ii );
+            int             netCode = connections.m_NetCodes[ii - aIdxStart];
+            int             busNetCode = connections.m_BusNetCodes[ii - aIdxStart];
+
+            net_item->SetNet( netCode ? netCode + m_lastNetCode - 1 : 0 );
+            net_item->m_BusNetCode = busNetCode ? busNetCode + m_lastBusNetCode - 1 : 0;
+        }
+
+        m_lastNetCode += connections.m_NetCodeCount;
+        m_lastBusNetCode += connections.m_BusNetCodeCount;
+        connections.m_Used = true;
+        return;
+    }
+
+    int firstNetCode = m_lastNetCode;
+    int firstBusNetCode = m_lastBusNetCode;
+
+    connectSheetItems( aIdxStart, aIdxEnd );
+
+    screenConnections.push_back( SHEET_CONNECTIONS() );
+
+    SHEET_CONNECTIONS& connections = screenConnections.back();
+
+    connections.m_Keys.swap( keys );
+    connections.m_NetCodes.resize( aIdxEnd - aIdxStart );
+    connections.m_BusNetCodes.resize( aIdxEnd - aIdxStart );
+
+    for( unsigned ii = aIdxStart; ii < aIdxEnd; ii++ )
+    {
+        NETLIST_OBJECT* net_item = GetItem( ii );
+
+        // All the net codes of the items are created by connectSheetItems()
+        connections.m_NetCodes[ii - aIdxStart] =
+            net_item->GetNet() ? net_item->GetNet() - firstNetCode + 1 : 0;
+        connections.m_BusNetCodes[ii - aIdxStart] =
+            net_item->m_BusNetCode ? net_item->m_BusNetCode - firstBusNetCode + 1 : 0;
+    }
+
+    connections.m_NetCodeCount = m_lastNetCode - firstNetCode;
+    connections.m_BusNetCodeCount = m_lastBusNetCode - firstBusNetCode;
+    connections.m_Used = true;
+}
+
+
+void NETLIST_OBJECT_LIST::connectSheetItems( unsigned aIdxStart, unsigned aIdxEnd )
+{
+    for( unsigned ii = aIdxStart; ii < aIdxEnd; ii++ )
+    {
+        NETLIST_OBJECT* net_item = GetItem( ii );
+
+        switch( net_item->m_Type )
+        {
+        case NET_ITEM_UNSPECIFIED:
+            wxMessageBox( wxT( "BuildNetListBase() error" ) );
+            break;
+
+        case NET_PIN:
+        case NET_PINLABEL:
+        case NET_SHEETLABEL:
+        case NET_NOCONNECT:
+            if( net_item->GetNet() != 0 )
+                break;
+
+        case NET_SEGMENT:
+            // Test connections point to point type without bus.
+            if( net_item->GetNet() == 0 )
+            {
+                net_item->SetNet( m_lastNetCode );
+                m_lastNetCode++;
+            }
+
+            pointToPointConnect( net_item, IS_WIRE, aIdxStart, aIdxEnd );
+            break;
+
+        case NET_JUNCTION:
+            // Control of the junction outside BUS.
+            if( net_item->GetNet() == 0 )
+            {
+                net_item->SetNet( m_lastNetCode );
+                m_lastNetCode++;
+            }
+
+            segmentToPointConnect( net_item, IS_WIRE, aIdxStart, aIdxEnd );
+
+            // Control of the junction, on BUS.
+            if( net_item->m_BusNetCode == 0 )
+            {
+                net_item->m_BusNetCode = m_lastBusNetCode;
+                m_lastBusNetCode++;
+            }
+
+            segmentToPointConnect( net_item, IS_BUS, aIdxStart, aIdxEnd );
+            break;
+
+        case NET_LABEL:
+        case NET_HIERLABEL:
+        case NET_GLOBLABEL:
+            // Test connections type junction without bus.
+            if( net_item->GetNet() == 0 )
+            {
+                net_item->SetNet( m_lastNetCode );
+                m_lastNetCode++;
+            }
+
+            segmentToPointConnect( net_item, IS_WIRE, aIdxStart, aIdxEnd );
+            break;
+
+        case NET_SHEETBUSLABELMEMBER:
+            if( net_item->m_BusNetCode != 0 )
+                break;
+
+        case NET_BUS:
+            // Control type connections point to point mode bus
+            if( net_item->m_BusNetCode == 0 )
+            {
+                net_item->m_BusNetCode = m_lastBusNetCode;
+                m_lastBusNetCode++;
+            }
+
+            pointToPointConnect( net_item, IS_BUS, aIdxStart, aIdxEnd );
+            break;
+
+        case NET_BUSLABELMEMBER:
+        case NET_HIERBUSLABELMEMBER:
+        case NET_GLOBBUSLABELMEMBER:
+            // Control connections similar has on BUS
+            if( net_item->GetNet() == 0 )
+            {
+                net_item->m_BusNetCode = m_lastBusNetCode;
+                m_lastBusNetCode++;
+            }
+
+            segmentToPointConnect( net_item, IS_BUS, aIdxStart, aIdxEnd );
+            break;
+        }
+    }
+}
+
+
 void NETLIST_OBJECT_LIST::sheetLabelConnect( NETLIST_OBJECT* SheetLabel )
 {
     if( SheetLabel->GetNet() == 0 )
@@ -587,7 +700,7 @@ void NETLIST_OBJECT_LIST::sheetLabelConnect( NETLIST_OBJECT* SheetLabel )
 
         // Propagate Netcode having all the objects of the same Netcode.
         if( ObjetNet->GetNet() )
-            propageNetCode( ObjetNet->GetNet(), SheetLabel->GetNet(), IS_WIRE );
+            propageNetCode( ObjetNet->GetNet(), SheetLabel->GetNet(), IS_WIRE, 0, size() );
         else
             ObjetNet->SetNet( SheetLabel->GetNet() );
     }
@@ -626,7 +739,8 @@ void NETLIST_OBJECT_LIST::connectBusLabels()
                     if( LabelInTst->GetNet() == 0 )
                         LabelInTst->SetNet( Label->GetNet() );
                     else
-                        propageNetCode( LabelInTst->GetNet(), Label->GetNet(), IS_WIRE );
+                        propageNetCode( LabelInTst->GetNet(), Label->GetNet(), IS_WIRE,
+                                        0, size() );
                 }
             }
         }
@@ -634,14 +748,15 @@ void NETLIST_OBJECT_LIST::connectBusLabels()
 }
 
 
-void NETLIST_OBJECT_LIST::propageNetCode( int aOldNetCode, int aNewNetCode, bool aIsBus )
+void NETLIST_OBJECT_LIST::propageNetCode( int aOldNetCode, int aNewNetCode, bool aIsBus,
+                                          unsigned aIdxStart, unsigned aIdxEnd )
 {
     if( aOldNetCode == aNewNetCode )
         return;
 
     if( aIsBus == false )    // Propagate NetCode
     {
-        for( unsigned jj = 0; jj < size(); jj++ )
+        for( unsigned jj = aIdxStart; jj < aIdxEnd; jj++ )
         {
             NETLIST_OBJECT* object = GetItem( jj );
 
@@ -651,7 +766,7 @@ void NETLIST_OBJECT_LIST::propageNetCode( int aOldNetCode, int aNewNetCode, bool
     }
     else               // Propagate BusNetCode
     {
-        for( unsigned jj = 0; jj < size(); jj++ )
+        for( unsigned jj = aIdxStart; jj < aIdxEnd; jj++ )
         {
             NETLIST_OBJECT* object = GetItem( jj );
 
@@ -663,7 +778,7 @@ void NETLIST_OBJECT_LIST::propageNetCode( int aOldNetCode, int aNewNetCode, bool
 
 
 void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus,
-                                               int start )
+                                               unsigned aIdxStart, unsigned aIdxEnd )
 {
     int netCode;
 
@@ -671,13 +786,11 @@ void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus
     {
         netCode = aRef->GetNet();
 
-        for( unsigned i = start; i < size(); i++ )
+        // All the items from aIdxStart to aIdxEnd are in the sheet of aRef
+        for( unsigned i = aIdxStart; i < aIdxEnd; i++ )
         {
             NETLIST_OBJECT* item = GetItem( i );
 
-            if( item->m_SheetPath != aRef->m_SheetPath )  //used to be > (why?)
-                continue;
-
             switch( item->m_Type )
             {
             case NET_SEGMENT:
@@ -697,7 +810,7 @@ void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus
                     if( item->GetNet() == 0 )
                         item->SetNet( netCode );
                     else
-                        propageNetCode( item->GetNet(), netCode, IS_WIRE );
+                        propageNetCode( item->GetNet(), netCode, IS_WIRE, aIdxStart, aIdxEnd );
                 }
                 break;
 
@@ -715,13 +828,10 @@ void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus
     {
         netCode = aRef->m_BusNetCode;
 
-        for( unsigned i = start; i < size(); i++ )
+        for( unsigned i = aIdxStart; i < aIdxEnd; i++ )
         {
             NETLIST_OBJECT* item = GetItem( i );
 
-            if( item->m_SheetPath != aRef->m_SheetPath )
-                continue;
-
             switch( item->m_Type )
             {
             case NET_ITEM_UNSPECIFIED:
@@ -749,7 +859,7 @@ void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus
                     if( item->m_BusNetCode == 0 )
                         item->m_BusNetCode = netCode;
                     else
-                        propageNetCode( item->m_BusNetCode, netCode, IS_BUS );
+                        propageNetCode( item->m_BusNetCode, netCode, IS_BUS, aIdxStart, aIdxEnd );
                 }
                 break;
             }
@@ -758,17 +868,14 @@ void NETLIST_OBJECT_LIST::pointToPointConnect( NETLIST_OBJECT* aRef, bool aIsBus
 }
 
 
-void NETLIST_OBJECT_LIST::segmentToPointConnect( NETLIST_OBJECT* aJonction,
-                                                bool aIsBus, int aIdxStart )
+void NETLIST_OBJECT_LIST::segmentToPointConnect( NETLIST_OBJECT* aJonction, bool aIsBus,
+                                                unsigned aIdxStart, unsigned aIdxEnd )
 {
-    for( unsigned i = aIdxStart; i < size(); i++ )
+    // All the items from aIdxStart to aIdxEnd are in the sheet of aJonction
+    for( unsigned i = aIdxStart; i < aIdxEnd; i++ )
     {
         NETLIST_OBJECT* segment = GetItem( i );
 
-        // if different sheets, obviously no physical connection between elements.
-        if( segment->m_SheetPath != aJonction->m_SheetPath )
-            continue;
-
         if( aIsBus == IS_WIRE )
         {
             if( segment->m_Type != NET_SEGMENT )
@@ -786,14 +893,16 @@ void NETLIST_OBJECT_LIST::segmentToPointConnect( NETLIST_OBJECT* aJonction,
             if( aIsBus == IS_WIRE )
             {
                 if( segment->GetNet() )
-                    propageNetCode( segment->GetNet(), aJonction->GetNet(), aIsBus );
+                    propageNetCode( segment->GetNet(), aJonction->GetNet(), aIsBus,
+                                    aIdxStart, aIdxEnd );
                 else
                     segment->SetNet( aJonction->GetNet() );
             }
             else
             {
                 if( segment->m_BusNetCode )
-                    propageNetCode( segment->m_BusNetCode, aJonction->m_BusNetCode, aIsBus );
+                    propageNetCode( segment->m_BusNetCode, aJonction->m_BusNetCode, aIsBus,
+                                    aIdxStart, aIdxEnd );
                 else
                     segment->m_BusNetCode = aJonction->m_BusNetCode;
             }
@@ -837,7 +946,7 @@ void NETLIST_OBJECT_LIST::labelConnect( NETLIST_OBJECT* aLabelRef )
                 continue;
 
             if( item->GetNet() )
-                propageNetCode( item->GetNet(), aLabelRef->GetNet(), IS_WIRE );
+                propageNetCode( item->GetNet(), aLabelRef->GetNet(), IS_WIRE, 0, size() );
             else
                 item->SetNet( aLabelRef->GetNet() );
         }
@@ -88,6 +88,7 @@ void SCH_BUS_ENTRY_BASE::SwapData( SCH_ITEM* aItem )
 
     EXCHG( m_pos, item->m_pos );
     EXCHG( m_size, item->m_size );
+    geometryChanged();
 }
 
 
@@ -201,6 +202,7 @@ void SCH_BUS_ENTRY_BASE::MirrorX( int aXaxis_position )
     NEGATE(  m_pos.y );
     m_pos.y += aXaxis_position;
     NEGATE(  m_size.y );
+    geometryChanged();
 }
 
 
@@ -210,6 +212,7 @@ void SCH_BUS_ENTRY_BASE::MirrorY( int aYaxis_position )
     NEGATE(  m_pos.x );
     m_pos.x += aYaxis_position;
     NEGATE(  m_size.x );
+    geometryChanged();
 }
 
 
@@ -217,6 +220,7 @@ void SCH_BUS_ENTRY_BASE::Rotate( wxPoint aPosition )
 {
     RotatePoint( &m_pos, aPosition, 900 );
     RotatePoint( &m_size.x, &m_size.y, 900 );
+    geometryChanged();
 }
 
 
@@ -309,6 +313,8 @@ void SCH_BUS_ENTRY_BASE::SetBusEntryShape( char aShape )
             m_size.y = -m_size.y;
         break;
     }
+
+    geometryChanged();
 }
 
 
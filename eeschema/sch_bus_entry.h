@@ -75,7 +75,7 @@ public:
 
     wxSize GetSize() const { return m_size; }
 
-    void SetSize( const wxSize& aSize ) { m_size = aSize; }
+    void SetSize( const wxSize& aSize ) { m_size = aSize; geometryChanged(); }
 
     void SwapData( SCH_ITEM* aItem );
 
@@ -89,6 +89,7 @@ public:
     void Move( const wxPoint& aMoveVector )
     {
         m_pos += aMoveVector;
+        geometryChanged();
     }
 
 
@@ -110,7 +111,7 @@ public:
 
     wxPoint GetPosition() const { return m_pos; }
 
-    void SetPosition( const wxPoint& aPosition ) { m_pos = aPosition; }
+    void SetPosition( const wxPoint& aPosition ) { m_pos = aPosition; geometryChanged(); }
 
     bool HitTest( const wxPoint& aPosition, int aAccuracy ) const;
 
@@ -29,6 +29,7 @@
 #include <macros.h>
 
 #include <sch_sheet_path.h>
+#include <class_sch_screen.h>
 #include <transform.h>
 #include <sch_collectors.h>
 #include <sch_component.h>
@@ -468,7 +469,12 @@ bool SCH_FIND_COLLECTOR::ReplaceItem( SCH_SHEET_PATH* aSheetPath )
     bool replaced = item->Replace( m_findReplaceData, aSheetPath );
 
     if( replaced )
-        SetForceSearch();
+    {
+        if( aSheetPath )
+            SetSheetModified( aSheetPath->LastScreen() );
+        else
+            SetForceSearch();
+    }
 
     return replaced;
 }
@@ -503,12 +509,62 @@ SEARCH_RESULT SCH_FIND_COLLECTOR::Inspect( EDA_ITEM* aItem, const void* aTestDat
 }
 
 
+void SCH_FIND_COLLECTOR::SetSheetModified( SCH_SCREEN* aScreen )
+{
+    m_forceSearch = true;
+
+    SHEET_MATCHES_MAP::iterator it = m_sheetMatches.begin();
+
+    while( it != m_sheetMatches.end() )
+    {
+        if( it->second.m_screen == aScreen )
+            it = m_sheetMatches.erase( it );
+        else
+            ++it;
+    }
+}
+
+
+void SCH_FIND_COLLECTOR::collectSheet( SCH_SHEET_PATH* aSheetPath )
+{
+    SCH_SCREEN*    screen = aSheetPath->LastScreen();
+    SHEET_MATCHES& matches = m_sheetMatches[ aSheetPath->PathHumanReadable() ];
+
+    matches.m_collectCount = m_collectCount;
+
+    // The screen of a sheet path changes when sheets are replaced, and the items of the
+    // screens not edited in this frame (e.g. markers) can be added or removed.
+    if( matches.m_screen != screen || matches.m_sheet != aSheetPath->Last()
+        || matches.m_drawListRevision != screen->GetDrawListRevision() )
+    {
+        size_t first = m_List.size();
+
+        m_sheetPath = aSheetPath;
+        EDA_ITEM::IterateForward( aSheetPath->LastDrawList(), this, NULL, m_ScanTypes );
+
+        matches.m_screen = screen;
+        matches.m_sheet = aSheetPath->Last();
+        matches.m_drawListRevision = screen->GetDrawListRevision();
+        matches.m_items.assign( m_List.begin() + first, m_List.end() );
+        matches.m_data.assign( m_data.begin() + first, m_data.end() );
+        return;
+    }
+
+    m_List.insert( m_List.end(), matches.m_items.begin(), matches.m_items.end() );
+    m_data.insert( m_data.end(), matches.m_data.begin(), matches.m_data.end() );
+}
+
+
 void SCH_FIND_COLLECTOR::Collect( SCH_FIND_REPLACE_DATA& aFindReplaceData,
                                   SCH_SHEET_PATH* aSheetPath )
 {
     if( !IsSearchRequired( aFindReplaceData ) && !m_List.empty() && !m_forceSearch )
         return;
 
+    // The items found by sheet are kept only for the same search criteria.
+    if( m_findReplaceData.ChangesCompare( aFindReplaceData ) )
+        m_sheetMatches.clear();
+
     m_findReplaceData = aFindReplaceData;
     Empty();                 // empty the collection just in case
     m_data.clear();
@@ -517,18 +573,26 @@ void SCH_FIND_COLLECTOR::Collect( SCH_FIND_REPLACE_DATA& aFindReplaceData,
 
     if( aSheetPath )
     {
-        m_sheetPath = aSheetPath;
-        EDA_ITEM::IterateForward( aSheetPath->LastDrawList(), this, NULL, m_ScanTypes );
+        collectSheet( aSheetPath );
     }
     else
     {
         SCH_SHEET_LIST schematic;
-        m_sheetPath = schematic.GetFirst();
 
-        while( m_sheetPath != NULL )
+        m_collectCount++;
+
+        for( SCH_SHEET_PATH* sheet = schematic.GetFirst(); sheet; sheet = schematic.GetNext() )
+            collectSheet( sheet );
+
+        // Forget the sheets removed from the hierarchy.
+        SHEET_MATCHES_MAP::iterator it = m_sheetMatches.begin();
+
+        while( it != m_sheetMatches.end() )
         {
-            EDA_ITEM::IterateForward( m_sheetPath->LastDrawList(), this, NULL, m_ScanTypes );
-            m_sheetPath = schematic.GetNext();
+            if( it->second.m_collectCount != m_collectCount )
+                it = m_sheetMatches.erase( it );
+            else
+                ++it;
         }
     }
 
@@ -541,6 +605,7 @@ void SCH_FIND_COLLECTOR::Collect( SCH_FIND_REPLACE_DATA& aFindReplaceData,
         wxFAIL_MSG( wxT( "List size mismatch." ) );
         m_List.clear();
         m_data.clear();
+        m_sheetMatches.clear();
     }
 }
 
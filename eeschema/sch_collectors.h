@@ -31,10 +31,15 @@
 
 
 #include <class_collector.h>
+#include <hashtables.h>
 #include <sch_item_struct.h>
 #include <dialogs/dialog_schematic_find.h>
 
 
+class SCH_SCREEN;
+class SCH_SHEET;
+
+
 /**
  * Class SCH_COLLECTOR
  */
@@ -241,6 +246,38 @@ class SCH_FIND_COLLECTOR : public COLLECTOR
     /// should trigger cache obsolescence.
     int     m_lib_hash;
 
+    /// The items found in a sheet, and the state of the sheet they were found in.
+    struct SHEET_MATCHES
+    {
+        SCH_SCREEN*                             m_screen;
+        SCH_SHEET*                              m_sheet;
+        unsigned                                m_drawListRevision;
+        unsigned                                m_collectCount;
+        std::vector< EDA_ITEM* >                m_items;
+        std::vector< SCH_FIND_COLLECTOR_DATA >  m_data;
+
+        SHEET_MATCHES() :
+            m_screen( NULL ), m_sheet( NULL ), m_drawListRevision( 0 ), m_collectCount( 0 )
+        { }
+    };
+
+    typedef boost::unordered_map< wxString, SHEET_MATCHES, WXSTRING_HASH > SHEET_MATCHES_MAP;
+
+    /// The items matching #m_findReplaceData by sheet path (@see
+    /// SCH_SHEET_PATH::PathHumanReadable()), kept between the searches so only the sheets
+    /// modified since the previous search are searched again.
+    SHEET_MATCHES_MAP m_sheetMatches;
+
+    /// The number of searches of the whole hierarchy, used to forget the removed sheets.
+    unsigned m_collectCount;
+
+    /**
+     * Function collectSheet
+     * appends the items of \a aSheetPath matching #m_findReplaceData to the list, searching
+     * the sheet only if it has been modified since it was searched.
+     */
+    void collectSheet( SCH_SHEET_PATH* aSheetPath );
+
     /**
      * Function dump
      * is a helper to dump the items in the find list for debugging purposes.
@@ -261,6 +298,7 @@ public:
         SetForceSearch( false );
         m_sheetPath = NULL;
         m_lib_hash = 0;
+        m_collectCount = 0;
     }
 
     void Empty()
@@ -270,7 +308,25 @@ public:
         m_data.clear();
     }
 
-    void SetForceSearch( bool doSearch = true ) { m_forceSearch = doSearch; }
+    /**
+     * Function SetForceSearch
+     * sets the flag forcing a new search even if the search criteria are unchanged.
+     * When \a doSearch is true, all the sheets will be searched again.
+     */
+    void SetForceSearch( bool doSearch = true )
+    {
+        m_forceSearch = doSearch;
+
+        if( doSearch )
+            m_sheetMatches.clear();
+    }
+
+    /**
+     * Function SetSheetModified
+     * forces a new search of the sheets using \a aScreen, the other sheets keep the items
+     * found by the previous search.
+     */
+    void SetSheetModified( SCH_SCREEN* aScreen );
 
     int GetLibHash() const          { return m_lib_hash; }
     void SetLibHash( int aHash )    { m_lib_hash = aHash; }
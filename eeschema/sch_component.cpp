@@ -256,6 +256,7 @@ void SCH_COMPONENT::SetPartName( const wxString& aName, PART_LIBS* aLibs )
     {
         m_part_name = aName;
         SetModified();
+        geometryChanged();
 
         if( aLibs )
             Resolve( aLibs );
@@ -272,6 +273,7 @@ bool SCH_COMPONENT::Resolve( PART_LIBS* aLibs )
     if( LIB_PART* part = aLibs->FindLibPart( m_part_name ) )
     {
         m_part = part->SharedPtr();
+        geometryChanged();
         return true;
     }
 
@@ -299,12 +301,14 @@ void SCH_COMPONENT::SetUnit( int aUnit )
     {
         m_unit = aUnit;
         SetModified();
+        geometryChanged();
     }
 }
 
 void SCH_COMPONENT::UpdateUnit( int aUnit )
 {
     m_unit = aUnit;
+    geometryChanged();
 }
 
 
@@ -314,6 +318,7 @@ void SCH_COMPONENT::SetConvert( int aConvert )
     {
         m_convert = aConvert;
         SetModified();
+        geometryChanged();
     }
 }
 
@@ -324,6 +329,7 @@ void SCH_COMPONENT::SetTransform( const TRANSFORM& aTransform )
     {
         m_transform = aTransform;
         SetModified();
+        geometryChanged();
     }
 }
 
@@ -701,6 +707,7 @@ void SCH_COMPONENT::SwapData( SCH_ITEM* aItem )
 
     m_transform = component->m_transform;
     component->m_transform = tmp;
+    geometryChanged();
 
     m_Fields.swap( component->m_Fields );    // std::vector's swap()
 
@@ -784,6 +791,7 @@ void SCH_COMPONENT::ClearAnnotation( SCH_SHEET_PATH* aSheetPath )
         // will reuse it
         m_PathsAndReferences.Empty();
         m_unit = 1;
+        geometryChanged();
     }
 
     // These 2 changes do not work in complex hierarchy.
@@ -920,6 +928,8 @@ void SCH_COMPONENT::SetOrientation( int aOrientation )
         newTransform.y2 = m_transform.y1 * temp.x2 + m_transform.y2 * temp.y2;
         m_transform = newTransform;
     }
+
+    geometryChanged();
 }
 
 
@@ -1877,6 +1887,7 @@ SCH_ITEM& SCH_COMPONENT::operator=( const SCH_ITEM& aItem )
         m_unit      = c->m_unit;
         m_convert   = c->m_convert;
         m_transform = c->m_transform;
+        geometryChanged();
 
         m_PathsAndReferences = c->m_PathsAndReferences;
 
@@ -148,6 +148,9 @@ public:
     void SetPartName( const wxString& aName, PART_LIBS* aLibs=NULL );
     const wxString& GetPartName() const        { return m_part_name; }
 
+    /// @return the reference to the LIB_PART this component is based on, set by Resolve()
+    PART_REF& GetPartRef()                      { return m_part; }
+
     /**
      * Function Resolve
      * [re-]assigns the current LIB_PART from aLibs which this component
@@ -386,6 +389,7 @@ public:
             GetField( ii )->Move( aMoveVector );
 
         SetModified();
+        geometryChanged();
     }
 
     void MirrorY( int aYaxis_position );
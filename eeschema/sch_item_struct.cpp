@@ -31,6 +31,7 @@
 #include <gr_basic.h>
 #include <base_struct.h>
 #include <sch_item_struct.h>
+#include <sch_items_rtree.h>
 #include <class_sch_screen.h>
 #include <class_drawpanel.h>
 #include <schframe.h>
@@ -56,6 +57,7 @@ SCH_ITEM::SCH_ITEM( EDA_ITEM* aParent, KICAD_T aType ) :
     EDA_ITEM( aParent, aType )
 {
     m_Layer = LAYER_WIRE; // It's only a default, in fact
+    m_spatialIndex = NULL;
 }
 
 
@@ -63,6 +65,7 @@ SCH_ITEM::SCH_ITEM( const SCH_ITEM& aItem ) :
     EDA_ITEM( aItem )
 {
     m_Layer = aItem.m_Layer;
+    m_spatialIndex = NULL;
 }
 
 
@@ -73,6 +76,28 @@ SCH_ITEM::~SCH_ITEM()
     // are owned by the sheet object container.
     if( !m_connections.empty() )
         m_connections.clear();
+
+    if( m_spatialIndex )
+        m_spatialIndex->Remove( this );
+}
+
+
+SCH_ITEM& SCH_ITEM::operator=( const SCH_ITEM& aItem )
+{
+    EDA_ITEM::operator=( aItem );
+
+    m_Layer = aItem.m_Layer;
+    m_connections = aItem.m_connections;
+    m_storedPos = aItem.m_storedPos;
+
+    return *this;
+}
+
+
+void SCH_ITEM::geometryChanged()
+{
+    if( m_spatialIndex )
+        m_spatialIndex->Invalidate( this );
 }
 
 
@@ -37,6 +37,7 @@
 #include <boost/ptr_container/ptr_vector.hpp>
 
 class SCH_ITEM;
+class SCH_ITEMS_RTREE;
 class SCH_SHEET_PATH;
 class LINE_READER;
 class SCH_EDIT_FRAME;
@@ -114,19 +115,33 @@ public:
  */
 class SCH_ITEM : public EDA_ITEM
 {
+    friend class SCH_ITEMS_RTREE;
+
 protected:
     LAYERSCH_ID    m_Layer;
     EDA_ITEMS      m_connections;   ///< List of items connected to this item.
     wxPoint        m_storedPos;     ///< a temporary variable used in some move commands
                                     ///> to store a initial pos (of the item or mouse cursor)
 
+    /**
+     * Function geometryChanged
+     * has to be called by functions changing the position or the shape of the wires,
+     * junctions, no connects, bus entries and components, so the spatial index of
+     * their screen is updated.
+     */
+    void geometryChanged();
+
 public:
     SCH_ITEM( EDA_ITEM* aParent, KICAD_T aType );
 
     SCH_ITEM( const SCH_ITEM& aItem );
 
+    /// Removes the item from the spatial index of its screen, if it is indexed
     ~SCH_ITEM();
 
+    /// Copies the item data.  The item stays in its own spatial index, if any.
+    SCH_ITEM& operator=( const SCH_ITEM& aItem );
+
     virtual wxString GetClass() const
     {
         return wxT( "SCH_ITEM" );
@@ -422,6 +437,9 @@ private:
      * @return True if connection to \a aPosition exists.
      */
     virtual bool doIsConnected( const wxPoint& aPosition ) const { return false; }
+
+    /// The spatial index of the screen holding this item, NULL if the item is not indexed
+    SCH_ITEMS_RTREE* m_spatialIndex;
 };
 
 
@@ -0,0 +1,290 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2015 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file sch_items_rtree.h
+ * @brief R-tree of schematic items, used by the SCH_SCREEN hit test functions.
+ */
+
+#ifndef SCH_ITEMS_RTREE_H
+#define SCH_ITEMS_RTREE_H
+
+#include <algorithm>
+#include <vector>
+#include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
+
+#include <geometry/rtree.h>
+#include <class_eda_rect.h>
+#include <sch_item_struct.h>
+
+/**
+ * Struct SCH_ITEM_REF
+ * is an entry of SCH_ITEMS_RTREE.  Besides the item, it stores a key giving the position
+ * of the item in the screen draw list, so a query can return the same item a linear
+ * search would have found first.
+ */
+struct SCH_ITEM_REF
+{
+    SCH_ITEM*   item;
+    double      order;
+
+    bool operator==( const SCH_ITEM_REF& aOther ) const
+    {
+        return item == aOther.item;
+    }
+};
+
+
+typedef RTree<SCH_ITEM_REF, int, 2, float> SCH_ITEMS_RTREE_BASE;
+
+/**
+ * Class SCH_ITEMS_RTREE
+ * implements an R-tree of schematic items.  Items are stored with the area in which their
+ * hit tests and connection tests may succeed, so a query returns all the candidates for
+ * these tests.  Items without such an area are kept aside.  Non-owning.
+ *
+ * Indexed items know their tree: their geometry setters mark their area as outdated with
+ * Invalidate(), and their destructor removes them.  The owner of the tree computes the
+ * outdated areas before querying the tree, as the area of a component depends on the
+ * libraries.
+ *
+ * The order keys of the items are spaced by OrderStep() when the tree is built, so items
+ * inserted later between two others get a key in between.
+ */
+class SCH_ITEMS_RTREE : public SCH_ITEMS_RTREE_BASE
+{
+public:
+    typedef boost::unordered_set<SCH_ITEM*> ITEMS;
+
+    /// Spacing of the order keys of consecutive items
+    static double OrderStep() { return 1024.0; }
+
+    SCH_ITEMS_RTREE() :
+        m_firstOrder( 0.0 ), m_lastOrder( 0.0 )
+    {
+    }
+
+    ~SCH_ITEMS_RTREE()
+    {
+        RemoveAll();
+    }
+
+    /**
+     * Function Insert()
+     * inserts an item into the tree.  Its area is outdated until SetArea() is called.
+     * @param aOrder is the key of the item position in the screen draw list.
+     */
+    void Insert( SCH_ITEM* aItem, double aOrder )
+    {
+        Remove( aItem );
+
+        ENTRY& entry = m_entries[aItem];
+
+        if( m_entries.size() == 1 )
+        {
+            m_firstOrder = aOrder;
+            m_lastOrder = aOrder;
+        }
+        else
+        {
+            m_firstOrder = std::min( m_firstOrder, aOrder );
+            m_lastOrder = std::max( m_lastOrder, aOrder );
+        }
+
+        entry.order = aOrder;
+        entry.hasArea = false;
+        m_outdated.insert( aItem );
+        aItem->m_spatialIndex = this;
+    }
+
+    /**
+     * Function Remove()
+     * removes an item from the tree, if it is there.
+     */
+    void Remove( SCH_ITEM* aItem )
+    {
+        ENTRIES::iterator it = m_entries.find( aItem );
+
+        if( it == m_entries.end() )
+            return;
+
+        removeArea( aItem, it->second );
+        m_outdated.erase( aItem );
+        m_entries.erase( it );
+        aItem->m_spatialIndex = NULL;
+    }
+
+    /**
+     * Function Invalidate()
+     * marks the area of an item as outdated, after a change of its geometry.
+     */
+    void Invalidate( SCH_ITEM* aItem )
+    {
+        if( m_entries.count( aItem ) )
+            m_outdated.insert( aItem );
+    }
+
+    /**
+     * Function SetArea()
+     * stores an item of the tree with the area it can be found in by a point query.
+     * @param aArea is the area, or NULL if the item is never found by a query.
+     */
+    void SetArea( SCH_ITEM* aItem, const EDA_RECT* aArea )
+    {
+        ENTRIES::iterator it = m_entries.find( aItem );
+
+        if( it == m_entries.end() )
+            return;
+
+        ENTRY& entry = it->second;
+
+        removeArea( aItem, entry );
+        m_outdated.erase( aItem );
+
+        if( !aArea )
+        {
+            m_withoutArea.insert( aItem );
+            return;
+        }
+
+        // Keep a margin for the rounding of the oblique segments hit tests
+        EDA_RECT area = *aArea;
+
+        area.Normalize();
+        area.Inflate( 1 );
+
+        SCH_ITEM_REF ref = { aItem, entry.order };
+
+        entry.min[0] = area.GetX();
+        entry.min[1] = area.GetY();
+        entry.max[0] = area.GetRight();
+        entry.max[1] = area.GetBottom();
+        entry.hasArea = true;
+
+        SCH_ITEMS_RTREE_BASE::Insert( entry.min, entry.max, ref );
+    }
+
+    /**
+     * Function TakeOutdatedItems()
+     * moves the items whose area is outdated to \a aItems.  Their area must be set again
+     * with SetArea().
+     */
+    void TakeOutdatedItems( std::vector<SCH_ITEM*>& aItems )
+    {
+        aItems.assign( m_outdated.begin(), m_outdated.end() );
+        m_outdated.clear();
+    }
+
+    /// @return the items of the tree which are never found by a query
+    const ITEMS& GetItemsWithoutArea() const { return m_withoutArea; }
+
+    /**
+     * Function RemoveAll()
+     * empties the tree.  The items are told they are no longer indexed.
+     */
+    void RemoveAll()
+    {
+        for( ENTRIES::iterator it = m_entries.begin(); it != m_entries.end(); ++it )
+            it->first->m_spatialIndex = NULL;
+
+        m_entries.clear();
+        m_outdated.clear();
+        m_withoutArea.clear();
+        SCH_ITEMS_RTREE_BASE::RemoveAll();
+    }
+
+    /**
+     * Function GetOrder()
+     * gets the order key of \a aItem.
+     * @return false if \a aItem is not in the tree.
+     */
+    bool GetOrder( const SCH_ITEM* aItem, double* aOrder ) const
+    {
+        ENTRIES::const_iterator it = m_entries.find( const_cast<SCH_ITEM*>( aItem ) );
+
+        if( it == m_entries.end() )
+            return false;
+
+        *aOrder = it->second.order;
+        return true;
+    }
+
+    /// @return a key not greater than the order keys in the tree, 0 if the tree is empty
+    double GetFirstOrder() const { return m_entries.empty() ? 0.0 : m_firstOrder; }
+
+    /// @return a key not smaller than the order keys in the tree, 0 if the tree is empty
+    double GetLastOrder() const { return m_entries.empty() ? 0.0 : m_lastOrder; }
+
+    /**
+     * Function Query()
+     * executes a function object aVisitor for each item whose area is closer than
+     * \a aAccuracy to \a aPosition.
+     */
+    template <class Visitor>
+    void Query( const wxPoint& aPosition, int aAccuracy, Visitor& aVisitor )
+    {
+        int dist = std::max( aAccuracy, 0 );
+
+        const int mmin[2] = { aPosition.x - dist, aPosition.y - dist };
+        const int mmax[2] = { aPosition.x + dist, aPosition.y + dist };
+
+        SCH_ITEMS_RTREE_BASE::Search( mmin, mmax, aVisitor );
+    }
+
+private:
+    /// Area and order key an item has been stored with, needed to remove it
+    struct ENTRY
+    {
+        int     min[2];
+        int     max[2];
+        double  order;
+        bool    hasArea;
+    };
+
+    typedef boost::unordered_map<SCH_ITEM*, ENTRY> ENTRIES;
+
+    /// Takes an item out of the R-tree or of the items without area
+    void removeArea( SCH_ITEM* aItem, ENTRY& aEntry )
+    {
+        if( aEntry.hasArea )
+        {
+            SCH_ITEM_REF ref = { aItem, aEntry.order };
+
+            SCH_ITEMS_RTREE_BASE::Remove( aEntry.min, aEntry.max, ref );
+            aEntry.hasArea = false;
+        }
+        else
+        {
+            m_withoutArea.erase( aItem );
+        }
+    }
+
+    ENTRIES     m_entries;
+    ITEMS       m_outdated;     ///< items whose area has to be set again
+    ITEMS       m_withoutArea;  ///< items never found by a query
+    double      m_firstOrder;   ///< smallest order key inserted since the tree was empty
+    double      m_lastOrder;    ///< largest order key inserted since the tree was empty
+};
+
+#endif /* SCH_ITEMS_RTREE_H */
@@ -75,6 +75,7 @@ void SCH_JUNCTION::SwapData( SCH_ITEM* aItem )
 
     SCH_JUNCTION* item = (SCH_JUNCTION*) aItem;
     EXCHG( m_pos, item->m_pos );
+    geometryChanged();
 }
 
 
@@ -131,6 +132,7 @@ void SCH_JUNCTION::MirrorX( int aXaxis_position )
     m_pos.y -= aXaxis_position;
     NEGATE( m_pos.y );
     m_pos.y += aXaxis_position;
+    geometryChanged();
 }
 
 
@@ -139,12 +141,14 @@ void SCH_JUNCTION::MirrorY( int aYaxis_position )
     m_pos.x -= aYaxis_position;
     NEGATE( m_pos.x );
     m_pos.x += aYaxis_position;
+    geometryChanged();
 }
 
 
 void SCH_JUNCTION::Rotate( wxPoint aPosition )
 {
     RotatePoint( &m_pos, aPosition, 900 );
+    geometryChanged();
 }
 
 
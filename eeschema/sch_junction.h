@@ -67,6 +67,7 @@ public:
     void Move( const wxPoint& aMoveVector )
     {
         m_pos += aMoveVector;
+        geometryChanged();
     }
 
     void MirrorY( int aYaxis_position );
@@ -91,7 +92,7 @@ public:
 
     wxPoint GetPosition() const { return m_pos; }
 
-    void SetPosition( const wxPoint& aPosition ) { m_pos = aPosition; }
+    void SetPosition( const wxPoint& aPosition ) { m_pos = aPosition; geometryChanged(); }
 
     bool HitTest( const wxPoint& aPosition, int aAccuracy ) const;
 
@@ -87,12 +87,14 @@ void SCH_LINE::Move( const wxPoint& aOffset )
     {
         m_start += aOffset;
         SetModified();
+        geometryChanged();
     }
 
     if( (m_Flags & ENDPOINT) == 0 && aOffset != wxPoint( 0, 0 ) )
     {
         m_end += aOffset;
         SetModified();
+        geometryChanged();
     }
 }
 
@@ -256,6 +258,7 @@ void SCH_LINE::MirrorX( int aXaxis_position )
     m_end.y   -= aXaxis_position;
     NEGATE(  m_end.y );
     m_end.y += aXaxis_position;
+    geometryChanged();
 }
 
 
@@ -267,6 +270,7 @@ void SCH_LINE::MirrorY( int aYaxis_position )
     m_end.x   -= aYaxis_position;
     NEGATE(  m_end.x );
     m_end.x += aYaxis_position;
+    geometryChanged();
 }
 
 
@@ -274,6 +278,7 @@ void SCH_LINE::Rotate( wxPoint aPosition )
 {
     RotatePoint( &m_start, aPosition, 900 );
     RotatePoint( &m_end, aPosition, 900 );
+    geometryChanged();
 }
 
 
@@ -364,6 +369,7 @@ bool SCH_LINE::MergeOverlap( SCH_LINE* aLine )
         wxPoint tmp = *candidates[3];
         m_start = *candidates[0];
         m_end = tmp;
+        geometryChanged();
         return true;
     }
     return false;
@@ -613,4 +619,5 @@ void SCH_LINE::SetPosition( const wxPoint& aPosition )
 {
     m_end = m_end - ( m_start - aPosition );
     m_start = aPosition;
+    geometryChanged();
 }
@@ -70,11 +70,11 @@ public:
 
     wxPoint GetStartPoint() const { return m_start; }
 
-    void SetStartPoint( const wxPoint& aPosition ) { m_start = aPosition; }
+    void SetStartPoint( const wxPoint& aPosition ) { m_start = aPosition; geometryChanged(); }
 
     wxPoint GetEndPoint() const { return m_end; }
 
-    void SetEndPoint( const wxPoint& aPosition ) { m_end = aPosition; }
+    void SetEndPoint( const wxPoint& aPosition ) { m_end = aPosition; geometryChanged(); }
 
     const EDA_RECT GetBoundingBox() const;    // Virtual
 
@@ -65,6 +65,7 @@ void SCH_NO_CONNECT::SwapData( SCH_ITEM* aItem )
     SCH_NO_CONNECT* item = (SCH_NO_CONNECT*)aItem;
     EXCHG( m_pos, item->m_pos );
     EXCHG( m_size, item->m_size );
+    geometryChanged();
 }
 
 
@@ -149,6 +150,7 @@ void SCH_NO_CONNECT::MirrorX( int aXaxis_position )
     m_pos.y -= aXaxis_position;
     NEGATE(  m_pos.y );
     m_pos.y += aXaxis_position;
+    geometryChanged();
 }
 
 
@@ -157,12 +159,14 @@ void SCH_NO_CONNECT::MirrorY( int aYaxis_position )
     m_pos.x -= aYaxis_position;
     NEGATE(  m_pos.x );
     m_pos.x += aYaxis_position;
+    geometryChanged();
 }
 
 
 void SCH_NO_CONNECT::Rotate( wxPoint aPosition )
 {
     RotatePoint( &m_pos, aPosition, 900 );
+    geometryChanged();
 }
 
 
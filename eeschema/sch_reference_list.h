@@ -40,6 +40,7 @@
 #include <sch_text.h>
 
 #include <map>
+#include <boost/unordered_map.hpp>
 
 class SCH_REFERENCE;
 class SCH_REFERENCE_LIST;
@@ -452,18 +453,50 @@ private:
 
     static bool sortByReferenceOnly( const SCH_REFERENCE& item1, const SCH_REFERENCE& item2 );
 
+    /**
+     * Struct PREFIX_NUMBERS
+     * the reference numbers in use and the annotated units of a reference prefix, kept
+     * up to date by Annotate() instead of searching the list for each component.
+     */
+    struct PREFIX_NUMBERS
+    {
+        std::map<int, int>                  m_NumRefs;      ///< count of references by number
+        std::map<std::pair<int, int>, int>  m_Units;        ///< count of annotated references
+                                                            ///< by number and unit
+        std::vector<int>                    m_FreedNumRefs; ///< numbers to remove from m_NumRefs
+                                                            ///< at the next StartGroup()
+        int                                 m_FirstFreeId;  ///< no free number below it
+
+        PREFIX_NUMBERS() : m_FirstFreeId( 0 ) {}
+
+        /**
+         * Function StartGroup
+         * is called when Annotate() starts to give numbers to a group of references of
+         * this prefix: as the list of numbers in use was built for each group, the numbers
+         * freed before (by re-annotated references) are free only from this group.
+         * @param aFirstValue The first number of the group.
+         */
+        void StartGroup( int aFirstValue );
+    };
+
+    typedef boost::unordered_map<std::string, PREFIX_NUMBERS> PREFIX_NUMBERS_MAP;
+
     /**
      * Function CreateFirstFreeRefId
-     * searches for the first free reference number in \a aListId of reference numbers in use.
-     * This function just searches for a hole in a list of incremented numbers, this list must
-     * be sorted by increasing values and each value can be stored only once.  The new value
-     * is added to the list.
-     * @see BuildRefIdInUseList to prepare this list
-     * @param aIdList The buffer that contains the reference numbers in use.
-     * @param aFirstValue The first expected free value
+     * searches for the first free reference number of the current group of \a aNumbers,
+     * i.e. the first hole in the reference numbers in use from the first number of the group.
+     * @param aNumbers The numbers of the reference prefix of the group.
      * @return The first free (not yet used) value.
      */
-    int CreateFirstFreeRefId( std::vector<int>& aIdList, int aFirstValue );
+    int CreateFirstFreeRefId( PREFIX_NUMBERS& aNumbers );
+
+    /**
+     * Function setAnnotation
+     * sets the number, the unit and the "not yet annotated" state of \a aItem, and
+     * updates \a aPrefixes accordingly.
+     */
+    void setAnnotation( PREFIX_NUMBERS_MAP& aPrefixes, SCH_REFERENCE& aItem,
+                        int aNumRef, int aUnit, bool aIsNew );
 };
 
 #endif    // _SCH_REFERENCE_LIST_H_
@@ -53,8 +53,10 @@
 #include <sch_component.h>
 #include <sch_text.h>
 #include <lib_pin.h>
+#include <sch_items_rtree.h>
 
 #include <boost/foreach.hpp>
+#include <climits>
 
 #define EESCHEMA_FILE_STAMP   "EESchema"
 
@@ -97,6 +99,13 @@ SCH_SCREEN::SCH_SCREEN( KIWAY* aKiway ) :
 {
     m_modification_sync = 0;
 
+    m_spatialIndex = NULL;
+    m_spatialQueryStamp.items         = UINT_MAX;
+    m_spatialQueryStamp.libraries     = 0;
+    m_spatialQueryStamp.lineThickness = 0;
+    m_spatialQueryStamp.junctionSize  = 0;
+    m_spatialIndexStamp = m_spatialQueryStamp;
+
     SetZoom( 32 );
 
     for( unsigned i = 0; i < DIM( SchematicZoomList ); i++ )
@@ -119,6 +128,7 @@ SCH_SCREEN::~SCH_SCREEN()
 {
     ClearUndoRedoList();
     FreeDrawList();
+    delete m_spatialIndex;
 }
 
 
@@ -149,13 +159,49 @@ void SCH_SCREEN::Clear()
 
 void SCH_SCREEN::FreeDrawList()
 {
+    if( m_spatialIndex )
+        m_spatialIndex->RemoveAll();
+
     m_drawList.DeleteAll();
 }
 
 
+void SCH_SCREEN::Append( SCH_ITEM* aItem )
+{
+    bool indexCurrent = isSpatialIndexCurrent();
+
+    m_drawList.Append( aItem );
+    --m_modification_sync;
+    indexItems( aItem, aItem, indexCurrent );
+}
+
+
+void SCH_SCREEN::Append( DLIST< SCH_ITEM >& aList )
+{
+    appendItems( aList );
+    --m_modification_sync;
+}
+
+
+void SCH_SCREEN::appendItems( DLIST< SCH_ITEM >& aList )
+{
+    bool      indexCurrent = isSpatialIndexCurrent();
+    SCH_ITEM* last = m_drawList.GetLast();
+
+    m_drawList.Append( aList );
+
+    SCH_ITEM* first = last ? last->Next() : m_drawList.begin();
+
+    indexItems( first, m_drawList.GetLast(), indexCurrent );
+}
+
+
 void SCH_SCREEN::Remove( SCH_ITEM* aItem )
 {
+    bool indexCurrent = isSpatialIndexCurrent();
+
     m_drawList.Remove( aItem );
+    unindexItem( aItem, indexCurrent );
 }
 
 
@@ -177,7 +223,8 @@ void SCH_SCREEN::DeleteItem( SCH_ITEM* aItem )
     }
     else
     {
-        delete m_drawList.Remove( aItem );
+        Remove( aItem );
+        delete aItem;
     }
 }
 
@@ -198,8 +245,668 @@ bool SCH_SCREEN::CheckIfOnDrawList( SCH_ITEM* aItem )
 }
 
 
+/**
+ * Struct FIRST_ITEM_FINDER
+ * is a visitor of SCH_ITEMS_RTREE, looking for the item accepted by PREDICATE that
+ * comes first in the draw list.
+ */
+template <class PREDICATE>
+struct FIRST_ITEM_FINDER
+{
+    FIRST_ITEM_FINDER( const PREDICATE& aPredicate ) :
+        m_predicate( aPredicate ), m_found( NULL ), m_order( 0.0 )
+    {
+    }
+
+    bool operator()( const SCH_ITEM_REF& aRef )
+    {
+        if( ( !m_found || aRef.order < m_order ) && m_predicate( aRef.item ) )
+        {
+            m_found = aRef.item;
+            m_order = aRef.order;
+        }
+
+        return true;
+    }
+
+    const PREDICATE&    m_predicate;
+    SCH_ITEM*           m_found;
+    double              m_order;
+};
+
+
+/**
+ * Struct ITEMS_COLLECTOR
+ * is a visitor of SCH_ITEMS_RTREE, collecting the items accepted by PREDICATE.
+ */
+template <class PREDICATE>
+struct ITEMS_COLLECTOR
+{
+    ITEMS_COLLECTOR( const PREDICATE& aPredicate ) :
+        m_predicate( aPredicate )
+    {
+    }
+
+    bool operator()( const SCH_ITEM_REF& aRef )
+    {
+        if( m_predicate( aRef.item ) )
+            m_found.push_back( aRef );
+
+        return true;
+    }
+
+    const PREDICATE&            m_predicate;
+    std::vector<SCH_ITEM_REF>   m_found;
+};
+
+
+static bool sortByDrawListOrder( const SCH_ITEM_REF& aItem1, const SCH_ITEM_REF& aItem2 )
+{
+    return aItem1.order < aItem2.order;
+}
+
+
+/**
+ * Function findFirstItem
+ * @return the item accepted by aPredicate, closer than aAccuracy to aPosition in aIndex,
+ * that comes first in the draw list.
+ */
+template <class PREDICATE>
+static SCH_ITEM* findFirstItem( SCH_ITEMS_RTREE* aIndex, const wxPoint& aPosition,
+                                int aAccuracy, const PREDICATE& aPredicate )
+{
+    FIRST_ITEM_FINDER<PREDICATE> finder( aPredicate );
+
+    aIndex->Query( aPosition, aAccuracy, finder );
+
+    return finder.m_found;
+}
+
+
+/**
+ * Function findFirstItem
+ * @return the first item accepted by aPredicate in the draw list starting at aFirstItem.
+ */
+template <class PREDICATE>
+static SCH_ITEM* findFirstItem( SCH_ITEM* aFirstItem, const PREDICATE& aPredicate )
+{
+    for( SCH_ITEM* item = aFirstItem; item; item = item->Next() )
+    {
+        if( aPredicate( item ) )
+            return item;
+    }
+
+    return NULL;
+}
+
+
+/**
+ * Function findItems
+ * stores in aList the items accepted by aPredicate, closer than aAccuracy to aPosition
+ * in aIndex, in the draw list order.
+ */
+template <class PREDICATE>
+static void findItems( SCH_ITEMS_RTREE* aIndex, const wxPoint& aPosition, int aAccuracy,
+                       const PREDICATE& aPredicate, std::vector<SCH_ITEM*>& aList )
+{
+    ITEMS_COLLECTOR<PREDICATE> collector( aPredicate );
+
+    aIndex->Query( aPosition, aAccuracy, collector );
+
+    sort( collector.m_found.begin(), collector.m_found.end(), sortByDrawListOrder );
+
+    for( unsigned ii = 0; ii < collector.m_found.size(); ii++ )
+        aList.push_back( collector.m_found[ii].item );
+}
+
+
+/// Hit test used by GetItem() for the item types stored in the spatial index
+struct ITEM_AT_POSITION
+{
+    ITEM_AT_POSITION( const wxPoint& aPosition, int aAccuracy, KICAD_T aType ) :
+        m_position( aPosition ), m_accuracy( aAccuracy ), m_type( aType )
+    {
+    }
+
+    bool operator()( SCH_ITEM* aItem ) const
+    {
+        return aItem->Type() == m_type && aItem->HitTest( m_position, m_accuracy );
+    }
+
+    const wxPoint&  m_position;
+    int             m_accuracy;
+    KICAD_T         m_type;
+};
+
+
+/// Hit test used by GetLine()
+struct LINE_AT_POSITION
+{
+    LINE_AT_POSITION( const wxPoint& aPosition, int aAccuracy, int aLayer,
+                      SCH_LINE_TEST_T aSearchType ) :
+        m_position( aPosition ), m_accuracy( aAccuracy ), m_layer( aLayer ),
+        m_searchType( aSearchType )
+    {
+    }
+
+    bool operator()( SCH_ITEM* aItem ) const
+    {
+        if( aItem->Type() != SCH_LINE_T )
+            return false;
+
+        if( aItem->GetLayer() != m_layer )
+            return false;
+
+        if( !aItem->HitTest( m_position, m_accuracy ) )
+            return false;
+
+        switch( m_searchType )
+        {
+        case ENTIRE_LENGTH_T:
+            return true;
+
+        case EXCLUDE_END_POINTS_T:
+            return !( (SCH_LINE*) aItem )->IsEndPoint( m_position );
+
+        case END_POINTS_ONLY_T:
+            return ( (SCH_LINE*) aItem )->IsEndPoint( m_position );
+        }
+
+        return false;
+    }
+
+    const wxPoint&  m_position;
+    int             m_accuracy;
+    int             m_layer;
+    SCH_LINE_TEST_T m_searchType;
+};
+
+
+/// Hit test used by GetWireOrBus() and GetNode()
+struct WIRE_OR_BUS_AT_POSITION
+{
+    WIRE_OR_BUS_AT_POSITION( const wxPoint& aPosition ) :
+        m_position( aPosition )
+    {
+    }
+
+    bool operator()( SCH_ITEM* aItem ) const
+    {
+        return aItem->Type() == SCH_LINE_T && aItem->HitTest( m_position )
+               && ( aItem->GetLayer() == LAYER_BUS || aItem->GetLayer() == LAYER_WIRE );
+    }
+
+    const wxPoint&  m_position;
+};
+
+
+/// Hit test used by GetNode()
+struct NODE_AT_POSITION
+{
+    NODE_AT_POSITION( const wxPoint& aPosition ) :
+        m_wireOrBus( aPosition )
+    {
+    }
+
+    bool operator()( SCH_ITEM* aItem ) const
+    {
+        if( m_wireOrBus( aItem ) )
+            return true;
+
+        return aItem->Type() == SCH_JUNCTION_T && aItem->HitTest( m_wireOrBus.m_position );
+    }
+
+    WIRE_OR_BUS_AT_POSITION m_wireOrBus;
+};
+
+
+/// Connection test used by CountConnectedItems()
+struct CONNECTED_AT_POSITION
+{
+    CONNECTED_AT_POSITION( const wxPoint& aPosition, bool aTestJunctions ) :
+        m_position( aPosition ), m_testJunctions( aTestJunctions )
+    {
+    }
+
+    bool operator()( SCH_ITEM* aItem ) const
+    {
+        if( aItem->Type() == SCH_JUNCTION_T && !m_testJunctions )
+            return false;
+
+        return aItem->IsConnected( m_position );
+    }
+
+    const wxPoint&  m_position;
+    bool            m_testJunctions;
+};
+
+
+/**
+ * Struct CONNECTED_ITEMS_COUNTER
+ * is a visitor of SCH_ITEMS_RTREE, counting the items connected at a position.
+ */
+struct CONNECTED_ITEMS_COUNTER
+{
+    CONNECTED_ITEMS_COUNTER( const CONNECTED_AT_POSITION& aConnected ) :
+        m_connected( aConnected ), m_count( 0 )
+    {
+    }
+
+    bool operator()( const SCH_ITEM_REF& aRef )
+    {
+        if( m_connected( aRef.item ) )
+            m_count++;
+
+        return true;
+    }
+
+    const CONNECTED_AT_POSITION&    m_connected;
+    int                             m_count;
+};
+
+
+/// Test of the segments BreakSegment() breaks
+struct SEGMENT_TO_BREAK
+{
+    SEGMENT_TO_BREAK( const wxPoint& aPoint ) :
+        m_point( aPoint )
+    {
+    }
+
+    bool operator()( SCH_ITEM* aItem ) const
+    {
+        if( (aItem->Type() != SCH_LINE_T) || (aItem->GetLayer() == LAYER_NOTES) )
+            return false;
+
+        SCH_LINE* segment = (SCH_LINE*) aItem;
+
+        return segment->HitTest( m_point, 0 ) && !segment->IsEndPoint( m_point );
+    }
+
+    const wxPoint&  m_point;
+};
+
+
+/// Test of the items MarkConnections() can mark from a segment
+struct SEGMENT_CONNECTION
+{
+    SEGMENT_CONNECTION( SCH_LINE* aSegment ) :
+        m_segment( aSegment )
+    {
+    }
+
+    bool operator()( SCH_ITEM* aItem ) const
+    {
+        if( aItem->Type() == SCH_JUNCTION_T )
+            return m_segment->IsEndPoint( ( (SCH_JUNCTION*) aItem )->GetPosition() );
+
+        if( aItem->Type() != SCH_LINE_T )
+            return false;
+
+        SCH_LINE* segment = (SCH_LINE*) aItem;
+
+        return m_segment->IsEndPoint( segment->GetStartPoint() )
+               || m_segment->IsEndPoint( segment->GetEndPoint() );
+    }
+
+    SCH_LINE*   m_segment;
+};
+
+
+/**
+ * Function markConnection
+ * sets the CANDIDATE flag of \a aItem if it is connected to \a aSegment, and marks the
+ * connections of the segments it flags.  Used by SCH_SCREEN::MarkConnections().
+ */
+static void markConnection( SCH_SCREEN* aScreen, SCH_LINE* aSegment, SCH_ITEM* aItem )
+{
+    if( aItem->GetFlags() & CANDIDATE )
+        return;
+
+    if( aItem->Type() == SCH_JUNCTION_T )
+    {
+        SCH_JUNCTION* junction = (SCH_JUNCTION*) aItem;
+
+        if( aSegment->IsEndPoint( junction->GetPosition() ) )
+            aItem->SetFlags( CANDIDATE );
+
+        return;
+    }
+
+    if( aItem->Type() != SCH_LINE_T )
+        return;
+
+    SCH_LINE* segment = (SCH_LINE*) aItem;
+
+    if( aSegment->IsEndPoint( segment->GetStartPoint() )
+        && !aScreen->GetPin( segment->GetStartPoint(), NULL, true ) )
+    {
+        aItem->SetFlags( CANDIDATE );
+        aScreen->MarkConnections( segment );
+    }
+
+    if( aSegment->IsEndPoint( segment->GetEndPoint() )
+        && !aScreen->GetPin( segment->GetEndPoint(), NULL, true ) )
+    {
+        aItem->SetFlags( CANDIDATE );
+        aScreen->MarkConnections( segment );
+    }
+}
+
+
+/// Test used by GetConnection() to find the deleted segments ending at a point
+struct DELETED_SEGMENT_END
+{
+    DELETED_SEGMENT_END( const wxPoint& aPoint ) :
+        m_point( aPoint )
+    {
+    }
+
+    bool operator()( SCH_ITEM* aItem ) const
+    {
+        return ( aItem->GetFlags() & STRUCT_DELETED ) && aItem->Type() == SCH_LINE_T
+               && ( (SCH_LINE*) aItem )->IsEndPoint( m_point );
+    }
+
+    const wxPoint&  m_point;
+};
+
+
+/**
+ * Function findPinAtEndPoint
+ * @return the first pin of the unit and the body style of \a aComponent having its
+ * connection point at \a aPosition, or NULL.  The part of \a aComponent is searched
+ * in \a aLibs.
+ */
+static LIB_PIN* findPinAtEndPoint( SCH_COMPONENT* aComponent, PART_LIBS* aLibs,
+                                   const wxPoint& aPosition )
+{
+    LIB_PART* part = aLibs->FindLibPart( aComponent->GetPartName() );
+
+    if( !part )
+        return NULL;
+
+    for( LIB_PIN* pin = part->GetNextPin(); pin; pin = part->GetNextPin( pin ) )
+    {
+        // Skip items not used for this part.
+        if( aComponent->GetUnit() && pin->GetUnit() &&
+            ( pin->GetUnit() != aComponent->GetUnit() ) )
+            continue;
+
+        if( aComponent->GetConvert() && pin->GetConvert() &&
+            ( pin->GetConvert() != aComponent->GetConvert() ) )
+            continue;
+
+        if( aComponent->GetPinPhysicalPosition( pin ) == aPosition )
+            return pin;
+    }
+
+    return NULL;
+}
+
+
+/// Hit test used by GetPin() to find a pin connection point
+struct COMPONENT_PIN_AT_POSITION
+{
+    COMPONENT_PIN_AT_POSITION( const wxPoint& aPosition, PART_LIBS* aLibs ) :
+        m_position( aPosition ), m_libs( aLibs )
+    {
+    }
+
+    bool operator()( SCH_ITEM* aItem ) const
+    {
+        return aItem->Type() == SCH_COMPONENT_T
+               && findPinAtEndPoint( (SCH_COMPONENT*) aItem, m_libs, m_position );
+    }
+
+    const wxPoint&  m_position;
+    PART_LIBS*      m_libs;
+};
+
+
+/**
+ * Function addPinPositions
+ * adds to \a aPositions the connection points of the pins of \a aPart used by the unit
+ * and the body style of \a aComponent.
+ */
+static void addPinPositions( SCH_COMPONENT* aComponent, LIB_PART* aPart,
+                             std::vector<wxPoint>& aPositions )
+{
+    for( LIB_PIN* pin = aPart->GetNextPin(); pin; pin = aPart->GetNextPin( pin ) )
+    {
+        if( aComponent->GetUnit() && pin->GetUnit() &&
+            ( pin->GetUnit() != aComponent->GetUnit() ) )
+            continue;
+
+        if( aComponent->GetConvert() && pin->GetConvert() &&
+            ( pin->GetConvert() != aComponent->GetConvert() ) )
+            continue;
+
+        aPositions.push_back( aComponent->GetPinPhysicalPosition( pin ) );
+    }
+}
+
+
+SCH_SCREEN::SPATIAL_INDEX_STAMP SCH_SCREEN::spatialIndexStamp() const
+{
+    SPATIAL_INDEX_STAMP stamp;
+
+    stamp.items         = m_drawList.GetRevision();
+    stamp.libraries     = Prj().SchLibs()->GetModifyHash();
+    stamp.lineThickness = GetDefaultLineThickness();
+    stamp.junctionSize  = SCH_JUNCTION::GetSymbolSize();
+
+    return stamp;
+}
+
+
+bool SCH_SCREEN::useSpatialIndex() const
+{
+    // Nothing to index, and no need to load the libraries of an empty screen
+    if( m_drawList.GetCount() == 0 )
+        return false;
+
+    SPATIAL_INDEX_STAMP stamp = spatialIndexStamp();
+
+    if( m_spatialIndex && stamp == m_spatialIndexStamp )
+    {
+        updateSpatialIndexAreas();
+        return true;
+    }
+
+    if( stamp == m_spatialQueryStamp )
+    {
+        // The screen has not changed since the last query, it is worth to index it
+        buildSpatialIndex();
+        return true;
+    }
+
+    m_spatialQueryStamp = stamp;
+
+    return false;
+}
+
+
+void SCH_SCREEN::buildSpatialIndex() const
+{
+    if( !m_spatialIndex )
+        m_spatialIndex = new SCH_ITEMS_RTREE;
+    else
+        m_spatialIndex->RemoveAll();
+
+    const double step = SCH_ITEMS_RTREE::OrderStep();
+    double order = 0.0;
+
+    for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
+    {
+        m_spatialIndex->Insert( item, order );
+        order += step;
+    }
+
+    updateSpatialIndexAreas();
+
+    m_spatialIndexStamp = spatialIndexStamp();
+}
+
+
+void SCH_SCREEN::updateSpatialIndexAreas() const
+{
+    std::vector<SCH_ITEM*> items;
+
+    m_spatialIndex->TakeOutdatedItems( items );
+
+    if( items.empty() )
+        return;
+
+    PART_LIBS*              libs = Prj().SchLibs();
+    std::vector<wxPoint>    points;
+
+    for( unsigned ii = 0; ii < items.size(); ii++ )
+    {
+        SCH_ITEM* item = items[ii];
+
+        points.clear();
+
+        switch( item->Type() )
+        {
+        case SCH_JUNCTION_T:
+        case SCH_NO_CONNECT_T:
+            // Their hit tests use their bounding box
+            points.push_back( item->GetBoundingBox().GetOrigin() );
+            points.push_back( item->GetBoundingBox().GetEnd() );
+            break;
+
+        case SCH_LINE_T:
+        case SCH_BUS_WIRE_ENTRY_T:
+        case SCH_BUS_BUS_ENTRY_T:
+            // Segments from one connection point to the other one
+            item->GetConnectionPoints( points );
+            break;
+
+        case SCH_COMPONENT_T:
+        {
+            // The pins of the part used by the connection tests, and the pins of the
+            // part found in the libraries by GetPin()
+            SCH_COMPONENT*  component = (SCH_COMPONENT*) item;
+            PART_SPTR       part = component->GetPartRef().lock();
+            LIB_PART*       libPart = libs->FindLibPart( component->GetPartName() );
+
+            if( part )
+                addPinPositions( component, part.get(), points );
+
+            if( libPart && libPart != part.get() )
+                addPinPositions( component, libPart, points );
+
+            break;
+        }
+
+        default:
+            break;
+        }
+
+        if( points.empty() )
+        {
+            m_spatialIndex->SetArea( item, NULL );
+            continue;
+        }
+
+        EDA_RECT area( points[0], wxSize( 0, 0 ) );
+
+        for( unsigned jj = 1; jj < points.size(); jj++ )
+            area.Merge( points[jj] );
+
+        m_spatialIndex->SetArea( item, &area );
+    }
+}
+
+
+bool SCH_SCREEN::indexItems( SCH_ITEM* aFirst, SCH_ITEM* aLast, bool aIndexCurrent )
+{
+    if( !aIndexCurrent )
+        return false;
+
+    const double        step = SCH_ITEMS_RTREE::OrderStep();
+    std::vector<double> orders;
+    double              back = 0.0;
+    double              next = 0.0;
+    SCH_ITEM*           item;
+
+    for( item = aFirst; item; item = item->Next() )
+    {
+        orders.push_back( 0.0 );
+
+        if( item == aLast )
+            break;
+    }
+
+    if( aFirst && aFirst->Back() && !m_spatialIndex->GetOrder( aFirst->Back(), &back ) )
+        return false;
+
+    if( aLast && aLast->Next() && !m_spatialIndex->GetOrder( aLast->Next(), &next ) )
+        return false;
+
+    for( unsigned ii = 0; ii < orders.size(); ii++ )
+    {
+        if( aFirst->Back() && aLast->Next() )
+            orders[ii] = back + ( next - back ) * ( ii + 1 ) / ( orders.size() + 1 );
+        else if( aFirst->Back() )
+            orders[ii] = back + step * ( ii + 1 );
+        else if( aLast->Next() )
+            orders[ii] = next - step * ( orders.size() - ii );
+        else
+            orders[ii] = step * ii;
+
+        // No key left between the neighbours
+        if( ( aFirst->Back() && orders[ii] <= back ) || ( ii && orders[ii] <= orders[ii - 1] )
+            || ( aLast->Next() && orders[ii] >= next ) )
+            return false;
+    }
+
+    item = aFirst;
+
+    for( unsigned ii = 0; ii < orders.size(); ii++, item = item->Next() )
+        m_spatialIndex->Insert( item, orders[ii] );
+
+    m_spatialIndexStamp = spatialIndexStamp();
+
+    return true;
+}
+
+
+bool SCH_SCREEN::unindexItem( SCH_ITEM* aItem, bool aIndexCurrent )
+{
+    // Unindexed even if the index is outdated, so the item does not stay linked to it
+    if( m_spatialIndex )
+        m_spatialIndex->Remove( aItem );
+
+    if( !aIndexCurrent )
+        return false;
+
+    m_spatialIndexStamp = spatialIndexStamp();
+
+    return true;
+}
+
+
 SCH_ITEM* SCH_SCREEN::GetItem( const wxPoint& aPosition, int aAccuracy, KICAD_T aType ) const
 {
+    switch( aType )
+    {
+    case SCH_JUNCTION_T:
+    case SCH_NO_CONNECT_T:
+    case SCH_LINE_T:
+    case SCH_BUS_WIRE_ENTRY_T:
+    case SCH_BUS_BUS_ENTRY_T:
+        if( useSpatialIndex() )
+            return findFirstItem( m_spatialIndex, aPosition, aAccuracy,
+                                  ITEM_AT_POSITION( aPosition, aAccuracy, aType ) );
+
+        break;
+
+    default:
+        break;
+    }
+
     for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
     {
         if( item->HitTest( aPosition, aAccuracy ) && (aType == NOT_USED) )
@@ -240,6 +947,7 @@ void SCH_SCREEN::ExtractWires( DLIST< SCH_ITEM >& aList, bool aCreateCopy )
 {
     SCH_ITEM* item;
     SCH_ITEM* next_item;
+    bool      indexCurrent = isSpatialIndexCurrent();
 
     for( item = m_drawList.begin(); item; item = next_item )
     {
@@ -250,10 +958,16 @@ void SCH_SCREEN::ExtractWires( DLIST< SCH_ITEM >& aList, bool aCreateCopy )
         case SCH_JUNCTION_T:
         case SCH_LINE_T:
             m_drawList.Remove( item );
+            indexCurrent = unindexItem( item, indexCurrent );
             aList.Append( item );
 
             if( aCreateCopy )
-                m_drawList.Insert( (SCH_ITEM*) item->Clone(), next_item );
+            {
+                SCH_ITEM* copy = (SCH_ITEM*) item->Clone();
+
+                m_drawList.Insert( copy, next_item );
+                indexCurrent = indexItems( copy, copy, indexCurrent );
+            }
 
             break;
 
@@ -286,7 +1000,7 @@ void SCH_SCREEN::ReplaceWires( DLIST< SCH_ITEM >& aWireList )
         }
     }
 
-    m_drawList.Append( aWireList );
+    appendItems( aWireList );
 }
 
 
@@ -295,40 +1009,30 @@ void SCH_SCREEN::MarkConnections( SCH_LINE* aSegment )
     wxCHECK_RET( (aSegment) && (aSegment->Type() == SCH_LINE_T),
                  wxT( "Invalid object pointer." ) );
 
-    for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
+    if( !useSpatialIndex() )
     {
-        if( item->GetFlags() & CANDIDATE )
-            continue;
+        for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
+            markConnection( this, aSegment, item );
 
-        if( item->Type() == SCH_JUNCTION_T )
-        {
-            SCH_JUNCTION* junction = (SCH_JUNCTION*) item;
+        return;
+    }
 
-            if( aSegment->IsEndPoint( junction->GetPosition() ) )
-                item->SetFlags( CANDIDATE );
+    // The items connected to aSegment are at one of its ends.  They are all found before
+    // the recursive calls, which may update the spatial index, and are visited in the
+    // draw list order, as the linear search does.
+    SEGMENT_CONNECTION                  connection( aSegment );
+    ITEMS_COLLECTOR<SEGMENT_CONNECTION> collector( connection );
 
-            continue;
-        }
+    m_spatialIndex->Query( aSegment->GetStartPoint(), 0, collector );
+    m_spatialIndex->Query( aSegment->GetEndPoint(), 0, collector );
 
-        if( item->Type() != SCH_LINE_T )
-            continue;
+    std::vector<SCH_ITEM_REF>& items = collector.m_found;
 
-        SCH_LINE* segment = (SCH_LINE*) item;
+    sort( items.begin(), items.end(), sortByDrawListOrder );
+    items.erase( unique( items.begin(), items.end() ), items.end() );
 
-        if( aSegment->IsEndPoint( segment->GetStartPoint() )
-            && !GetPin( segment->GetStartPoint(), NULL, true ) )
-        {
-            item->SetFlags( CANDIDATE );
-            MarkConnections( segment );
-        }
-
-        if( aSegment->IsEndPoint( segment->GetEndPoint() )
-            && !GetPin( segment->GetEndPoint(), NULL, true ) )
-        {
-            item->SetFlags( CANDIDATE );
-            MarkConnections( segment );
-        }
-    }
+    for( unsigned ii = 0; ii < items.size(); ii++ )
+        markConnection( this, aSegment, items[ii].item );
 }
 
 
@@ -648,6 +1352,23 @@ LIB_PIN* SCH_SCREEN::GetPin( const wxPoint& aPosition, SCH_COMPONENT** aComponen
     SCH_COMPONENT*  component = NULL;
     LIB_PIN*        pin = NULL;
 
+    if( aEndPointOnly && useSpatialIndex() )
+    {
+        PART_LIBS* libs = Prj().SchLibs();
+
+        component = (SCH_COMPONENT*) findFirstItem( m_spatialIndex, aPosition, 0,
+                                                    COMPONENT_PIN_AT_POSITION( aPosition,
+                                                                               libs ) );
+
+        if( component )
+            pin = findPinAtEndPoint( component, libs, aPosition );
+
+        if( pin && aComponent )
+            *aComponent = component;
+
+        return pin;
+    }
+
     for( item = m_drawList.begin(); item; item = item->Next() )
     {
         if( item->Type() != SCH_COMPONENT_T )
@@ -657,27 +1378,8 @@ LIB_PIN* SCH_SCREEN::GetPin( const wxPoint& aPosition, SCH_COMPONENT** aComponen
 
         if( aEndPointOnly )
         {
-            pin = NULL;
-
-            LIB_PART* part = Prj().SchLibs()->FindLibPart( component->GetPartName() );
-
-            if( !part )
-                continue;
+            pin = findPinAtEndPoint( component, Prj().SchLibs(), aPosition );
 
-            for( pin = part->GetNextPin(); pin; pin = part->GetNextPin( pin ) )
-            {
-                // Skip items not used for this part.
-                if( component->GetUnit() && pin->GetUnit() &&
-                    ( pin->GetUnit() != component->GetUnit() ) )
-                    continue;
-
-                if( component->GetConvert() && pin->GetConvert() &&
-                    ( pin->GetConvert() != component->GetConvert() ) )
-                    continue;
-
-                if(component->GetPinPhysicalPosition( pin ) == aPosition )
-                    break;
-            }
             if( pin )
                 break;
         }
@@ -739,6 +1441,26 @@ int SCH_SCREEN::CountConnectedItems( const wxPoint& aPos, bool aTestJunctions )
     SCH_ITEM* item;
     int       count = 0;
 
+    if( useSpatialIndex() )
+    {
+        CONNECTED_AT_POSITION   connected( aPos, aTestJunctions );
+        CONNECTED_ITEMS_COUNTER counter( connected );
+
+        m_spatialIndex->Query( aPos, 0, counter );
+        count = counter.m_count;
+
+        // The labels are not found by the spatial index queries
+        const SCH_ITEMS_RTREE::ITEMS& others = m_spatialIndex->GetItemsWithoutArea();
+
+        for( SCH_ITEMS_RTREE::ITEMS::const_iterator it = others.begin(); it != others.end(); ++it )
+        {
+            if( connected( *it ) )
+                count++;
+        }
+
+        return count;
+    }
+
     for( item = m_drawList.begin(); item; item = item->Next() )
     {
         if( item->Type() == SCH_JUNCTION_T  && !aTestJunctions )
@@ -957,28 +1679,42 @@ bool SCH_SCREEN::BreakSegment( const wxPoint& aPoint )
 {
     SCH_LINE* segment;
     SCH_LINE* newSegment;
-    bool brokenSegments = false;
+    SEGMENT_TO_BREAK toBreak( aPoint );
+    std::vector<SCH_ITEM*> segments;
 
-    for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
+    // The new segments start at aPoint and are never broken, so the segments to break
+    // can all be found before breaking them.
+    if( useSpatialIndex() )
     {
-        if( (item->Type() != SCH_LINE_T) || (item->GetLayer() == LAYER_NOTES) )
-            continue;
+        findItems( m_spatialIndex, aPoint, 0, toBreak, segments );
+    }
+    else
+    {
+        for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
+        {
+            if( toBreak( item ) )
+                segments.push_back( item );
+        }
+    }
 
-        segment = (SCH_LINE*) item;
+    if( segments.empty() )
+        return false;
 
-        if( !segment->HitTest( aPoint, 0 ) || segment->IsEndPoint( aPoint ) )
-            continue;
+    bool indexCurrent = isSpatialIndexCurrent();
+
+    for( unsigned ii = 0; ii < segments.size(); ii++ )
+    {
+        segment = (SCH_LINE*) segments[ii];
 
         // Break the segment at aPoint and create a new segment.
         newSegment = new SCH_LINE( *segment );
         newSegment->SetStartPoint( aPoint );
         segment->SetEndPoint( aPoint );
         m_drawList.Insert( newSegment, segment->Next() );
-        item = newSegment;
-        brokenSegments = true;
+        indexCurrent = indexItems( newSegment, newSegment, indexCurrent );
     }
 
-    return brokenSegments;
+    return true;
 }
 
 
@@ -1013,17 +1749,22 @@ bool SCH_SCREEN::BreakSegmentsOnJunctions()
 
 int SCH_SCREEN::GetNode( const wxPoint& aPosition, EDA_ITEMS& aList )
 {
+    NODE_AT_POSITION node( aPosition );
+
+    if( useSpatialIndex() )
+    {
+        std::vector<SCH_ITEM*> items;
+
+        findItems( m_spatialIndex, aPosition, 0, node, items );
+        aList.insert( aList.end(), items.begin(), items.end() );
+
+        return (int) aList.size();
+    }
+
     for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
     {
-        if( item->Type() == SCH_LINE_T && item->HitTest( aPosition )
-            && (item->GetLayer() == LAYER_BUS || item->GetLayer() == LAYER_WIRE) )
-        {
+        if( node( item ) )
             aList.push_back( item );
-        }
-        else if( item->Type() == SCH_JUNCTION_T && item->HitTest( aPosition ) )
-        {
-            aList.push_back( item );
-        }
     }
 
     return (int) aList.size();
@@ -1032,50 +1773,24 @@ int SCH_SCREEN::GetNode( const wxPoint& aPosition, EDA_ITEMS& aList )
 
 SCH_LINE* SCH_SCREEN::GetWireOrBus( const wxPoint& aPosition )
 {
-    for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
-    {
-        if( (item->Type() == SCH_LINE_T) && item->HitTest( aPosition )
-            && (item->GetLayer() == LAYER_BUS || item->GetLayer() == LAYER_WIRE) )
-        {
-            return (SCH_LINE*) item;
-        }
-    }
+    WIRE_OR_BUS_AT_POSITION wireOrBus( aPosition );
 
-    return NULL;
+    if( useSpatialIndex() )
+        return (SCH_LINE*) findFirstItem( m_spatialIndex, aPosition, 0, wireOrBus );
+
+    return (SCH_LINE*) findFirstItem( m_drawList.begin(), wireOrBus );
 }
 
 
 SCH_LINE* SCH_SCREEN::GetLine( const wxPoint& aPosition, int aAccuracy, int aLayer,
                                SCH_LINE_TEST_T aSearchType )
 {
-    for( SCH_ITEM* item = m_drawList.begin(); item; item = item->Next() )
-    {
-        if( item->Type() != SCH_LINE_T )
-            continue;
-
-        if( item->GetLayer() != aLayer )
-            continue;
+    LINE_AT_POSITION line( aPosition, aAccuracy, aLayer, aSearchType );
 
-        if( !item->HitTest( aPosition, aAccuracy ) )
-            continue;
+    if( useSpatialIndex() )
+        return (SCH_LINE*) findFirstItem( m_spatialIndex, aPosition, aAccuracy, line );
 
-        switch( aSearchType )
-        {
-        case ENTIRE_LENGTH_T:
-            return (SCH_LINE*) item;
-
-        case EXCLUDE_END_POINTS_T:
-            if( !( (SCH_LINE*) item )->IsEndPoint( aPosition ) )
-                return (SCH_LINE*) item;
-            break;
-
-        case END_POINTS_ONLY_T:
-            if( ( (SCH_LINE*) item )->IsEndPoint( aPosition ) )
-                return (SCH_LINE*) item;
-        }
-    }
-
-    return NULL;
+    return (SCH_LINE*) findFirstItem( m_drawList.begin(), line );
 }
 
 
@@ -1206,21 +1921,12 @@ int SCH_SCREEN::GetConnection( const wxPoint& aPosition, PICKED_ITEMS_LIST& aLis
 
             /* If the wire start point is connected to a wire that was already found
              * and now is not connected, add the wire to the list. */
-            for( tmp = m_drawList.begin(); tmp; tmp = tmp->Next() )
-            {
-                // Ensure tmp is a previously deleted segment:
-                if( ( tmp->GetFlags() & STRUCT_DELETED ) == 0 )
-                    continue;
-
-                if( tmp->Type() != SCH_LINE_T )
-                    continue;
-
-                SCH_LINE* testSegment = (SCH_LINE*) tmp;
+            DELETED_SEGMENT_END deletedStart( segment->GetStartPoint() );
 
-               // Test for segment connected to the previously deleted segment:
-                if( testSegment->IsEndPoint( segment->GetStartPoint() ) )
-                    break;
-            }
+            if( useSpatialIndex() )
+                tmp = findFirstItem( m_spatialIndex, segment->GetStartPoint(), 0, deletedStart );
+            else
+                tmp = findFirstItem( m_drawList.begin(), deletedStart );
 
             // when tmp != NULL, segment is a new candidate:
             // put it in deleted list if
@@ -1230,21 +1936,12 @@ int SCH_SCREEN::GetConnection( const wxPoint& aPosition, PICKED_ITEMS_LIST& aLis
 
             /* If the wire end point is connected to a wire that has already been found
              * and now is not connected, add the wire to the list. */
-            for( tmp = m_drawList.begin(); tmp; tmp = tmp->Next() )
-            {
-                // Ensure tmp is a previously deleted segment:
-                if( ( tmp->GetFlags() & STRUCT_DELETED ) == 0 )
-                    continue;
-
-                if( tmp->Type() != SCH_LINE_T )
-                    continue;
+            DELETED_SEGMENT_END deletedEnd( segment->GetEndPoint() );
 
-                SCH_LINE* testSegment = (SCH_LINE*) tmp;
-
-                // Test for segment connected to the previously deleted segment:
-                if( testSegment->IsEndPoint( segment->GetEndPoint() ) )
-                    break;
-            }
+            if( useSpatialIndex() )
+                tmp = findFirstItem( m_spatialIndex, segment->GetEndPoint(), 0, deletedEnd );
+            else
+                tmp = findFirstItem( m_drawList.begin(), deletedEnd );
 
             // when tmp != NULL, segment is a new candidate:
             // put it in deleted list if
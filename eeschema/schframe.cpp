@@ -718,7 +718,9 @@ void SCH_EDIT_FRAME::OnModify()
     GetScreen()->SetModify();
     GetScreen()->SetSave();
 
-    m_foundItems.SetForceSearch();
+    // Only the current screen is searched again by the next find, the commands modifying
+    // other screens force a new search of the whole hierarchy.
+    m_foundItems.SetSheetModified( GetScreen() );
 }
 
 
@@ -206,6 +206,13 @@ protected:
 
     void updateFindReplaceView( wxFindDialogEvent& aEvent );
 
+    /**
+     * Function setFindReplaceSheet
+     * makes \a aSheet the current sheet, without redrawing it, so a found item can be
+     * shown or modified.
+     */
+    void setFindReplaceSheet( SCH_SHEET_PATH* aSheet );
+
     void backAnnotateFootprints( const std::string& aChangedSetOfReferences )
         throw( IO_ERROR, boost::bad_pointer );
 
@@ -0,0 +1,135 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2015 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file background_file_writer.h
+ */
+
+#ifndef BACKGROUND_FILE_WRITER_H_
+#define BACKGROUND_FILE_WRITER_H_
+
+#include <string>
+#include <wx/string.h>
+#include <wx/event.h>
+#include <boost/thread.hpp>
+
+class OUTPUTFORMATTER;
+
+
+/**
+ * Class BACKGROUND_FILE_WRITER
+ * formats a snapshot of a document and writes it to a file in a worker thread, so the
+ * user can keep on editing during the save.
+ * The text is written to a temporary file which is then renamed to the destination
+ * file, so the destination is always either the previous or the new complete file.
+ * Only one write at a time is done.
+ */
+class BACKGROUND_FILE_WRITER
+{
+public:
+    /**
+     * Class SNAPSHOT
+     * is a copy of a document, made in the main thread and formatted in the worker
+     * thread.  It is deleted in the main thread.
+     */
+    class SNAPSHOT
+    {
+    public:
+        virtual ~SNAPSHOT() {}
+
+        /**
+         * Function Format
+         * outputs the document to \a aFormatter.  It is called in the worker thread, so
+         * it must not use anything but the snapshot.
+         * @throw IO_ERROR if the document cannot be formatted.
+         */
+        virtual void Format( OUTPUTFORMATTER* aFormatter ) = 0;
+    };
+
+    /**
+     * Constructor
+     * @param aHandler, if not NULL, receives a wxThreadEvent (wxEVT_THREAD) when a write
+     *  ends, so it can call Wait() to report the errors without polling.
+     * @param aId is the id of this event.
+     */
+    BACKGROUND_FILE_WRITER( wxEvtHandler* aHandler = NULL, int aId = wxID_ANY );
+
+    /// Waits for the write in progress, if any.
+    ~BACKGROUND_FILE_WRITER();
+
+    /**
+     * Function Start
+     * starts formatting @a aSnapshot and writing it to @a aFileName in a worker thread.
+     *
+     * @param aSnapshot is the document to write, owned by the writer from now on.
+     * @param aFileName is the full path of the destination file.
+     * @return bool - false if the previous write is still running, then nothing
+     *  is done and @a aSnapshot is deleted.
+     */
+    bool Start( SNAPSHOT* aSnapshot, const wxString& aFileName );
+
+    /**
+     * Function IsBusy
+     * @return bool - true while a write is running.
+     */
+    bool IsBusy();
+
+    /**
+     * Function Wait
+     * waits for the write in progress, if any, and deletes its snapshot.
+     *
+     * @return wxString - the error message of the last write, empty if it was
+     *  successful.  An error is returned only once, so it is reported only once.
+     */
+    wxString Wait();
+
+private:
+    /// What the worker thread failed to do
+    enum STATUS
+    {
+        WRITE_OK,
+        FORMAT_FAILED,
+        OPEN_FAILED,
+        WRITE_FAILED,
+        RENAME_FAILED
+    };
+
+    /// The worker thread function
+    void run();
+
+    wxEvtHandler*   m_handler;      ///< notified when a write ends
+    int             m_id;           ///< id of the notification event
+    boost::thread*  m_thread;
+    boost::mutex    m_lock;         ///< protects m_busy
+    bool            m_busy;
+
+    // Owned by the worker thread while m_busy is true.  The file names and the
+    // error are copied as UTF8 since wxString copies may share their data.
+    SNAPSHOT*       m_snapshot;
+    std::string     m_fileName;
+    std::string     m_tempFileName;
+    std::string     m_formatError;
+    STATUS          m_status;
+};
+
+#endif  // BACKGROUND_FILE_WRITER_H_
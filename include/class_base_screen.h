@@ -129,6 +129,14 @@ private:
      */
     wxPoint getCrossHairScreenPosition() const;
 
+    /**
+     * Function trimUndoORRedoList
+     * removes the oldest commands from \a aList until both the command count and the
+     * memory budget are respected. The most recent command is always kept, so the
+     * last change can be undone even if it exceeds the memory budget alone.
+     */
+    void trimUndoORRedoList( UNDO_REDO_CONTAINER& aList );
+
     /**
      * Function getNearestGridPosition
      * returns the nearest \a aGridSize location to \a aPosition.
@@ -209,6 +217,7 @@ public:
     UNDO_REDO_CONTAINER m_UndoList;         ///< Objects list for the undo command (old data)
     UNDO_REDO_CONTAINER m_RedoList;         ///< Objects list for the redo command (old data)
     unsigned            m_UndoRedoCountMax; ///< undo/Redo command Max depth
+    size_t              m_UndoRedoMemoryMax; ///< undo/Redo memory budget in bytes, 0 = no limit
 
     // block control
     BLOCK_SELECTOR      m_BlockLocate;      ///< Block description for block commands
@@ -268,11 +277,24 @@ public:
      */
     virtual void ClearUndoRedoList();
 
+    /**
+     * Function GetCommandMemorySize (virtual).
+     * estimates the memory used by the data owned by \a aCommand (item copies and deleted
+     * items), so undo and redo lists can be limited by a memory budget
+     * (see m_UndoRedoMemoryMax). Only the derived screens know the stored item types.
+     * @param aCommand = the command to evaluate
+     * @return the estimated size in bytes, or 0 if unknown
+     */
+    virtual size_t GetCommandMemorySize( const PICKED_ITEMS_LIST& aCommand ) const
+    {
+        return 0;
+    }
+
     /**
      * Function PushCommandToUndoList
      * add a command to undo in undo list
-     * delete the very old commands when the max count of undo commands is
-     * reached
+     * delete the very old commands when the max count of undo commands or
+     * the undo memory budget is reached
      * ( using ClearUndoORRedoList)
      */
     virtual void PushCommandToUndoList( PICKED_ITEMS_LIST* aItem );
@@ -280,8 +302,8 @@ public:
     /**
      * Function PushCommandToRedoList
      * add a command to redo in redo list
-     * delete the very old commands when the max count of redo commands is
-     * reached
+     * delete the very old commands when the max count of redo commands or
+     * the redo memory budget is reached
      * ( using ClearUndoORRedoList)
      */
     virtual void PushCommandToRedoList( PICKED_ITEMS_LIST* aItem );
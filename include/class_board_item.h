@@ -39,6 +39,9 @@
 #define FMT_IU     BOARD_ITEM::FormatInternalUnits
 #define FMT_ANGLE  BOARD_ITEM::FormatAngle
 
+/// Size of the buffers given to the FMT_IU( char*, ... ) functions, big enough for a point.
+#define FMT_IU_BUFSIZE  64
+
 class BOARD;
 class EDA_DRAW_PANEL;
 
@@ -312,6 +315,24 @@ public:
 
     static std::string FormatInternalUnits( const wxSize& aSize );
 
+    /**
+     * Function FormatInternalUnits
+     * writes \a aValue, converted like FormatInternalUnits( int ) does, to \a aBuffer,
+     * without any memory allocation.  Used to write big boards fast.
+     *
+     * @param aBuffer is the destination, at least FMT_IU_BUFSIZE bytes long.
+     * @param aValue A coordinate value to convert.
+     * @return int - the length of the text, which is null terminated.
+     */
+    static int FormatInternalUnits( char* aBuffer, int aValue );
+
+    /**
+     * Function FormatInternalUnits
+     * writes the coordinates of \a aPoint separated by a space to \a aBuffer.
+     * @see FormatInternalUnits( char*, int ).
+     */
+    static int FormatInternalUnits( char* aBuffer, const wxPoint& aPoint );
+
     /// @copydoc VIEW_ITEM::ViewGetLayers()
     virtual void ViewGetLayers( int aLayers[], int& aCount ) const;
 
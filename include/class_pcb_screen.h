@@ -36,6 +36,9 @@
 
 class UNDO_REDO_CONTAINER;
 
+/// Default memory budget of the undo/redo lists, in MB (see BASE_SCREEN::m_UndoRedoMemoryMax)
+#define PCB_UNDO_MEMORY_MAX_DEFAULT_MB  256
+
 
 /* Handle info to display a board */
 class PCB_SCREEN : public BASE_SCREEN
@@ -100,6 +103,13 @@ public:
      * So this function can be called to remove old commands
      */
     void ClearUndoORRedoList( UNDO_REDO_CONTAINER& aList, int aItemCount = -1 );
+
+    /**
+     * Function GetCommandMemorySize
+     * estimates the memory used by the board item copies and the deleted items owned
+     * by \a aCommand. Zone outlines and fillings, module pads and drawings are counted.
+     */
+    size_t GetCommandMemorySize( const PICKED_ITEMS_LIST& aCommand ) const;
 };
 
 #endif  // CLASS_PCB_SCREEN_H_
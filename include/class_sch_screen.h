@@ -47,6 +47,7 @@ class SCH_SHEET_PATH;
 class SCH_SHEET_PIN;
 class SCH_LINE;
 class SCH_TEXT;
+class SCH_ITEMS_RTREE;
 class PLOTTER;
 
 
@@ -84,6 +85,34 @@ private:
     int     m_modification_sync;        ///< inequality with PART_LIBS::GetModificationHash()
                                         ///< will trigger ResolveAll().
 
+    /// State of the draw list and of the settings the items geometry depends on,
+    /// see spatialIndexStamp()
+    struct SPATIAL_INDEX_STAMP
+    {
+        unsigned items;
+        int      libraries;
+        int      lineThickness;
+        int      junctionSize;
+
+        bool operator==( const SPATIAL_INDEX_STAMP& aOther ) const
+        {
+            return items == aOther.items && libraries == aOther.libraries &&
+                   lineThickness == aOther.lineThickness &&
+                   junctionSize == aOther.junctionSize;
+        }
+    };
+
+    /// Spatial index of the draw list items, used by the hit test functions.  Only the
+    /// wires, buses, junctions, no connects, bus entries and component pins can be found
+    /// by its queries.
+    mutable SCH_ITEMS_RTREE*        m_spatialIndex;
+
+    /// Screen state the spatial index has been built or updated for
+    mutable SPATIAL_INDEX_STAMP     m_spatialIndexStamp;
+
+    /// Screen state seen by the last query that could not use the spatial index
+    mutable SPATIAL_INDEX_STAMP     m_spatialQueryStamp;
+
     /**
      * Function addConnectedItemsToBlock
      * add items connected at \a aPosition to the block pick list.
@@ -96,6 +125,70 @@ private:
      */
     void addConnectedItemsToBlock( const wxPoint& aPosition );
 
+    /**
+     * Function spatialIndexStamp
+     * @return the current state of the screen: revision of the draw list, revision of the
+     * libraries, default line thickness and junction size.
+     */
+    SPATIAL_INDEX_STAMP spatialIndexStamp() const;
+
+    /**
+     * Function isSpatialIndexCurrent
+     * @return true if the spatial index is built and describes the draw list.
+     */
+    bool isSpatialIndexCurrent() const
+    {
+        return m_spatialIndex && spatialIndexStamp() == m_spatialIndexStamp;
+    }
+
+    /**
+     * Function useSpatialIndex
+     * checks if the spatial index can be used by a hit test function, and updates the
+     * areas of the items moved or transformed since the previous query.  The items added
+     * to or removed from the draw list are inserted in or removed from the index.  The
+     * index is outdated when the libraries, the default line thickness or the junction
+     * size change.  An outdated index is rebuilt only if the screen has not changed
+     * since the previous query.
+     * @return true if the spatial index is up to date.
+     */
+    bool useSpatialIndex() const;
+
+    /**
+     * Function buildSpatialIndex
+     * rebuilds the spatial index of the draw list items.
+     */
+    void buildSpatialIndex() const;
+
+    /**
+     * Function updateSpatialIndexAreas
+     * computes the areas of the items of the spatial index which are outdated.
+     */
+    void updateSpatialIndexAreas() const;
+
+    /**
+     * Function indexItems
+     * inserts the items from \a aFirst to \a aLast, just inserted in the draw list, in
+     * the spatial index, if it was up to date before the insertion.
+     * @param aIndexCurrent tells if the index was up to date before the insertion.
+     * @return true if the index is up to date, false if no order key is left for the
+     * items between their neighbours, then the index must be rebuilt.
+     */
+    bool indexItems( SCH_ITEM* aFirst, SCH_ITEM* aLast, bool aIndexCurrent );
+
+    /**
+     * Function unindexItem
+     * removes \a aItem, just removed from the draw list, from the spatial index.
+     * @param aIndexCurrent tells if the index was up to date before the removal.
+     * @return true if the index is up to date.
+     */
+    bool unindexItem( SCH_ITEM* aItem, bool aIndexCurrent );
+
+    /**
+     * Function appendItems
+     * moves the items of \a aList to the end of the draw list.
+     */
+    void appendItems( DLIST< SCH_ITEM >& aList );
+
 public:
 
     /**
@@ -136,11 +229,14 @@ public:
      */
     SCH_ITEM* GetDrawItems() const                          { return m_drawList.begin(); }
 
-    void Append( SCH_ITEM* aItem )
-    {
-        m_drawList.Append( aItem );
-        --m_modification_sync;
-    }
+    /**
+     * Function GetDrawListRevision
+     * @return a number which changes whenever items are added to or removed from the
+     *         draw list.
+     */
+    unsigned GetDrawListRevision() const                    { return m_drawList.GetRevision(); }
+
+    void Append( SCH_ITEM* aItem );
 
     /**
      * Function Append
@@ -148,11 +244,7 @@ public:
      *
      * @param aList A reference to a #DLIST containing the #SCH_ITEM to add to the sheet.
      */
-    void Append( DLIST< SCH_ITEM >& aList )
-    {
-        m_drawList.Append( aList );
-        --m_modification_sync;
-    }
+    void Append( DLIST< SCH_ITEM >& aList );
 
     /**
      * Function GetCurItem
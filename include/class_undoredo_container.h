@@ -135,6 +135,9 @@ public:
                                    * UR_UNSPECIFIED */
     wxPoint m_TransformPoint;     /* used to undo redo command by the same command: usually
                                    * need to know the rotate point or the move vector */
+    size_t  m_MemorySize;         /* estimated size of the data owned by the command, in
+                                   * bytes. Set when the command is pushed to an undo or
+                                   * redo list (see BASE_SCREEN::GetCommandMemorySize()) */
 
 private:
     std::vector <ITEM_PICKER> m_ItemsList;
@@ -224,6 +227,18 @@ public:
      */
     EDA_ITEM* GetPickedItemLink( unsigned int aIdx ) const;
 
+    /**
+     * Function GetPickedItemOwnedData
+     * returns the item owned by the picker, i.e. the one ClearListAndDeleteItems() deletes.
+     * Ownership follows the current status: when a command is undone or redone, the
+     * UR_NEW and UR_DELETED statuses are swapped before it is moved to the other list,
+     * so the same test is valid for commands stored in both the undo and redo lists.
+     * @return the owned item (the picked item or its link), or NULL if the picked item
+     *         is in use (e.g. it is in the board) and the picker does not own anything
+     * @param aIdx Index of the picked item in the picked list
+     */
+    EDA_ITEM* GetPickedItemOwnedData( unsigned int aIdx ) const;
+
     /**
      * Function GetPickedItemStatus
      * @return The type of undo/redo operation associated to the picked item,
@@ -322,6 +337,12 @@ public:
     PICKED_ITEMS_LIST* PopCommand();
 
     void ClearCommandList();
+
+    /**
+     * Function GetMemorySize
+     * @return the estimated size of the data owned by all the stored commands, in bytes.
+     */
+    size_t GetMemorySize() const;
 };
 
 
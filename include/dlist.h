@@ -43,6 +43,7 @@ protected:
     EDA_ITEM*     first;          ///< first element in list, or NULL if list empty
     EDA_ITEM*     last;           ///< last elment in list, or NULL if empty
     unsigned      count;          ///< how many elements are in the list, automatically maintained.
+    unsigned      revision;       ///< incremented on every change of the list content
     bool          meOwner;        ///< I must delete the objects I hold in my destructor
 
     /**
@@ -54,6 +55,7 @@ protected:
         first(0),
         last(0),
         count(0),
+        revision(0),
         meOwner(true)
     {
     }
@@ -118,6 +120,13 @@ public:
      */
     void SetOwnership( bool Iown ) { meOwner = Iown; }
 
+    /**
+     * Function GetRevision
+     * returns a number which changes whenever an element is added to or removed from
+     * the list, so data derived from the list content can be checked for being up to date.
+     */
+    unsigned GetRevision() const { return revision; }
+
 
     /**
      * Function GetCount
@@ -42,6 +42,14 @@ struct KEYWORD
     const char* name;       ///< unique keyword.
     int         token;      ///< a zero based index into an array of KEYWORDs
 };
+
+/**
+ * Type KEYWORD_FINDER
+ * is a function which returns the token of the keyword given by @a aText and
+ * @a aLength, or DSN_SYMBOL if it is not a keyword.  TokenList2DsnLexer.cmake
+ * generates one for each keyword table, which does not need any hashing.
+ */
+typedef int (*KEYWORD_FINDER)( const char* aText, unsigned aLength );
 #endif
 
 // something like this macro can be used to help initialize a KEYWORD table.
@@ -111,9 +119,13 @@ protected:
     const KEYWORD*      keywords;               ///< table sorted by CMake for bsearch()
     unsigned            keywordCount;           ///< count of keywords table
     KEYWORD_MAP         keyword_hash;           ///< fast, specialized "C string" hashtable
+    KEYWORD_FINDER      keywordFinder;          ///< generated lookup, used instead of keyword_hash if not NULL
 
     void init();
 
+    /// Fill keyword_hash from keywords[], for tables having no KEYWORD_FINDER
+    void fillKeywordHash();
+
     int readLine() throw( IO_ERROR )
     {
         if( reader )
@@ -169,9 +181,11 @@ public:
      * @param aKeywordCount is the count of tokens in aKeywordTable.
      * @param aFile is an open file, which will be closed when this is destructed.
      * @param aFileName is the name of the file
+     * @param aKeywordFinder is an optional lookup function for aKeywordTable.
      */
     DSNLEXER( const KEYWORD* aKeywordTable, unsigned aKeywordCount,
-              FILE* aFile, const wxString& aFileName );
+              FILE* aFile, const wxString& aFileName,
+              KEYWORD_FINDER aKeywordFinder = NULL );
 
     /**
      * Constructor ( const KEYWORD*, unsigned, const std::string&, const wxString& )
@@ -182,9 +196,11 @@ public:
      * @param aKeywordCount is the count of tokens in aKeywordTable.
      * @param aSExpression is text to feed through a STRING_LINE_READER
      * @param aSource is a description of aSExpression, used for error reporting.
+     * @param aKeywordFinder is an optional lookup function for aKeywordTable.
      */
     DSNLEXER( const KEYWORD* aKeywordTable, unsigned aKeywordCount,
-              const std::string& aSExpression, const wxString& aSource = wxEmptyString );
+              const std::string& aSExpression, const wxString& aSource = wxEmptyString,
+              KEYWORD_FINDER aKeywordFinder = NULL );
 
     /**
      * Constructor ( const std::string&, const wxString& )
@@ -209,9 +225,11 @@ public:
      *
      * @param aLineReader is any subclassed instance of LINE_READER, such as
      *  STRING_LINE_READER or FILE_LINE_READER.  No ownership is taken.
+     *
+     * @param aKeywordFinder is an optional lookup function for aKeywordTable.
      */
     DSNLEXER( const KEYWORD* aKeywordTable, unsigned aKeywordCount,
-              LINE_READER* aLineReader = NULL );
+              LINE_READER* aLineReader = NULL, KEYWORD_FINDER aKeywordFinder = NULL );
 
     virtual ~DSNLEXER();
 
@@ -68,6 +68,22 @@ public:
     /// @copydoc COMPOSITOR::DrawBuffer()
     virtual void DrawBuffer( unsigned int aBufferHandle );
 
+    /**
+     * Function CreateTileContext()
+     * Creates a context that draws to a rectangular part of a buffer. The context uses the same
+     * device coordinates as the whole buffer, drawing outside the tile is clipped. Contexts
+     * created for disjoint tiles may be used by different threads at the same time.
+     *
+     * @param aBufferHandle is the buffer to be drawn on.
+     * @param aX is the left edge of the tile (in pixels).
+     * @param aY is the top edge of the tile (in pixels).
+     * @param aWidth is the width of the tile (in pixels).
+     * @param aHeight is the height of the tile (in pixels).
+     * @return The created context, it has to be released with cairo_destroy() by the caller.
+     */
+    cairo_t* CreateTileContext( unsigned int aBufferHandle, int aX, int aY,
+                                int aWidth, int aHeight ) const;
+
     /**
      * Function SetMainContext()
      * Sets a context to be treated as the main context (ie. as a target of buffers rendering and
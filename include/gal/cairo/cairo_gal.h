@@ -28,11 +28,13 @@
 #define CAIROGAL_H_
 
 #include <map>
+#include <vector>
 #include <iterator>
 
 #include <cairo.h>
 
 #include <gal/graphics_abstraction_layer.h>
+#include <math/box2.h>
 #include <boost/smart_ptr/shared_ptr.hpp>
 #include <wx/dcbuffer.h>
 
@@ -83,6 +85,16 @@ public:
     CAIRO_GAL( wxWindow* aParent, wxEvtHandler* aMouseListener = NULL,
                wxEvtHandler* aPaintListener = NULL, const wxString& aName = wxT( "CairoCanvas" ) );
 
+    /**
+     * Constructor CAIRO_GAL
+     * creates an offscreen GAL, which renders to an image in memory. No native window is
+     * created, so it can be used without a display (e.g. by benchmarks).
+     *
+     * @param aWidth is the width of the image, in pixels.
+     * @param aHeight is the height of the image, in pixels.
+     */
+    CAIRO_GAL( int aWidth, int aHeight );
+
     virtual ~CAIRO_GAL();
 
     // ---------------
@@ -259,6 +271,19 @@ public:
         paintListener = aPaintListener;
     }
 
+    /**
+     * Function EnableTiledRendering
+     * Enables or disables tiled rendering. When enabled, drawing commands issued between
+     * BeginDrawing() and EndDrawing() are recorded and replayed in EndDrawing() into tiles
+     * of the screen, which are rendered in parallel (if OpenMP is available).
+     *
+     * @param aEnabled tells if tiled rendering should be used.
+     */
+    void EnableTiledRendering( bool aEnabled )
+    {
+        isTiledRendering = aEnabled;
+    }
+
 protected:
     virtual void drawGridLine( const VECTOR2D& aStartPoint, const VECTOR2D& aEndPoint );
 
@@ -274,6 +299,7 @@ private:
     bool                    validCompositor;        ///< Compositor initialization flag
 
     // Variables related to wxWidgets
+    bool                    isOffscreen;            ///< Is there no window to show the image?
     wxWindow*               parentWindow;           ///< Parent window
     wxEvtHandler*           mouseListener;          ///< Mouse listener
     wxEvtHandler*           paintListener;          ///< Paint listener
@@ -306,7 +332,9 @@ private:
         CMD_SCALE,                                  ///< Scale the context
         CMD_SAVE,                                   ///< Save the transformation matrix
         CMD_RESTORE,                                ///< Restore the transformation matrix
-        CMD_CALL_GROUP                              ///< Call a group
+        CMD_CALL_GROUP,                             ///< Call a group
+        CMD_SET_LAYER,                              ///< Start a new layer (tiled rendering only)
+        CMD_SET_TARGET                              ///< Change the buffer (tiled rendering only)
     };
 
     /// Type definition for an graphics group element
@@ -326,6 +354,38 @@ private:
     std::map<int, GROUP>        groups;             ///< List of graphic groups
     unsigned int                groupCounter;       ///< Counter used for generating keys for groups
     GROUP*                      currentGroup;       ///< Currently used group
+    int                         currentGroupNumber; ///< Number of the currently used group
+    std::map<int, BOX2D>        groupExtents;       ///< Bounding boxes of groups (world coordinates)
+    cairo_matrix_t              groupMatrix;        ///< Transformation recorded in the current group
+    std::vector<cairo_matrix_t> groupMatrixStack;   ///< Stack of recorded transformations
+
+    // Variables for tiled rendering
+    bool                        isTiledRendering;   ///< Should tiled rendering be used?
+    bool                        isRecordingFrame;   ///< Are drawing commands recorded for tiles?
+    GROUP                       frameCommands;      ///< Commands recorded for the current frame
+
+    /// Size (in pixels) of a single tile
+    static const int TILE_SIZE = 128;
+
+    /// State of the group commands interpreter, one per each context the commands are replayed on
+    struct REPLAY_STATE
+    {
+        cairo_t*    context;                        ///< Context receiving drawing commands
+        bool        isFillEnabled;                  ///< Is filling enabled?
+        bool        isStrokeEnabled;                ///< Is stroking enabled?
+        COLOR4D     fillColor;                      ///< Current fill color
+        COLOR4D     strokeColor;                    ///< Current stroke color
+        bool        isTransformed;                  ///< Was the world transformation modified?
+        std::vector<bool> transformStack;           ///< Saved isTransformed values
+
+        // Tiled rendering only
+        const BOX2D* clip;                          ///< Tile area in world coordinates (or NULL)
+        int         tile[4];                        ///< Tile position and size, in pixels
+        std::map<unsigned int, cairo_t*> contexts;  ///< Tile contexts for compositor buffers
+    };
+
+    /// Drawing settings at the beginning of the recorded frame
+    REPLAY_STATE                frameState;
 
     // Variables related to Cairo <-> wxWidgets
     cairo_matrix_t      cairoWorldScreenMatrix; ///< Cairo world to screen transformation matrix
@@ -339,8 +399,36 @@ private:
     COLOR4D             backgroundColor;        ///< Background color
 
     // Methods
+    void init();                                ///< Initialize members, common to constructors
     void storePath();                           ///< Store the actual path
 
+    /**
+     * @brief Executes commands stored in a group. This implements a small virtual machine,
+     * nested calling is also possible.
+     *
+     * @param aGroup is the group to be executed.
+     * @param aState is the state of the interpreter.
+     */
+    void replayGroup( const GROUP& aGroup, REPLAY_STATE& aState ) const;
+
+    /**
+     * @brief Replays commands recorded for the current frame on a part of the screen.
+     * It may be called for different tiles from several threads at the same time.
+     */
+    void drawTile( int aX, int aY, int aWidth, int aHeight ) const;
+
+    /// Replays commands recorded for the current frame on all tiles
+    void drawFrameTiles();
+
+    /// Stores a transformation applied in the current group, so its bounding box is known
+    void recordTransform( const cairo_matrix_t& aMatrix );
+
+    /// Updates the bounding box of the current group with the current path
+    void updateGroupExtents();
+
+    /// Removes paths stored in a group
+    void clearGroup( GROUP& aGroup );
+
     // Event handlers
     /**
      * @brief Paint event handler.
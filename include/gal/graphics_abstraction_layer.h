@@ -410,6 +410,44 @@ public:
      */
     virtual void ClearCache() = 0;
 
+    /**
+     * @brief Create a GAL that draws groups to its own buffers.
+     *
+     * Workers do not modify the GAL they were created from, so each thread may draw items
+     * to be cached using its own worker. Groups created by a worker are transferred to
+     * the cache with MergeCacheGroup().
+     *
+     * @return a new worker (owned by the caller) or NULL if workers are not supported.
+     */
+    virtual GAL* CreateCacheWorker() const
+    {
+        return NULL;
+    }
+
+    /**
+     * @brief Prepare a cache worker to be used again.
+     *
+     * The groups of the worker are removed, and the view settings it uses (scale, screen
+     * size) are copied again from this GAL, so a worker can be kept between recaches.
+     *
+     * @param aWorker is a GAL obtained from CreateCacheWorker().
+     */
+    virtual void ResetCacheWorker( GAL* aWorker ) const
+    {
+    }
+
+    /**
+     * @brief Copy a group created by a cache worker to the cached target.
+     *
+     * @param aWorker is a GAL obtained from CreateCacheWorker().
+     * @param aGroupNumber is the number of the group in the worker.
+     * @return the number of the group created in this GAL.
+     */
+    virtual int MergeCacheGroup( const GAL* aWorker, int aGroupNumber )
+    {
+        return -1;
+    }
+
     // --------------------------------------------------------
     // Handling the world <-> screen transformation
     // --------------------------------------------------------
@@ -35,6 +35,8 @@
 #include <gal/opengl/vertex_container.h>
 #include <map>
 #include <set>
+#include <vector>
+#include <stdint.h>
 
 // Debug messages verbosity level
 // #define CACHED_CONTAINER_TEST 1
@@ -64,17 +66,54 @@ public:
     ///> @copydoc VERTEX_CONTAINER::Clear()
     virtual void Clear();
 
+    ///> Allocation statistics, accumulated since the container was created
+    struct STATS
+    {
+        unsigned int allocations;       ///< Number of chunks reserved for items
+        unsigned int slotReuses;        ///< Allocations served by a freed slot of the same class
+        unsigned int coalescings;       ///< Number of free chunk merges (no vertices are moved)
+        unsigned int defragmentations;  ///< Number of compactions (all items are moved)
+        unsigned int resizes;           ///< Number of container size changes
+        uint64_t     movedVertices;     ///< Vertices copied by compactions
+    };
+
+    /**
+     * Function GetStats()
+     * returns the allocation statistics.
+     */
+    inline const STATS& GetStats() const
+    {
+        return m_stats;
+    }
+
+    /**
+     * Function GetFragmentation()
+     * returns the part of the free space that is not available for the biggest possible
+     * allocation: 0.0 means that all the free space is contiguous, values close to 1.0 mean
+     * that it is scattered among many small chunks.
+     */
+    double GetFragmentation() const;
+
 protected:
     ///> Maps size of free memory chunks to their offsets
     typedef std::pair<unsigned int, unsigned int> CHUNK;
     typedef std::multimap<unsigned int, unsigned int> FREE_CHUNK_MAP;
 
+    ///> Maps a size class to offsets of free slots of that size
+    typedef std::map<unsigned int, std::vector<unsigned int> > FREE_SLOT_MAP;
+
     /// List of all the stored items
     typedef std::set<VERTEX_ITEM*> ITEMS;
 
     ///> Stores size & offset of free chunks.
     FREE_CHUNK_MAP      m_freeChunks;
 
+    ///> Stores chunks freed by items, grouped by size class, so they can be reused as a whole.
+    FREE_SLOT_MAP       m_freeSlots;
+
+    ///> Allocation statistics
+    STATS               m_stats;
+
     ///> Stored VERTEX_ITEMs
     ITEMS               m_items;
 
@@ -95,6 +134,33 @@ protected:
      */
     virtual unsigned int reallocate( unsigned int aSize );
 
+    /**
+     * Function allocateChunk()
+     * reserves a chunk of memory. A free slot of the same size class is used if there is one,
+     * otherwise the chunk is cut from the free space. The container is enlarged if there is
+     * no free chunk big enough.
+     *
+     * @param aSize is the size of the chunk, it has to be a size class (see getSizeClass()).
+     * @return offset of the chunk or UINT_MAX in case of failure.
+     */
+    unsigned int allocateChunk( unsigned int aSize );
+
+    /**
+     * Function freeChunk()
+     * returns a chunk of memory to the pool.
+     *
+     * @param aOffset is the offset of the chunk.
+     * @param aSize is the size of the chunk.
+     */
+    void freeChunk( unsigned int aOffset, unsigned int aSize );
+
+    /**
+     * Function releaseFreeSlots()
+     * moves all the free slots to the free chunks pool and merges the neighbouring chunks,
+     * so bigger chunks may be allocated. No vertices are moved.
+     */
+    void releaseFreeSlots();
+
     /**
      * Function defragment()
      * removes empty spaces between chunks, so after that there is a long continous space
@@ -131,6 +197,16 @@ protected:
      */
     unsigned int getPowerOf2( unsigned int aNumber ) const;
 
+    /**
+     * Function getSizeClass()
+     * returns the size of the chunk reserved for an item of a given size. Sizes are rounded up
+     * to a multiple of 4 up to 32 vertices, bigger ones to an eighth of the nearest bigger power
+     * of 2, so less than 25% of the reserved space is wasted.
+     *
+     * @param aSize is the number of vertices to be stored.
+     */
+    unsigned int getSizeClass( unsigned int aSize ) const;
+
 private:
     /**
      * Function getChunkSize()
@@ -115,6 +115,15 @@ public:
         return m_currentSize;
     }
 
+    /**
+     * Function GetUsedSize()
+     * returns amount of vertices that are in use (i.e. the container size without free space).
+     */
+    inline unsigned int GetUsedSize() const
+    {
+        return m_currentSize - m_freeSpace;
+    }
+
     /**
      * Function IsDirty()
      * returns information about container cache state. Clears the flag after calling the function.
@@ -96,6 +96,17 @@ public:
      */
     void Vertices( const VERTEX aVertices[], unsigned int aSize ) const;
 
+    /**
+     * Function CopyVertices()
+     * adds vertices to the currently set item without any modifications, i.e. the current
+     * transformation, color and shader are not applied. It is meant for moving vertices that were
+     * already processed by another VERTEX_MANAGER.
+     *
+     * @param aVertices contains vertices to be added
+     * @param aSize is the number of vertices to be added.
+     */
+    void CopyVertices( const VERTEX aVertices[], unsigned int aSize ) const;
+
     /**
      * Function Color()
      * changes currently used color that will be applied to newly added vertices.
@@ -273,6 +284,29 @@ public:
      */
     VERTEX* GetVertices( const VERTEX_ITEM& aItem ) const;
 
+    /**
+     * Function GetVertices()
+     * returns a pointer to the vertices stored at the given offset.
+     *
+     * @param aOffset is the offset of the first vertex.
+     */
+    VERTEX* GetVertices( unsigned int aOffset ) const;
+
+    /**
+     * Function GetVertexCount()
+     * returns the number of vertices stored in the container.
+     */
+    unsigned int GetVertexCount() const;
+
+    /**
+     * Function GetContainer()
+     * returns the container that stores vertices, eg. to check its allocation statistics.
+     */
+    const VERTEX_CONTAINER* GetContainer() const
+    {
+        return m_container.get();
+    }
+
     const glm::mat4& GetTransformation() const
     {
         return m_transform;
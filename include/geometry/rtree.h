@@ -611,9 +611,8 @@ RTREE_TEMPLATE RTREE_QUAL::RTree()
     ASSERT( MINNODES > 0 );
 
 
-    // We only support machine word size simple data type eg. integer index or object pointer.
-    // Since we are storing as union with non data branch
-    ASSERT( sizeof(DATATYPE) == sizeof(void*) || sizeof(DATATYPE) == sizeof(int) );
+    // We only support plain data types, eg. integer index, object pointer or POD struct,
+    // since we are storing them as union with non data branch
 
     // Precomputed volumes of the unit spheres for the first few dimensions
     const float UNIT_SPHERE_VOLUMES[] =
@@ -1146,7 +1145,7 @@ bool RTREE_QUAL::InsertRectRec( Rect*           a_rect,
     else if( a_node->m_level == a_level ) // Have reached level for insertion. Add rect, split if necessary
     {
         branch.m_rect   = *a_rect;
-        branch.m_child  = (Node*) a_id;
+        branch.m_data   = a_id;
         // Child field of leaves contains id of data record
         return AddBranch( &branch, a_node, a_newNode );
     }
@@ -1760,7 +1759,7 @@ bool RTREE_QUAL::RemoveRectRec( Rect*           a_rect,
     {
         for( int index = 0; index < a_node->m_count; ++index )
         {
-            if( a_node->m_branch[index].m_child == (Node*) a_id )
+            if( a_node->m_branch[index].m_data == a_id )
             {
                 DisconnectBranch( a_node, index ); // Must return after this call as count has changed
                 return false;
@@ -85,6 +85,25 @@ char* GetLine( FILE* aFile, char* Line, int* LineNum = NULL, int SizeLine = 255
  */
 char* StrPurge( char* text );
 
+/**
+ * Function ParseDouble
+ * converts the decimal number at the start of \a aText to a double, like strtod(),
+ * but always with '.' as the decimal separator whatever the current locale is.
+ * Leading white space is skipped.  The result is correctly rounded, so it is the
+ * same as strtod() in the C locale gives, and numbers written with enough digits
+ * are read back exactly.
+ * Numbers whose digits, without the decimal point, make an integer not greater than
+ * 2^53, with a decimal exponent between -22 and 22, are converted without any library
+ * call.  This covers all the coordinates in board and netlist files.  Hexadecimal numbers, "inf" and "nan" are not numbers here.
+ *
+ * @param aText is the text to convert.
+ * @param aEnd, if not NULL, is set to the first character after the number, or to
+ *  \a aText if there is no number.
+ * @return double - the value, 0.0 if there is no number.  errno is set to ERANGE if
+ *  the value is out of range of a double.
+ */
+double ParseDouble( const char* aText, const char** aEnd = NULL );
+
 /**
  * Function DateAndTime
  * @return a string giving the current date and time.
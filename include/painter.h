@@ -301,6 +301,18 @@ public:
      */
     virtual bool Draw( const VIEW_ITEM* aItem, int aLayer ) = 0;
 
+    /**
+     * Function Clone
+     * creates a painter with the same settings, that draws using another GAL. Clones allow
+     * items to be drawn by several threads at once, as painters keep their drawing state.
+     * @param aGal is the GAL to be used by the new painter.
+     * @return A new painter (owned by the caller) or NULL if the painter cannot be cloned.
+     */
+    virtual PAINTER* Clone( GAL* aGal ) const
+    {
+        return NULL;
+    }
+
 protected:
     /// Instance of graphic abstraction layer that gives an interface to call
     /// commands used to draw (eg. DrawLine, DrawCircle, etc.)
@@ -440,6 +440,7 @@ public:
 
 
 #define OUTPUTFMTBUFZ    500        ///< default buffer size for any OUTPUT_FORMATTER
+#define FILE_OUTPUTFMTBUFZ  65536   ///< stdio buffer size of FILE_OUTPUTFORMATTER
 
 /**
  * Class OUTPUTFORMATTER
@@ -610,6 +611,15 @@ public:
         return mystring;
     }
 
+    /**
+     * Function SwapString
+     * exchanges the formatted text with @a aString, to take it without copying.
+     */
+    void SwapString( std::string& aString )
+    {
+        mystring.swap( aString );
+    }
+
 protected:
     //-----<OUTPUTFORMATTER>------------------------------------------------
     void write( const char* aOutBuf, int aCount ) throw( IO_ERROR );
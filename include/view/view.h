@@ -27,6 +27,8 @@
 
 #include <vector>
 #include <set>
+#include <map>
+#include <stdint.h>
 #include <boost/unordered/unordered_map.hpp>
 
 #include <math/box2.h>
@@ -141,6 +143,8 @@ public:
      */
     void SetPainter( PAINTER* aPainter )
     {
+        // painter clones used for caching copy the settings of the former painter
+        clearCacheWorkers();
         m_painter = aPainter;
     }
 
@@ -532,6 +536,40 @@ public:
 
     static const int VIEW_MAX_LAYERS = 256;      ///< maximum number of layers that may be shown
 
+    /**
+     * Struct STATS
+     * Rendering counters gathered by the VIEW. They are always available, so the redraw
+     * performance may be measured without a special build.
+     */
+    struct STATS
+    {
+        int         frames;                         ///< Number of Redraw() calls
+        uint64_t    redrawTime;                     ///< Total time spent in Redraw() [us]
+        uint64_t    lastRedrawTime;                 ///< Time spent in the last Redraw() [us]
+        int         recacheCalls;                   ///< Number of RecacheAllItems() calls
+        uint64_t    recacheTime;                    ///< Total time spent in RecacheAllItems() [us]
+        int         updateCalls;                    ///< Number of UpdateItems() calls
+        int         updatedItems;                   ///< Total number of items updated
+        uint64_t    updateTime;                     ///< Total time spent in UpdateItems() [us]
+        int         drawnItems[VIEW_MAX_LAYERS];    ///< Items drawn in the last frame, per layer
+        int         culledItems[VIEW_MAX_LAYERS];   ///< Items skipped in the last frame due to LOD
+    };
+
+    /**
+     * Function GetStats()
+     * Returns rendering counters gathered since the VIEW creation or the last ResetStats() call.
+     */
+    const STATS& GetStats() const
+    {
+        return m_stats;
+    }
+
+    /**
+     * Function ResetStats()
+     * Zeroes all rendering counters.
+     */
+    void ResetStats();
+
 private:
     struct VIEW_LAYER
     {
@@ -558,6 +596,10 @@ private:
     struct updateItemsColor;
     struct changeItemsDepth;
     struct extentsVisitor;
+    struct collectCacheJobs;
+
+    ///* Maps LOD proxies to one of the items they stand for (used to determine the proxy color)
+    typedef std::map<VIEW_ITEM*, VIEW_ITEM*> LOD_PROXY_MAP;
 
 
     ///* Redraws contents within rect aRect
@@ -602,6 +644,44 @@ private:
      */
     void draw( VIEW_GROUP* aGroup, bool aImmediate = false );
 
+    /**
+     * Function drawLodProxy()
+     * Draws a coarse representation (a filled bounding box) of an item standing for items
+     * that are too small to be displayed at the current zoom. For cached layers the box is
+     * stored as a GAL group, so it is created only once.
+     *
+     * @param aProxy is the proxy item to be drawn.
+     * @param aItem is one of the items represented by the proxy, it determines the color.
+     * @param aLayer is the layer which should be drawn.
+     */
+    void drawLodProxy( VIEW_ITEM* aProxy, VIEW_ITEM* aItem, int aLayer );
+
+    ///* Removes cached LOD proxy groups stored for an item
+    void deleteLodProxy( VIEW_ITEM* aProxy );
+
+    ///* Removes all cached LOD proxy groups, so they are recreated on the next redraw
+    void clearLodProxies();
+
+    ///* Returns the key used to store LOD proxy group ids in VIEW_ITEMs for a given layer
+    static int lodProxyKey( int aLayer )
+    {
+        return VIEW_MAX_LAYERS + aLayer;
+    }
+
+    /**
+     * Function recacheParallel()
+     * Draws items on all cached layers to new GAL groups using several threads. Each thread
+     * tessellates items with its own GAL cache worker and painter clone, then the results are
+     * moved to the GAL cache by the calling thread.
+     * Workers and painter clones are created at the first call, and reused by the next ones.
+     *
+     * @return false if nothing was done, as the GAL or the painter do not support it.
+     */
+    bool recacheParallel();
+
+    ///* Deletes the GAL cache workers and their painters
+    void clearCacheWorkers();
+
     ///* Sorts m_orderedLayers when layer rendering order has changed
     void sortLayers();
 
@@ -674,6 +754,16 @@ private:
 
     /// Items to be updated
     std::vector<VIEW_ITEM*> m_needsUpdate;
+
+    /// Items that have cached LOD proxy groups
+    std::set<VIEW_ITEM*> m_lodProxies;
+
+    /// Rendering counters
+    STATS m_stats;
+
+    /// GAL cache workers and painters drawing with them, one pair for each thread
+    std::vector<GAL*>       m_cacheWorkers;
+    std::vector<PAINTER*>   m_cachePainters;
 };
 } // namespace KIGFX
 
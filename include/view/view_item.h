@@ -194,6 +194,33 @@ public:
         return 0;
     }
 
+    /**
+     * Function ViewGetMinScreenSize()
+     * Returns the minimal size (in pixels) of the item's bounding box on screen that is required
+     * for the item to be drawn on a given layer. Items that would appear smaller are skipped
+     * during redraw and their LOD proxy (if any) is drawn instead.
+     * @param aLayer is the layer that is going to be drawn.
+     * @return minimal on-screen size in pixels, 0 means that the item is always drawn.
+     */
+    virtual int ViewGetMinScreenSize( int aLayer ) const
+    {
+        // By default do not cull the item
+        return 0;
+    }
+
+    /**
+     * Function ViewGetLODProxy()
+     * Returns the item that represents this item on a given layer when it is too small to be
+     * drawn (see ViewGetMinScreenSize()). The proxy is displayed as a filled box covering its
+     * bounding box, it is cached and drawn only once, no matter how many items it stands for.
+     * @param aLayer is the layer that is going to be drawn.
+     * @return the proxy item or NULL if culled item should simply not be displayed.
+     */
+    virtual VIEW_ITEM* ViewGetLODProxy( int aLayer ) const
+    {
+        return NULL;
+    }
+
     /**
      * Function ViewUpdate()
      * For dynamic VIEWs, informs the associated VIEW that the graphical representation of
@@ -64,6 +64,7 @@ class REPORTER;
 struct PARSE_ERROR;
 struct IO_ERROR;
 class FP_LIB_TABLE;
+class BACKGROUND_FILE_WRITER;
 
 namespace PCB { struct IFACE; }     // KIFACE_I is in pcbnew.cpp
 
@@ -106,6 +107,8 @@ protected:
 
     DRC* m_drc;                                 ///< the DRC controller, see drc.cpp
 
+    BACKGROUND_FILE_WRITER* m_autoSaveWriter;   ///< writes the auto save files, see files.cpp
+
     PARAM_CFG_ARRAY   m_configSettings;         ///< List of Pcbnew configuration settings.
 
     wxString          m_lastNetListRead;        ///< Last net list read with relative path.
@@ -181,12 +184,20 @@ protected:
     /**
      * Function doAutoSave
      * performs auto save when the board has been modified and not saved within the
-     * auto save interval.
+     * auto save interval.  A copy of the board is formatted and written in the
+     * background.
      *
-     * @return true if the auto save was successful.
+     * @return true if the auto save was started.
      */
     virtual bool doAutoSave();
 
+    /**
+     * Function OnAutoSaveWritten
+     * is called when the auto save file has been written in the background.  If the
+     * write failed, it displays the error and flags the board for the next auto save.
+     */
+    void OnAutoSaveWritten( wxThreadEvent& aEvent );
+
     /**
      * Function isautoSaveRequired
      * returns true if the board has been modified.
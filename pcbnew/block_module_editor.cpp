@@ -447,7 +447,7 @@ void CopyMarkedItems( MODULE* module, wxPoint offset, bool aIncrement )
         D_PAD* NewPad = new D_PAD( *pad );
         NewPad->SetParent( module );
         NewPad->SetFlags( SELECTED );
-        module->Pads().PushFront( NewPad );
+        module->Add( NewPad, false );
 
         if( aIncrement )
             NewPad->IncrementItemReference();
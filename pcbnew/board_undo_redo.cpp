@@ -24,6 +24,7 @@
  */
 
 #include <boost/bind.hpp>
+#include <boost/unordered_set.hpp>
 #include <fctsys.h>
 #include <class_drawpanel.h>
 #include <class_draw_panel_gal.h>
@@ -38,6 +39,7 @@
 #include <class_pcb_text.h>
 #include <class_mire.h>
 #include <class_module.h>
+#include <class_pad.h>
 #include <class_dimension.h>
 #include <class_zone.h>
 #include <class_edge_mod.h>
@@ -101,82 +103,122 @@
  */
 
 
+typedef boost::unordered_set<const BOARD_ITEM*> BOARD_ITEM_SET;
+
+
 /**
- * Function TestForExistingItem
- * test if aItem exists somewhere in lists of items
+ * Function CollectExistingItems
+ * fills aItemSet with all items of the board, so the existence of an item can be tested
+ * in constant time.
  * This is a function used by PutDataInPreviousState to be sure an item was not deleted
  * since an undo or redo.
  * This could be possible:
  *   - if a call to SaveCopyInUndoList was forgotten in Pcbnew
  *   - in zones outlines, when a change in one zone merges this zone with an other
- * This function avoids a Pcbnew crash
- * Before using this function to test existence of items,
- * it must be called with aItem = NULL to prepare the list
+ * This function avoids a Pcbnew crash: only the pointers are compared, items
+ * not found in the set are never dereferenced.
  * @param aPcb = board to test
- * @param aItem = item to find
- *              = NULL to build the list of existing items
+ * @param aItemSet = the set to fill
  */
-static bool TestForExistingItem( BOARD* aPcb, BOARD_ITEM* aItem )
+static void CollectExistingItems( BOARD* aPcb, BOARD_ITEM_SET& aItemSet )
 {
-    static std::vector<BOARD_ITEM*> itemsList;
+    BOARD_ITEM* item;
 
-    if( aItem == NULL ) // Build list
-    {
-        // Count items to store in itemsList:
-        int icnt = 0;
-        BOARD_ITEM* item;
+    aItemSet.clear();
+    aItemSet.rehash( aPcb->m_Track.GetCount() + aPcb->m_Modules.GetCount() +
+                     aPcb->m_Drawings.GetCount() + aPcb->GetAreaCount() +
+                     aPcb->m_Zone.GetCount() );
 
-        // Count tracks:
-        for( item = aPcb->m_Track; item != NULL; item = item->Next() )
-            icnt++;
+    // Tracks:
+    for( item = aPcb->m_Track; item != NULL; item = item->Next() )
+        aItemSet.insert( item );
 
-        // Count modules:
-        for( item = aPcb->m_Modules; item != NULL; item = item->Next() )
-            icnt++;
+    // Modules:
+    for( item = aPcb->m_Modules; item != NULL; item = item->Next() )
+        aItemSet.insert( item );
 
-        // Count drawings
-        for( item = aPcb->m_Drawings; item != NULL; item = item->Next() )
-            icnt++;
+    // Drawings
+    for( item = aPcb->m_Drawings; item != NULL; item = item->Next() )
+        aItemSet.insert( item );
 
-        // Count zones outlines
-        icnt +=  aPcb->GetAreaCount();
+    // Zones outlines
+    for( int ii = 0; ii < aPcb->GetAreaCount(); ii++ )
+        aItemSet.insert( aPcb->GetArea( ii ) );
 
-        // Count zones segm (now obsolete):
-        for( item = aPcb->m_Zone; item != NULL; item = item->Next() )
-             icnt++;
+    // Zones segm (now obsolete):
+    for( item = aPcb->m_Zone; item != NULL; item = item->Next() )
+        aItemSet.insert( item );
+}
 
-        // Build candidate list:
-        itemsList.clear();
-        itemsList.reserve(icnt);
 
-        // Store items in list:
-        // Append tracks:
-        for( item = aPcb->m_Track; item != NULL; item = item->Next() )
-            itemsList.push_back( item );
+/**
+ * Function BoardItemMemorySize
+ * estimates the memory used by a board item which is not on board (a copy stored in
+ * an undo/redo command, or a deleted item), including its children and polygons.
+ */
+static size_t BoardItemMemorySize( const BOARD_ITEM* aItem )
+{
+    switch( aItem->Type() )
+    {
+    case PCB_MODULE_T:
+    {
+        const MODULE* module = static_cast<const MODULE*>( aItem );
+        size_t size = sizeof( MODULE ) + 2 * sizeof( TEXTE_MODULE );     // reference & value
 
-        // Append modules:
-        for( item = aPcb->m_Modules; item != NULL; item = item->Next() )
-            itemsList.push_back( item );
+        for( const D_PAD* pad = module->Pads(); pad; pad = pad->Next() )
+            size += sizeof( D_PAD );
 
-        // Append drawings
-        for( item = aPcb->m_Drawings; item != NULL; item = item->Next() )
-            itemsList.push_back( item );
+        for( const BOARD_ITEM* item = module->GraphicalItems(); item; item = item->Next() )
+            size += BoardItemMemorySize( item );
 
-        // Append zones outlines
-        for( int ii = 0; ii < aPcb->GetAreaCount(); ii++ )
-            itemsList.push_back( aPcb->GetArea( ii ) );
+        return size;
+    }
 
-        // Append zones segm:
-        for( item = aPcb->m_Zone; item != NULL; item = item->Next() )
-            itemsList.push_back( item );
+    case PCB_ZONE_AREA_T:
+    {
+        const ZONE_CONTAINER* zone = static_cast<const ZONE_CONTAINER*>( aItem );
 
-        // Sort list
-        std::sort( itemsList.begin(), itemsList.end() );
-        return false;
+        return sizeof( ZONE_CONTAINER ) + sizeof( CPolyLine )
+               + zone->GetNumCorners() * sizeof( CPolyPt )
+               + zone->GetFilledPolysList().GetCornersCount() * sizeof( CPolyPt )
+               + zone->FillSegments().size() * sizeof( SEGMENT );
     }
 
-    // search in list:
-    return std::binary_search( itemsList.begin(), itemsList.end(), aItem );
+    case PCB_LINE_T:
+    case PCB_MODULE_EDGE_T:
+    {
+        const DRAWSEGMENT* segment = static_cast<const DRAWSEGMENT*>( aItem );
+        size_t size = aItem->Type() == PCB_LINE_T ? sizeof( DRAWSEGMENT ) : sizeof( EDGE_MODULE );
+
+        return size + ( segment->GetPolyPoints().size() + segment->GetBezierPoints().size() )
+                      * sizeof( wxPoint );
+    }
+
+    case PCB_TRACE_T:
+    case PCB_ZONE_T:
+        return sizeof( TRACK );
+
+    case PCB_VIA_T:
+        return sizeof( VIA );
+
+    case PCB_TEXT_T:
+        return sizeof( TEXTE_PCB );
+
+    case PCB_MODULE_TEXT_T:
+        return sizeof( TEXTE_MODULE );
+
+    case PCB_PAD_T:
+        return sizeof( D_PAD );
+
+    case PCB_DIMENSION_T:
+        return sizeof( DIMENSION );
+
+    case PCB_TARGET_T:
+        return sizeof( PCB_TARGET );
+
+    default:
+        return sizeof( BOARD_ITEM );
+    }
 }
 
 
@@ -469,7 +511,8 @@ void PCB_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool aRed
     // Undo in the reverse order of list creation: (this can allow stacked changes
     // like the same item can be changes and deleted in the same complex command
 
-    bool build_item_list = true;    // if true the list of existing items must be rebuilt
+    BOARD_ITEM_SET existingItems;
+    bool build_item_list = true;    // if true the set of existing items must be built
 
     for( int ii = aList->GetCount() - 1; ii >= 0 ; ii-- )
     {
@@ -488,12 +531,12 @@ void PCB_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool aRed
         if( status != UR_DELETED )
         {
             if( build_item_list )
-                // Build list of existing items, for integrity test
-                TestForExistingItem( GetBoard(), NULL );
+                // Build set of existing items, for integrity test
+                CollectExistingItems( GetBoard(), existingItems );
 
             build_item_list = false;
 
-            if( !TestForExistingItem( GetBoard(), item ) )
+            if( existingItems.find( item ) == existingItems.end() )
             {
                 // Remove this non existent item
                 aList->RemovePicker( ii );
@@ -579,7 +622,11 @@ void PCB_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool aRed
             view->Add( item );
 
             item->ViewUpdate( KIGFX::VIEW_ITEM::GEOMETRY );
-            build_item_list = true;
+
+            // The item exists again (no need to build the set if not yet done)
+            if( !build_item_list )
+                existingItems.insert( item );
+
             break;
 
         case UR_MOVED:
@@ -702,3 +749,23 @@ void PCB_SCREEN::ClearUndoORRedoList( UNDO_REDO_CONTAINER& aList, int aItemCount
         delete curr_cmd;    // Delete command
     }
 }
+
+
+size_t PCB_SCREEN::GetCommandMemorySize( const PICKED_ITEMS_LIST& aCommand ) const
+{
+    size_t size = sizeof( PICKED_ITEMS_LIST ) + aCommand.GetCount() * sizeof( ITEM_PICKER );
+
+    // Commands are pushed to the redo list after PutDataInPreviousState() has undone them:
+    // new items removed from the board are then flagged UR_DELETED (owned by the command)
+    // and restored deleted items UR_NEW (owned by the board), so the statuses tell the
+    // ownership for both lists.
+    for( unsigned ii = 0; ii < aCommand.GetCount(); ii++ )
+    {
+        const EDA_ITEM* owned = aCommand.GetPickedItemOwnedData( ii );
+
+        if( owned )
+            size += BoardItemMemorySize( static_cast<const BOARD_ITEM*>( owned ) );
+    }
+
+    return size;
+}
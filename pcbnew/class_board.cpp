@@ -58,6 +58,7 @@
 #include <class_pcb_text.h>
 #include <class_mire.h>
 #include <class_dimension.h>
+#include <connected_items_rtree.h>
 
 
 /* This is an odd place for this, but CvPcb won't link if it is
@@ -79,6 +80,17 @@ BOARD::BOARD() :
     m_nodeCount     = 0;                    // Number of connected pads.
     m_unconnectedNetCount   = 0;            // Number of unconnected nets.
 
+    m_moduleIndexRevision   = 0;            // Module indexes are built on demand
+    m_moduleIndexValid      = false;
+
+    m_padListRevision = 0;
+    m_padsIndex     = NULL;                 // So are spatial indexes
+    m_tracksIndex   = NULL;
+    m_spatialQueryStamp.modules  = UINT_MAX;
+    m_spatialQueryStamp.tracks   = UINT_MAX;
+    m_spatialQueryStamp.pads     = UINT_MAX;
+    m_spatialIndexStamp = m_spatialQueryStamp;
+
     m_CurrentZoneContour = NULL;            // This ZONE_CONTAINER handle the
                                             // zone contour currently in progress
 
@@ -119,6 +131,8 @@ BOARD::~BOARD()
     }
 
     delete m_ratsnest;
+    delete m_padsIndex;
+    delete m_tracksIndex;
 
     m_FullRatsnest.clear();
     m_LocalRatsnest.clear();
@@ -131,6 +145,152 @@ BOARD::~BOARD()
 }
 
 
+static bool sortNetsByCode( const NETINFO_ITEM* a, const NETINFO_ITEM* b )
+{
+    return a->GetNet() < b->GetNet();
+}
+
+
+/// Nets of a board and of its snapshot
+typedef boost::unordered_map<const NETINFO_ITEM*, NETINFO_ITEM*> SNAPSHOT_NETS;
+
+
+/**
+ * Function moveToSnapshotNet
+ * attaches \a aItem, a copy living in a snapshot board, to the snapshot net matching
+ * the net of the original item.  Orphaned items get the unconnected net.
+ */
+static void moveToSnapshotNet( BOARD_CONNECTED_ITEM* aItem, const SNAPSHOT_NETS& aNets )
+{
+    SNAPSHOT_NETS::const_iterator it = aNets.find( aItem->GetNet() );
+
+    aItem->SetNetCode( it != aNets.end() ? it->second->GetNet() : NETINFO_LIST::UNCONNECTED );
+}
+
+
+BOARD* BOARD::Snapshot() const
+{
+    BOARD* snapshot = new BOARD();
+
+    snapshot->m_fileName = m_fileName;
+    snapshot->m_fileFormatVersionAtLoad = m_fileFormatVersionAtLoad;
+
+    for( LAYER_NUM layer = 0; layer < LAYER_ID_COUNT; ++layer )
+        snapshot->m_Layer[layer] = m_Layer[layer];
+
+    snapshot->m_zoneSettings = m_zoneSettings;
+    snapshot->m_paper = m_paper;
+    snapshot->m_titles = m_titles;
+    snapshot->m_plotOptions = m_plotOptions;
+
+    // The design settings share their net classes, the snapshot needs its own copies
+    snapshot->m_designSettings = m_designSettings;
+
+    NETCLASSES& netClasses = snapshot->m_designSettings.m_NetClasses;
+
+    netClasses = NETCLASSES();
+    *netClasses.GetDefault() = *m_designSettings.GetDefault();
+
+    for( NETCLASSES::const_iterator it = m_designSettings.m_NetClasses.begin();
+         it != m_designSettings.m_NetClasses.end(); ++it )
+    {
+        netClasses.Add( NETCLASSPTR( new NETCLASS( *it->second ) ) );
+    }
+
+    // Only the sizes of the rats nest are saved, the items are not needed
+    snapshot->m_FullRatsnest.resize( m_FullRatsnest.size() );
+    snapshot->m_unconnectedNetCount = m_unconnectedNetCount;
+
+    // Nets are appended in the order of their codes, so they are mapped to the same
+    // consecutive codes when the snapshot is saved
+    std::vector<NETINFO_ITEM*> nets;
+    SNAPSHOT_NETS snapshotNets;
+
+    for( NETINFO_LIST::iterator net( BeginNets() ), netEnd( EndNets() ); net != netEnd; ++net )
+        nets.push_back( *net );
+
+    std::sort( nets.begin(), nets.end(), sortNetsByCode );
+
+    for( unsigned ii = 0; ii < nets.size(); ii++ )
+    {
+        NETINFO_ITEM* net = snapshot->FindNet( nets[ii]->GetNetname() );
+
+        if( !net )      // the unconnected net already exists
+        {
+            net = new NETINFO_ITEM( snapshot, nets[ii]->GetNetname(), nets[ii]->GetNet() );
+            snapshot->AppendNet( net );
+        }
+
+        snapshotNets[nets[ii]] = net;
+    }
+
+    // Items are appended directly to the lists to keep their order, and the copies get
+    // the time stamps of the original items, which are saved
+    for( MODULE* module = m_Modules; module; module = module->Next() )
+    {
+        MODULE* copy = (MODULE*) module->Clone();
+
+        copy->SetTimeStamp( module->GetTimeStamp() );
+        copy->SetParent( snapshot );
+        snapshot->m_Modules.PushBack( copy );
+
+        for( D_PAD* pad = copy->Pads().GetFirst(); pad; pad = pad->Next() )
+            moveToSnapshotNet( pad, snapshotNets );
+    }
+
+    for( BOARD_ITEM* item = m_Drawings; item; item = item->Next() )
+    {
+        BOARD_ITEM* copy = (BOARD_ITEM*) item->Clone();
+
+        copy->SetTimeStamp( item->GetTimeStamp() );
+
+        if( item->Type() == PCB_DIMENSION_T )
+        {
+            ( (DIMENSION*) copy )->Text().SetTimeStamp(
+                    ( (DIMENSION*) item )->Text().GetTimeStamp() );
+        }
+
+        copy->SetParent( snapshot );
+        snapshot->m_Drawings.PushBack( copy );
+    }
+
+    for( TRACK* track = m_Track; track; track = track->Next() )
+    {
+        TRACK* copy = (TRACK*) track->Clone();
+
+        copy->SetTimeStamp( track->GetTimeStamp() );
+        copy->SetParent( snapshot );
+        snapshot->m_Track.PushBack( copy );
+        moveToSnapshotNet( copy, snapshotNets );
+    }
+
+    for( SEGZONE* segzone = m_Zone; segzone; segzone = segzone->Next() )
+    {
+        SEGZONE* copy = (SEGZONE*) segzone->Clone();
+
+        copy->SetTimeStamp( segzone->GetTimeStamp() );
+        copy->SetParent( snapshot );
+        snapshot->m_Zone.PushBack( copy );
+        moveToSnapshotNet( copy, snapshotNets );
+    }
+
+    for( unsigned ii = 0; ii < m_ZoneDescriptorList.size(); ii++ )
+    {
+        ZONE_CONTAINER* copy = (ZONE_CONTAINER*) m_ZoneDescriptorList[ii]->Clone();
+
+        copy->SetTimeStamp( m_ZoneDescriptorList[ii]->GetTimeStamp() );
+        copy->SetParent( snapshot );
+        snapshot->m_ZoneDescriptorList.push_back( copy );
+        moveToSnapshotNet( copy, snapshotNets );
+
+        // ~BOARD() removes the zones from the rats nest, as BOARD::Add() puts them there
+        snapshot->m_ratsnest->Add( copy );
+    }
+
+    return snapshot;
+}
+
+
 const wxPoint& BOARD::GetPosition() const
 {
     wxLogWarning( wxT( "This should not be called on the BOARD object") );
@@ -686,11 +846,19 @@ void BOARD::Add( BOARD_ITEM* aBoardItem, int aControl )
 
     case PCB_TRACE_T:
     case PCB_VIA_T:
+    {
+        bool indexCurrent = isSpatialIndexCurrent();
+
         TRACK* insertAid;
         insertAid = ( (TRACK*) aBoardItem )->GetBestInsertPoint( this );
         m_Track.Insert( (TRACK*) aBoardItem, insertAid );
         aBoardItem->SetParent( this );
+
+        if( indexCurrent && indexTrack( (TRACK*) aBoardItem ) )
+            m_spatialIndexStamp = spatialIndexStamp();
+
         break;
+    }
 
     case PCB_ZONE_T:
         if( aControl & ADD_APPEND )
@@ -702,6 +870,10 @@ void BOARD::Add( BOARD_ITEM* aBoardItem, int aControl )
         break;
 
     case PCB_MODULE_T:
+    {
+        bool indexCurrent = isModuleIndexCurrent();
+        bool spatialIndexCurrent = isSpatialIndexCurrent();
+
         if( aControl & ADD_APPEND )
             m_Modules.PushBack( (MODULE*) aBoardItem );
         else
@@ -709,10 +881,23 @@ void BOARD::Add( BOARD_ITEM* aBoardItem, int aControl )
 
         aBoardItem->SetParent( this );
 
+        if( indexCurrent )
+        {
+            indexModule( (MODULE*) aBoardItem );
+            m_moduleIndexRevision = m_Modules.GetRevision();
+        }
+
+        if( spatialIndexCurrent )
+        {
+            indexModulePads( (MODULE*) aBoardItem );
+            m_spatialIndexStamp = spatialIndexStamp();
+        }
+
         // Because the list of pads has changed, reset the status
         // This indicate the list of pad and nets must be recalculated before use
         m_Status_Pcb = 0;
         break;
+    }
 
     case PCB_MODULE_EDGE_T:
         assert( false );        // TODO Orson: I am just checking if it is supposed to be here
@@ -779,13 +964,46 @@ BOARD_ITEM* BOARD::Remove( BOARD_ITEM* aBoardItem )
         break;
 
     case PCB_MODULE_T:
+    {
+        bool indexCurrent = isModuleIndexCurrent();
+        bool spatialIndexCurrent = isSpatialIndexCurrent();
+
         m_Modules.Remove( (MODULE*) aBoardItem );
+
+        if( indexCurrent )
+        {
+            unindexModule( (MODULE*) aBoardItem );
+            m_moduleIndexRevision = m_Modules.GetRevision();
+        }
+
+        // Unindexed even if the index is outdated, so the pads do not stay linked to it
+        if( m_padsIndex )
+        {
+            for( D_PAD* pad = ( (MODULE*) aBoardItem )->Pads(); pad; pad = pad->Next() )
+                m_padsIndex->Remove( pad );
+        }
+
+        if( spatialIndexCurrent )
+            m_spatialIndexStamp = spatialIndexStamp();
+
         break;
+    }
 
     case PCB_TRACE_T:
     case PCB_VIA_T:
+    {
+        bool indexCurrent = isSpatialIndexCurrent();
+
         m_Track.Remove( (TRACK*) aBoardItem );
+
+        if( m_tracksIndex )
+            m_tracksIndex->Remove( (TRACK*) aBoardItem );
+
+        if( indexCurrent )
+            m_spatialIndexStamp = spatialIndexStamp();
+
         break;
+    }
 
     case PCB_ZONE_T:
         m_Zone.Remove( (SEGZONE*) aBoardItem );
@@ -1258,62 +1476,127 @@ NETINFO_ITEM* BOARD::FindNet( const wxString& aNetname ) const
 
 MODULE* BOARD::FindModuleByReference( const wxString& aReference ) const
 {
-    struct FINDER : public INSPECTOR
+    if( !isModuleIndexCurrent() )
+        buildModuleIndex();
+
+    return findIndexedModule( m_modulesByReference, aReference );
+}
+
+
+MODULE* BOARD::FindModule( const wxString& aRefOrTimeStamp, bool aSearchByTimeStamp ) const
+{
+    if( aSearchByTimeStamp )
+    {
+        // Time stamps are compared case insensitive, so the index keys are upper case
+        if( !isModuleIndexCurrent() )
+            buildModuleIndex();
+
+        return findIndexedModule( m_modulesByPath, aRefOrTimeStamp.Upper() );
+    }
+    else
     {
-        MODULE* found;
+        return FindModuleByReference( aRefOrTimeStamp );
+    }
+}
 
-        FINDER() : found( 0 )  {}
 
-        // implement interface INSPECTOR
-        SEARCH_RESULT Inspect( EDA_ITEM* item, const void* data )
-        {
-            MODULE*         module = (MODULE*) item;
-            const wxString& ref    = *(const wxString*) data;
+void BOARD::UpdateModuleIndex( MODULE* aModule )
+{
+    // Stale indexes are rebuilt on the next look up anyway
+    if( !isModuleIndexCurrent() )
+        return;
 
-            if( ref == module->GetReference() )
-            {
-                found = module;
-                return SEARCH_QUIT;
-            }
+    // Modules that are not on the board (e.g. held by the undo list) are not indexed
+    if( m_moduleKeys.find( aModule ) == m_moduleKeys.end() )
+        return;
 
-            return SEARCH_CONTINUE;
-        }
-    } inspector;
+    unindexModule( aModule );
+    indexModule( aModule );
+}
 
-    // search only for MODULES
-    static const KICAD_T scanTypes[] = { PCB_MODULE_T, EOT };
 
-    // visit this BOARD with the above inspector
-    BOARD* nonconstMe = (BOARD*) this;
-    nonconstMe->Visit( &inspector, &aReference, scanTypes );
+void BOARD::buildModuleIndex() const
+{
+    m_modulesByReference.clear();
+    m_modulesByPath.clear();
+    m_moduleKeys.clear();
 
-    return inspector.found;
+    for( MODULE* module = m_Modules; module; module = module->Next() )
+        indexModule( module );
+
+    m_moduleIndexRevision = m_Modules.GetRevision();
+    m_moduleIndexValid = true;
 }
 
 
-MODULE* BOARD::FindModule( const wxString& aRefOrTimeStamp, bool aSearchByTimeStamp ) const
+void BOARD::indexModule( MODULE* aModule ) const
 {
-    if( aSearchByTimeStamp )
+    MODULE_KEYS& keys = m_moduleKeys[aModule];
+
+    keys.reference = aModule->GetReference();
+    keys.path      = aModule->GetPath().Upper();
+
+    m_modulesByReference.insert( std::make_pair( keys.reference, aModule ) );
+    m_modulesByPath.insert( std::make_pair( keys.path, aModule ) );
+}
+
+
+/**
+ * Function eraseIndexEntry
+ * removes the entry of \a aModule stored under \a aKey from \a aIndex.
+ */
+template <class INDEX>
+static void eraseIndexEntry( INDEX& aIndex, const wxString& aKey, const MODULE* aModule )
+{
+    std::pair<typename INDEX::iterator, typename INDEX::iterator> range = aIndex.equal_range( aKey );
+
+    for( typename INDEX::iterator it = range.first; it != range.second; ++it )
     {
-        for( MODULE* module = m_Modules;  module;  module = module->Next() )
+        if( it->second == aModule )
         {
-            if( aRefOrTimeStamp.CmpNoCase( module->GetPath() ) == 0 )
-                return module;
+            aIndex.erase( it );
+            return;
         }
     }
-    else
-    {
+}
+
+
+void BOARD::unindexModule( const MODULE* aModule ) const
+{
+    MODULE_KEYS_MAP::iterator keys = m_moduleKeys.find( aModule );
+
+    if( keys == m_moduleKeys.end() )
+        return;
+
+    // Use the stored keys, the module ones may have been changed already
+    eraseIndexEntry( m_modulesByReference, keys->second.reference, aModule );
+    eraseIndexEntry( m_modulesByPath, keys->second.path, aModule );
+
+    m_moduleKeys.erase( keys );
+}
+
+
+MODULE* BOARD::findIndexedModule( const MODULE_INDEX& aIndex, const wxString& aKey ) const
+{
+    std::pair<MODULE_INDEX::const_iterator, MODULE_INDEX::const_iterator> range =
+            aIndex.equal_range( aKey );
+
+    if( range.first == range.second )
+        return NULL;
 
-#if 0   // case independent compare, why?
-        for( MODULE* module = m_Modules;  module;  module = module->Next() )
+    MODULE_INDEX::const_iterator second = range.first;
+
+    if( ++second == range.second )
+        return range.first->second;
+
+    // The key is not unique (e.g. duplicated references), return the first matching module
+    for( MODULE* module = m_Modules; module; module = module->Next() )
+    {
+        for( MODULE_INDEX::const_iterator it = range.first; it != range.second; ++it )
         {
-            if( aRefOrTimeStamp.CmpNoCase( module->GetReference() ) == 0 )
+            if( it->second == module )
                 return module;
         }
-#else
-        return FindModuleByReference( aRefOrTimeStamp );
-#endif
-
     }
 
     return NULL;
@@ -1463,8 +1746,304 @@ int BOARD::SetAreasNetCodesFromNetNames()
 }
 
 
+/**
+ * Struct FIRST_ITEM_FINDER
+ * is a visitor of CONNECTED_ITEMS_RTREE, looking for the item accepted by PREDICATE that
+ * comes first in the board lists.
+ */
+template <class PREDICATE>
+struct FIRST_ITEM_FINDER
+{
+    FIRST_ITEM_FINDER( const PREDICATE& aPredicate ) :
+        m_predicate( aPredicate ), m_found( NULL ), m_order( 0.0 )
+    {
+    }
+
+    bool operator()( const CONNECTED_ITEM_REF& aRef )
+    {
+        if( ( !m_found || aRef.order < m_order ) && m_predicate( aRef.item ) )
+        {
+            m_found = aRef.item;
+            m_order = aRef.order;
+        }
+
+        return true;
+    }
+
+    const PREDICATE&        m_predicate;
+    BOARD_CONNECTED_ITEM*   m_found;
+    double                  m_order;
+};
+
+
+/**
+ * Function findFirstItem
+ * @return the item accepted by aPredicate, at aPosition in aIndex, that comes first
+ * in the board lists.
+ */
+template <class PREDICATE>
+static BOARD_CONNECTED_ITEM* findFirstItem( CONNECTED_ITEMS_RTREE* aIndex,
+                                            const wxPoint& aPosition,
+                                            const PREDICATE& aPredicate )
+{
+    FIRST_ITEM_FINDER<PREDICATE> finder( aPredicate );
+
+    aIndex->Query( aPosition, finder );
+
+    return finder.m_found;
+}
+
+
+/// Hit test used by GetViaByPosition()
+struct VIA_AT_POSITION
+{
+    VIA_AT_POSITION( const wxPoint& aPosition, LAYER_ID aLayer ) :
+        m_position( aPosition ), m_layer( aLayer )
+    {
+    }
+
+    bool operator()( BOARD_CONNECTED_ITEM* aItem ) const
+    {
+        VIA* via = dyn_cast<VIA*>( aItem );
+
+        return via && via->GetStart() == m_position &&
+               via->GetState( BUSY | IS_DELETED ) == 0 &&
+               ( m_layer == UNDEFINED_LAYER || via->IsOnLayer( m_layer ) );
+    }
+
+    const wxPoint&  m_position;
+    LAYER_ID        m_layer;
+};
+
+
+/// Hit test used by GetPad() and GetLockPoint(), the same as in MODULE::GetPad()
+struct PAD_AT_POSITION
+{
+    PAD_AT_POSITION( const wxPoint& aPosition, LSET aLayerMask ) :
+        m_position( aPosition ), m_layerMask( aLayerMask )
+    {
+    }
+
+    bool operator()( BOARD_CONNECTED_ITEM* aItem ) const
+    {
+        D_PAD* pad = static_cast<D_PAD*>( aItem );
+
+        return ( pad->GetLayerSet() & m_layerMask ).any() && pad->HitTest( m_position );
+    }
+
+    const wxPoint&  m_position;
+    LSET            m_layerMask;
+};
+
+
+/// Hit test used by GetTrack()
+struct TRACK_AT_POSITION
+{
+    TRACK_AT_POSITION( const BOARD_DESIGN_SETTINGS& aSettings, const wxPoint& aPosition,
+                       LSET aLayerMask ) :
+        m_settings( aSettings ), m_position( aPosition ), m_layerMask( aLayerMask )
+    {
+    }
+
+    bool operator()( BOARD_CONNECTED_ITEM* aItem ) const
+    {
+        TRACK*   track = static_cast<TRACK*>( aItem );
+        LAYER_ID layer = track->GetLayer();
+
+        if( track->GetState( BUSY | IS_DELETED ) )
+            return false;
+
+        if( !m_settings.IsLayerVisible( layer ) )
+            return false;
+
+        // Vias are found regardless of the layer mask
+        if( track->Type() != PCB_VIA_T && !m_layerMask[layer] )
+            return false;
+
+        return track->HitTest( m_position );
+    }
+
+    const BOARD_DESIGN_SETTINGS&    m_settings;
+    const wxPoint&                  m_position;
+    LSET                            m_layerMask;
+};
+
+
+/// Hit test used by GetLockPoint(), the same as in ::GetTrack()
+struct TRACK_END_AT_POSITION
+{
+    TRACK_END_AT_POSITION( const wxPoint& aPosition, LSET aLayerMask ) :
+        m_position( aPosition ), m_layerMask( aLayerMask )
+    {
+    }
+
+    bool operator()( BOARD_CONNECTED_ITEM* aItem ) const
+    {
+        TRACK* track = static_cast<TRACK*>( aItem );
+
+        if( track->GetState( IS_DELETED | BUSY ) )
+            return false;
+
+        if( m_position != track->GetStart() && m_position != track->GetEnd() )
+            return false;
+
+        return ( m_layerMask & track->GetLayerSet() ).any();
+    }
+
+    const wxPoint&  m_position;
+    LSET            m_layerMask;
+};
+
+
+BOARD::SPATIAL_INDEX_STAMP BOARD::spatialIndexStamp() const
+{
+    SPATIAL_INDEX_STAMP stamp;
+
+    stamp.modules  = m_Modules.GetRevision();
+    stamp.tracks   = m_Track.GetRevision();
+    stamp.pads     = m_padListRevision;
+
+    return stamp;
+}
+
+
+bool BOARD::useSpatialIndex() const
+{
+    SPATIAL_INDEX_STAMP stamp = spatialIndexStamp();
+
+    if( m_tracksIndex && stamp == m_spatialIndexStamp )
+        return true;
+
+    if( stamp == m_spatialQueryStamp )
+    {
+        // The board has not changed since the last query, it is worth to index it
+        buildSpatialIndex();
+        return true;
+    }
+
+    m_spatialQueryStamp = stamp;
+
+    return false;
+}
+
+
+void BOARD::buildSpatialIndex() const
+{
+    if( !m_padsIndex )
+        m_padsIndex = new CONNECTED_ITEMS_RTREE;
+    else
+        m_padsIndex->RemoveAll();
+
+    if( !m_tracksIndex )
+        m_tracksIndex = new CONNECTED_ITEMS_RTREE;
+    else
+        m_tracksIndex->RemoveAll();
+
+    const double step = CONNECTED_ITEMS_RTREE::OrderStep();
+    double order = 0.0;
+
+    for( MODULE* module = m_Modules; module; module = module->Next() )
+    {
+        for( D_PAD* pad = module->Pads(); pad; pad = pad->Next() )
+        {
+            m_padsIndex->Insert( pad, order );
+            order += step;
+        }
+    }
+
+    order = 0.0;
+
+    for( TRACK* track = m_Track; track; track = track->Next() )
+    {
+        m_tracksIndex->Insert( track, order );
+        order += step;
+    }
+
+    m_spatialIndexStamp = spatialIndexStamp();
+}
+
+
+bool BOARD::indexTrack( TRACK* aTrack ) const
+{
+    const double step = CONNECTED_ITEMS_RTREE::OrderStep();
+    double order;
+
+    if( aTrack->Back() && aTrack->Next() )
+    {
+        double back, next;
+
+        if( !m_tracksIndex->GetOrder( aTrack->Back(), &back ) ||
+            !m_tracksIndex->GetOrder( aTrack->Next(), &next ) )
+            return false;
+
+        order = ( back + next ) / 2;
+
+        // No key left between the neighbours
+        if( order <= back || order >= next )
+            return false;
+    }
+    else if( aTrack->Back() )
+    {
+        if( !m_tracksIndex->GetOrder( aTrack->Back(), &order ) )
+            return false;
+
+        order += step;
+    }
+    else if( aTrack->Next() )
+    {
+        if( !m_tracksIndex->GetOrder( aTrack->Next(), &order ) )
+            return false;
+
+        order -= step;
+    }
+    else
+    {
+        order = 0.0;
+    }
+
+    m_tracksIndex->Insert( aTrack, order );
+
+    return true;
+}
+
+
+void BOARD::indexModulePads( MODULE* aModule ) const
+{
+    const double step = CONNECTED_ITEMS_RTREE::OrderStep();
+
+    if( aModule->Back() )
+    {
+        // Appended: after the pads of all the other modules
+        double order = m_padsIndex->GetLastOrder();
+
+        for( D_PAD* pad = aModule->Pads(); pad; pad = pad->Next() )
+        {
+            order += step;
+            m_padsIndex->Insert( pad, order );
+        }
+    }
+    else
+    {
+        // Pushed front: before the pads of all the other modules
+        double order = m_padsIndex->GetFirstOrder() - step * aModule->Pads().GetCount();
+
+        for( D_PAD* pad = aModule->Pads(); pad; pad = pad->Next() )
+        {
+            m_padsIndex->Insert( pad, order );
+            order += step;
+        }
+    }
+}
+
+
 VIA* BOARD::GetViaByPosition( const wxPoint& aPosition, LAYER_ID aLayer) const
 {
+    if( useSpatialIndex() )
+    {
+        return static_cast<VIA*>( findFirstItem( m_tracksIndex, aPosition,
+                                                 VIA_AT_POSITION( aPosition, aLayer ) ) );
+    }
+
     for( VIA *via = GetFirstVia( m_Track); via; via = GetFirstVia( via->Next() ) )
     {
         if( (via->GetStart() == aPosition) &&
@@ -1477,10 +2056,13 @@ VIA* BOARD::GetViaByPosition( const wxPoint& aPosition, LAYER_ID aLayer) const
 }
 
 
-D_PAD* BOARD::GetPad( const wxPoint& aPosition, LSET aLayerMask )
+D_PAD* BOARD::findPad( const wxPoint& aPosition, LSET aLayerMask ) const
 {
-    if( !aLayerMask.any() )
-        aLayerMask = LSET::AllCuMask();
+    if( useSpatialIndex() )
+    {
+        return static_cast<D_PAD*>( findFirstItem( m_padsIndex, aPosition,
+                                                   PAD_AT_POSITION( aPosition, aLayerMask ) ) );
+    }
 
     for( MODULE* module = m_Modules;  module;  module = module->Next() )
     {
@@ -1494,21 +2076,22 @@ D_PAD* BOARD::GetPad( const wxPoint& aPosition, LSET aLayerMask )
 }
 
 
+D_PAD* BOARD::GetPad( const wxPoint& aPosition, LSET aLayerMask )
+{
+    if( !aLayerMask.any() )
+        aLayerMask = LSET::AllCuMask();
+
+    return findPad( aPosition, aLayerMask );
+}
+
+
 D_PAD* BOARD::GetPad( TRACK* aTrace, ENDPOINT_T aEndPoint )
 {
     const wxPoint& aPosition = aTrace->GetEndPoint( aEndPoint );
 
     LSET aLayerMask( aTrace->GetLayer() );
 
-    for( MODULE* module = m_Modules;  module;  module = module->Next() )
-    {
-        D_PAD*  pad = module->GetPad( aPosition, aLayerMask );
-
-        if( pad )
-            return pad;
-    }
-
-    return NULL;
+    return findPad( aPosition, aLayerMask );
 }
 
 
@@ -1661,6 +2244,14 @@ void BOARD::GetSortedPadListByXthenYCoord( std::vector<D_PAD*>& aVector, int aNe
 TRACK* BOARD::GetTrack( TRACK* aTrace, const wxPoint& aPosition,
         LSET aLayerMask ) const
 {
+    // The index covers the whole track list only
+    if( aTrace == m_Track && aTrace && useSpatialIndex() )
+    {
+        TRACK_AT_POSITION hitTest( m_designSettings, aPosition, aLayerMask );
+
+        return static_cast<TRACK*>( findFirstItem( m_tracksIndex, aPosition, hitTest ) );
+    }
+
     for( TRACK* track = aTrace; track; track = track->Next() )
     {
         LAYER_ID layer = track->GetLayer();
@@ -2001,16 +2592,23 @@ MODULE* BOARD::GetFootprint( const wxPoint& aPosition, LAYER_ID aActiveLayer,
 
 BOARD_CONNECTED_ITEM* BOARD::GetLockPoint( const wxPoint& aPosition, LSET aLayerMask )
 {
-    for( MODULE* module = m_Modules; module; module = module->Next() )
-    {
-        D_PAD* pad = module->GetPad( aPosition, aLayerMask );
+    D_PAD* pad = findPad( aPosition, aLayerMask );
 
-        if( pad )
-            return pad;
-    }
+    if( pad )
+        return pad;
 
     // No pad has been located so check for a segment of the trace.
-    TRACK* segment = ::GetTrack( m_Track, NULL, aPosition, aLayerMask );
+    TRACK* segment;
+
+    if( useSpatialIndex() )
+    {
+        segment = static_cast<TRACK*>( findFirstItem( m_tracksIndex, aPosition,
+                                       TRACK_END_AT_POSITION( aPosition, aLayerMask ) ) );
+    }
+    else
+    {
+        segment = ::GetTrack( m_Track, NULL, aPosition, aLayerMask );
+    }
 
     if( segment == NULL )
         segment = GetTrack( m_Track, aPosition, aLayerMask );
@@ -32,6 +32,7 @@
 
 
 #include <dlist.h>
+#include <boost/unordered_map.hpp>
 
 #include <common.h>                         // PAGE_INFO
 #include <layers_id_colors_and_visibility.h>
@@ -47,6 +48,7 @@
 class PCB_BASE_FRAME;
 class PCB_EDIT_FRAME;
 class PICKED_ITEMS_LIST;
+class CONNECTED_ITEMS_RTREE;
 class BOARD;
 class ZONE_CONTAINER;
 class SEGZONE;
@@ -212,6 +214,63 @@ private:
     /// Number of unconnected nets in the current rats nest.
     int                     m_unconnectedNetCount;
 
+    /// Hash index of modules, several modules may share a key
+    typedef boost::unordered_multimap<wxString, MODULE*, WXSTRING_HASH> MODULE_INDEX;
+
+    /// Keys a module is stored under in the module indexes
+    struct MODULE_KEYS
+    {
+        wxString reference;
+        wxString path;
+    };
+
+    typedef boost::unordered_map<const MODULE*, MODULE_KEYS> MODULE_KEYS_MAP;
+
+    /// Modules by reference designator, used by FindModuleByReference()
+    mutable MODULE_INDEX    m_modulesByReference;
+
+    /// Modules by time stamp path (upper case), used by FindModule()
+    mutable MODULE_INDEX    m_modulesByPath;
+
+    /// Keys of the indexed modules, needed to update the indexes when a key changes
+    mutable MODULE_KEYS_MAP m_moduleKeys;
+
+    /// m_Modules revision the module indexes correspond to
+    mutable unsigned        m_moduleIndexRevision;
+
+    /// Set when the module indexes have been built
+    mutable bool            m_moduleIndexValid;
+
+    /// State of the board lists, see spatialIndexStamp()
+    struct SPATIAL_INDEX_STAMP
+    {
+        unsigned modules;
+        unsigned tracks;
+        unsigned pads;
+
+        bool operator==( const SPATIAL_INDEX_STAMP& aOther ) const
+        {
+            return modules == aOther.modules && tracks == aOther.tracks &&
+                   pads == aOther.pads;
+        }
+    };
+
+    /// Incremented by PadListChanged()
+    unsigned                        m_padListRevision;
+
+    /// Spatial index of pads, used by GetPad() and GetLockPoint()
+    mutable CONNECTED_ITEMS_RTREE*  m_padsIndex;
+
+    /// Spatial index of tracks and vias, used by GetTrack(), GetViaByPosition()
+    /// and GetLockPoint()
+    mutable CONNECTED_ITEMS_RTREE*  m_tracksIndex;
+
+    /// Board state the spatial indexes have been built or updated for
+    mutable SPATIAL_INDEX_STAMP     m_spatialIndexStamp;
+
+    /// Board state seen by the last query that could not use the spatial indexes
+    mutable SPATIAL_INDEX_STAMP     m_spatialQueryStamp;
+
     /**
      * Function chainMarkedSegments
      * is used by MarkTrace() to set the BUSY flag of connected segments of the trace
@@ -223,6 +282,97 @@ private:
      */
     void chainMarkedSegments( wxPoint aPosition, LSET aLayerMask, TRACK_PTRS* aList );
 
+    /**
+     * Function isModuleIndexCurrent
+     * @return true if the module indexes describe the current content of m_Modules.
+     * Modules may be added or removed directly through the DLIST, in that case
+     * the indexes are rebuilt on the next look up.
+     */
+    bool isModuleIndexCurrent() const
+    {
+        return m_moduleIndexValid && m_moduleIndexRevision == m_Modules.GetRevision();
+    }
+
+    /**
+     * Function buildModuleIndex
+     * rebuilds the module indexes from scratch.
+     */
+    void buildModuleIndex() const;
+
+    /**
+     * Function indexModule
+     * adds \a aModule to the module indexes.
+     */
+    void indexModule( MODULE* aModule ) const;
+
+    /**
+     * Function unindexModule
+     * removes \a aModule from the module indexes.
+     */
+    void unindexModule( const MODULE* aModule ) const;
+
+    /**
+     * Function findIndexedModule
+     * looks up \a aKey in \a aIndex.  If several modules share the key, the first one
+     * found in m_Modules is returned, as a linear search would do.
+     */
+    MODULE* findIndexedModule( const MODULE_INDEX& aIndex, const wxString& aKey ) const;
+
+    /**
+     * Function spatialIndexStamp
+     * @return the current state of the board: revisions of the module and track lists
+     * and of the pad lists of the modules.
+     */
+    SPATIAL_INDEX_STAMP spatialIndexStamp() const;
+
+    /**
+     * Function isSpatialIndexCurrent
+     * @return true if the spatial indexes are built and describe the board lists.
+     */
+    bool isSpatialIndexCurrent() const
+    {
+        return m_tracksIndex && spatialIndexStamp() == m_spatialIndexStamp;
+    }
+
+    /**
+     * Function useSpatialIndex
+     * checks if the spatial indexes can be used by a hit test function.
+     * The indexes follow the items moved or resized, the pads and tracks deleted and
+     * those added or removed by Add() and Remove().  They are outdated when the lists
+     * are changed otherwise.  Outdated indexes are rebuilt only if the board has not
+     * changed since the previous query, as a linear search is cheaper than rebuilding
+     * the indexes for every query while the lists are being changed.
+     * @return true if the spatial indexes are up to date.
+     */
+    bool useSpatialIndex() const;
+
+    /**
+     * Function indexTrack
+     * inserts \a aTrack, just inserted in m_Track, in the spatial index of tracks.
+     * @return false if no order key is left between its neighbours, then the index
+     * must be rebuilt.
+     */
+    bool indexTrack( TRACK* aTrack ) const;
+
+    /**
+     * Function indexModulePads
+     * inserts the pads of \a aModule, just added in m_Modules, in the spatial index of
+     * pads.
+     */
+    void indexModulePads( MODULE* aModule ) const;
+
+    /**
+     * Function buildSpatialIndex
+     * rebuilds the spatial indexes of pads and tracks.
+     */
+    void buildSpatialIndex() const;
+
+    /**
+     * Function findPad
+     * finds the first pad on \a aLayerMask hit by \a aPosition.
+     */
+    D_PAD* findPad( const wxPoint& aPosition, LSET aLayerMask ) const;
+
 public:
     static inline bool ClassOf( const EDA_ITEM* aItem )
     {
@@ -268,6 +418,17 @@ public:
     void SetFileFormatVersionAtLoad( int aVersion ) { m_fileFormatVersionAtLoad = aVersion; }
     int GetFileFormatVersionAtLoad()  const { return m_fileFormatVersionAtLoad; }
 
+    /**
+     * Function Snapshot
+     * creates a copy of this board holding everything written to a board file, so the
+     * copy can be formatted in a worker thread while this board is edited.  The copy has
+     * its own nets and net classes and keeps the time stamps of the items.  Markers and
+     * connectivity data are not copied, only the rats nest counts are.
+     * The copy must be deleted in the main thread.
+     * @return BOARD* - the copy, owned by the caller.
+     */
+    BOARD* Snapshot() const;
+
     /**
      * Function Add
      * adds the given item to this BOARD and takes ownership of its memory.
@@ -301,6 +462,13 @@ public:
      */
     BOARD_ITEM* Remove( BOARD_ITEM* aBoardItem );
 
+    /**
+     * Function PadListChanged
+     * is called by MODULE when pads are added to or removed from a module of this board,
+     * it outdates the spatial index of pads.
+     */
+    void PadListChanged() { ++m_padListRevision; }
+
     BOARD_ITEM* DuplicateAndAddItem( const BOARD_ITEM* aItem,
                                      bool aIncrementReferences );
 
@@ -939,6 +1107,15 @@ public:
      */
     MODULE* FindModule( const wxString& aRefOrTimeStamp, bool aSearchByTimeStamp = false ) const;
 
+    /**
+     * Function UpdateModuleIndex
+     * updates the keys of \a aModule in the indexes used by FindModuleByReference() and
+     * FindModule().  It has to be called after the reference or the path of a module
+     * has been changed, MODULE and TEXTE_MODULE setters take care of it.
+     * @param aModule is the changed module, it is ignored if it does not belong to this board.
+     */
+    void UpdateModuleIndex( MODULE* aModule );
+
     /**
      * Function ReplaceNetlist
      * updates the #BOARD according to \a aNetlist.
@@ -33,18 +33,49 @@
 
 #include <class_board.h>
 #include <class_board_item.h>
+#include <connected_items_rtree.h>
+
 
 BOARD_CONNECTED_ITEM::BOARD_CONNECTED_ITEM( BOARD_ITEM* aParent, KICAD_T idtype ) :
     BOARD_ITEM( aParent, idtype ), m_netinfo( &NETINFO_LIST::ORPHANED ),
-    m_Subnet( 0 ), m_ZoneSubnet( 0 )
+    m_Subnet( 0 ), m_ZoneSubnet( 0 ), m_spatialIndex( NULL )
 {
 }
 
 
 BOARD_CONNECTED_ITEM::BOARD_CONNECTED_ITEM( const BOARD_CONNECTED_ITEM& aItem ) :
     BOARD_ITEM( aItem ), m_netinfo( aItem.m_netinfo ), m_Subnet( aItem.m_Subnet ),
-    m_ZoneSubnet( aItem.m_ZoneSubnet )
+    m_ZoneSubnet( aItem.m_ZoneSubnet ), m_spatialIndex( NULL )
+{
+}
+
+
+BOARD_CONNECTED_ITEM::~BOARD_CONNECTED_ITEM()
+{
+    // The index keeps the area the item was inserted with, the item itself is not used
+    if( m_spatialIndex )
+        m_spatialIndex->Remove( this );
+}
+
+
+BOARD_CONNECTED_ITEM& BOARD_CONNECTED_ITEM::operator=( const BOARD_CONNECTED_ITEM& aItem )
+{
+    BOARD_ITEM::operator=( aItem );
+
+    m_TracksConnected = aItem.m_TracksConnected;
+    m_PadsConnected = aItem.m_PadsConnected;
+    m_netinfo = aItem.m_netinfo;
+    m_Subnet = aItem.m_Subnet;
+    m_ZoneSubnet = aItem.m_ZoneSubnet;
+
+    return *this;
+}
+
+
+void BOARD_CONNECTED_ITEM::geometryChanged()
 {
+    if( m_spatialIndex )
+        m_spatialIndex->Update( this );
 }
 
 
@@ -37,6 +37,7 @@
 class NETCLASS;
 class TRACK;
 class D_PAD;
+class CONNECTED_ITEMS_RTREE;
 
 /**
  * Class BOARD_CONNECTED_ITEM
@@ -48,6 +49,7 @@ class D_PAD;
 class BOARD_CONNECTED_ITEM : public BOARD_ITEM
 {
     friend class CONNECTIONS;
+    friend class CONNECTED_ITEMS_RTREE;
 
 public:
     // These 2 members are used for temporary storage during connections calculations:
@@ -58,6 +60,12 @@ public:
 
     BOARD_CONNECTED_ITEM( const BOARD_CONNECTED_ITEM& aItem );
 
+    /// Removes the item from the spatial index of its board, if it is indexed
+    ~BOARD_CONNECTED_ITEM();
+
+    /// Copies the item data.  The item stays in its own spatial index, if any.
+    BOARD_CONNECTED_ITEM& operator=( const BOARD_CONNECTED_ITEM& aItem );
+
     static inline bool ClassOf( const EDA_ITEM* aItem )
     {
         if( aItem == NULL )
@@ -185,6 +193,13 @@ protected:
     /// Stores all informations about the net that item belongs to
     NETINFO_ITEM* m_netinfo;
 
+    /**
+     * Function geometryChanged
+     * has to be called by functions changing the shape or the position of a pad or
+     * a track, so the spatial index of its board is updated.
+     */
+    void geometryChanged();
+
 private:
     int         m_Subnet;       /* In rastnest routines : for the current net, block number
                                  * (number common to the current connected items found)
@@ -192,6 +207,9 @@ private:
 
     int         m_ZoneSubnet;   // used in rastnest computations : for the current net,
                                 // handle cluster number in zone connection
+
+    /// The spatial index of the board holding this item, NULL if the item is not indexed
+    CONNECTED_ITEMS_RTREE* m_spatialIndex;
 };
 
 
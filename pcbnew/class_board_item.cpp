@@ -88,82 +88,102 @@ wxString BOARD_ITEM::GetLayerName() const
 
 std::string BOARD_ITEM::FormatInternalUnits( int aValue )
 {
-#if 1
+    char    buf[FMT_IU_BUFSIZE];
+    int     len = FormatInternalUnits( buf, aValue );
 
-    char    buf[50];
-    int     len;
-    double  mm = aValue / IU_PER_MM;
+    return std::string( buf, len );
+}
 
-    if( mm != 0.0 && fabs( mm ) <= 0.0001 )
+
+int BOARD_ITEM::FormatInternalUnits( char* aBuffer, int aValue )
+{
+    if( IU_PER_MM != 1e6 )
     {
-        len = sprintf( buf, "%.10f", mm );
+        int     len;
+        double  mm = aValue / IU_PER_MM;
 
-        while( --len > 0 && buf[len] == '0' )
-            buf[len] = '\0';
+        if( mm != 0.0 && fabs( mm ) <= 0.0001 )
+        {
+            len = sprintf( aBuffer, "%.10f", mm );
+
+            while( --len > 0 && aBuffer[len] == '0' )
+                aBuffer[len] = '\0';
 
-        if( buf[len] == '.' )
-            buf[len] = '\0';
+            if( aBuffer[len] == '.' )
+                aBuffer[len] = '\0';
+            else
+                ++len;
+        }
         else
-            ++len;
-    }
-    else
-    {
-        len = sprintf( buf, "%.10g", mm );
-    }
+        {
+            len = sprintf( aBuffer, "%.10g", mm );
+        }
 
-    return std::string( buf, len );
+        return len;
+    }
 
-#else
+    // Internal units are nanometers: write the integer millimeters, then the
+    // decimal point and the remaining digits, without the trailing zeros.
+    // A 32 bit int has at most 10 digits, so this is the same text as "%.10g"
+    // of aValue / IU_PER_MM gives (and "%.10f" for the tiny values), with no
+    // floating point and no sprintf().
+    char*       cp = aBuffer;
+    unsigned    value = aValue;
 
-    // Assume aValue is in nanometers, and that we want the result in millimeters,
-    // and that int is 32 bits wide.  Then perform an alternative algorithm.
-    // Can be used to verify that the above algorithm is correctly generating text.
-    // Convert aValue into an integer string, then insert a decimal point manually.
-    // Results are the same as above general purpose algorithm.
+    if( aValue < 0 )
+    {
+        *cp++ = '-';
+        value = 0u - value;
+    }
 
-    wxASSERT( sizeof(int) == 4 );
+    unsigned    mm = value / 1000000;
+    unsigned    fraction = value % 1000000;
+    char        digits[12];
+    int         count = 0;
 
-    if( aValue == 0 )
-        return std::string( 1, '0' );
-    else
+    do
     {
-        char    buf[50];
-        int     len = sprintf( buf, aValue > 0 ? "%06d" : "%07d", aValue );     // optionally pad w/leading zeros
+        digits[count++] = char( '0' + mm % 10 );
+        mm /= 10;
+    } while( mm );
 
-        std::string ret( buf, len );
+    while( count )
+        *cp++ = digits[--count];
 
-        std::string::iterator it = ret.end() - 1;           // last byte
+    if( fraction )
+    {
+        int width = 6;
 
-        // insert '.' at 6 positions from end, dividing by 10e6 (a million), nm => mm
-        std::string::iterator decpoint = ret.end() - 6;
+        while( fraction % 10 == 0 )
+        {
+            fraction /= 10;
+            --width;
+        }
 
-        // truncate trailing zeros, up to decimal point position
-        for(  ; *it=='0' && it >= decpoint;  --it )
-            ret.erase( it );    // does not invalidate iterators it or decpoint
+        *cp++ = '.';
 
-        if( it >= decpoint )
+        for( int i = width - 1; i >= 0; --i )
         {
-            ret.insert( decpoint, '.' );
-
-            // decpoint is invalidated here, after insert()
-
-#if 1       // want a leading zero when decimal point is in first position?
-            if( ret[0] == '.' )
-            {
-                // insert leading zero ahead of decimal point.
-                ret.insert( ret.begin(), '0' );
-            }
-            else if( ret[0]=='-' && ret[1]=='.' )
-            {
-                ret.insert( ret.begin() + 1, '0' );
-            }
-#endif
+            cp[i] = char( '0' + fraction % 10 );
+            fraction /= 10;
         }
 
-        return ret;
+        cp += width;
     }
 
-#endif
+    *cp = '\0';
+
+    return cp - aBuffer;
+}
+
+
+int BOARD_ITEM::FormatInternalUnits( char* aBuffer, const wxPoint& aPoint )
+{
+    int len = FormatInternalUnits( aBuffer, aPoint.x );
+
+    aBuffer[len++] = ' ';
+
+    return len + FormatInternalUnits( aBuffer + len, aPoint.y );
 }
 
 
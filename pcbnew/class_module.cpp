@@ -208,6 +208,18 @@ void MODULE::DrawAncre( EDA_DRAW_PANEL* panel, wxDC* DC, const wxPoint& offset,
 }
 
 
+void MODULE::SetPath( const wxString& aPath )
+{
+    m_Path = aPath;
+
+    // The path is a key of the board module index
+    BOARD* board = GetBoard();
+
+    if( board )
+        board->UpdateModuleIndex( this );
+}
+
+
 void MODULE::Copy( MODULE* aModule )
 {
     m_Pos           = aModule->m_Pos;
@@ -246,6 +258,8 @@ void MODULE::Copy( MODULE* aModule )
         m_Pads.PushBack( newpad );
     }
 
+    padListChanged();
+
     // Copy auxiliary data: Drawings
     m_Drawings.DeleteAll();
 
@@ -309,6 +323,15 @@ void MODULE::Copy( MODULE* aModule )
 }
 
 
+void MODULE::padListChanged()
+{
+    BOARD* board = GetBoard();
+
+    if( board )
+        board->PadListChanged();
+}
+
+
 void MODULE::Add( BOARD_ITEM* aBoardItem, bool doAppend )
 {
     switch( aBoardItem->Type() )
@@ -331,6 +354,8 @@ void MODULE::Add( BOARD_ITEM* aBoardItem, bool doAppend )
             m_Pads.PushBack( static_cast<D_PAD*>( aBoardItem ) );
         else
             m_Pads.PushFront( static_cast<D_PAD*>( aBoardItem ) );
+
+        padListChanged();
         break;
 
     default:
@@ -362,6 +387,7 @@ BOARD_ITEM* MODULE::Remove( BOARD_ITEM* aBoardItem )
         return m_Drawings.Remove( static_cast<BOARD_ITEM*>( aBoardItem ) );
 
     case PCB_PAD_T:
+        padListChanged();
         return m_Pads.Remove( static_cast<D_PAD*>( aBoardItem ) );
 
     default:
@@ -1134,7 +1160,7 @@ BOARD_ITEM* MODULE::DuplicateAndAddItem( const BOARD_ITEM* aItem,
     {
         D_PAD* new_pad = new D_PAD( *static_cast<const D_PAD*>( aItem ) );
 
-        Pads().PushBack( new_pad );
+        Add( new_pad );
         new_item = new_pad;
         break;
     }
@@ -173,7 +173,7 @@ public:
     void SetKeywords( const wxString& aKeywords ) { m_KeyWord = aKeywords; }
 
     const wxString& GetPath() const { return m_Path; }
-    void SetPath( const wxString& aPath ) { m_Path = aPath; }
+    void SetPath( const wxString& aPath );
 
     int GetLocalSolderMaskMargin() const { return m_LocalSolderMaskMargin; }
     void SetLocalSolderMaskMargin( int aMargin ) { m_LocalSolderMaskMargin = aMargin; }
@@ -669,6 +669,12 @@ private:
 
     wxArrayString*    m_initial_comments;   ///< leading s-expression comments in the module,
                                             ///< lazily allocated only if needed for speed
+
+    /**
+     * Function padListChanged
+     * tells the board holding this module that pads have been added or removed.
+     */
+    void padListChanged();
 };
 
 #endif     // MODULE_H_
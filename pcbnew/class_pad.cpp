@@ -234,12 +234,16 @@ void D_PAD::SetDrawCoord()
     m_Pos = m_Pos0;
 
     if( module == NULL )
+    {
+        geometryChanged();
         return;
+    }
 
     double angle = module->GetOrientation();
 
     RotatePoint( &m_Pos.x, &m_Pos.y, angle );
     m_Pos += module->GetPosition();
+    geometryChanged();
 }
 
 
@@ -271,6 +275,7 @@ void D_PAD::SetOrientation( double aAngle )
 {
     NORMALIZE_ANGLE_POS( aAngle );
     m_Orient = aAngle;
+    geometryChanged();
 }
 
 
@@ -456,6 +461,8 @@ void D_PAD::Copy( D_PAD* source )
 
     SetSubRatsnest( 0 );
     SetSubNet( 0 );
+
+    geometryChanged();
 }
 
 
@@ -849,6 +856,7 @@ void D_PAD::Rotate( const wxPoint& aRotCentre, double aAngle )
     NORMALIZE_ANGLE_360( m_Orient );
 
     SetLocalCoord();
+    geometryChanged();
 }
 
 
@@ -995,6 +1003,28 @@ unsigned int D_PAD::ViewGetLOD( int aLayer ) const
 }
 
 
+int D_PAD::ViewGetMinScreenSize( int aLayer ) const
+{
+    // Netnames visibility is already handled by ViewGetLOD()
+    if( IsNetnameLayer( aLayer ) )
+        return 0;
+
+    // Do not bother drawing pads that would take less than a couple of pixels
+    return 2;
+}
+
+
+KIGFX::VIEW_ITEM* D_PAD::ViewGetLODProxy( int aLayer ) const
+{
+    // Tiny copper pads are represented by the footprint box, other layers are simply skipped
+    if( aLayer == ITEM_GAL_LAYER( PADS_VISIBLE ) || aLayer == ITEM_GAL_LAYER( PAD_FR_VISIBLE ) ||
+        aLayer == ITEM_GAL_LAYER( PAD_BK_VISIBLE ) )
+        return GetParent();
+
+    return NULL;
+}
+
+
 const BOX2I D_PAD::ViewBBox() const
 {
     // Bounding box includes soldermask too
@@ -136,13 +136,18 @@ public:
      * @return the shape of this pad.
      */
     PAD_SHAPE_T GetShape() const                { return m_padShape; }
-    void SetShape( PAD_SHAPE_T aShape )         { m_padShape = aShape; m_boundingRadius = -1; }
+    void SetShape( PAD_SHAPE_T aShape )
+    {
+        m_padShape = aShape;
+        m_boundingRadius = -1;
+        geometryChanged();
+    }
 
-    void SetPosition( const wxPoint& aPos )     { m_Pos = aPos; }   // was overload
+    void SetPosition( const wxPoint& aPos )     { m_Pos = aPos; geometryChanged(); } // was overload
     const wxPoint& GetPosition() const          { return m_Pos; }   // was overload
 
-    void SetY( int y )                          { m_Pos.y = y; }
-    void SetX( int x )                          { m_Pos.x = x; }
+    void SetY( int y )                          { m_Pos.y = y; geometryChanged(); }
+    void SetX( int x )                          { m_Pos.x = x; geometryChanged(); }
 
     void SetPos0( const wxPoint& aPos )         { m_Pos0 = aPos; }
     const wxPoint& GetPos0() const              { return m_Pos0; }
@@ -150,16 +155,26 @@ public:
     void SetY0( int y )                         { m_Pos0.y = y; }
     void SetX0( int x )                         { m_Pos0.x = x; }
 
-    void SetSize( const wxSize& aSize )         { m_Size = aSize;  m_boundingRadius = -1; }
+    void SetSize( const wxSize& aSize )
+    {
+        m_Size = aSize;
+        m_boundingRadius = -1;
+        geometryChanged();
+    }
     const wxSize& GetSize() const               { return m_Size; }
 
-    void SetDelta( const wxSize& aSize )        { m_DeltaSize = aSize;  m_boundingRadius = -1; }
+    void SetDelta( const wxSize& aSize )
+    {
+        m_DeltaSize = aSize;
+        m_boundingRadius = -1;
+        geometryChanged();
+    }
     const wxSize& GetDelta() const              { return m_DeltaSize; }
 
     void SetDrillSize( const wxSize& aSize )    { m_Drill = aSize; }
     const wxSize& GetDrillSize() const          { return m_Drill; }
 
-    void SetOffset( const wxPoint& aOffset )    { m_Offset = aOffset; }
+    void SetOffset( const wxPoint& aOffset )    { m_Offset = aOffset; geometryChanged(); }
     const wxPoint& GetOffset() const            { return m_Offset; }
 
     void Flip( const wxPoint& aCentre );        // Virtual function
@@ -421,6 +436,7 @@ public:
     {
         m_Pos += aMoveVector;
         SetLocalCoord();
+        geometryChanged();
     }
 
     void Rotate( const wxPoint& aRotCentre, double aAngle );
@@ -467,6 +483,12 @@ public:
     /// @copydoc VIEW_ITEM::ViewGetLOD()
     virtual unsigned int ViewGetLOD( int aLayer ) const;
 
+    /// @copydoc VIEW_ITEM::ViewGetMinScreenSize()
+    virtual int ViewGetMinScreenSize( int aLayer ) const;
+
+    /// @copydoc VIEW_ITEM::ViewGetLODProxy()
+    virtual KIGFX::VIEW_ITEM* ViewGetLODProxy( int aLayer ) const;
+
     /// @copydoc VIEW_ITEM::ViewBBox()
     virtual const BOX2I ViewBBox() const;
 
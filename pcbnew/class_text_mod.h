@@ -121,6 +121,9 @@ public:
 
     void Copy( TEXTE_MODULE* source ); // copy structure
 
+    /// @copydoc EDA_TEXT::SetText()
+    virtual void SetText( const wxString& aText );
+
     int GetLength() const;        // text length
 
     /**
@@ -181,6 +184,13 @@ public:
     /// @copydoc VIEW_ITEM::ViewGetLayers()
     virtual void ViewGetLayers( int aLayers[], int& aCount ) const;
 
+    /// @copydoc VIEW_ITEM::ViewGetMinScreenSize()
+    virtual int ViewGetMinScreenSize( int aLayer ) const
+    {
+        // Texts smaller than a few pixels are not readable, so there is no point in drawing them
+        return 4;
+    }
+
 #if defined(DEBUG)
     virtual void Show( int nestLevel, std::ostream& os ) const { ShowDummy( os ); }    // override
 #endif
@@ -195,6 +205,9 @@ private:
 
     wxPoint   m_Pos0;       ///< text coordinates relatives to the footprint anchor, orient 0.
                             ///< text coordinate ref point is the text centre
+
+    /// Lets the board know the reference designator of the parent module has changed.
+    void updateModuleIndex();
 };
 
 #endif // TEXT_MODULE_H_
@@ -332,6 +332,7 @@ void TRACK::Rotate( const wxPoint& aRotCentre, double aAngle )
 {
     RotatePoint( &m_Start, aRotCentre, aAngle );
     RotatePoint( &m_End, aRotCentre, aAngle );
+    geometryChanged();
 }
 
 
@@ -339,6 +340,7 @@ void TRACK::Flip( const wxPoint& aCentre )
 {
     m_Start.y = aCentre.y - (m_Start.y - aCentre.y);
     m_End.y   = aCentre.y - (m_End.y - aCentre.y);
+    geometryChanged();
     SetLayer( FlipLayer( GetLayer() ) );
 }
 
@@ -347,6 +349,7 @@ void VIA::Flip( const wxPoint& aCentre )
 {
     m_Start.y = aCentre.y - (m_Start.y - aCentre.y);
     m_End.y   = aCentre.y - (m_End.y - aCentre.y);
+    geometryChanged();
 }
 
 
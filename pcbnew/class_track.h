@@ -101,22 +101,23 @@ public:
     {
         m_Start += aMoveVector;
         m_End   += aMoveVector;
+        geometryChanged();
     }
 
     virtual void Rotate( const wxPoint& aRotCentre, double aAngle );
 
     virtual void Flip( const wxPoint& aCentre );
 
-    void SetPosition( const wxPoint& aPos )     { m_Start = aPos; }     // was overload
+    void SetPosition( const wxPoint& aPos )     { m_Start = aPos; geometryChanged(); } // was overload
     const wxPoint& GetPosition() const          { return m_Start; }     // was overload
 
-    void SetWidth( int aWidth )                 { m_Width = aWidth; }
+    void SetWidth( int aWidth )                 { m_Width = aWidth; geometryChanged(); }
     int GetWidth() const                        { return m_Width; }
 
-    void SetEnd( const wxPoint& aEnd )          { m_End = aEnd; }
+    void SetEnd( const wxPoint& aEnd )          { m_End = aEnd; geometryChanged(); }
     const wxPoint& GetEnd() const               { return m_End; }
 
-    void SetStart( const wxPoint& aStart )      { m_Start = aStart; }
+    void SetStart( const wxPoint& aStart )      { m_Start = aStart; geometryChanged(); }
     const wxPoint& GetStart() const             { return m_Start; }
 
 
@@ -413,7 +414,12 @@ public:
     void LayerPair( LAYER_ID* top_layer, LAYER_ID* bottom_layer ) const;
 
     const wxPoint& GetPosition() const  {  return m_Start; }       // was overload
-    void SetPosition( const wxPoint& aPoint ) { m_Start = aPoint;  m_End = aPoint; }    // was overload
+    void SetPosition( const wxPoint& aPoint )
+    {
+        m_Start = aPoint;
+        m_End = aPoint;
+        geometryChanged();
+    }
 
     virtual bool HitTest( const wxPoint& aPosition ) const;
 
@@ -433,6 +439,13 @@ public:
     /// @copydoc VIEW_ITEM::ViewGetLayers()
     virtual void ViewGetLayers( int aLayers[], int& aCount ) const;
 
+    /// @copydoc VIEW_ITEM::ViewGetMinScreenSize()
+    virtual int ViewGetMinScreenSize( int aLayer ) const
+    {
+        // Sub-pixel vias are not visible anyway
+        return 1;
+    }
+
     virtual void Flip( const wxPoint& aCentre );
 
 #if defined (DEBUG)
@@ -48,6 +48,7 @@ class PCB_EDIT_FRAME;
 class BOARD;
 class ZONE_CONTAINER;
 class MSG_PANEL_ITEM;
+class POLYGON_SET;
 
 
 /**
@@ -298,27 +299,12 @@ public:
     bool BuildFilledSolidAreasPolygons( BOARD* aPcb, CPOLYGONS_LIST* aOutlineBuffer = NULL );
 
     /**
-     * Function CopyPolygonsFromKiPolygonListToFilledPolysList
-     * Copy polygons stored in aKiPolyList to m_FilledPolysList
+     * Function CopyPolygonsFromPolygonSetToFilledPolysList
+     * Copy polygons stored in aPolySet to m_FilledPolysList
      * The previous m_FilledPolysList contents is replaced.
-     * @param aKiPolyList = a KI_POLYGON_SET containing polygons.
+     * @param aPolySet = a fractured POLYGON_SET (see POLYGON_SET::Fracture())
      */
-    void CopyPolygonsFromKiPolygonListToFilledPolysList( KI_POLYGON_SET& aKiPolyList );
-
-    /**
-     * Function CopyPolygonsFromClipperPathsToFilledPolysList
-     * Copy polygons stored in aKiPolyList to m_FilledPolysList
-     * The previous m_FilledPolysList contents is replaced.
-     * @param aClipperPolyList = a ClipperLib::Paths containing polygons.
-     */
-    void CopyPolygonsFromClipperPathsToFilledPolysList( ClipperLib::Paths& aClipperPolyList );
-
-    /**
-     * Function CopyPolygonsFromFilledPolysListToKiPolygonList
-     * Copy polygons from m_FilledPolysList to aKiPolyList
-     * @param aKiPolyList = a KI_POLYGON_SET to fill by polygons.
-     */
-    void CopyPolygonsFromFilledPolysListToKiPolygonList( KI_POLYGON_SET& aKiPolyList );
+    void CopyPolygonsFromPolygonSetToFilledPolysList( const POLYGON_SET& aPolySet );
 
     /**
      * Function AddClearanceAreasPolygonsToPolysList
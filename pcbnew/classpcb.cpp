@@ -184,6 +184,10 @@ PCB_SCREEN::PCB_SCREEN( const wxSize& aPageSizeIU ) :
 
     SetZoom( DEFAULT_ZOOM );             // a default value for zoom
 
+    // Copies of modules and filled zones can be big, so limit also the undo/redo memory.
+    // The board editor reads this budget from its settings.
+    m_UndoRedoMemoryMax = (size_t) PCB_UNDO_MEMORY_MAX_DEFAULT_MB * 1024 * 1024;
+
     InitDataPoints( aPageSizeIU );
 }
 
@@ -36,80 +36,15 @@
 #include <class_board.h>
 #include <class_track.h>
 #include <connect.h>
+#include <tracks_cleaner.h>
 #include <dialog_cleaning_options.h>
 #include <ratsnest_data.h>
 
-// Helper class used to clean tracks and vias
-class TRACKS_CLEANER: CONNECTIONS
-{
-private:
-    BOARD *m_Brd;
-
-public:
-    TRACKS_CLEANER( BOARD * aPcb );
-
-    /**
-     * the cleanup function.
-     * return true if some item was modified
-     */
-    bool CleanupBoard( PCB_EDIT_FRAME *aFrame, bool aCleanVias,
-                       bool aMergeSegments, bool aDeleteUnconnected);
-
-private:
-
-    /**
-     * Removes redundant vias like vias at same location
-     * or on pad through
-     */
-    bool clean_vias();
-
-    /**
-     * Removes all the following THT vias on the same position of the
-     * specified one
-     */
-    bool remove_duplicates_of_via( const VIA *aVia );
-
-    /**
-     * Removes all the following duplicates tracks of the specified one
-     */
-    bool remove_duplicates_of_track( const TRACK *aTrack );
-
-    /**
-     * Removes dangling tracks
-     */
-    bool deleteUnconnectedTracks();
-
-    /// Delete null length track segments
-    bool delete_null_segments();
-
-    /// Try to merge the segment to a following collinear one
-    bool merge_collinear_of_track( TRACK *aSegment );
-
-    /**
-     * Merge collinear segments and remove duplicated and null len segments
-     */
-    bool clean_segments();
+#include <algorithm>
+#include <deque>
+#include <boost/functional/hash.hpp>
+#include <boost/unordered_set.hpp>
 
-    /**
-     * helper function
-     * Rebuild list of tracks, and connected tracks
-     * this info must be rebuilt when tracks are erased
-     */
-    void buildTrackConnectionInfo();
-
-    /**
-     * helper function
-     * merge aTrackRef and aCandidate, when possible,
-     * i.e. when they are colinear, same width, and obviously same layer
-     */
-    TRACK* mergeCollinearSegmentIfPossible( TRACK* aTrackRef,
-                                           TRACK* aCandidate, ENDPOINT_T aEndType );
-
-    const ZONE_CONTAINER* zoneForTrackEndpoint( const TRACK *aTrack,
-            ENDPOINT_T aEndPoint );
-
-    bool testTrackEndpointDangling( TRACK *aTrack, ENDPOINT_T aEndPoint );
-};
 
 /* Install the cleanup dialog frame to know what should be cleaned
 */
@@ -123,8 +58,24 @@ void PCB_EDIT_FRAME::Clean_Pcb()
     wxBusyCursor( dummy );
     TRACKS_CLEANER cleaner( GetBoard() );
 
-    cleaner.CleanupBoard( this, dlg.m_cleanVias, dlg.m_mergeSegments,
-                          dlg.m_deleteUnconnectedSegm );
+    if( cleaner.CleanupBoard( this, dlg.m_cleanVias, dlg.m_mergeSegments,
+                              dlg.m_deleteUnconnectedSegm ) )
+    {
+        const TRACKS_CLEANER::STATS& stats = cleaner.GetStats();
+
+        ClearMsgPanel();
+        AppendMsgPanel( _( "Vias" ), wxString::Format( wxT( "%d" ), stats.m_ViasRemoved ),
+                        DARKCYAN );
+        AppendMsgPanel( _( "Null" ), wxString::Format( wxT( "%d" ), stats.m_NullSegmentsRemoved ),
+                        DARKCYAN );
+        AppendMsgPanel( _( "Duplicated" ),
+                        wxString::Format( wxT( "%d" ), stats.m_DuplicatesRemoved ), DARKCYAN );
+        AppendMsgPanel( _( "Merged" ), wxString::Format( wxT( "%d" ), stats.m_SegmentsMerged ),
+                        DARKCYAN );
+        AppendMsgPanel( _( "Dangling" ), wxString::Format( wxT( "%d" ), stats.m_DanglingRemoved ),
+                        DARKCYAN );
+    }
+
     m_canvas->Refresh( true );
 }
 
@@ -174,13 +125,78 @@ bool TRACKS_CLEANER::CleanupBoard( PCB_EDIT_FRAME *aFrame,
     return modified;
 }
 
+
+TRACKS_CLEANER::SEGMENT_KEY::SEGMENT_KEY( const TRACK* aTrack )
+{
+    m_Type    = aTrack->Type();
+    m_Layer   = aTrack->GetLayer();
+    m_NetCode = aTrack->GetNetCode();
+    m_Width   = aTrack->GetWidth();
+
+    const wxPoint& start = aTrack->GetStart();
+    const wxPoint& end   = aTrack->GetEnd();
+
+    if( start.x < end.x || ( start.x == end.x && start.y <= end.y ) )
+    {
+        m_A = start;
+        m_B = end;
+    }
+    else
+    {
+        m_A = end;
+        m_B = start;
+    }
+}
+
+
+std::size_t TRACKS_CLEANER::KEY_HASH::operator()( const wxPoint& aPos ) const
+{
+    std::size_t seed = 0;
+
+    boost::hash_combine( seed, aPos.x );
+    boost::hash_combine( seed, aPos.y );
+
+    return seed;
+}
+
+
+std::size_t TRACKS_CLEANER::KEY_HASH::operator()( const ENDPOINT_KEY& aKey ) const
+{
+    std::size_t seed = (*this)( aKey.m_Pos );
+
+    boost::hash_combine( seed, aKey.m_NetCode );
+
+    return seed;
+}
+
+
+std::size_t TRACKS_CLEANER::KEY_HASH::operator()( const SEGMENT_KEY& aKey ) const
+{
+    std::size_t seed = (*this)( aKey.m_A );
+
+    boost::hash_combine( seed, aKey.m_B.x );
+    boost::hash_combine( seed, aKey.m_B.y );
+    boost::hash_combine( seed, aKey.m_NetCode );
+    boost::hash_combine( seed, aKey.m_Width );
+    boost::hash_combine( seed, (int) aKey.m_Layer );
+
+    return seed;
+}
+
+
 TRACKS_CLEANER::TRACKS_CLEANER( BOARD * aPcb ): CONNECTIONS( aPcb )
 {
     m_Brd = aPcb;
 
+    const STATS noStats = { 0, 0, 0, 0, 0 };
+    m_stats = noStats;
+
     // Build connections info
     BuildPadsList();
     buildTrackConnectionInfo();
+
+    for( TRACK* track = m_Brd->m_Track; track != NULL; track = track->Next() )
+        indexTrack( track );
 }
 
 void TRACKS_CLEANER::buildTrackConnectionInfo()
@@ -220,37 +236,80 @@ void TRACKS_CLEANER::buildTrackConnectionInfo()
     }
 }
 
-bool TRACKS_CLEANER::remove_duplicates_of_via( const VIA *aVia )
+
+void TRACKS_CLEANER::indexTrack( TRACK* aTrack )
 {
-    bool modified = false;
+    m_endpoints[ENDPOINT_KEY( aTrack->GetNetCode(), aTrack->GetStart() )].push_back( aTrack );
 
-    // Search and delete others vias at same location
-    VIA* next_via;
-    for( VIA* alt_via = GetFirstVia( aVia->Next() ); alt_via != NULL;
-            alt_via = next_via )
+    // Vias and null segments have the same start and end
+    if( aTrack->GetEnd() != aTrack->GetStart() && aTrack->Type() != PCB_VIA_T )
+        m_endpoints[ENDPOINT_KEY( aTrack->GetNetCode(), aTrack->GetEnd() )].push_back( aTrack );
+}
+
+
+void TRACKS_CLEANER::unindexTrack( TRACK* aTrack )
+{
+    for( ENDPOINT_T endpoint = ENDPOINT_START; endpoint <= ENDPOINT_END;
+            endpoint = ENDPOINT_T( endpoint + 1 ) )
     {
-        next_via = GetFirstVia( alt_via->Next() );
+        ENDPOINT_MAP::iterator it =
+            m_endpoints.find( ENDPOINT_KEY( aTrack->GetNetCode(), aTrack->GetEndPoint( endpoint ) ) );
 
-        if( (alt_via->GetViaType() == VIA_THROUGH) &&
-                (alt_via->GetStart() == aVia->GetStart()) )
-        {
-            // delete via
-            m_Brd->GetRatsnest()->Remove( alt_via );
-            alt_via->ViewRelease();
-            alt_via->DeleteStructure();
-            modified = true;
-        }
+        if( it == m_endpoints.end() )
+            continue;
+
+        TRACK_LIST& items = it->second;
+        items.erase( std::remove( items.begin(), items.end(), aTrack ), items.end() );
+
+        if( items.empty() )
+            m_endpoints.erase( it );
+    }
+}
+
+
+void TRACKS_CLEANER::removeTrack( TRACK* aTrack )
+{
+    unindexTrack( aTrack );
+
+    m_Brd->GetRatsnest()->Remove( aTrack );
+    aTrack->ViewRelease();
+    aTrack->DeleteStructure();
+}
+
+
+void TRACKS_CLEANER::getConnectedItems( const TRACK* aTrack, const wxPoint& aPos,
+                                        const TRACK* aExclude, TRACK_LIST& aList ) const
+{
+    aList.clear();
+
+    ENDPOINT_MAP::const_iterator it = m_endpoints.find( ENDPOINT_KEY( aTrack->GetNetCode(), aPos ) );
+
+    if( it == m_endpoints.end() )
+        return;
+
+    LSET refLayers = aTrack->GetLayerSet();
+    const TRACK_LIST& items = it->second;
+
+    for( unsigned ii = 0; ii < items.size(); ii++ )
+    {
+        TRACK* item = items[ii];
+
+        if( item != aTrack && item != aExclude && ( refLayers & item->GetLayerSet() ).any() )
+            aList.push_back( item );
     }
-    return modified;
 }
 
+
 bool TRACKS_CLEANER::clean_vias()
 {
     bool modified = false;
+    boost::unordered_set<wxPoint, KEY_HASH> throughVias;
+    VIA* next_via;
 
-    for( VIA* via = GetFirstVia( m_Brd->m_Track ); via != NULL;
-            via = GetFirstVia( via->Next() ) )
+    for( VIA* via = GetFirstVia( m_Brd->m_Track ); via != NULL; via = next_via )
     {
+        next_via = GetFirstVia( via->Next() );
+
         // Correct via m_End defects (if any), should never happen
         if( via->GetStart() != via->GetEnd() )
         {
@@ -261,27 +320,33 @@ bool TRACKS_CLEANER::clean_vias()
         /* Important: these cleanups only do thru hole vias, they don't
          * (yet) handle high density interconnects */
         if( via->GetViaType() != VIA_THROUGH )
+            continue;
+
+        // Delete the through vias at the same location as a previous one
+        if( !throughVias.insert( via->GetStart() ).second )
         {
-            modified |= remove_duplicates_of_via( via );
+            removeTrack( via );
+            m_stats.m_ViasRemoved++;
+            modified = true;
+            continue;
+        }
+
+        /* To delete through Via on THT pads at same location
+         * Examine the list of connected pads:
+         * if one through pad is found, the via can be removed */
+        for( unsigned ii = 0; ii < via->m_PadsConnected.size(); ++ii )
+        {
+            const D_PAD *pad = via->m_PadsConnected[ii];
+
+            const LSET all_cu = LSET::AllCuMask();
 
-            /* To delete through Via on THT pads at same location
-             * Examine the list of connected pads:
-             * if one through pad is found, the via can be removed */
-            for( unsigned ii = 0; ii < via->m_PadsConnected.size(); ++ii )
+            if( (pad->GetLayerSet() & all_cu) == all_cu )
             {
-                const D_PAD *pad = via->m_PadsConnected[ii];
-
-                const LSET all_cu = LSET::AllCuMask();
-
-                if( (pad->GetLayerSet() & all_cu) == all_cu )
-                {
-                    // redundant: delete the via
-                    m_Brd->GetRatsnest()->Remove( via );
-                    via->ViewRelease();
-                    via->DeleteStructure();
-                    modified = true;
-                    break;
-                }
+                // redundant: delete the via
+                removeTrack( via );
+                m_stats.m_ViasRemoved++;
+                modified = true;
+                break;
             }
         }
     }
@@ -314,8 +379,11 @@ const ZONE_CONTAINER* TRACKS_CLEANER::zoneForTrackEndpoint( const TRACK *aTrack,
 bool TRACKS_CLEANER::testTrackEndpointDangling( TRACK *aTrack, ENDPOINT_T aEndPoint )
 {
     bool flag_erase = false;
+    TRACK_LIST connected;
+
+    getConnectedItems( aTrack, aTrack->GetEndPoint( aEndPoint ), NULL, connected );
 
-    TRACK* other = aTrack->GetTrack( m_Brd->m_Track, NULL, aEndPoint, true, false );
+    TRACK* other = connected.empty() ? NULL : connected[0];
 
     if( (other == NULL) && (zoneForTrackEndpoint( aTrack, aEndPoint ) == NULL) )
         flag_erase = true; // Start endpoint is neither on pad, zone or other track
@@ -335,16 +403,12 @@ bool TRACKS_CLEANER::testTrackEndpointDangling( TRACK *aTrack, ENDPOINT_T aEndPo
         if( via )
         {
             // search for another segment following the via
-            aTrack->SetState( BUSY, true );
-
-            other = via->GetTrack( m_Brd->m_Track, NULL, aEndPoint, true, false );
+            getConnectedItems( via, via->GetStart(), aTrack, connected );
 
             // There is a via on the start but it goes nowhere
-            if( (other == NULL) &&
+            if( connected.empty() &&
                     (zoneForTrackEndpoint( via, aEndPoint ) == NULL) )
                 flag_erase = true;
-
-            aTrack->SetState( BUSY, false );
         }
     }
 
@@ -362,46 +426,78 @@ bool TRACKS_CLEANER::deleteUnconnectedTracks()
         return false;
 
     bool modified = false;
-    bool item_erased;
-    do // Iterate when at least one track is deleted
+
+    // All tracks are tested once, then only the ones connected to a deleted track,
+    // because they perhaps are not connected any more and should be deleted
+    std::deque<TRACK*> candidates;
+    boost::unordered_set<TRACK*> queued;
+
+    for( TRACK* track = m_Brd->m_Track; track != NULL; track = track->Next() )
     {
-        item_erased = false;
-        TRACK* next_track;
-        for( TRACK *track = m_Brd->m_Track; track != NULL; track = next_track )
-        {
-            next_track = track->Next();
+        candidates.push_back( track );
+        queued.insert( track );
+    }
+
+    TRACK_LIST neighbours;
+    TRACK_LIST connected;
+
+    while( !candidates.empty() )
+    {
+        TRACK* track = candidates.front();
+        candidates.pop_front();
+        queued.erase( track );
+
+        bool flag_erase = false; // Start without a good reason to erase it
+
+        /* if a track endpoint is not connected to a pad, test if
+         * the endpoint is connected to another track or to a zone.
+         * For via test, an enhancement could be to test if
+         * connected to 2 items on different layers. Currently
+         * a via must be connected to 2 items, that can be on the
+         * same layer */
 
-            bool flag_erase = false; // Start without a good reason to erase it
+        // Check if there is nothing attached on the start
+        if( !(track->GetState( START_ON_PAD )) )
+            flag_erase |= testTrackEndpointDangling( track, ENDPOINT_START );
 
-            /* if a track endpoint is not connected to a pad, test if
-             * the endpoint is connected to another track or to a zone.
-             * For via test, an enhancement could be to test if
-             * connected to 2 items on different layers. Currently
-             * a via must be connected to 2 items, that can be on the
-             * same layer */
+        // Check if there is nothing attached on the end
+        if( !(track->GetState( END_ON_PAD )) )
+            flag_erase |= testTrackEndpointDangling( track, ENDPOINT_END );
 
-            // Check if there is nothing attached on the start
-            if( !(track->GetState( START_ON_PAD )) )
-                flag_erase |= testTrackEndpointDangling( track, ENDPOINT_START );
+        if( !flag_erase )
+            continue;
 
-            // Check if there is nothing attached on the end
-            if( !(track->GetState( END_ON_PAD )) )
-                flag_erase |= testTrackEndpointDangling( track, ENDPOINT_END );
+        // Collect the items connected to the track, directly or through a via
+        neighbours.clear();
 
-            if( flag_erase )
+        for( ENDPOINT_T endpoint = ENDPOINT_START; endpoint <= ENDPOINT_END;
+                endpoint = ENDPOINT_T( endpoint + 1 ) )
+        {
+            getConnectedItems( track, track->GetEndPoint( endpoint ), NULL, connected );
+            neighbours.insert( neighbours.end(), connected.begin(), connected.end() );
+
+            for( unsigned ii = 0; ii < connected.size(); ii++ )
             {
-                // remove segment from board
-                m_Brd->GetRatsnest()->Remove( track );
-                track->ViewRelease();
-                track->DeleteStructure();
-
-                /* keep iterating, because a track connected to the deleted track
-                 * now perhaps is not connected and should be deleted */
-                item_erased = true;
-                modified = true;
+                if( connected[ii]->Type() != PCB_VIA_T )
+                    continue;
+
+                TRACK_LIST viaItems;
+                getConnectedItems( connected[ii], connected[ii]->GetStart(), track, viaItems );
+                neighbours.insert( neighbours.end(), viaItems.begin(), viaItems.end() );
             }
         }
-    } while( item_erased );
+
+        // remove segment from board
+        removeTrack( track );
+        m_stats.m_DanglingRemoved++;
+        modified = true;
+
+        for( unsigned ii = 0; ii < neighbours.size(); ii++ )
+        {
+            if( queued.insert( neighbours[ii] ).second )
+                candidates.push_back( neighbours[ii] );
+        }
+    }
 
     return modified;
 }
@@ -419,43 +515,35 @@ bool TRACKS_CLEANER::delete_null_segments()
 
         if( segment->IsNull() )     // Length segment = 0; delete it
         {
-            m_Brd->GetRatsnest()->Remove( segment );
-            segment->ViewRelease();
-            segment->DeleteStructure();
+            removeTrack( segment );
+            m_stats.m_NullSegmentsRemoved++;
             modified = true;
         }
     }
     return modified;
 }
 
-bool TRACKS_CLEANER::remove_duplicates_of_track( const TRACK *aTrack )
+bool TRACKS_CLEANER::remove_duplicated_segments()
 {
     bool modified = false;
+    boost::unordered_set<SEGMENT_KEY, KEY_HASH> segments;
 
     TRACK *nextsegment;
-    for( TRACK *other = aTrack->Next(); other; other = nextsegment )
+    for( TRACK *segment = m_Brd->m_Track; segment; segment = nextsegment )
     {
-        nextsegment = other->Next();
+        nextsegment = segment->Next();
 
-        // New netcode, break out (can't be there any other)
-        if( aTrack->GetNetCode() != other->GetNetCode() )
-            break;
+        // Vias are handled by clean_vias()
+        if( segment->Type() == PCB_VIA_T )
+            continue;
 
-        // Must be of the same type, on the same layer and the endpoints
+        // Must be of the same type, net, width, on the same layer and the endpoints
         // must be the same (maybe swapped)
-        if( (aTrack->Type() != other->Type()) &&
-            (aTrack->GetLayer() != other->GetLayer()) )
+        if( !segments.insert( SEGMENT_KEY( segment ) ).second )
         {
-            if( ((aTrack->GetStart() == other->GetStart()) &&
-                 (aTrack->GetEnd() == other->GetEnd())) ||
-                ((aTrack->GetStart() == other->GetEnd()) &&
-                 (aTrack->GetEnd() == other->GetStart())))
-            {
-                m_Brd->GetRatsnest()->Remove( other );
-                other->ViewRelease();
-                other->DeleteStructure();
-                modified = true;
-            }
+            removeTrack( segment );
+            m_stats.m_DuplicatesRemoved++;
+            modified = true;
         }
     }
     return modified;
@@ -464,47 +552,36 @@ bool TRACKS_CLEANER::remove_duplicates_of_track( const TRACK *aTrack )
 bool TRACKS_CLEANER::merge_collinear_of_track( TRACK *aSegment )
 {
     bool merged_this = false;
+    TRACK_LIST connected;
 
     // *WHY* doesn't C++ have prec and succ (or ++ --) like PASCAL?
     for( ENDPOINT_T endpoint = ENDPOINT_START; endpoint <= ENDPOINT_END;
             endpoint = ENDPOINT_T( endpoint + 1 ) )
     {
         // search for a possible segment connected to the current endpoint of the current one
-        TRACK *other = aSegment->Next();
-        if( other )
-        {
-            other = aSegment->GetTrack( other, NULL, endpoint, true, false );
+        getConnectedItems( aSegment, aSegment->GetEndPoint( endpoint ), NULL, connected );
 
-            if( other )
-            {
-                // the two segments must have the same width and the other
-                // cannot be a via
-                if( (aSegment->GetWidth() == other->GetWidth()) &&
-                        (other->Type() == PCB_TRACE_T) )
-                {
-                    // There can be only one segment connected
-                    other->SetState( BUSY, true );
-                    TRACK *yet_another = aSegment->GetTrack( m_Brd->m_Track, NULL,
-                            endpoint, true, false );
-                    other->SetState( BUSY, false );
-
-                    if( !yet_another )
-                    {
-                        // Try to merge them
-                        TRACK *segDelete = mergeCollinearSegmentIfPossible( aSegment,
-                                other, endpoint );
-
-                        // Merge succesful, the other one has to go away
-                        if( segDelete )
-                        {
-                            m_Brd->GetRatsnest()->Remove( segDelete );
-                            segDelete->ViewRelease();
-                            segDelete->DeleteStructure();
-                            merged_this = true;
-                        }
-                    }
-                }
-            }
+        // There can be only one segment connected, it must have the same width
+        // and cannot be a via
+        if( connected.size() != 1 )
+            continue;
+
+        TRACK* other = connected[0];
+
+        if( (aSegment->GetWidth() != other->GetWidth()) || (other->Type() != PCB_TRACE_T) )
+            continue;
+
+        // Try to merge them (the ends of aSegment can be moved)
+        unindexTrack( aSegment );
+        TRACK *segDelete = mergeCollinearSegmentIfPossible( aSegment, other, endpoint );
+        indexTrack( aSegment );
+
+        // Merge succesful, the other one has to go away
+        if( segDelete )
+        {
+            removeTrack( segDelete );
+            m_stats.m_SegmentsMerged++;
+            merged_this = true;
         }
     }
 
@@ -520,8 +597,7 @@ bool TRACKS_CLEANER::clean_segments()
     modified |= delete_null_segments();
 
     // Delete redundant segments, i.e. segments having the same end points and layers
-    for( TRACK *segment = m_Brd->m_Track; segment; segment = segment->Next() )
-        modified |= remove_duplicates_of_track( segment );
+    modified |= remove_duplicated_segments();
 
     // merge collinear segments:
     TRACK *nextsegment;
@@ -0,0 +1,249 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2015 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file connected_items_rtree.h
+ * @brief R-tree of pads or tracks, used by the BOARD hit test functions.
+ */
+
+#ifndef CONNECTED_ITEMS_RTREE_H
+#define CONNECTED_ITEMS_RTREE_H
+
+#include <algorithm>
+#include <boost/unordered_map.hpp>
+
+#include <geometry/rtree.h>
+#include <class_track.h>
+#include <class_pad.h>
+
+/**
+ * Struct CONNECTED_ITEM_REF
+ * is an entry of CONNECTED_ITEMS_RTREE.  Besides the item, it stores a key giving the
+ * position of the item in the board lists, so a query can return the same item a linear
+ * search would have found first.
+ */
+struct CONNECTED_ITEM_REF
+{
+    BOARD_CONNECTED_ITEM*   item;
+    double                  order;
+
+    bool operator==( const CONNECTED_ITEM_REF& aOther ) const
+    {
+        return item == aOther.item;
+    }
+};
+
+
+typedef RTree<CONNECTED_ITEM_REF, int, 2, float> CONNECTED_ITEMS_RTREE_BASE;
+
+/**
+ * Class CONNECTED_ITEMS_RTREE
+ * implements an R-tree of pads or tracks.  Items are stored with the area in which
+ * their HitTest( const wxPoint& ) may succeed, so a point query returns all the candidates
+ * for a hit test.  Non-owning.
+ *
+ * Indexed items know their tree: their geometry setters update their area with Update(),
+ * and their destructor removes them.
+ *
+ * The order keys of the items are spaced by OrderStep() when the tree is built, so items
+ * inserted later between two others get a key in between.
+ */
+class CONNECTED_ITEMS_RTREE : public CONNECTED_ITEMS_RTREE_BASE
+{
+public:
+    /// Spacing of the order keys of consecutive items
+    static double OrderStep() { return 1024.0; }
+
+    CONNECTED_ITEMS_RTREE() :
+        m_firstOrder( 0.0 ), m_lastOrder( 0.0 )
+    {
+    }
+
+    ~CONNECTED_ITEMS_RTREE()
+    {
+        RemoveAll();
+    }
+
+    /**
+     * Function Insert()
+     * inserts a pad or a track into the tree.
+     * @param aOrder is the key of the item position in the board lists.
+     */
+    void Insert( BOARD_CONNECTED_ITEM* aItem, double aOrder )
+    {
+        Remove( aItem );
+
+        ENTRY&              entry = m_entries[aItem];
+        CONNECTED_ITEM_REF  ref = { aItem, aOrder };
+
+        if( m_entries.size() == 1 )
+        {
+            m_firstOrder = aOrder;
+            m_lastOrder = aOrder;
+        }
+        else
+        {
+            m_firstOrder = std::min( m_firstOrder, aOrder );
+            m_lastOrder = std::max( m_lastOrder, aOrder );
+        }
+
+        entry.order = aOrder;
+        getArea( aItem, entry.min, entry.max );
+        CONNECTED_ITEMS_RTREE_BASE::Insert( entry.min, entry.max, ref );
+        aItem->m_spatialIndex = this;
+    }
+
+    /**
+     * Function Remove()
+     * removes an item from the tree, if it is there.
+     */
+    void Remove( BOARD_CONNECTED_ITEM* aItem )
+    {
+        ENTRIES::iterator it = m_entries.find( aItem );
+
+        if( it == m_entries.end() )
+            return;
+
+        CONNECTED_ITEM_REF ref = { aItem, it->second.order };
+
+        CONNECTED_ITEMS_RTREE_BASE::Remove( it->second.min, it->second.max, ref );
+        m_entries.erase( it );
+        aItem->m_spatialIndex = NULL;
+    }
+
+    /**
+     * Function Update()
+     * moves an item of the tree to its current area, after a change of its geometry.
+     */
+    void Update( BOARD_CONNECTED_ITEM* aItem )
+    {
+        ENTRIES::iterator it = m_entries.find( aItem );
+
+        if( it == m_entries.end() )
+            return;
+
+        ENTRY&              entry = it->second;
+        CONNECTED_ITEM_REF  ref = { aItem, entry.order };
+
+        CONNECTED_ITEMS_RTREE_BASE::Remove( entry.min, entry.max, ref );
+        getArea( aItem, entry.min, entry.max );
+        CONNECTED_ITEMS_RTREE_BASE::Insert( entry.min, entry.max, ref );
+    }
+
+    /**
+     * Function RemoveAll()
+     * empties the tree.  The items are told they are no longer indexed.
+     */
+    void RemoveAll()
+    {
+        for( ENTRIES::iterator it = m_entries.begin(); it != m_entries.end(); ++it )
+            it->first->m_spatialIndex = NULL;
+
+        m_entries.clear();
+        CONNECTED_ITEMS_RTREE_BASE::RemoveAll();
+    }
+
+    /**
+     * Function GetOrder()
+     * gets the order key of \a aItem.
+     * @return false if \a aItem is not in the tree.
+     */
+    bool GetOrder( const BOARD_CONNECTED_ITEM* aItem, double* aOrder ) const
+    {
+        ENTRIES::const_iterator it = m_entries.find( const_cast<BOARD_CONNECTED_ITEM*>( aItem ) );
+
+        if( it == m_entries.end() )
+            return false;
+
+        *aOrder = it->second.order;
+        return true;
+    }
+
+    /// @return a key not greater than the order keys in the tree, 0 if the tree is empty
+    double GetFirstOrder() const { return m_entries.empty() ? 0.0 : m_firstOrder; }
+
+    /// @return a key not smaller than the order keys in the tree, 0 if the tree is empty
+    double GetLastOrder() const { return m_entries.empty() ? 0.0 : m_lastOrder; }
+
+    /**
+     * Function Query()
+     * executes a function object aVisitor for each item whose area contains aPosition.
+     */
+    template <class Visitor>
+    void Query( const wxPoint& aPosition, Visitor& aVisitor )
+    {
+        const int point[2] = { aPosition.x, aPosition.y };
+
+        CONNECTED_ITEMS_RTREE_BASE::Search( point, point, aVisitor );
+    }
+
+private:
+    /// Area and order key an item has been inserted with, needed to remove it
+    struct ENTRY
+    {
+        int     min[2];
+        int     max[2];
+        double  order;
+    };
+
+    typedef boost::unordered_map<BOARD_CONNECTED_ITEM*, ENTRY> ENTRIES;
+
+    /**
+     * Function getArea()
+     * computes the area in which the hit test of a pad or a track may succeed.
+     */
+    static void getArea( BOARD_CONNECTED_ITEM* aItem, int aMin[2], int aMax[2] )
+    {
+        if( aItem->Type() == PCB_PAD_T )
+        {
+            // The same area as the bounding circle test in D_PAD::HitTest()
+            D_PAD*  pad = static_cast<D_PAD*>( aItem );
+            wxPoint center = pad->ShapePos();
+            int     radius = pad->GetBoundingRadius() + 1;
+
+            aMin[0] = center.x - radius;
+            aMin[1] = center.y - radius;
+            aMax[0] = center.x + radius;
+            aMax[1] = center.y + radius;
+        }
+        else
+        {
+            // Ends of segments are round, vias are tested against their diameter
+            TRACK*          track  = static_cast<TRACK*>( aItem );
+            const wxPoint&  start  = track->GetStart();
+            const wxPoint&  end    = track->GetEnd();
+            int             radius = track->GetWidth() / 2 + 1;
+
+            aMin[0] = std::min( start.x, end.x ) - radius;
+            aMin[1] = std::min( start.y, end.y ) - radius;
+            aMax[0] = std::max( start.x, end.x ) + radius;
+            aMax[1] = std::max( start.y, end.y ) + radius;
+        }
+    }
+
+    ENTRIES     m_entries;
+    double      m_firstOrder;   ///< smallest order key inserted since the tree was empty
+    double      m_lastOrder;    ///< largest order key inserted since the tree was empty
+};
+
+#endif /* CONNECTED_ITEMS_RTREE_H */
@@ -28,6 +28,9 @@
  * @file drc.cpp
  */
 
+#include <algorithm>
+#include <climits>
+
 #include <fctsys.h>
 #include <wxPcbStruct.h>
 #include <trigo.h>
@@ -436,36 +439,127 @@ bool DRC::testNetClasses()
 }
 
 
+/**
+ * Struct PAD_SWEEP_ITEM
+ * is a pad seen by the broad phase of the pad to pad DRC: its bounding box enlarged by
+ * its clearance, and the copper layers where it can collide with other pads.
+ */
+struct PAD_SWEEP_ITEM
+{
+    D_PAD*  m_Pad;
+    int     m_XMin, m_XMax;
+    int     m_YMin, m_YMax;
+    LSET    m_Layers;
+};
+
+
+static bool sortByXMin( const PAD_SWEEP_ITEM& aItemA, const PAD_SWEEP_ITEM& aItemB )
+{
+    return aItemA.m_XMin < aItemB.m_XMin;
+}
+
+
 void DRC::testPad2Pad()
 {
-    std::vector<D_PAD*> sortedPads;
+    std::vector<D_PAD*> pads;
 
-    m_pcb->GetSortedPadListByXthenYCoord( sortedPads );
+    m_pcb->GetSortedPadListByXthenYCoord( pads );
 
-    // find the max size of the pads (used to stop the test)
-    int max_size = 0;
+    /* Build the broad phase items. Each pad uses its own size and clearance, so a
+     * big pad does not widen the search window of the other pads.
+     * A pad having a hole can collide with pads on any copper layer (the hole is on
+     * all layers), other pads only with pads sharing one of their copper layers.
+     * Pads without copper layer are put on all layers, holes near them are tested.
+     */
+    const LSET boardCu = LSET::AllCuMask() & m_pcb->GetEnabledLayers();
+    std::vector<PAD_SWEEP_ITEM> items( pads.size() );
 
-    for( unsigned i = 0; i < sortedPads.size(); ++i )
+    for( unsigned i = 0; i < pads.size(); ++i )
     {
-        D_PAD* pad = sortedPads[i];
+        D_PAD* pad = pads[i];
+        PAD_SWEEP_ITEM& item = items[i];
+
+        // GetBoundingRadius() is the radius of the minimum sized circle fully containing
+        // the pad, around its shape position
+        int extent = pad->GetBoundingRadius() + KiROUND( EuclideanNorm( pad->GetOffset() ) );
+        extent = std::max( extent, std::max( pad->GetDrillSize().x, pad->GetDrillSize().y ) / 2 );
+        extent += pad->GetClearance();
 
-        // GetBoundingRadius() is the radius of the minimum sized circle fully containing the pad
-        int radius = pad->GetBoundingRadius();
-        if( radius > max_size )
-            max_size = radius;
+        item.m_Pad  = pad;
+        item.m_XMin = pad->GetPosition().x - extent;
+        item.m_XMax = pad->GetPosition().x + extent;
+        item.m_YMin = pad->GetPosition().y - extent;
+        item.m_YMax = pad->GetPosition().y + extent;
+        item.m_Layers = pad->GetLayerSet() & boardCu;
+
+        if( pad->GetDrillSize().x || item.m_Layers.none() )
+            item.m_Layers = boardCu;
     }
 
-    // Test the pads
-    D_PAD** listEnd = &sortedPads[ sortedPads.size() ];
+    std::sort( items.begin(), items.end(), sortByXMin );
+
+    /* used to test DRC pad to holes: this dummy pad has the size and shape of the hole
+     * to test pad to pad hole DRC, using the pad to pad DRC test function.
+     * Therefore, this dummy pad is a circle or an oval.
+     * A pad must have a parent because some functions expect a non null parent
+     * to find the parent board, and some other data
+     */
+    MODULE  dummymodule( m_pcb );    // Creates a dummy parent
+    D_PAD   dummypad( &dummymodule );
+
+    // Ensure the hole is on all copper layers
+    dummypad.SetLayerSet( LSET::AllCuMask() | dummypad.GetLayerSet() );
 
-    for( unsigned i = 0; i< sortedPads.size(); ++i )
+    // Use the minimal local clearance value for the dummy pad.
+    // The clearance of the active pad will be used as minimum distance to a hole
+    // (a value = 0 means use netclass value)
+    dummypad.SetLocalClearance( 1 );
+
+    // Sweep along the X axis: each copper layer has a list of the pads whose extent
+    // contains the current X position. A pad on several layers is tested only once
+    // against a given pad, thanks to testedBy.
+    std::vector<unsigned> active[LAYER_ID_COUNT];
+    std::vector<unsigned> testedBy( items.size(), UINT_MAX );
+
+    for( unsigned i = 0; i < items.size(); ++i )
     {
-        D_PAD* pad = sortedPads[i];
+        const PAD_SWEEP_ITEM& item = items[i];
+        bool success = true;
 
-        int    x_limit = max_size + pad->GetClearance() +
-                         pad->GetBoundingRadius() + pad->GetPosition().x;
+        for( LSEQ cu = item.m_Layers.CuStack();  cu;  ++cu )
+        {
+            std::vector<unsigned>& layerItems = active[*cu];
+
+            for( unsigned k = 0; k < layerItems.size(); )
+            {
+                unsigned idx = layerItems[k];
+                const PAD_SWEEP_ITEM& other = items[idx];
+
+                // This pad, and all the following ones, are beyond the other pad
+                if( other.m_XMax < item.m_XMin )
+                {
+                    layerItems[k] = layerItems.back();
+                    layerItems.pop_back();
+                    continue;
+                }
+
+                ++k;
+
+                if( !success || testedBy[idx] == i )
+                    continue;
+
+                testedBy[idx] = i;
+
+                if( other.m_YMax < item.m_YMin || other.m_YMin > item.m_YMax )
+                    continue;
+
+                success = doPadToPadDrc( item.m_Pad, other.m_Pad, &dummypad );
+            }
+
+            layerItems.push_back( i );
+        }
 
-        if( !doPadToPadsDrc( pad, &sortedPads[i], listEnd, x_limit ) )
+        if( !success )
         {
             wxASSERT( m_currentMarker );
             m_pcb->Add( m_currentMarker );
@@ -832,124 +926,94 @@ bool DRC::doTrackKeepoutDrc( TRACK* aRefSeg )
 }
 
 
-bool DRC::doPadToPadsDrc( D_PAD* aRefPad, D_PAD** aStart, D_PAD** aEnd, int x_limit )
+bool DRC::doPadToPadDrc( D_PAD* aRefPad, D_PAD* aPad, D_PAD* aDummyPad )
 {
     const static LSET all_cu = LSET::AllCuMask();
 
     LSET layerMask = aRefPad->GetLayerSet() & all_cu;
 
-    /* used to test DRC pad to holes: this dummy pad has the size and shape of the hole
-     * to test pad to pad hole DRC, using the pad to pad DRC test function.
-     * Therefore, this dummy pad is a circle or an oval.
-     * A pad must have a parent because some functions expect a non null parent
-     * to find the parent board, and some other data
-     */
-    MODULE  dummymodule( m_pcb );    // Creates a dummy parent
-    D_PAD   dummypad( &dummymodule );
-
-    // Ensure the hole is on all copper layers
-    dummypad.SetLayerSet( all_cu | dummypad.GetLayerSet() );
-
-    // Use the minimal local clearance value for the dummy pad.
-    // The clearance of the active pad will be used as minimum distance to a hole
-    // (a value = 0 means use netclass value)
-    dummypad.SetLocalClearance( 1 );
-
-    for( D_PAD** pad_list = aStart;  pad_list<aEnd;  ++pad_list )
+    // No problem if pads are on different copper layers,
+    // but their hole (if any ) can create DRC error because they are on all
+    // copper layers, so we test them
+    if( ( aPad->GetLayerSet() & layerMask ) == 0 )
     {
-        D_PAD* pad = *pad_list;
-
-        if( pad == aRefPad )
-            continue;
+        // if holes are in the same location and have the same size and shape,
+        // this can be accepted
+        if( aPad->GetPosition() == aRefPad->GetPosition()
+            && aPad->GetDrillSize() == aRefPad->GetDrillSize()
+            && aPad->GetDrillShape() == aRefPad->GetDrillShape() )
+        {
+            if( aRefPad->GetDrillShape() == PAD_DRILL_CIRCLE )
+                return true;
 
-        // We can stop the test when pad->GetPosition().x > x_limit
-        // because the list is sorted by X values
-        if( pad->GetPosition().x > x_limit )
-            break;
+            // for oval holes: must also have the same orientation
+            if( aPad->GetOrientation() == aRefPad->GetOrientation() )
+                return true;
+        }
 
-        // No problem if pads are on different copper layers,
-        // but their hole (if any ) can create DRC error because they are on all
-        // copper layers, so we test them
-        if( ( pad->GetLayerSet() & layerMask ) == 0 )
+        /* Here, we must test clearance between holes and pads
+         * dummy pad size and shape is adjusted to pad drill size and shape
+         */
+        if( aPad->GetDrillSize().x )
         {
-            // if holes are in the same location and have the same size and shape,
-            // this can be accepted
-            if( pad->GetPosition() == aRefPad->GetPosition()
-                && pad->GetDrillSize() == aRefPad->GetDrillSize()
-                && pad->GetDrillShape() == aRefPad->GetDrillShape() )
+            // pad under testing has a hole, test this hole against pad reference
+            aDummyPad->SetPosition( aPad->GetPosition() );
+            aDummyPad->SetSize( aPad->GetDrillSize() );
+            aDummyPad->SetShape( aPad->GetDrillShape() == PAD_DRILL_OBLONG ?
+                                 PAD_OVAL : PAD_CIRCLE );
+            aDummyPad->SetOrientation( aPad->GetOrientation() );
+
+            if( !checkClearancePadToPad( aRefPad, aDummyPad ) )
             {
-                if( aRefPad->GetDrillShape() == PAD_DRILL_CIRCLE )
-                    continue;
-
-                // for oval holes: must also have the same orientation
-                if( pad->GetOrientation() == aRefPad->GetOrientation() )
-                    continue;
+                // here we have a drc error on pad!
+                m_currentMarker = fillMarker( aPad, aRefPad,
+                                              DRCE_HOLE_NEAR_PAD, m_currentMarker );
+                return false;
             }
+        }
 
-            /* Here, we must test clearance between holes and pads
-             * dummy pad size and shape is adjusted to pad drill size and shape
-             */
-            if( pad->GetDrillSize().x )
-            {
-                // pad under testing has a hole, test this hole against pad reference
-                dummypad.SetPosition( pad->GetPosition() );
-                dummypad.SetSize( pad->GetDrillSize() );
-                dummypad.SetShape( pad->GetDrillShape() == PAD_DRILL_OBLONG ?
-                                                           PAD_OVAL : PAD_CIRCLE );
-                dummypad.SetOrientation( pad->GetOrientation() );
-
-                if( !checkClearancePadToPad( aRefPad, &dummypad ) )
-                {
-                    // here we have a drc error on pad!
-                    m_currentMarker = fillMarker( pad, aRefPad,
-                                                  DRCE_HOLE_NEAR_PAD, m_currentMarker );
-                    return false;
-                }
-            }
+        if( aRefPad->GetDrillSize().x ) // pad reference has a hole
+        {
+            aDummyPad->SetPosition( aRefPad->GetPosition() );
+            aDummyPad->SetSize( aRefPad->GetDrillSize() );
+            aDummyPad->SetShape( aRefPad->GetDrillShape() == PAD_DRILL_OBLONG ?
+                                 PAD_OVAL : PAD_CIRCLE );
+            aDummyPad->SetOrientation( aRefPad->GetOrientation() );
 
-            if( aRefPad->GetDrillSize().x ) // pad reference has a hole
+            if( !checkClearancePadToPad( aPad, aDummyPad ) )
             {
-                dummypad.SetPosition( aRefPad->GetPosition() );
-                dummypad.SetSize( aRefPad->GetDrillSize() );
-                dummypad.SetShape( aRefPad->GetDrillShape() == PAD_DRILL_OBLONG ?
-                                                               PAD_OVAL : PAD_CIRCLE );
-                dummypad.SetOrientation( aRefPad->GetOrientation() );
-
-                if( !checkClearancePadToPad( pad, &dummypad ) )
-                {
-                    // here we have a drc error on aRefPad!
-                    m_currentMarker = fillMarker( aRefPad, pad,
-                                                  DRCE_HOLE_NEAR_PAD, m_currentMarker );
-                    return false;
-                }
+                // here we have a drc error on aRefPad!
+                m_currentMarker = fillMarker( aRefPad, aPad,
+                                              DRCE_HOLE_NEAR_PAD, m_currentMarker );
+                return false;
             }
-
-            continue;
         }
 
-        // The pad must be in a net (i.e pt_pad->GetNet() != 0 ),
-        // But no problem if pads have the same netcode (same net)
-        if( pad->GetNetCode() && ( aRefPad->GetNetCode() == pad->GetNetCode() ) )
-            continue;
+        return true;
+    }
 
-        // if pads are from the same footprint
-        if( pad->GetParent() == aRefPad->GetParent() )
-        {
-            // and have the same pad number ( equivalent pads  )
+    // The pad must be in a net (i.e pt_pad->GetNet() != 0 ),
+    // But no problem if pads have the same netcode (same net)
+    if( aPad->GetNetCode() && ( aRefPad->GetNetCode() == aPad->GetNetCode() ) )
+        return true;
 
-            // one can argue that this 2nd test is not necessary, that any
-            // two pads from a single module are acceptable.  This 2nd test
-            // should eventually be a configuration option.
-            if( pad->PadNameEqual( aRefPad ) )
-                continue;
-        }
+    // if pads are from the same footprint
+    if( aPad->GetParent() == aRefPad->GetParent() )
+    {
+        // and have the same pad number ( equivalent pads  )
 
-        if( !checkClearancePadToPad( aRefPad, pad ) )
-        {
-            // here we have a drc error!
-            m_currentMarker = fillMarker( aRefPad, pad, DRCE_PAD_NEAR_PAD1, m_currentMarker );
-            return false;
-        }
+        // one can argue that this 2nd test is not necessary, that any
+        // two pads from a single module are acceptable.  This 2nd test
+        // should eventually be a configuration option.
+        if( aPad->PadNameEqual( aRefPad ) )
+            return true;
+    }
+
+    if( !checkClearancePadToPad( aRefPad, aPad ) )
+    {
+        // here we have a drc error!
+        m_currentMarker = fillMarker( aRefPad, aPad, DRCE_PAD_NEAR_PAD1, m_currentMarker );
+        return false;
     }
 
     return true;
@@ -276,6 +276,12 @@ private:
      */
     void testTracks( bool aShowProgressBar );
 
+    /**
+     * Function testPad2Pad
+     * performs the pad to pad DRC. Pads are swept along the X axis with an active list
+     * per copper layer, so each pad is tested only against the pads overlapping its own
+     * bounding box enlarged by the clearances.
+     */
     void testPad2Pad();
 
     void testUnconnected();
@@ -291,15 +297,14 @@ private:
     bool doNetClass( boost::shared_ptr<NETCLASS> aNetClass, wxString& msg );
 
     /**
-     * Function doPadToPadsDrc
-     * tests the clearance between aRefPad and other pads.
-     * The pad list must be sorted by x coordinate.
+     * Function doPadToPadDrc
+     * tests the clearance between aRefPad and aPad, and between their holes and the
+     * other pad, if they are not on the same copper layers.
      * @param aRefPad The pad to test
-     * @param aStart The start of the pad list to test against
-     * @param aEnd Marks the end of the list and is not included
-     * @param x_limit is used to stop the test (when the any pad's X coord exceeds this)
+     * @param aPad The pad to test against
+     * @param aDummyPad A pad on all copper layers, which is given the shape of the holes
      */
-    bool doPadToPadsDrc( D_PAD* aRefPad, D_PAD** aStart, D_PAD** aEnd, int x_limit );
+    bool doPadToPadDrc( D_PAD* aRefPad, D_PAD* aPad, D_PAD* aDummyPad );
 
     /**
      * Function DoTrackDrc
@@ -41,10 +41,12 @@
 #include <pgm_base.h>
 #include <msgpanel.h>
 #include <fp_lib_table.h>
+#include <background_file_writer.h>
 
 #include <pcbnew.h>
 #include <pcbnew_id.h>
 #include <io_mgr.h>
+#include <kicad_plugin.h>
 #include <wildcards_and_files_ext.h>
 
 #include <class_board.h>
@@ -61,6 +63,35 @@ static const wxChar backupSuffix[]   = wxT( "-bak" );
 static const wxChar autosavePrefix[] = wxT( "_autosave-" );
 
 
+/**
+ * Class BOARD_SNAPSHOT
+ * is a copy of a board, saved by the background auto save.  The copy is made and
+ * deleted in the GUI thread, it is formatted in the worker thread.
+ */
+class BOARD_SNAPSHOT : public BACKGROUND_FILE_WRITER::SNAPSHOT
+{
+public:
+    BOARD_SNAPSHOT( const BOARD* aBoard ) :
+        m_board( aBoard->Snapshot() )
+    {
+    }
+
+    ~BOARD_SNAPSHOT()
+    {
+        delete m_board;
+    }
+
+    void Format( OUTPUTFORMATTER* aFormatter )
+    {
+        m_io.FormatBoardFile( m_board, aFormatter );
+    }
+
+private:
+    BOARD*  m_board;
+    PCB_IO  m_io;       ///< created in the GUI thread, with its parser
+};
+
+
 /**
  * Function AskLoadBoardFileName
  * puts up a wxFileDialog asking for a BOARD filename to open.
@@ -728,7 +759,12 @@ bool PCB_EDIT_FRAME::SavePcbFile( const wxString& aFileName, bool aCreateBackupF
     if( aCreateBackupFile )
         UpdateFileHistory( GetBoard()->GetFileName() );
 
-    // Delete auto save file on successful save.
+    // Delete auto save file on successful save, once a background auto save is done.
+    wxString autoSaveError = m_autoSaveWriter->Wait();
+
+    if( !autoSaveError.IsEmpty() )
+        DisplayError( this, autoSaveError );
+
     wxFileName autoSaveFileName = pcbFileName;
 
     autoSaveFileName.SetName( wxString( autosavePrefix ) + pcbFileName.GetName() );
@@ -803,8 +839,18 @@ bool PCB_EDIT_FRAME::SavePcbCopy( const wxString& aFileName )
 
 bool PCB_EDIT_FRAME::doAutoSave()
 {
-    wxFileName tmpFileName = Prj().AbsolutePath( GetBoard()->GetFileName() );
-    wxFileName fn = tmpFileName;
+    // The previous auto save is still being written, try again later
+    if( m_autoSaveWriter->IsBusy() )
+        return false;
+
+    // Release the previous writer thread, its error is normally already reported by
+    // OnAutoSaveWritten()
+    wxString error = m_autoSaveWriter->Wait();
+
+    if( !error.IsEmpty() )
+        DisplayError( this, error );
+
+    wxFileName fn = Prj().AbsolutePath( GetBoard()->GetFileName() );
 
     // Auto save file name is the normal file name prepended with
     // autosaveFilePrefix string.
@@ -813,16 +859,41 @@ bool PCB_EDIT_FRAME::doAutoSave()
     wxLogTrace( traceAutoSave,
                 wxT( "Creating auto save file <" + fn.GetFullPath() ) + wxT( ">" ) );
 
-    if( SavePcbFile( fn.GetFullPath(), NO_BACKUP_FILE ) )
-    {
-        GetScreen()->SetModify();
-        GetBoard()->SetFileName( tmpFileName.GetFullPath() );
-        UpdateTitle();
-        m_autoSaveState = false;
-        return true;
-    }
+    if( !IsWritable( fn ) )
+        return false;
+
+    GetBoard()->SynchronizeNetsAndNetClasses();
+
+    // Select default Netclass before writing file.
+    // Useful to save default values in headers
+    SetCurrentNetClass( NETCLASS::Default );
+
+    // Only a copy of the board is made here, in the GUI thread.  The copy is formatted
+    // and written in a worker thread while the board is edited.
+    if( !m_autoSaveWriter->Start( new BOARD_SNAPSHOT( GetBoard() ), fn.GetFullPath() ) )
+        return false;
+
+    // The board is still modified, only the auto save is up to date.  This is undone by
+    // OnAutoSaveWritten() if the write fails.
+    GetScreen()->ClrSave();
+    m_autoSaveState = false;
+    return true;
+}
 
-    GetBoard()->SetFileName( tmpFileName.GetFullPath() );
 
-    return false;
+void PCB_EDIT_FRAME::OnAutoSaveWritten( wxThreadEvent& aEvent )
+{
+    // A new auto save was started before this event was processed, its own event
+    // will report it
+    if( m_autoSaveWriter->IsBusy() )
+        return;
+
+    wxString error = m_autoSaveWriter->Wait();
+
+    if( !error.IsEmpty() )
+    {
+        // The auto save file is not up to date, so the next auto save must write it
+        GetScreen()->SetSave();
+        DisplayError( this, error );
+    }
 }
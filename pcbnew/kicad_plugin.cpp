@@ -62,6 +62,29 @@ using namespace PCB_KEYS_T;
  */
 static const wxString traceFootprintLibrary( wxT( "KicadFootprintLib" ) );
 
+
+/**
+ * Class QUOTED_LAYER_NAMES_CLEANER
+ * clears the quoted layer names cache of PCB_IO when it goes out of scope, so the
+ * names of a board are not used by the next save if formatting throws.
+ */
+class QUOTED_LAYER_NAMES_CLEANER
+{
+public:
+    QUOTED_LAYER_NAMES_CLEANER( std::vector<std::string>& aNames ) :
+        m_names( aNames )
+    {
+    }
+
+    ~QUOTED_LAYER_NAMES_CLEANER()
+    {
+        m_names.clear();
+    }
+
+private:
+    std::vector<std::string>& m_names;
+};
+
 ///> Removes empty nets (i.e. with node count equal zero) from net classes
 void filterNetClass( const BOARD& aBoard, NETCLASS& aNetClass )
 {
@@ -395,6 +418,15 @@ bool FP_CACHE::IsModified( const wxString& aLibPath, const wxString& aFootprintN
 
 
 void PCB_IO::Save( const wxString& aFileName, BOARD* aBoard, const PROPERTIES* aProperties )
+{
+    FILE_OUTPUTFORMATTER    formatter( aFileName );
+
+    FormatBoardFile( aBoard, &formatter, aProperties );
+}
+
+
+void PCB_IO::FormatBoardFile( BOARD* aBoard, OUTPUTFORMATTER* aFormatter,
+                              const PROPERTIES* aProperties )
 {
     LOCALE_IO   toggle;     // toggles on, then off, the C locale.
 
@@ -405,12 +437,10 @@ void PCB_IO::Save( const wxString& aFileName, BOARD* aBoard, const PROPERTIES* a
     // Prepare net mapping that assures that net codes saved in a file are consecutive integers
     m_mapping->SetBoard( aBoard );
 
-    FILE_OUTPUTFORMATTER    formatter( aFileName );
-
-    m_out = &formatter;     // no ownership
+    m_out = aFormatter;     // no ownership
 
     m_out->Print( 0, "(kicad_pcb (version %d) (host pcbnew %s)\n", SEXPR_BOARD_FILE_VERSION,
-                  formatter.Quotew( GetBuildVersion() ).c_str() );
+                  m_out->Quotew( GetBuildVersion() ).c_str() );
 
     Format( aBoard, 1 );
 
@@ -488,6 +518,21 @@ void PCB_IO::Format( BOARD_ITEM* aItem, int aNestLevel ) const
 }
 
 
+const char* PCB_IO::quotedLayerName( const BOARD* aBoard, LAYER_ID aLayer,
+                                     std::string& aStorage ) const
+{
+    if( !m_quotedLayerNames.empty() )
+        return m_quotedLayerNames[aLayer].c_str();
+
+    if( aBoard )
+        aStorage = m_out->Quotew( aBoard->GetLayerName( aLayer ) );
+    else
+        aStorage = m_out->Quotew( BOARD::GetStandardLayerName( aLayer ) );
+
+    return aStorage.c_str();
+}
+
+
 void PCB_IO::formatLayer( const BOARD_ITEM* aItem ) const
 {
     if( m_ctl & CTL_STD_LAYER_NAMES )
@@ -744,9 +789,19 @@ void PCB_IO::format( BOARD* aBoard, int aNestLevel ) const
 
     // Do not save MARKER_PCBs, they can be regenerated easily.
 
-    // Save the tracks and vias.
-    for( TRACK* track = aBoard->m_Track;  track; track = track->Next() )
-        Format( track, aNestLevel );
+    // Save the tracks and vias.  Their layer names are quoted once for all of them,
+    // and forgotten when the tracks are written, even if an exception is thrown.
+    {
+        QUOTED_LAYER_NAMES_CLEANER cleaner( m_quotedLayerNames );
+
+        m_quotedLayerNames.resize( LAYER_ID_COUNT );
+
+        for( LAYER_NUM layer = 0; layer < LAYER_ID_COUNT; ++layer )
+            m_quotedLayerNames[layer] = m_out->Quotew( aBoard->GetLayerName( LAYER_ID( layer ) ) );
+
+        for( TRACK* track = aBoard->m_Track;  track; track = track->Next() )
+            Format( track, aNestLevel );
+    }
 
     if( aBoard->m_Track.GetCount() )
         m_out->Print( 0, "\n" );
@@ -1398,6 +1453,11 @@ void PCB_IO::format( TEXTE_MODULE* aText, int aNestLevel ) const
 void PCB_IO::format( TRACK* aTrack, int aNestLevel ) const
     throw( IO_ERROR )
 {
+    // formatted without allocations, there may be hundreds of thousands of tracks
+    char    start[FMT_IU_BUFSIZE];
+    char    end[FMT_IU_BUFSIZE];
+    char    width[FMT_IU_BUFSIZE];
+
     if( aTrack->Type() == PCB_VIA_T )
     {
         LAYER_ID  layer1, layer2;
@@ -1429,24 +1489,35 @@ void PCB_IO::format( TRACK* aTrack, int aNestLevel ) const
             THROW_IO_ERROR( wxString::Format( _( "unknown via type %d"  ), via->GetViaType() ) );
         }
 
-        m_out->Print( 0, " (at %s) (size %s)",
-                      FMT_IU( aTrack->GetStart() ).c_str(),
-                      FMT_IU( aTrack->GetWidth() ).c_str() );
+        FMT_IU( start, aTrack->GetStart() );
+        FMT_IU( width, aTrack->GetWidth() );
+
+        m_out->Print( 0, " (at %s) (size %s)", start, width );
 
         if( via->GetDrill() != UNDEFINED_DRILL_DIAMETER )
-            m_out->Print( 0, " (drill %s)", FMT_IU( via->GetDrill() ).c_str() );
+        {
+            FMT_IU( width, via->GetDrill() );
+            m_out->Print( 0, " (drill %s)", width );
+        }
+
+        std::string name1, name2;
 
         m_out->Print( 0, " (layers %s %s)",
-                      m_out->Quotew( m_board->GetLayerName( layer1 ) ).c_str(),
-                      m_out->Quotew( m_board->GetLayerName( layer2 ) ).c_str() );
+                      quotedLayerName( m_board, layer1, name1 ),
+                      quotedLayerName( m_board, layer2, name2 ) );
     }
     else
     {
-        m_out->Print( aNestLevel, "(segment (start %s) (end %s) (width %s)",
-                      FMT_IU( aTrack->GetStart() ).c_str(), FMT_IU( aTrack->GetEnd() ).c_str(),
-                      FMT_IU( aTrack->GetWidth() ).c_str() );
+        FMT_IU( start, aTrack->GetStart() );
+        FMT_IU( end, aTrack->GetEnd() );
+        FMT_IU( width, aTrack->GetWidth() );
+
+        m_out->Print( aNestLevel, "(segment (start %s) (end %s) (width %s)", start, end, width );
 
-        m_out->Print( 0, " (layer %s)", m_out->Quotew( aTrack->GetLayerName() ).c_str() );
+        std::string name;
+
+        m_out->Print( 0, " (layer %s)",
+                      quotedLayerName( aTrack->GetBoard(), aTrack->GetLayer(), name ) );
     }
 
     m_out->Print( 0, " (net %d)", m_mapping->Translate( aTrack->GetNetCode() ) );
@@ -1571,6 +1642,7 @@ void PCB_IO::format( ZONE_CONTAINER* aZone, int aNestLevel ) const
 
     const CPOLYGONS_LIST& cv = aZone->Outline()->m_CornersList;
     int newLine = 0;
+    char xy[FMT_IU_BUFSIZE];
 
     if( cv.GetCornersCount() )
     {
@@ -1579,12 +1651,12 @@ void PCB_IO::format( ZONE_CONTAINER* aZone, int aNestLevel ) const
 
         for( unsigned it = 0; it < cv.GetCornersCount(); ++it )
         {
+            FMT_IU( xy, cv.GetPos( it ) );
+
             if( newLine == 0 )
-                m_out->Print( aNestLevel+3, "(xy %s %s)",
-                              FMT_IU( cv.GetX( it ) ).c_str(), FMT_IU( cv.GetY( it ) ).c_str() );
+                m_out->Print( aNestLevel+3, "(xy %s)", xy );
             else
-                m_out->Print( 0, " (xy %s %s)",
-                              FMT_IU( cv.GetX( it ) ).c_str(), FMT_IU( cv.GetY( it ) ).c_str() );
+                m_out->Print( 0, " (xy %s)", xy );
 
             if( newLine < 4 )
             {
@@ -1627,12 +1699,12 @@ void PCB_IO::format( ZONE_CONTAINER* aZone, int aNestLevel ) const
 
         for( unsigned it = 0; it < fv.GetCornersCount();  ++it )
         {
+            FMT_IU( xy, fv.GetPos( it ) );
+
             if( newLine == 0 )
-                m_out->Print( aNestLevel+3, "(xy %s %s)",
-                              FMT_IU( fv.GetX( it ) ).c_str(), FMT_IU( fv.GetY( it ) ).c_str() );
+                m_out->Print( aNestLevel+3, "(xy %s)", xy );
             else
-                m_out->Print( 0, " (xy %s %s)",
-                              FMT_IU( fv.GetX( it ) ).c_str(), FMT_IU( fv.GetY( it ) ).c_str() );
+                m_out->Print( 0, " (xy %s)", xy );
 
             if( newLine < 4 )
             {
@@ -1673,9 +1745,12 @@ void PCB_IO::format( ZONE_CONTAINER* aZone, int aNestLevel ) const
 
         for( std::vector< SEGMENT >::const_iterator it = segs.begin();  it != segs.end();  ++it )
         {
-            m_out->Print( aNestLevel+2, "(pts (xy %s) (xy %s))\n",
-                          FMT_IU( it->m_Start ).c_str(),
-                          FMT_IU( it->m_End ).c_str() );
+            char end[FMT_IU_BUFSIZE];
+
+            FMT_IU( xy, it->m_Start );
+            FMT_IU( end, it->m_End );
+
+            m_out->Print( aNestLevel+2, "(pts (xy %s) (xy %s))\n", xy, end );
         }
 
         m_out->Print( aNestLevel+1, ")\n" );
@@ -1730,6 +1805,7 @@ void PCB_IO::init( const PROPERTIES* aProperties )
     m_reader = NULL;
     m_loading_format_version = SEXPR_BOARD_FILE_VERSION;
     m_props = aProperties;
+    m_quotedLayerNames.clear();
 }
 
 
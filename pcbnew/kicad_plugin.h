@@ -26,6 +26,7 @@
 
 #include <io_mgr.h>
 #include <string>
+#include <vector>
 #include <layers_id_colors_and_visibility.h>
 
 class BOARD;
@@ -106,6 +107,20 @@ public:
     void Save( const wxString& aFileName, BOARD* aBoard,
                const PROPERTIES* aProperties = NULL );          // overload
 
+    /**
+     * Function FormatBoardFile
+     * outputs a whole board file, as written by Save(), to \a aFormatter.
+     * The auto save uses it to format a copy of the board in a worker thread,
+     * see BOARD::Snapshot().
+     *
+     * @param aBoard The board to output.
+     * @param aFormatter The formatter receiving the text.
+     * @param aProperties Same as for Save().
+     * @throw IO_ERROR on write error.
+     */
+    void FormatBoardFile( BOARD* aBoard, OUTPUTFORMATTER* aFormatter,
+                          const PROPERTIES* aProperties = NULL );
+
     BOARD* Load( const wxString& aFileName, BOARD* aAppendToMe, const PROPERTIES* aProperties = NULL );
 
     wxArrayString FootprintEnumerate( const wxString& aLibraryPath, const PROPERTIES* aProperties = NULL);
@@ -176,12 +191,23 @@ protected:
     NETINFO_MAPPING*    m_mapping;  ///< mapping for net codes, so only not empty net codes
                                     ///< are stored with consecutive integers as net codes
 
+    /// quoted layer names of the board, only while its tracks are formatted
+    mutable std::vector<std::string>    m_quotedLayerNames;
+
     /// we only cache one footprint library, this determines which one.
     void cacheLib( const wxString& aLibraryPath, const wxString& aFootprintName = wxEmptyString );
 
     void init( const PROPERTIES* aProperties );
 
 private:
+    /**
+     * Function quotedLayerName
+     * returns the quoted name of \a aLayer of \a aBoard, from m_quotedLayerNames
+     * if it is filled, else quoted into \a aStorage.
+     */
+    const char* quotedLayerName( const BOARD* aBoard, LAYER_ID aLayer,
+                                 std::string& aStorage ) const;
+
     void format( BOARD* aBoard, int aNestLevel = 0 ) const
         throw( IO_ERROR );
 
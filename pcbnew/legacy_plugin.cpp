@@ -1126,7 +1126,7 @@ void LEGACY_PLUGIN::loadSETUP()
 
         else if( TESTLINE( "Pad2PasteClearanceRatio" ) )
         {
-            double ratio = atof( line + SZ( "Pad2PasteClearanceRatio" ) );
+            double ratio = ParseDouble( line + SZ( "Pad2PasteClearanceRatio" ) );
             bds.m_SolderPasteMarginRatio = ratio;
         }
 
@@ -1354,7 +1354,7 @@ void LEGACY_PLUGIN::loadMODULE( MODULE* aModule )
 
         else if( TESTLINE( ".SolderPasteRatio" ) )
         {
-            double tmp = atof( line + SZ( ".SolderPasteRatio" ) );
+            double tmp = ParseDouble( line + SZ( ".SolderPasteRatio" ) );
             // Due to a bug in dialog editor in Modedit, fixed in BZR version 3565
             // this parameter can be broken.
             // It should be >= -50% (no solder paste) and <= 0% (full area of the pad)
@@ -1603,7 +1603,7 @@ void LEGACY_PLUGIN::loadPAD( MODULE* aModule )
 
         else if( TESTLINE( ".SolderPasteRatio" ) )
         {
-            double tmp = atof( line + SZ( ".SolderPasteRatio" ) );
+            double tmp = ParseDouble( line + SZ( ".SolderPasteRatio" ) );
             pad->SetLocalSolderPasteMarginRatio( tmp );
         }
 
@@ -2985,11 +2985,11 @@ void LEGACY_PLUGIN::loadPCB_TARGET()
 
 BIU LEGACY_PLUGIN::biuParse( const char* aValue, const char** nptrptr )
 {
-    char*   nptr;
+    const char* nptr;
 
     errno = 0;
 
-    double fval = strtod( aValue, &nptr );
+    double fval = ParseDouble( aValue, &nptr );
 
     if( errno )
     {
@@ -3022,11 +3022,11 @@ BIU LEGACY_PLUGIN::biuParse( const char* aValue, const char** nptrptr )
 
 double LEGACY_PLUGIN::degParse( const char* aValue, const char** nptrptr )
 {
-    char*   nptr;
+    const char* nptr;
 
     errno = 0;
 
-    double fval = strtod( aValue, &nptr );
+    double fval = ParseDouble( aValue, &nptr );
 
     if( errno )
     {
@@ -261,7 +261,7 @@ MODULE* PCB_EDIT_FRAME::Genere_Self( wxDC* DC )
     // Place a pad on each end of coil.
     pad = new D_PAD( module );
 
-    module->Pads().PushFront( pad );
+    module->Add( pad, false );
 
     pad->SetPadName( wxT( "1" ) );
     pad->SetPosition( s_inductor_pattern.m_End );
@@ -275,7 +275,7 @@ MODULE* PCB_EDIT_FRAME::Genere_Self( wxDC* DC )
 
     D_PAD* newpad = new D_PAD( *pad );
 
-    module->Pads().Insert( newpad, pad->Next() );
+    module->Add( newpad );
 
     pad = newpad;
     pad->SetPadName( wxT( "2" ) );
@@ -547,7 +547,7 @@ MODULE* PCB_EDIT_FRAME::CreateMuWaveBaseFootprint( const wxString& aValue,
     {
         D_PAD* pad = new D_PAD( module );
 
-        module->Pads().PushFront( pad );
+        module->Add( pad, false );
 
         int tw = GetDesignSettings().GetCurrentTrackWidth();
         pad->SetSize( wxSize( tw, tw ) );
@@ -49,6 +49,22 @@ public:
      */
     void DisplayBoard( const BOARD* aBoard );
 
+    /**
+     * Function SetupView
+     * sets the rendering order and the properties of the board layers in a VIEW. It is used
+     * by the panel, and by code that renders boards without a window.
+     * @param aView is the VIEW to be configured.
+     */
+    static void SetupView( KIGFX::VIEW* aView );
+
+    /**
+     * Function AddBoardItems
+     * adds the zones, drawings, tracks and modules (with their children) of a board to a VIEW.
+     * @param aView is the VIEW receiving the items.
+     * @param aBoard is the PCB to be loaded.
+     */
+    static void AddBoardItems( KIGFX::VIEW* aView, const BOARD* aBoard );
+
     /**
      * Function SetWorksheet
      * Sets (or updates) worksheet used by the draw panel.
@@ -197,6 +197,15 @@ public:
     /// @copydoc PAINTER::Draw()
     virtual bool Draw( const VIEW_ITEM* aItem, int aLayer );
 
+    /// @copydoc PAINTER::Clone()
+    virtual PAINTER* Clone( GAL* aGal ) const
+    {
+        PCB_PAINTER* painter = new PCB_PAINTER( *this );
+        painter->SetGAL( aGal );
+
+        return painter;
+    }
+
 protected:
     PCB_RENDER_SETTINGS m_pcbSettings;
 
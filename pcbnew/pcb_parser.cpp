@@ -31,6 +31,7 @@
 #include <common.h>
 #include <confirm.h>
 #include <macros.h>
+#include <kicad_string.h>
 #include <convert_from_iu.h>
 #include <trigo.h>
 #include <3d_struct.h>
@@ -125,11 +126,12 @@ void PCB_PARSER::pushValueIntoMap( int aIndex, int aValue )
 
 double PCB_PARSER::parseDouble() throw( IO_ERROR )
 {
-    char* tmp;
+    const char* tmp;
 
     errno = 0;
 
-    double fval = strtod( CurText(), &tmp );
+    // locale independent, no LOCALE_IO is needed for it
+    double fval = ParseDouble( CurText(), &tmp );
 
     if( errno )
     {
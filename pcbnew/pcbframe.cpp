@@ -41,6 +41,7 @@
 #include <3d_viewer.h>
 #include <msgpanel.h>
 #include <fp_lib_table.h>
+#include <background_file_writer.h>
 
 #include <pcbnew.h>
 #include <pcbnew_id.h>
@@ -86,6 +87,7 @@
 #define PCB_MAGNETIC_TRACKS_OPT         wxT( "PcbMagTrackOpt" )
 #define SHOW_MICROWAVE_TOOLS            wxT( "ShowMicrowaveTools" )
 #define SHOW_LAYER_MANAGER_TOOLS        wxT( "ShowLayerManagerTools" )
+#define PCB_UNDO_MEMORY_MAX_OPT         wxT( "UndoRedoMemoryMax_MB" )
 
 
 BEGIN_EVENT_TABLE( PCB_EDIT_FRAME, PCB_BASE_FRAME )
@@ -96,6 +98,7 @@ BEGIN_EVENT_TABLE( PCB_EDIT_FRAME, PCB_BASE_FRAME )
     EVT_COMBOBOX( ID_ON_GRID_SELECT, PCB_EDIT_FRAME::OnSelectGrid )
 
     EVT_CLOSE( PCB_EDIT_FRAME::OnCloseWindow )
+    EVT_THREAD( ID_PCB_AUTO_SAVE_WRITTEN, PCB_EDIT_FRAME::OnAutoSaveWritten )
     EVT_SIZE( PCB_EDIT_FRAME::OnSize )
 
     EVT_TOOL( ID_LOAD_FILE, PCB_EDIT_FRAME::Files_io )
@@ -347,6 +350,7 @@ PCB_EDIT_FRAME::PCB_EDIT_FRAME( KIWAY* aKiway, wxWindow* aParent ) :
     m_Layers = new PCB_LAYER_WIDGET( this, GetCanvas(), pointSize );
 
     m_drc = new DRC( this );        // these 2 objects point to each other
+    m_autoSaveWriter = new BACKGROUND_FILE_WRITER( this, ID_PCB_AUTO_SAVE_WRITTEN );
 
     wxIcon  icon;
     icon.CopyFromBitmap( KiBitmap( icon_pcbnew_xpm ) );
@@ -463,6 +467,7 @@ PCB_EDIT_FRAME::~PCB_EDIT_FRAME()
         m_Macros[i].m_Record.clear();
 
     delete m_drc;
+    delete m_autoSaveWriter;    // waits for the auto save in progress
 }
 
 
@@ -779,6 +784,18 @@ void PCB_EDIT_FRAME::LoadSettings( wxConfigBase* aCfg )
     aCfg->Read( PCB_MAGNETIC_TRACKS_OPT, &g_MagneticTrackOption );
     aCfg->Read( SHOW_MICROWAVE_TOOLS, &m_show_microwave_tools );
     aCfg->Read( SHOW_LAYER_MANAGER_TOOLS, &m_show_layer_manager_tools );
+
+    // Memory budget of the undo/redo lists, in MB (0 = only the command count is limited)
+    const size_t megabyte = 1024 * 1024;
+    long         undoMemoryMax;
+
+    aCfg->Read( PCB_UNDO_MEMORY_MAX_OPT, &undoMemoryMax, PCB_UNDO_MEMORY_MAX_DEFAULT_MB );
+
+    if( undoMemoryMax < 0 )
+        undoMemoryMax = 0;
+
+    GetScreen()->m_UndoRedoMemoryMax =
+        std::min( (size_t) undoMemoryMax, ( (size_t) -1 ) / megabyte ) * megabyte;
 }
 
 
@@ -797,6 +814,8 @@ void PCB_EDIT_FRAME::SaveSettings( wxConfigBase* aCfg )
     aCfg->Write( PCB_MAGNETIC_TRACKS_OPT, (long) g_MagneticTrackOption );
     aCfg->Write( SHOW_MICROWAVE_TOOLS, (long) m_show_microwave_tools );
     aCfg->Write( SHOW_LAYER_MANAGER_TOOLS, (long)m_show_layer_manager_tools );
+    aCfg->Write( PCB_UNDO_MEMORY_MAX_OPT,
+                 (long) ( GetScreen()->m_UndoRedoMemoryMax / ( 1024 * 1024 ) ) );
 }
 
 
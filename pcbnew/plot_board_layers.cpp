@@ -47,6 +47,7 @@
 #include <class_drawsegment.h>
 #include <class_mire.h>
 #include <class_dimension.h>
+#include <polygon_set.h>
 
 #include <pcbnew.h>
 #include <pcbplot.h>
@@ -542,7 +543,6 @@ static const LAYER_ID plot_seq[] = {
 
 /* Plot outlines of copper, for copper layer
  */
-#include "clipper.hpp"
 void PlotLayerOutlines( BOARD *aBoard, PLOTTER* aPlotter,
                         LSET aLayerMask, const PCB_PLOT_PARAMS& aPlotOpt )
 {
@@ -559,51 +559,28 @@ void PlotLayerOutlines( BOARD *aBoard, PLOTTER* aPlotter,
         outlines.RemoveAllContours();
         aBoard->ConvertBrdLayerToPolygonalContours( layer, outlines );
 
-        // Merge all overlapping polygons.
-        KI_POLYGON_SET kpolygons;
-        KI_POLYGON_SET ktmp;
-        outlines.ExportTo( ktmp );
-
-        kpolygons += ktmp;
+        // Merge all overlapping polygons.  Outlines and holes are separate contours
+        // after Simplify(), so they are plotted as clean outlines.
+        POLYGON_SET polygons;
+        polygons.AddOutlines( outlines );
+        polygons.Simplify();
 
         // Plot outlines
         std::vector< wxPoint > cornerList;
 
-        for( unsigned ii = 0; ii < kpolygons.size(); ii++ )
+        for( int ii = 0; ii < polygons.ContourCount(); ii++ )
         {
-            KI_POLYGON polygon = kpolygons[ii];
-
-            // polygon contains only one polygon, but it can have holes linked by
-            // overlapping segments.
-            // To plot clean outlines, we have to break this polygon into more polygons with
-            // no overlapping segments, using Clipper, because boost::polygon
-            // does not allow that
-            ClipperLib::Path raw_polygon;
-            ClipperLib::Paths normalized_polygons;
-
-            for( unsigned ic = 0; ic < polygon.size(); ic++ )
-            {
-                KI_POLY_POINT corner = *(polygon.begin() + ic);
-                raw_polygon.push_back( ClipperLib::IntPoint( corner.x(), corner.y() ) );
-            }
-
-            ClipperLib::SimplifyPolygon( raw_polygon, normalized_polygons );
+            const ClipperLib::Path& polygon = polygons.GetPaths()[ii];
+            cornerList.clear();
 
-            // Now we have one or more basic polygons: plot each polygon
-            for( unsigned ii = 0; ii < normalized_polygons.size(); ii++ )
-            {
-                ClipperLib::Path& polygon = normalized_polygons[ii];
-                cornerList.clear();
-
-                for( unsigned jj = 0; jj < polygon.size(); jj++ )
-                    cornerList.push_back( wxPoint( polygon[jj].X , polygon[jj].Y ) );
+            for( unsigned jj = 0; jj < polygon.size(); jj++ )
+                cornerList.push_back( wxPoint( polygon[jj].X , polygon[jj].Y ) );
 
-                // Ensure the polygon is closed
-                if( cornerList[0] != cornerList[cornerList.size()-1] )
-                    cornerList.push_back( cornerList[0] );
+            // Ensure the polygon is closed
+            if( cornerList[0] != cornerList[cornerList.size()-1] )
+                cornerList.push_back( cornerList[0] );
 
-                aPlotter->PlotPoly( cornerList, NO_FILL );
-            }
+            aPlotter->PlotPoly( cornerList, NO_FILL );
         }
 
         // Plot pad holes
@@ -792,52 +769,23 @@ void PlotSolderMaskLayer( BOARD *aBoard, PLOTTER* aPlotter,
     // 1 - merge polygons which are intersecting, i.e. remove gaps
     //     having a thickness < aMinThickness
     // 2 - deflate resulting polygons by aMinThickness/2
-    KI_POLYGON_SET areasToMerge;
-    bufferPolys.ExportTo( areasToMerge );
-    KI_POLYGON_SET initialAreas;
-    initialPolys.ExportTo( initialAreas );
-
     // Merge polygons: because each shape was created with an extra margin
     // = aMinThickness/2, shapes too close ( dist < aMinThickness )
-    // will be merged, because they are overlapping
-    KI_POLYGON_SET areas;
-    areas |= areasToMerge;      // Populates with merged polygons
-
+    // will be merged, because they are overlapping.
     // Deflate: remove the extra margin, to create the actual shapes
-    // Here I am using polygon:resize, because this function creates better shapes
-    // than deflate algo.
-    // Use here deflate made by Clipper, because:
-    // Clipper is (by far) faster and better, event using arcs to deflate shapes
-    // boost::polygon < 1.56 polygon resize function sometimes crashes when deflating using arcs
-    // boost::polygon >=1.56 polygon resize function just does not work
-    // Note also we combine polygons using boost::polygon, which works better than Clipper,
-    // especially with zones using holes linked to main outlines by overlapping segments
-    CPOLYGONS_LIST tmp;
-    tmp.ImportFrom( areas );
-
-    // Deflate area using Clipper, better than boost::polygon
-    ClipperLib::Paths areasDeflate;
-    tmp.ExportTo( areasDeflate );
-
-    // Deflate areas: they will have the right size after deflate
-    ClipperLib::ClipperOffset offset_engine;
-    circleToSegmentsCount = 16;
-    offset_engine.ArcTolerance = (double)inflate / 3.14 / circleToSegmentsCount;
-    offset_engine.AddPaths( areasDeflate, ClipperLib::jtRound, ClipperLib::etClosedPolygon );
-    offset_engine.Execute( areasDeflate, -inflate );
+    // (Inflate() merges the overlapping polygons first)
+    POLYGON_SET areas;
+    areas.AddOutlines( bufferPolys );
+    areas.Inflate( -inflate, 16 );
 
     // Combine the current areas to initial areas. This is mandatory because
     // inflate/deflate transform is not perfect, and we want the initial areas perfectly kept
-    tmp.RemoveAllContours();
-    tmp.ImportFrom( areasDeflate );
-    areas.clear();
-    tmp.ExportTo( areas );
-
-    // Resize slightly changes shapes (the transform is not perfect).
-    // So *ensure* initial shapes are kept
-    areas |= initialAreas;
+    POLYGON_SET initialAreas;
+    initialAreas.AddOutlines( initialPolys );
+    areas.BooleanAdd( initialAreas );
 
-    zone.CopyPolygonsFromKiPolygonListToFilledPolysList( areas );
+    areas.Fracture();
+    zone.CopyPolygonsFromPolygonSetToFilledPolysList( areas );
 
     itemplotter.PlotFilledAreas( &zone );
 }
@@ -27,11 +27,13 @@
 
 
 //  see http://www.boost.org/libs/ptr_container/doc/ptr_sequence_adapter.html
+#include <map>
 #include <boost/ptr_container/ptr_vector.hpp>
 
 //  see http://www.boost.org/libs/ptr_container/doc/ptr_set.html
 #include <boost/ptr_container/ptr_set.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/unordered_map.hpp>
 
 #include <fctsys.h>
 #include <specctra_lexer.h>
@@ -2093,6 +2095,7 @@ typedef boost::ptr_vector<IMAGE>    IMAGES;
 class PADSTACK : public ELEM_HOLDER
 {
     friend class SPECCTRA_DB;
+    friend class LIBRARY;
 
     std::string     hash;       ///< a hash string used by Compare(), not Format()ed/exported.
 
@@ -2233,6 +2236,60 @@ class LIBRARY : public ELEM
     PADSTACKS       padstacks;      ///< all except vias, which are in 'vias'
     PADSTACKS       vias;
 
+    /*  Hash indexes of the containers above, so looking up an image or a padstack
+        does not compare it with all the others.  They are updated lazily, by the
+        index*() functions, because the parser fills the containers directly.
+    */
+    typedef boost::unordered_map<std::string, int>  STRING_INDEX;
+
+    STRING_INDEX    imagesByHash;       ///< IMAGE hash -> index in images
+    STRING_INDEX    imageIdCounts;      ///< image_id -> number of images using it
+    unsigned        indexedImages;
+
+    STRING_INDEX    viasByHash;         ///< padstack_id and PADSTACK hash -> index in vias
+    unsigned        indexedVias;
+
+    STRING_INDEX    padstacksById;      ///< padstack_id -> index of the first one in padstacks
+    unsigned        indexedPadstacks;
+
+    static std::string viaKey( PADSTACK* aVia )
+    {
+        if( !aVia->hash.size() )
+            aVia->hash = aVia->makeHash();
+
+        // a padstack_id cannot hold a newline, so the key is not ambiguous
+        return aVia->padstack_id + '\n' + aVia->hash;
+    }
+
+    void indexImages()
+    {
+        for( ;  indexedImages < images.size();  ++indexedImages )
+        {
+            IMAGE* image = &images[indexedImages];
+
+            if( !image->hash.size() )
+                image->hash = image->makeHash();
+
+            imagesByHash.insert( std::make_pair( image->hash, (int) indexedImages ) );
+            ++imageIdCounts[image->image_id];
+        }
+    }
+
+    void indexVias()
+    {
+        for( ;  indexedVias < vias.size();  ++indexedVias )
+            viasByHash.insert( std::make_pair( viaKey( &vias[indexedVias] ), (int) indexedVias ) );
+    }
+
+    void indexPadstacks()
+    {
+        for( ;  indexedPadstacks < padstacks.size();  ++indexedPadstacks )
+        {
+            padstacksById.insert( std::make_pair( padstacks[indexedPadstacks].GetPadstackId(),
+                                                  (int) indexedPadstacks ) );
+        }
+    }
+
 public:
 
     LIBRARY( ELEM* aParent, DSN_T aType = T_library ) :
@@ -2240,6 +2297,9 @@ public:
     {
         unit = 0;
 //        via_start_index = -1;       // 0 or greater means there is at least one via
+        indexedImages = 0;
+        indexedVias = 0;
+        indexedPadstacks = 0;
     }
     ~LIBRARY()
     {
@@ -2271,21 +2331,22 @@ public:
      */
     int FindIMAGE( IMAGE* aImage )
     {
-        unsigned i;
-        for( i=0;  i<images.size();  ++i )
-        {
-            if( 0 == IMAGE::Compare( aImage, &images[i] ) )
-                return (int) i;
-        }
+        indexImages();
+
+        if( !aImage->hash.size() )
+            aImage->hash = aImage->makeHash();
+
+        STRING_INDEX::const_iterator it = imagesByHash.find( aImage->hash );
+
+        if( it != imagesByHash.end() )
+            return it->second;
 
         // There is no match to the IMAGE contents, but now generate a unique
         // name for it.
-        int dups = 1;
-        for( i=0;  i<images.size();  ++i )
-        {
-            if( 0 == aImage->image_id.compare( images[i].image_id ) )
-                aImage->duplicated = dups++;
-        }
+        STRING_INDEX::const_iterator dups = imageIdCounts.find( aImage->image_id );
+
+        if( dups != imageIdCounts.end() )
+            aImage->duplicated = dups->second;
 
         return -1;
     }
@@ -2327,11 +2388,13 @@ public:
      */
     int FindVia( PADSTACK* aVia )
     {
-        for( unsigned i=0;  i<vias.size();  ++i )
-        {
-            if( 0 == PADSTACK::Compare( aVia, &vias[i] ) )
-                return int( i );
-        }
+        indexVias();
+
+        STRING_INDEX::const_iterator it = viasByHash.find( viaKey( aVia ) );
+
+        if( it != viasByHash.end() )
+            return it->second;
+
         return -1;
     }
 
@@ -2382,12 +2445,13 @@ public:
      */
     PADSTACK* FindPADSTACK( const std::string& aPadstackId )
     {
-        for( unsigned i=0;  i<padstacks.size();  ++i )
-        {
-            PADSTACK* ps = &padstacks[i];
-            if( 0 == ps->GetPadstackId().compare( aPadstackId ) )
-                return ps;
-        }
+        indexPadstacks();
+
+        STRING_INDEX::const_iterator it = padstacksById.find( aPadstackId );
+
+        if( it != padstacksById.end() )
+            return &padstacks[it->second];
+
         return NULL;
     }
 
@@ -3085,6 +3149,24 @@ typedef boost::ptr_vector<WIRE_VIA>      WIRE_VIAS;
  * Class WIRING
  * corresponds to &lt;wiring_descriptor&gt; in the specctra dsn spec.
  */
+/**
+ * Class WIRING_SOURCE
+ * is an interface for objects which write wires and wire vias directly while
+ * the WIRING is formatted, so they do not need to be stored in the WIRING.
+ */
+class WIRING_SOURCE
+{
+public:
+    virtual ~WIRING_SOURCE() {}
+
+    /**
+     * Function FormatWIRING
+     * writes &lt;wire_descriptor&gt;s and &lt;wire_via_descriptor&gt;s to \a out.
+     */
+    virtual void FormatWIRING( OUTPUTFORMATTER* out, int nestLevel ) throw( IO_ERROR ) = 0;
+};
+
+
 class WIRING : public ELEM
 {
     friend class SPECCTRA_DB;
@@ -3093,12 +3175,15 @@ class WIRING : public ELEM
     WIRES       wires;
     WIRE_VIAS   wire_vias;
 
+    WIRING_SOURCE*  source;     ///< writes more wires after the stored ones, not owned
+
 public:
 
     WIRING( ELEM* aParent ) :
         ELEM( T_wiring, aParent )
     {
         unit = 0;
+        source = 0;
     }
     ~WIRING()
     {
@@ -3115,6 +3200,9 @@ public:
 
         for( WIRE_VIAS::iterator i=wire_vias.begin();  i!=wire_vias.end();  ++i )
             i->Format( out, nestLevel );
+
+        if( source )
+            source->FormatWIRING( out, nestLevel );
     }
 
     UNIT_RES*  GetUnits() const
@@ -3599,7 +3687,7 @@ typedef boost::ptr_set<PADSTACK>    PADSTACKSET;
  * holds a DSN data tree, usually coming from a DSN file. Is essentially a
  * SPECCTRA_PARSER class.
  */
-class SPECCTRA_DB : public SPECCTRA_LEXER
+class SPECCTRA_DB : public SPECCTRA_LEXER, public WIRING_SOURCE
 {
     /// specctra DSN keywords
     static const KEYWORD keywords[];
@@ -3628,6 +3716,36 @@ class SPECCTRA_DB : public SPECCTRA_LEXER
     /// a copy to avoid passing as an argument, memory for it is not owned here.
     BOARD*          sessionBoard;
 
+    /// the BOARD given to FromBOARD(), its tracks and vias are written by FormatWIRING()
+    /// only when the file is written, memory for it is not owned here.
+    BOARD*          exportBoard;
+
+    /// identifies the padstack of a BOARD via, see FromBOARD()
+    struct VIA_KEY
+    {
+        int     diameter;
+        int     drill;
+        int     topLayer;       ///< specctra cu layer
+        int     botLayer;
+
+        bool operator<( const VIA_KEY& aOther ) const
+        {
+            if( diameter != aOther.diameter )
+                return diameter < aOther.diameter;
+
+            if( drill != aOther.drill )
+                return drill < aOther.drill;
+
+            if( topLayer != aOther.topLayer )
+                return topLayer < aOther.topLayer;
+
+            return botLayer < aOther.botLayer;
+        }
+    };
+
+    /// padstack_id of the library via used by each kind of BOARD via
+    std::map<VIA_KEY, std::string>  viaPadstackIds;
+
     static const KICAD_T scanPADs[];
 
     PADSTACKSET     padstackset;
@@ -3798,6 +3916,12 @@ class SPECCTRA_DB : public SPECCTRA_LEXER
      */
     PADSTACK* makeVia( const ::VIA* aVia );
 
+    /**
+     * Function makeVIA_KEY
+     * returns the key of the padstack of the given KiCad VIA in viaPadstackIds.
+     */
+    VIA_KEY makeVIA_KEY( const ::VIA* aVia );
+
     /**
      * Function deleteNETs
      * deletes all the NETs that may be in here.
@@ -3854,6 +3978,7 @@ public:
         // Avoid not initialized members:
         routeResolution = NULL;
         sessionBoard = NULL;
+        exportBoard = NULL;
         m_top_via_layer = 0;
         m_bot_via_layer = 0;
     }
@@ -3943,6 +4068,15 @@ public:
      */
     void FromBOARD( BOARD* aBoard ) throw( IO_ERROR, boost::bad_ptr_container_operation );
 
+    /**
+     * Function FormatWIRING
+     * writes the tracks and vias of the BOARD given to FromBOARD() as
+     * &lt;wire_descriptor&gt;s and &lt;wire_via_descriptor&gt;s.  They are not
+     * stored in the PCB, so memory use does not depend on the number of tracks.
+     * The BOARD must not be modified between FromBOARD() and ExportPCB().
+     */
+    void FormatWIRING( OUTPUTFORMATTER* out, int nestLevel ) throw( IO_ERROR );
+
     /**
      * Function FromSESSION
      * adds the entire SESSION info to a BOARD but does not write it out.  The
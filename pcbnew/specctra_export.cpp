@@ -838,20 +838,32 @@ PADSTACK* SPECCTRA_DB::makeVia( int aCopperDiameter, int aDrillDiameter,
 }
 
 
-PADSTACK* SPECCTRA_DB::makeVia( const ::VIA* aVia )
+SPECCTRA_DB::VIA_KEY SPECCTRA_DB::makeVIA_KEY( const ::VIA* aVia )
 {
     LAYER_ID    topLayerNum;
     LAYER_ID    botLayerNum;
 
     aVia->LayerPair( &topLayerNum, &botLayerNum );
 
-    int topLayer = kicadLayer2pcb[topLayerNum];
-    int botLayer = kicadLayer2pcb[botLayerNum];
+    VIA_KEY key;
+
+    key.diameter = aVia->GetWidth();
+    key.drill    = aVia->GetDrillValue();
+    key.topLayer = kicadLayer2pcb[topLayerNum];
+    key.botLayer = kicadLayer2pcb[botLayerNum];
+
+    if( key.topLayer > key.botLayer )
+        EXCHG( key.topLayer, key.botLayer );
+
+    return key;
+}
+
 
-    if( topLayer > botLayer )
-        EXCHG( topLayer, botLayer );
+PADSTACK* SPECCTRA_DB::makeVia( const ::VIA* aVia )
+{
+    VIA_KEY key = makeVIA_KEY( aVia );
 
-    return makeVia( aVia->GetWidth(), aVia->GetDrillValue(), topLayer, botLayer );
+    return makeVia( key.diameter, key.drill, key.topLayer, key.botLayer );
 }
 
 
@@ -1929,25 +1941,98 @@ void SPECCTRA_DB::FromBOARD( BOARD* aBoard )
 
 #if 1    // do existing wires and vias
 
-    //-----<create the wires from tracks>-----------------------------------
+    //-----<register the padstacks of the existing vias>---------------------
     {
-        // export all of them for now, later we'll decide what controls we need
-        // on this.
-        static const KICAD_T scanTRACKs[] = { PCB_TRACE_T, EOT };
+        // The tracks and vias themselves are written by FormatWIRING() when the
+        // file is written, so the PCB does not grow with the number of tracks.
+        // The library and the via descriptors need the via padstacks now, though:
+        // register one per unique size, drill and layer pair combo.
+        viaPadstackIds.clear();
+
+        for( TRACK* track = aBoard->m_Track; track; track = track->Next() )
+        {
+            if( track->Type() != PCB_VIA_T || track->GetNetCode() == 0 )
+                continue;
+
+            ::VIA*  via = (::VIA*) track;
+            VIA_KEY key = makeVIA_KEY( via );
+
+            if( viaPadstackIds.find( key ) != viaPadstackIds.end() )
+                continue;
+
+            PADSTACK*   padstack    = makeVia( via );
+            PADSTACK*   registered  = pcb->library->LookupVia( padstack );
+
+            // if the one looked up is not our padstack, then delete our padstack
+            // since it was a duplicate of one already registered.
+            if( padstack != registered )
+            {
+                delete padstack;
+            }
+
+            viaPadstackIds[key] = registered->padstack_id;
+        }
+
+        exportBoard = aBoard;
+        pcb->wiring->source = this;
+    }
+
+#endif    // do existing wires and vias
+
+    //-----<via_descriptor>-------------------------------------------------
+    {
+        // The pcb->library will output <padstack_descriptors> which is a combined
+        // list of part padstacks and via padstacks.  specctra dsn uses the
+        // <via_descriptors> to say which of those padstacks are vias.
+
+        // Output the vias in the padstack list here, by name only.  This must
+        // be done after exporting existing vias as WIRE_VIAs.
+        VIA* vias = pcb->structure->via;
+
+        for(  unsigned viaNdx = 0; viaNdx < pcb->library->vias.size(); ++viaNdx )
+        {
+            vias->AppendVia( pcb->library->vias[viaNdx].padstack_id.c_str() );
+        }
+    }
+
+
+    //-----<output NETCLASSs>----------------------------------------------------
+    NETCLASSES& nclasses = aBoard->GetDesignSettings().m_NetClasses;
+
+    exportNETCLASS( nclasses.GetDefault(), aBoard );
+
+    for( NETCLASSES::iterator nc = nclasses.begin(); nc != nclasses.end(); ++nc )
+    {
+        NETCLASSPTR netclass = nc->second;
+        exportNETCLASS( netclass, aBoard );
+    }
+}
 
-        items.Collect( aBoard, scanTRACKs );
 
-        std::string netname;
-        WIRING*     wiring = pcb->wiring;
-        PATH*       path = 0;
+void SPECCTRA_DB::FormatWIRING( OUTPUTFORMATTER* out, int nestLevel ) throw( IO_ERROR )
+{
+    if( !exportBoard )
+        return;
+
+    //-----<wires from tracks>-----------------------------------------------
+    {
+        // export all of them for now, later we'll decide what controls we need
+        // on this.  A single WIRE is reused for each run of connected segments
+        // having the same net, width and layer.
+        WIRE        wire( pcb->wiring );
+        PATH*       path = new PATH( &wire );
+
+        wire.SetShape( path );
+        wire.wire_type = T_protect;    // @todo, this should be configurable
 
         int old_netcode = -1;
         int old_width = -1;
         LAYER_NUM old_layer = UNDEFINED_LAYER;
 
-        for( int i=0;  i<items.GetCount();  ++i )
+        for( TRACK* track = exportBoard->m_Track;  track;  track = track->Next() )
         {
-            TRACK*  track = (TRACK*) items[i];
+            if( track->Type() != PCB_TRACE_T )
+                continue;
 
             int     netcode = track->GetNetCode();
 
@@ -1957,34 +2042,29 @@ void SPECCTRA_DB::FromBOARD( BOARD* aBoard )
             if( old_netcode != netcode
             ||  old_width   != track->GetWidth()
             ||  old_layer   != track->GetLayer()
-            ||  (path && path->points.back() != mapPt(track->GetStart()) )
+            ||  (path->points.size() && path->points.back() != mapPt(track->GetStart()) )
               )
             {
+                // write the previous run
+                if( path->points.size() )
+                    wire.Format( out, nestLevel );
+
+                path->points.clear();
+
                 old_width   = track->GetWidth();
                 old_layer   = track->GetLayer();
 
                 if( old_netcode != netcode )
                 {
                     old_netcode = netcode;
-                    NETINFO_ITEM* net = aBoard->FindNet( netcode );
+                    NETINFO_ITEM* net = exportBoard->FindNet( netcode );
                     wxASSERT( net );
-                    netname = TO_UTF8( net->GetNetname() );
+                    wire.net_id = TO_UTF8( net->GetNetname() );
                 }
 
-                WIRE* wire = new WIRE( wiring );
-
-                wiring->wires.push_back( wire );
-                wire->net_id = netname;
-
-                wire->wire_type = T_protect;    // @todo, this should be configurable
-
                 LAYER_NUM kiLayer  = track->GetLayer();
                 int pcbLayer = kicadLayer2pcb[kiLayer];
 
-                path = new PATH( wire );
-
-                wire->SetShape( path );
-
                 path->layer_id = layerIds[pcbLayer];
                 path->aperture_width = scale( old_width );
 
@@ -1993,81 +2073,42 @@ void SPECCTRA_DB::FromBOARD( BOARD* aBoard )
 
             path->AppendPoint( mapPt( track->GetEnd() ) );
         }
-    }
 
+        if( path->points.size() )
+            wire.Format( out, nestLevel );
+    }
 
-    //-----<export the existing real BOARD instantiated vias>-----------------
+    //-----<existing vias>----------------------------------------------------
     {
-        // Export all vias, once per unique size and drill diameter combo.
-        static const KICAD_T scanVIAs[] = { PCB_VIA_T, EOT };
+        WIRE_VIA    dsnVia( pcb->wiring );
 
-        items.Collect( aBoard, scanVIAs );
+        dsnVia.via_type = T_protect;     // @todo, this should be configurable
 
-        for( int i = 0; i<items.GetCount(); ++i )
+        for( TRACK* track = exportBoard->m_Track;  track;  track = track->Next() )
         {
-            ::VIA* via = (::VIA*) items[i];
-            wxASSERT( via->Type() == PCB_VIA_T );
+            if( track->Type() != PCB_VIA_T )
+                continue;
 
+            ::VIA*  via = (::VIA*) track;
             int     netcode = via->GetNetCode();
 
             if( netcode == 0 )
                 continue;
 
-            PADSTACK*   padstack    = makeVia( via );
-            PADSTACK*   registered  = pcb->library->LookupVia( padstack );
-
-            // if the one looked up is not our padstack, then delete our padstack
-            // since it was a duplicate of one already registered.
-            if( padstack != registered )
-            {
-                delete padstack;
-            }
-
-            WIRE_VIA* dsnVia = new WIRE_VIA( pcb->wiring );
-
-            pcb->wiring->wire_vias.push_back( dsnVia );
+            // the padstack was registered by FromBOARD()
+            dsnVia.padstack_id = viaPadstackIds[ makeVIA_KEY( via ) ];
 
-            dsnVia->padstack_id = registered->padstack_id;
-            dsnVia->vertexes.push_back( mapPt( via->GetPosition() ) );
+            dsnVia.vertexes.clear();
+            dsnVia.vertexes.push_back( mapPt( via->GetPosition() ) );
 
-            NETINFO_ITEM* net = aBoard->FindNet( netcode );
+            NETINFO_ITEM* net = exportBoard->FindNet( netcode );
             wxASSERT( net );
 
-            dsnVia->net_id = TO_UTF8( net->GetNetname() );
+            dsnVia.net_id = TO_UTF8( net->GetNetname() );
 
-            dsnVia->via_type = T_protect;     // @todo, this should be configurable
+            dsnVia.Format( out, nestLevel );
         }
     }
-
-#endif    // do existing wires and vias
-
-    //-----<via_descriptor>-------------------------------------------------
-    {
-        // The pcb->library will output <padstack_descriptors> which is a combined
-        // list of part padstacks and via padstacks.  specctra dsn uses the
-        // <via_descriptors> to say which of those padstacks are vias.
-
-        // Output the vias in the padstack list here, by name only.  This must
-        // be done after exporting existing vias as WIRE_VIAs.
-        VIA* vias = pcb->structure->via;
-
-        for(  unsigned viaNdx = 0; viaNdx < pcb->library->vias.size(); ++viaNdx )
-        {
-            vias->AppendVia( pcb->library->vias[viaNdx].padstack_id.c_str() );
-        }
-    }
-
-
-    //-----<output NETCLASSs>----------------------------------------------------
-    NETCLASSES& nclasses = aBoard->GetDesignSettings().m_NetClasses;
-
-    exportNETCLASS( nclasses.GetDefault(), aBoard );
-
-    for( NETCLASSES::iterator nc = nclasses.begin(); nc != nclasses.end(); ++nc )
-    {
-        NETCLASSPTR netclass = nc->second;
-        exportNETCLASS( netclass, aBoard );
-    }
 }
 
 
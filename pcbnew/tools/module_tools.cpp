@@ -143,7 +143,7 @@ int MODULE_TOOLS::PlacePad( const TOOL_EVENT& aEvent )
 
             m_board->m_Status_Pcb = 0;    // I have no clue why, but it is done in the legacy view
             module->SetLastEditTime();
-            module->Pads().PushBack( pad );
+            module->Add( pad );
 
             // Set the relative pad position
             // ( pad position for module orient, 0, and relative to the module position)
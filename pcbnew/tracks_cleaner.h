@@ -0,0 +1,200 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2004-2015 Jean-Pierre Charras, jp.charras at wanadoo.fr
+ * Copyright (C) 1992-2015 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file tracks_cleaner.h
+ * @brief helper class to clean tracks: remove null length, redundant and dangling segments
+ */
+
+#ifndef TRACKS_CLEANER_H
+#define TRACKS_CLEANER_H
+
+#include <vector>
+#include <boost/unordered_map.hpp>
+
+#include <class_track.h>
+#include <connect.h>
+
+class PCB_EDIT_FRAME;
+
+
+/**
+ * Class TRACKS_CLEANER
+ * cleans tracks and vias of a board.
+ * Tracks are found by their endpoints in a hash map, instead of scanning the track list
+ * for each track.
+ */
+class TRACKS_CLEANER: CONNECTIONS
+{
+public:
+    /// Counts of items removed by the cleanup
+    struct STATS
+    {
+        int m_ViasRemoved;          ///< redundant vias (same location, on through pads)
+        int m_NullSegmentsRemoved;  ///< null length segments
+        int m_DuplicatesRemoved;    ///< segments having the same ends, layer and width
+        int m_SegmentsMerged;       ///< segments merged to a collinear one
+        int m_DanglingRemoved;      ///< tracks and vias connected only at one end
+
+        int Total() const
+        {
+            return m_ViasRemoved + m_NullSegmentsRemoved + m_DuplicatesRemoved +
+                   m_SegmentsMerged + m_DanglingRemoved;
+        }
+    };
+
+    TRACKS_CLEANER( BOARD* aPcb );
+
+    /**
+     * the cleanup function.
+     * return true if some item was modified
+     */
+    bool CleanupBoard( PCB_EDIT_FRAME* aFrame, bool aCleanVias,
+                       bool aMergeSegments, bool aDeleteUnconnected );
+
+    const STATS& GetStats() const { return m_stats; }
+
+private:
+    /// Key of the endpoints hash map: only items of the same net can be connected
+    struct ENDPOINT_KEY
+    {
+        int     m_NetCode;
+        wxPoint m_Pos;
+
+        ENDPOINT_KEY( int aNetCode, const wxPoint& aPos ) :
+            m_NetCode( aNetCode ), m_Pos( aPos ) {}
+
+        bool operator==( const ENDPOINT_KEY& aOther ) const
+        {
+            return m_NetCode == aOther.m_NetCode && m_Pos == aOther.m_Pos;
+        }
+    };
+
+    /// Canonical key of a segment: the ends are sorted, so swapped ends give the same key
+    struct SEGMENT_KEY
+    {
+        KICAD_T  m_Type;
+        LAYER_ID m_Layer;
+        int      m_NetCode;
+        int      m_Width;
+        wxPoint  m_A;
+        wxPoint  m_B;
+
+        SEGMENT_KEY( const TRACK* aTrack );
+
+        bool operator==( const SEGMENT_KEY& aOther ) const
+        {
+            return m_Type == aOther.m_Type && m_Layer == aOther.m_Layer &&
+                   m_NetCode == aOther.m_NetCode && m_Width == aOther.m_Width &&
+                   m_A == aOther.m_A && m_B == aOther.m_B;
+        }
+    };
+
+    struct KEY_HASH
+    {
+        std::size_t operator()( const wxPoint& aPos ) const;
+        std::size_t operator()( const ENDPOINT_KEY& aKey ) const;
+        std::size_t operator()( const SEGMENT_KEY& aKey ) const;
+    };
+
+    typedef std::vector<TRACK*> TRACK_LIST;
+    typedef boost::unordered_map<ENDPOINT_KEY, TRACK_LIST, KEY_HASH> ENDPOINT_MAP;
+
+    BOARD*       m_Brd;
+    STATS        m_stats;
+
+    ///> Tracks and vias, by net and endpoint (vias are stored once, at their position)
+    ENDPOINT_MAP m_endpoints;
+
+    /**
+     * Removes redundant vias like vias at same location
+     * or on pad through
+     */
+    bool clean_vias();
+
+    /**
+     * Removes dangling tracks
+     */
+    bool deleteUnconnectedTracks();
+
+    /// Delete null length track segments
+    bool delete_null_segments();
+
+    /// Delete segments having the same end points, layer and width as a previous one
+    bool remove_duplicated_segments();
+
+    /// Try to merge the segment to a collinear one
+    bool merge_collinear_of_track( TRACK* aSegment );
+
+    /**
+     * Merge collinear segments and remove duplicated and null len segments
+     */
+    bool clean_segments();
+
+    /**
+     * helper function
+     * Rebuild list of tracks, and connected tracks
+     * this info must be rebuilt when tracks are erased
+     */
+    void buildTrackConnectionInfo();
+
+    /// Adds aTrack to the endpoints map
+    void indexTrack( TRACK* aTrack );
+
+    /// Removes aTrack from the endpoints map
+    void unindexTrack( TRACK* aTrack );
+
+    /**
+     * helper function
+     * removes aTrack from the endpoints map and from the board.
+     */
+    void removeTrack( TRACK* aTrack );
+
+    /**
+     * helper function
+     * collects the items (tracks and vias) connected to aTrack at aPos: items of the same
+     * net, having an endpoint at aPos and sharing a layer with aTrack.
+     * @param aTrack = the reference item
+     * @param aPos = the connection point
+     * @param aExclude = an other item to skip (can be NULL)
+     * @param aList = the list to fill
+     */
+    void getConnectedItems( const TRACK* aTrack, const wxPoint& aPos,
+                            const TRACK* aExclude, TRACK_LIST& aList ) const;
+
+    /**
+     * helper function
+     * merge aTrackRef and aCandidate, when possible,
+     * i.e. when they are colinear, same width, and obviously same layer
+     */
+    TRACK* mergeCollinearSegmentIfPossible( TRACK* aTrackRef,
+                                            TRACK* aCandidate, ENDPOINT_T aEndType );
+
+    const ZONE_CONTAINER* zoneForTrackEndpoint( const TRACK* aTrack,
+                                                ENDPOINT_T aEndPoint );
+
+    bool testTrackEndpointDangling( TRACK* aTrack, ENDPOINT_T aEndPoint );
+};
+
+#endif  // TRACKS_CLEANER_H
@@ -0,0 +1,485 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2015 KiCad Developers, see change_log.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+// Benchmark of the GAL based board rendering.  It loads a board, displays it
+// with the Cairo (default) or OpenGL backend and then redraws it for a number of
+// frames using a few typical viewports (whole board, zoomed in, panning).  Timings
+// are taken from KIGFX::VIEW::STATS, the OpenGL backend also reports the allocation
+// statistics of its cached vertex container.
+//
+// usage: view_benchmark <board file> [frames per scenario] [cairo|opengl]
+//
+// The Cairo backend renders to an image in memory: no window is created and the
+// GUI is not initialized, so it runs on machines without a display.  The OpenGL
+// backend needs a shown frame to get an OpenGL context, so it requires a display.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+
+#include <wx/app.h>
+#include <wx/frame.h>
+#include <wx/filename.h>
+
+#include <pgm_base.h>
+#include <kiway.h>
+#include <common.h>
+#include <profile.h>
+#include <wildcards_and_files_ext.h>
+#include <class_board.h>
+#include <class_module.h>
+#include <class_track.h>
+#include <io_mgr.h>
+#include <pcb_draw_panel_gal.h>
+#include <pcb_painter.h>
+#include <ratsnest_viewitem.h>
+#include <view/view.h>
+#include <gal/graphics_abstraction_layer.h>
+#include <gal/cairo/cairo_gal.h>
+#include <gal/opengl/opengl_gal.h>
+
+
+/**
+ * Struct PGM_VIEW_BENCHMARK
+ * is the PGM_BASE returned by Pgm() in the pcbnew code.  The benchmark only loads and
+ * renders a board, so neither the program nor the KIFACE are started: it would require
+ * the GUI (e.g. for the first run messages of the footprint library table).
+ */
+static struct PGM_VIEW_BENCHMARK : public PGM_BASE
+{
+    bool OnPgmInit( wxApp* aWxApp )
+    {
+        return false;
+    }
+
+    void OnPgmExit()
+    {
+    }
+
+    void MacOpenFile( const wxString& aFileName ) {}
+} program;
+
+
+///> Size of the rendered frames, in pixels
+static const int FRAME_WIDTH  = 1280;
+static const int FRAME_HEIGHT = 1024;
+
+
+struct SCENARIO_RESULT
+{
+    int         frames;
+    uint64_t    total;
+    uint64_t    min;
+    uint64_t    max;
+};
+
+
+/**
+ * Function drawFrame
+ * redraws the whole view, the same way EDA_DRAW_PANEL_GAL::onPaint() does.
+ * @return the time spent on the frame [us].
+ */
+static uint64_t drawFrame( KIGFX::VIEW* aView )
+{
+    KIGFX::GAL* gal = aView->GetGAL();
+
+    prof_counter frameTime;
+    prof_start( &frameTime );
+
+    aView->UpdateItems();
+    gal->BeginDrawing();
+    gal->ClearScreen( aView->GetPainter()->GetSettings()->GetBackgroundColor() );
+
+    aView->ClearTargets();
+
+    if( aView->IsTargetDirty( KIGFX::TARGET_NONCACHED ) )
+        gal->DrawGrid();
+
+    aView->Redraw();
+    gal->EndDrawing();
+
+    prof_end( &frameTime );
+
+    return frameTime.usecs();
+}
+
+
+/**
+ * Function runScenario
+ * draws aFrames frames. Before each frame the view is moved by aStep (in viewport
+ * sizes) or, if aStep is zero, just invalidated, so every frame is a full redraw.
+ */
+static SCENARIO_RESULT runScenario( KIGFX::VIEW* aView, int aFrames, const VECTOR2D& aStep )
+{
+    SCENARIO_RESULT result = { 0, 0, std::numeric_limits<uint64_t>::max(), 0 };
+    VECTOR2D step = VECTOR2D( aStep.x * aView->GetViewport().GetWidth(),
+                              aStep.y * aView->GetViewport().GetHeight() );
+
+    for( int i = 0; i < aFrames; ++i )
+    {
+        // Move back and forth, so the view stays over the board
+        if( i % 16 < 8 )
+            aView->SetCenter( aView->GetCenter() + step );
+        else
+            aView->SetCenter( aView->GetCenter() - step );
+
+        aView->MarkDirty();
+
+        uint64_t t = drawFrame( aView );
+
+        result.frames++;
+        result.total += t;
+        result.min = std::min( result.min, t );
+        result.max = std::max( result.max, t );
+    }
+
+    return result;
+}
+
+
+static void printScenario( const char* aName, const SCENARIO_RESULT& aResult )
+{
+    if( aResult.frames == 0 )
+        return;
+
+    printf( "%-12s frames: %5d  avg: %8.2f ms  min: %8.2f ms  max: %8.2f ms\n", aName,
+            aResult.frames, aResult.total / 1000.0 / aResult.frames,
+            aResult.min / 1000.0, aResult.max / 1000.0 );
+}
+
+
+static void printLayerStats( const BOARD* aBoard, const KIGFX::VIEW::STATS& aStats )
+{
+    printf( "  %-24s %10s %10s\n", "layer", "drawn", "culled" );
+
+    for( int i = 0; i < KIGFX::VIEW::VIEW_MAX_LAYERS; ++i )
+    {
+        if( aStats.drawnItems[i] == 0 && aStats.culledItems[i] == 0 )
+            continue;
+
+        wxString name = IsValidLayer( i ) ? aBoard->GetLayerName( LAYER_ID( i ) )
+                                          : wxString::Format( wxT( "#%d" ), i );
+
+        printf( "  %-24s %10d %10d\n", TO_UTF8( name ),
+                aStats.drawnItems[i], aStats.culledItems[i] );
+    }
+}
+
+
+/**
+ * Function printCacheStats
+ * prints the allocation statistics of the cached vertex container, if aGal uses one.
+ */
+static void printCacheStats( const KIGFX::GAL* aGal )
+{
+    const KIGFX::OPENGL_GAL* openglGal = dynamic_cast<const KIGFX::OPENGL_GAL*>( aGal );
+
+    if( !openglGal )
+        return;
+
+    const KIGFX::CACHED_CONTAINER* container = openglGal->GetCachedContainer();
+    const KIGFX::CACHED_CONTAINER::STATS& stats = container->GetStats();
+
+    printf( "\ncached vertices:\n" );
+    printf( "  allocations:      %10u  slot reuses: %10u  merges: %10u\n",
+            stats.allocations, stats.slotReuses, stats.coalescings );
+    printf( "  compactions:      %10u  resizes:     %10u  moved vertices: %llu\n",
+            stats.defragmentations, stats.resizes,
+            (unsigned long long) stats.movedVertices );
+    printf( "  fragmentation:    %9.1f %%\n", container->GetFragmentation() * 100.0 );
+}
+
+
+/**
+ * Struct BENCHMARK_CANVAS
+ * holds the VIEW the board is rendered in.  The Cairo backend renders to an image in
+ * memory and the VIEW is set up like PCB_DRAW_PANEL_GAL does it, without any window.
+ * The OpenGL backend uses a PCB_DRAW_PANEL_GAL in a shown frame.
+ */
+struct BENCHMARK_CANVAS
+{
+    BENCHMARK_CANVAS( bool aOpenGL ) :
+        m_view( NULL ), m_gal( NULL ), m_painter( NULL ), m_ratsnest( NULL ),
+        m_frame( NULL ), m_panel( NULL )
+    {
+        if( aOpenGL )
+        {
+            m_frame = new wxFrame( NULL, wxID_ANY, wxT( "view_benchmark" ), wxDefaultPosition,
+                                   wxSize( FRAME_WIDTH, FRAME_HEIGHT ) );
+            m_panel = new PCB_DRAW_PANEL_GAL( m_frame, wxID_ANY, wxPoint( 0, 0 ),
+                                              wxSize( FRAME_WIDTH, FRAME_HEIGHT ),
+                                              EDA_DRAW_PANEL_GAL::GAL_TYPE_OPENGL );
+
+            // OpenGL needs a visible window to create its context
+            m_frame->Show();
+
+            // Paint events are not wanted, frames are drawn only by the benchmark
+            m_panel->StopDrawing();
+            m_panel->GetGAL()->ResizeScreen( FRAME_WIDTH, FRAME_HEIGHT );
+
+            m_view = m_panel->GetView();
+        }
+        else
+        {
+            m_gal     = new KIGFX::CAIRO_GAL( FRAME_WIDTH, FRAME_HEIGHT );
+            m_painter = new KIGFX::PCB_PAINTER( m_gal );
+            m_view    = new KIGFX::VIEW( true );
+            m_view->SetPainter( m_painter );
+            m_view->SetGAL( m_gal );
+
+            PCB_DRAW_PANEL_GAL::SetupView( m_view );
+        }
+    }
+
+    ~BENCHMARK_CANVAS()
+    {
+        if( m_frame )
+        {
+            m_frame->Destroy();
+        }
+        else
+        {
+            delete m_view;
+            delete m_ratsnest;
+            delete m_painter;
+            delete m_gal;
+        }
+    }
+
+    /**
+     * Function DisplayBoard
+     * adds the board items to the VIEW and caches them, like PCB_DRAW_PANEL_GAL::DisplayBoard().
+     */
+    void DisplayBoard( BOARD* aBoard )
+    {
+        if( m_panel )
+        {
+            m_panel->DisplayBoard( aBoard );
+            return;
+        }
+
+        PCB_DRAW_PANEL_GAL::AddBoardItems( m_view, aBoard );
+
+        m_ratsnest = new KIGFX::RATSNEST_VIEWITEM( aBoard->GetRatsnest() );
+        m_view->Add( m_ratsnest );
+
+        static_cast<KIGFX::PCB_RENDER_SETTINGS*>( m_painter->GetSettings() )
+                ->ImportLegacyColors( aBoard->GetColorsSettings() );
+
+        m_view->RecacheAllItems( true );
+    }
+
+    KIGFX::VIEW*                m_view;
+
+    // Offscreen rendering (Cairo)
+    KIGFX::GAL*                 m_gal;
+    KIGFX::PAINTER*             m_painter;
+    KIGFX::RATSNEST_VIEWITEM*   m_ratsnest;
+
+    // Rendering in a window (OpenGL)
+    wxFrame*                    m_frame;
+    PCB_DRAW_PANEL_GAL*         m_panel;
+};
+
+
+/**
+ * Function runBenchmark
+ * loads the board, renders the scenarios and prints the results.
+ * @return the exit code of the program.
+ */
+static int runBenchmark( const wxString& aFileName, int aFrames, bool aOpenGL )
+{
+    IO_MGR::PCB_FILE_T pluginType = IO_MGR::LEGACY;
+
+    if( wxFileName( aFileName ).GetExt() == KiCadPcbFileExtension )
+        pluginType = IO_MGR::KICAD;
+
+    BOARD* board = NULL;
+    prof_counter loadTime;
+    prof_start( &loadTime );
+
+    try
+    {
+        board = IO_MGR::Load( pluginType, aFileName );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        fprintf( stderr, "%s\n", TO_UTF8( ioe.errorText ) );
+        return 1;
+    }
+
+    prof_end( &loadTime );
+
+    BENCHMARK_CANVAS canvas( aOpenGL );
+    KIGFX::VIEW* view = canvas.m_view;
+
+    prof_counter displayTime;
+    prof_start( &displayTime );
+    canvas.DisplayBoard( board );
+    prof_end( &displayTime );
+
+    EDA_RECT bbox = board->ComputeBoundingBox();
+    view->SetViewport( BOX2D( VECTOR2D( bbox.GetOrigin() ), VECTOR2D( bbox.GetSize() ) ) );
+
+    printf( "board:        %s\n", TO_UTF8( aFileName ) );
+    printf( "backend:      %s\n", aOpenGL ? "opengl" : "cairo (offscreen)" );
+    printf( "modules:      %u  tracks: %u  drawings: %u  nets: %u\n",
+            board->m_Modules.GetCount(), board->m_Track.GetCount(),
+            board->m_Drawings.GetCount(), board->GetNetCount() );
+    printf( "load:         %8.2f ms\n", loadTime.msecs() );
+    printf( "display:      %8.2f ms\n", displayTime.msecs() );
+
+    // Warm up, so the first frame does not include the deferred initialization
+    drawFrame( view );
+    view->ResetStats();
+
+    SCENARIO_RESULT fit = runScenario( view, aFrames, VECTOR2D( 0.0, 0.0 ) );
+    KIGFX::VIEW::STATS fitStats = view->GetStats();
+
+    view->SetScale( view->GetScale() * 8.0 );
+    SCENARIO_RESULT zoom = runScenario( view, aFrames, VECTOR2D( 0.0, 0.0 ) );
+    SCENARIO_RESULT pan  = runScenario( view, aFrames, VECTOR2D( 0.1, 0.05 ) );
+    KIGFX::VIEW::STATS zoomStats = view->GetStats();
+
+    view->ResetStats();
+    view->RecacheAllItems( true );
+
+    for( MODULE* module = board->m_Modules; module; module = module->Next() )
+    {
+        module->ViewUpdate( KIGFX::VIEW_ITEM::COLOR );
+
+        for( D_PAD* pad = module->Pads(); pad; pad = pad->Next() )
+            pad->ViewUpdate( KIGFX::VIEW_ITEM::COLOR );
+    }
+
+    for( TRACK* track = board->m_Track; track; track = track->Next() )
+        track->ViewUpdate( KIGFX::VIEW_ITEM::COLOR );
+
+    view->UpdateItems();
+
+    const KIGFX::VIEW::STATS& cacheStats = view->GetStats();
+
+    printf( "\n" );
+    printScenario( "fit", fit );
+    printScenario( "zoom x8", zoom );
+    printScenario( "pan", pan );
+
+    printf( "\nrecache:      %8.2f ms\n", cacheStats.recacheTime / 1000.0 );
+    printf( "update:       %8.2f ms (%d items)\n", cacheStats.updateTime / 1000.0,
+            cacheStats.updatedItems );
+
+    printf( "\nlast frame, whole board:\n" );
+    printLayerStats( board, fitStats );
+    printf( "\nlast frame, zoomed in:\n" );
+    printLayerStats( board, zoomStats );
+
+    printCacheStats( view->GetGAL() );
+
+    // The view items are removed from the view before the board is deleted
+    view->Clear();
+    delete board;
+
+    return 0;
+}
+
+
+/**
+ * Struct APP_VIEW_BENCHMARK
+ * does all the work in OnRun(), the program exits as soon as the benchmark is finished.
+ * It derives from wxAppConsole for the offscreen rendering, so the GUI is not initialized
+ * (it would fail without a display), and from wxApp for the OpenGL backend.
+ */
+template <class APP>
+struct APP_VIEW_BENCHMARK : public APP
+{
+    APP_VIEW_BENCHMARK( const wxString& aFileName, int aFrames, bool aOpenGL ) :
+        m_fileName( aFileName ), m_frames( aFrames ), m_openGL( aOpenGL ) {}
+
+    bool OnInit()
+    {
+        // The arguments are parsed in main()
+        return true;
+    }
+
+    int OnRun()
+    {
+        // Hand the program over to the KIFACE, so Pgm() is valid in the pcbnew code
+        int kifaceVersion;
+        KIFACE_GETTER( &kifaceVersion, KIFACE_VERSION, &program );
+
+        return runBenchmark( m_fileName, m_frames, m_openGL );
+    }
+
+private:
+    wxString    m_fileName;
+    int         m_frames;
+    bool        m_openGL;
+};
+
+
+int main( int argc, char** argv )
+{
+    long frames = 100;
+    bool openGL = false;
+
+    if( argc < 2 )
+    {
+        fprintf( stderr, "usage: view_benchmark <board file> [frames per scenario] "
+                         "[cairo|opengl]\n" );
+        return 1;
+    }
+
+    if( argc > 2 )
+    {
+        char* end;
+        frames = strtol( argv[2], &end, 10 );
+
+        if( *end != 0 || frames <= 0 )
+        {
+            fprintf( stderr, "invalid number of frames: %s\n", argv[2] );
+            return 1;
+        }
+    }
+
+    if( argc > 3 )
+    {
+        if( strcmp( argv[3], "opengl" ) == 0 )
+            openGL = true;
+        else if( strcmp( argv[3], "cairo" ) != 0 )
+        {
+            fprintf( stderr, "invalid backend: %s\n", argv[3] );
+            return 1;
+        }
+    }
+
+    wxString fileName = wxString::FromUTF8( argv[1] );
+
+    if( openGL )
+        wxApp::SetInstance( new APP_VIEW_BENCHMARK<wxApp>( fileName, frames, openGL ) );
+    else
+        wxApp::SetInstance( new APP_VIEW_BENCHMARK<wxAppConsole>( fileName, frames, openGL ) );
+
+    return wxEntry( argc, argv );
+}
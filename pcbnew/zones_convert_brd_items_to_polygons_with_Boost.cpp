@@ -47,7 +47,7 @@
 #include <cmath>
 
 #include <fctsys.h>
-#include <polygons_defs.h>
+#include <polygon_set.h>
 #include <wxPcbStruct.h>
 #include <trigo.h>
 
@@ -143,8 +143,8 @@ void ZONE_CONTAINER::AddClearanceAreasPolygonsToPolysList( BOARD* aPcb )
     static CPOLYGONS_LIST cornerBufferPolysToSubstract;
     cornerBufferPolysToSubstract.RemoveAllContours();
 
-    // This KI_POLYGON_SET is the area(s) to fill, with m_ZoneMinThickness/2
-    KI_POLYGON_SET polyset_zone_solid_areas;
+    // This POLYGON_SET is the area(s) to fill, with m_ZoneMinThickness/2
+    POLYGON_SET polyset_zone_solid_areas;
     int         margin = m_ZoneMinThickness / 2;
 
     /* First, creates the main polygon (i.e. the filled area using only one outline)
@@ -154,34 +154,14 @@ void ZONE_CONTAINER::AddClearanceAreasPolygonsToPolysList( BOARD* aPcb )
      * so m_ZoneMinThickness is the min thickness of the filled zones areas
      * the main polygon is stored in polyset_zone_solid_areas
      */
-#if 1
-    m_smoothedPoly->m_CornersList.ExportTo( polyset_zone_solid_areas );
+    polyset_zone_solid_areas.AddPolygonWithHoles( m_smoothedPoly->m_CornersList );
 
-    if( polyset_zone_solid_areas.size() == 0 )
+    if( polyset_zone_solid_areas.IsEmpty() )
         return;
 
-    // Extract holes (cutout areas) and add them to the hole buffer
-    KI_POLYGON_SET outlineHoles;
-
-    while( polyset_zone_solid_areas.size() > 1 )
-    {
-        outlineHoles.push_back( polyset_zone_solid_areas.back() );
-        polyset_zone_solid_areas.pop_back();
-    }
-
     // deflate main outline reserve room for thick outline
-    polyset_zone_solid_areas -= margin;
-    // inflate outline holes
-    if( outlineHoles.size() )
-        outlineHoles += margin;
-
-    if( outlineHoles.size() )
-        cornerBufferPolysToSubstract.ImportFrom( outlineHoles );
-#else
-    CPOLYGONS_LIST tmp;
-    m_smoothedPoly->m_CornersList.InflateOutline( tmp, -margin, true );
-    tmp.ExportTo( polyset_zone_solid_areas );
-#endif
+    // (holes, i.e. cutout areas, are inflated)
+    polyset_zone_solid_areas.Inflate( -margin, s_CircleToSegmentsCount );
 
     /* Calculates the clearance value that meet DRC requirements
      * from m_ZoneClearance and clearance from the corresponding netclass
@@ -443,15 +423,15 @@ void ZONE_CONTAINER::AddClearanceAreasPolygonsToPolysList( BOARD* aPcb )
     // Calculate now actual solid areas
     if( cornerBufferPolysToSubstract.GetCornersCount() > 0 )
     {
-        KI_POLYGON_SET polyset_holes;
-        cornerBufferPolysToSubstract.ExportTo( polyset_holes );
+        POLYGON_SET polyset_holes;
+        polyset_holes.AddOutlines( cornerBufferPolysToSubstract );
         // Remove holes from initial area.:
-        polyset_zone_solid_areas -= polyset_holes;
+        polyset_zone_solid_areas.BooleanSubtract( polyset_holes );
     }
 
     // put solid areas in m_FilledPolysList:
-    m_FilledPolysList.RemoveAllContours();
-    CopyPolygonsFromKiPolygonListToFilledPolysList( polyset_zone_solid_areas );
+    polyset_zone_solid_areas.Fracture();
+    CopyPolygonsFromPolygonSetToFilledPolysList( polyset_zone_solid_areas );
 
     // Remove insulated islands:
     if( GetNetCode() > 0 )
@@ -469,15 +449,15 @@ void ZONE_CONTAINER::AddClearanceAreasPolygonsToPolysList( BOARD* aPcb )
     // remove copper areas corresponding to not connected stubs
     if( cornerBufferPolysToSubstract.GetCornersCount() )
     {
-        KI_POLYGON_SET polyset_holes;
-        cornerBufferPolysToSubstract.ExportTo( polyset_holes );
+        POLYGON_SET polyset_holes;
+        polyset_holes.AddOutlines( cornerBufferPolysToSubstract );
 
         // Remove unconnected stubs
-        polyset_zone_solid_areas -= polyset_holes;
+        polyset_zone_solid_areas.BooleanSubtract( polyset_holes );
 
         // put these areas in m_FilledPolysList
-        m_FilledPolysList.RemoveAllContours();
-        CopyPolygonsFromKiPolygonListToFilledPolysList( polyset_zone_solid_areas );
+        polyset_zone_solid_areas.Fracture();
+        CopyPolygonsFromPolygonSetToFilledPolysList( polyset_zone_solid_areas );
 
         if( GetNetCode() > 0 )
             TestForCopperIslandAndRemoveInsulatedIslands( aPcb );
@@ -487,14 +467,8 @@ void ZONE_CONTAINER::AddClearanceAreasPolygonsToPolysList( BOARD* aPcb )
 }
 
 
-void ZONE_CONTAINER::CopyPolygonsFromKiPolygonListToFilledPolysList( KI_POLYGON_SET& aKiPolyList )
+void ZONE_CONTAINER::CopyPolygonsFromPolygonSetToFilledPolysList( const POLYGON_SET& aPolySet )
 {
     m_FilledPolysList.RemoveAllContours();
-    m_FilledPolysList.ImportFrom( aKiPolyList );
-}
-
-
-void ZONE_CONTAINER::CopyPolygonsFromFilledPolysListToKiPolygonList( KI_POLYGON_SET& aKiPolyList )
-{
-    m_FilledPolysList.ExportTo( aKiPolyList );
+    aPolySet.ExportTo( m_FilledPolysList );
 }
@@ -45,6 +45,7 @@
 #include <bezier_curves.h>
 #include <polygon_test_point_inside.h>
 #include <math_for_graphics.h>
+#include <polygon_set.h>
 #include <polygon_test_point_inside.h>
 
 
@@ -1443,39 +1444,17 @@ void CPOLYGONS_LIST::ImportFrom( ClipperLib::Paths& aPolygons )
  */
 void CPOLYGONS_LIST::InflateOutline( CPOLYGONS_LIST& aResult, int aInflateValue, bool aLinkHoles )
 {
-    KI_POLYGON_SET polyset_outline;
-    ExportTo( polyset_outline );
+    POLYGON_SET polyset;
 
-    // Extract holes (cutout areas) and add them to the hole buffer
-    KI_POLYGON_SET outlineHoles;
+    // The main outline is inflated, and holes are deflated
+    polyset.AddPolygonWithHoles( *this );
+    polyset.Inflate( aInflateValue, 32 );
 
-    while( polyset_outline.size() > 1 )
-    {
-        outlineHoles.push_back( polyset_outline.back() );
-        polyset_outline.pop_back();
-    }
-
-    // inflate main outline
-    if( polyset_outline.size() )
-        polyset_outline += aInflateValue;
+    // Without linking, outlines and holes are separate contours
+    if( aLinkHoles )
+        polyset.Fracture();
 
-    // deflate outline holes
-    if( outlineHoles.size() )
-        outlineHoles -= aInflateValue;
-
-    // Copy modified polygons
-    if( !aLinkHoles )
-    {
-        aResult.ImportFrom( polyset_outline );
-
-        if( outlineHoles.size() )
-            aResult.ImportFrom( outlineHoles );
-    }
-    else
-    {
-        polyset_outline -= outlineHoles;
-        aResult.ImportFrom( polyset_outline );
-    }
+    polyset.ExportTo( aResult );
 }
 
 /**
@@ -1507,50 +1486,16 @@ void ConvertPolysListWithHolesToOnePolygon( const CPOLYGONS_LIST& aPolysListWith
     }
 
     // Holes are found: convert them to only one polygon with overlap segments
-    KI_POLYGON_SET polysholes;
-    KI_POLYGON_SET mainpoly;
-    KI_POLYGON poly_tmp;
-    std::vector<KI_POLY_POINT> cornerslist;
-    corners_count = aPolysListWithHoles.GetCornersCount();
-
-    unsigned ic    = 0;
-    // enter main outline
-    while( ic < corners_count )
-    {
-        const CPolyPt& corner = aPolysListWithHoles.GetCorner( ic++ );
-        cornerslist.push_back( KI_POLY_POINT( corner.x, corner.y ) );
-
-        if( corner.end_contour )
-            break;
-    }
-    bpl::set_points( poly_tmp, cornerslist.begin(), cornerslist.end() );
-    mainpoly.push_back( poly_tmp );
-
-    while( ic < corners_count )
-    {
-        cornerslist.clear();
-        {
-            while( ic < corners_count )
-            {
-                const CPolyPt& corner = aPolysListWithHoles.GetCorner( ic++ );
-                cornerslist.push_back( KI_POLY_POINT( corner.x, corner.y ) );
-
-                if( corner.end_contour )
-                    break;
-            }
-
-            bpl::set_points( poly_tmp, cornerslist.begin(), cornerslist.end() );
-            polysholes.push_back( poly_tmp );
-        }
-    }
+    POLYGON_SET polyset;
 
-    mainpoly -= polysholes;
+    polyset.AddPolygonWithHoles( aPolysListWithHoles );
+    polyset.Fracture();
 
     // copy polygon with no holes to destination
     // Because all holes are now linked to the main outline
     // by overlapping segments, we should have only one polygon in list
-    wxASSERT( mainpoly.size() == 1 );
-    aOnePolyList.ImportFrom( mainpoly );
+    wxASSERT( polyset.ContourCount() == 1 );
+    polyset.ExportTo( aOnePolyList );
 }
 
 /**
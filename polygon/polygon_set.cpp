@@ -0,0 +1,287 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2015 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file polygon_set.cpp
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <vector>
+
+#include <PolyLine.h>
+#include <polygon_set.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+using namespace ClipperLib;
+
+
+unsigned POLYGON_SET::addContour( const CPOLYGONS_LIST& aList, unsigned aFirst )
+{
+    unsigned count = aList.GetCornersCount();
+    unsigned ii;
+    Path     path;
+
+    for( ii = aFirst; ii < count; ii++ )
+    {
+        const CPolyPt& corner = aList.GetCorner( ii );
+
+        path.push_back( IntPoint( corner.x, corner.y ) );
+
+        if( corner.end_contour )
+            break;
+    }
+
+    if( path.size() >= 3 )
+    {
+        // Contours are stored with a positive orientation
+        if( !Orientation( path ) )
+            ReversePath( path );
+
+        m_paths.push_back( Path() );
+        m_paths.back().swap( path );
+    }
+
+    return ii + 1;
+}
+
+
+void POLYGON_SET::AddOutlines( const CPOLYGONS_LIST& aList )
+{
+    unsigned ii = 0;
+
+    while( ii < aList.GetCornersCount() )
+        ii = addContour( aList, ii );
+}
+
+
+void POLYGON_SET::AddPolygonWithHoles( const CPOLYGONS_LIST& aList )
+{
+    // Holes can overlap each other or cross the outline, so they cannot be added with
+    // a negative orientation (the winding would be -1 there): they are subtracted
+    // from the outline, and the result is added with the holes which remain inside it.
+    POLYGON_SET outline;
+    POLYGON_SET holes;
+    unsigned    ii = outline.addContour( aList, 0 );
+
+    while( ii < aList.GetCornersCount() )
+        ii = holes.addContour( aList, ii );
+
+    if( holes.IsEmpty() )
+    {
+        m_paths.insert( m_paths.end(), outline.m_paths.begin(), outline.m_paths.end() );
+        return;
+    }
+
+    outline.BooleanSubtract( holes );
+    m_paths.insert( m_paths.end(), outline.m_paths.begin(), outline.m_paths.end() );
+}
+
+
+void POLYGON_SET::booleanOp( ClipType aType, const POLYGON_SET& aOther )
+{
+    Clipper clipper;
+
+    clipper.AddPaths( m_paths, ptSubject, true );
+    clipper.AddPaths( aOther.m_paths, ptClip, true );
+
+    clipper.Execute( aType, m_paths, pftNonZero, pftNonZero );
+}
+
+
+void POLYGON_SET::BooleanAdd( const POLYGON_SET& aOther )
+{
+    booleanOp( ctUnion, aOther );
+}
+
+
+void POLYGON_SET::BooleanSubtract( const POLYGON_SET& aOther )
+{
+    booleanOp( ctDifference, aOther );
+}
+
+
+void POLYGON_SET::Simplify()
+{
+    booleanOp( ctUnion, POLYGON_SET() );
+}
+
+
+void POLYGON_SET::Inflate( int aAmount, int aCircleSegmentsCount )
+{
+    // Linked holes would be opened by a deflate, and overlapping outlines do not give
+    // the right result: offset only separate outlines and holes
+    Simplify();
+
+    if( aAmount == 0 )
+        return;
+
+    ClipperOffset offset;
+
+    // Max distance between the arc and its segments
+    offset.ArcTolerance = std::abs( aAmount ) * ( 1.0 - cos( M_PI / aCircleSegmentsCount ) );
+    offset.AddPaths( m_paths, jtRound, etClosedPolygon );
+    offset.Execute( m_paths, aAmount );
+}
+
+
+void POLYGON_SET::Fracture()
+{
+    Clipper     clipper;
+    PolyTree    tree;
+
+    clipper.AddPaths( m_paths, ptSubject, true );
+    clipper.Execute( ctUnion, tree, pftNonZero, pftNonZero );
+
+    m_paths.clear();
+
+    // The children of an outline are its holes
+    for( PolyNode* node = tree.GetFirst(); node; node = node->GetNext() )
+    {
+        if( !node->IsHole() )
+            fractureSingle( node->Contour, node->Childs );
+    }
+}
+
+
+/// Returns the index of the leftmost (then lowest) corner of aPath
+static unsigned leftmostCorner( const Path& aPath )
+{
+    unsigned best = 0;
+
+    for( unsigned ii = 1; ii < aPath.size(); ii++ )
+    {
+        if( aPath[ii].X < aPath[best].X ||
+            ( aPath[ii].X == aPath[best].X && aPath[ii].Y < aPath[best].Y ) )
+            best = ii;
+    }
+
+    return best;
+}
+
+
+void POLYGON_SET::fractureSingle( const Path& aOutline, const PolyNodes& aHoles )
+{
+    Path outline = aOutline;
+
+    // Holes are linked from left to right: the horizontal bridge going left from the
+    // leftmost corner of a hole can only cross the outline or holes already linked to it.
+    std::vector< std::pair<cInt, unsigned> > order;
+
+    for( unsigned ii = 0; ii < aHoles.size(); ii++ )
+    {
+        const Path& hole = aHoles[ii]->Contour;
+
+        if( hole.size() )
+            order.push_back( std::make_pair( hole[leftmostCorner( hole )].X, ii ) );
+    }
+
+    std::sort( order.begin(), order.end() );
+
+    Path linked;
+
+    for( unsigned ii = 0; ii < order.size(); ii++ )
+    {
+        const Path& hole  = aHoles[order[ii].second]->Contour;
+        unsigned    start = leftmostCorner( hole );
+        IntPoint    p = hole[start];
+
+        // Find the nearest outline edge crossed by the horizontal line going left from p
+        int         edge = -1;
+        double      edgeX = 0.0;
+        unsigned    count = outline.size();
+
+        for( unsigned jj = 0; jj < count; jj++ )
+        {
+            const IntPoint& a = outline[jj];
+            const IntPoint& b = outline[ jj + 1 < count ? jj + 1 : 0 ];
+
+            if( ( a.Y <= p.Y && b.Y > p.Y ) || ( b.Y <= p.Y && a.Y > p.Y ) )
+            {
+                double x = a.X + double( p.Y - a.Y ) * double( b.X - a.X ) / double( b.Y - a.Y );
+
+                if( x <= p.X && ( edge < 0 || x > edgeX ) )
+                {
+                    edge = jj;
+                    edgeX = x;
+                }
+            }
+        }
+
+        if( edge < 0 )      // Should not happen: keep the hole as a separate contour
+        {
+            m_paths.push_back( hole );
+            continue;
+        }
+
+        IntPoint        bridge( cInt( floor( edgeX + 0.5 ) ), p.Y );
+        const IntPoint& a = outline[edge];
+        const IntPoint& b = outline[ edge + 1 < int( count ) ? edge + 1 : 0 ];
+
+        linked.clear();
+        linked.reserve( count + hole.size() + 3 );
+        linked.insert( linked.end(), outline.begin(), outline.begin() + edge + 1 );
+
+        if( bridge != a )
+            linked.push_back( bridge );
+
+        // The whole hole, from its leftmost corner and back to it
+        linked.insert( linked.end(), hole.begin() + start, hole.end() );
+        linked.insert( linked.end(), hole.begin(), hole.begin() + start + 1 );
+
+        if( bridge != b )
+            linked.push_back( bridge );
+
+        linked.insert( linked.end(), outline.begin() + edge + 1, outline.end() );
+
+        outline.swap( linked );
+    }
+
+    m_paths.push_back( Path() );
+    m_paths.back().swap( outline );
+}
+
+
+void POLYGON_SET::ExportTo( CPOLYGONS_LIST& aList ) const
+{
+    unsigned count = aList.GetCornersCount();
+
+    for( unsigned ii = 0; ii < m_paths.size(); ii++ )
+        count += m_paths[ii].size();
+
+    aList.reserve( count );
+
+    for( unsigned ii = 0; ii < m_paths.size(); ii++ )
+    {
+        const Path& path = m_paths[ii];
+
+        for( unsigned jj = 0; jj < path.size(); jj++ )
+            aList.AddCorner( CPolyPt( int( path[jj].X ), int( path[jj].Y ) ) );
+
+        aList.CloseLastContour();
+    }
+}
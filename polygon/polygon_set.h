@@ -0,0 +1,129 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2015 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file polygon_set.h
+ * @brief a set of polygons with holes, and the boolean operations on it, using Clipper.
+ */
+
+#ifndef POLYGON_SET_H
+#define POLYGON_SET_H
+
+#include <clipper.hpp>
+
+class CPOLYGONS_LIST;
+
+
+/**
+ * Class POLYGON_SET
+ * stores a set of polygons with holes as ClipperLib::Paths, and performs the boolean
+ * operations (union, subtraction), inflate/deflate and fracture on it, so a polygon
+ * calculation is done with only one copy of the corners from and to CPOLYGONS_LIST.
+ *
+ * The set is filled with the non zero rule: overlapping outlines are allowed, as well
+ * as contours having holes linked to the outline by overlapping segments (as
+ * CPOLYGONS_LIST stores them).  Separate holes are only found in the results of the
+ * operations, inside their outline and with a negative orientation.
+ */
+class POLYGON_SET
+{
+public:
+    POLYGON_SET() {}
+
+    void RemoveAllPolygons() { m_paths.clear(); }
+
+    bool IsEmpty() const { return m_paths.empty(); }
+
+    /// @return the count of contours (outlines and holes, or outlines after Fracture())
+    int ContourCount() const { return m_paths.size(); }
+
+    const ClipperLib::Paths& GetPaths() const { return m_paths; }
+
+    /**
+     * Function AddOutlines
+     * adds each contour of \a aList as a filled outline, whatever its orientation.
+     * A contour can have holes linked to it by overlapping segments.
+     */
+    void AddOutlines( const CPOLYGONS_LIST& aList );
+
+    /**
+     * Function AddPolygonWithHoles
+     * adds the first contour of \a aList as an outline, and the other contours
+     * as holes in this outline, like in zone outlines.  The holes are subtracted
+     * from the outline, so they can overlap each other or cross the outline.
+     */
+    void AddPolygonWithHoles( const CPOLYGONS_LIST& aList );
+
+    /// Adds the polygons of \a aOther to this set (union)
+    void BooleanAdd( const POLYGON_SET& aOther );
+
+    /// Removes the polygons of \a aOther from this set (difference)
+    void BooleanSubtract( const POLYGON_SET& aOther );
+
+    /**
+     * Function Simplify
+     * merges the overlapping polygons, so the set contains only non overlapping
+     * outlines, and their holes as separate contours.
+     */
+    void Simplify();
+
+    /**
+     * Function Inflate
+     * inflates (or deflates, when \a aAmount < 0) the polygons, with round corners.
+     * Holes are deflated (or inflated) accordingly.
+     * @param aAmount = the inflate value
+     * @param aCircleSegmentsCount = the count of segments of a full circle, to
+     *  approximate the round corners.
+     */
+    void Inflate( int aAmount, int aCircleSegmentsCount );
+
+    /**
+     * Function Fracture
+     * converts the set to outlines without holes: each hole is linked to its outline
+     * by two overlapping segments, so every polygon is stored in only one contour,
+     * which is what CPOLYGONS_LIST users (plot, draw, zone filled areas) expect.
+     */
+    void Fracture();
+
+    /**
+     * Function ExportTo
+     * appends all the contours to \a aList.  Call Fracture() before to get outlines
+     * with linked holes.
+     */
+    void ExportTo( CPOLYGONS_LIST& aList ) const;
+
+private:
+    /// Adds a contour of aList, starting at corner aFirst, with a positive orientation.
+    /// @return the index of the first corner after the contour.
+    unsigned addContour( const CPOLYGONS_LIST& aList, unsigned aFirst );
+
+    void booleanOp( ClipperLib::ClipType aType, const POLYGON_SET& aOther );
+
+    /// Links aHoles to aOutline, and adds the result to m_paths
+    void fractureSingle( const ClipperLib::Path& aOutline,
+                         const ClipperLib::PolyNodes& aHoles );
+
+    ClipperLib::Paths m_paths;
+};
+
+#endif  // POLYGON_SET_H
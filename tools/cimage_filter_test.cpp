@@ -0,0 +1,157 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2015 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/*
+ * Checks CIMAGE::EfxFilter() gives the same images as a 5x5 filter applied pixel by
+ * pixel with Getpixel(), the way it was done before, and compares their speed on
+ * the 512x512 images of the shadows of the 3D viewer.
+ *
+ * usage: cimage_filter_test [blur pass count]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <common.h>
+#include <CImage.h>
+
+
+/// The filter kernels of CImage.cpp, in the E_FILTER order
+static const S_FILTER refFilters[] =
+{
+    // Hi Pass
+    { { { 0, -1, -1, -1,  0}, {-1,  2, -4,  2, -1}, {-1, -4, 13, -4, -1},
+        {-1,  2, -4,  2, -1}, { 0, -1, -1, -1,  0} }, 7, 255 },
+    // Blur
+    { { { 3,  5,  7,  5,  3}, { 5,  9, 12,  9,  5}, { 7, 12, 20, 12,  7},
+        { 5,  9, 12,  9,  5}, { 3,  5,  7,  5,  3} }, 182, 0 },
+    // Blur Invert
+    { { { 0,  0,  0,  0,  0}, { 0,  0, -1,  0,  0}, { 0, -1,  0, -1,  0},
+        { 0,  0, -1,  0,  0}, { 0,  0,  0,  0,  0} }, 4, 255 }
+};
+
+
+static void refFilter( CIMAGE& aOutImg, const CIMAGE& aInImg, unsigned aWidth,
+                       unsigned aHeight, E_FILTER aFilterType )
+{
+    const S_FILTER& filter = refFilters[aFilterType];
+
+    for( int iy = 0; iy < (int) aHeight; iy++ )
+    {
+        for( int ix = 0; ix < (int) aWidth; ix++ )
+        {
+            int v = 0;
+
+            for( int sy = 0; sy < 5; sy++ )
+            {
+                for( int sx = 0; sx < 5; sx++ )
+                    v += aInImg.Getpixel( ix + sx - 2, iy + sy - 2 ) * filter.kernel[sx][sy];
+            }
+
+            v /= filter.div;
+            v += filter.offset;
+            v = v < 0 ? 0 : ( v > 255 ? 255 : v );
+
+            aOutImg.Setpixel( ix, iy, v );
+        }
+    }
+}
+
+
+static void randomImage( CIMAGE& aImg, unsigned aSize )
+{
+    unsigned char* pixels = aImg.GetBuffer();
+
+    // Smooth random shapes, like a depth buffer, and some noise
+    for( unsigned ii = 0; ii < aSize; ii++ )
+        pixels[ii] = ( ii % 7 ) ? pixels[ii ? ii - 1 : 0] : rand() % 256;
+}
+
+
+int main( int argc, char** argv )
+{
+    int passes = argc > 1 ? atoi( argv[1] ) : 10;
+    int errors = 0;
+
+    srand( 1 );
+
+    // Small sizes check the borders
+    static const unsigned sizes[][2] = { { 1, 1 }, { 2, 3 }, { 4, 4 }, { 5, 5 }, { 7, 2 },
+                                         { 37, 19 }, { 512, 512 } };
+
+    for( unsigned ii = 0; ii < sizeof( sizes ) / sizeof( sizes[0] ); ii++ )
+    {
+        unsigned w = sizes[ii][0];
+        unsigned h = sizes[ii][1];
+
+        CIMAGE in( w, h );
+        CIMAGE out( w, h );
+        CIMAGE ref( w, h );
+
+        randomImage( in, w * h );
+
+        for( int filter = FILTER_HIPASS; filter <= FILTER_INVERT_BLUR; filter++ )
+        {
+            out.EfxFilter( &in, (E_FILTER) filter );
+            refFilter( ref, in, w, h, (E_FILTER) filter );
+
+            if( memcmp( out.GetBuffer(), ref.GetBuffer(), w * h ) )
+            {
+                printf( "filter %d on %ux%u: the images are different\n", filter, w, h );
+                errors++;
+            }
+        }
+    }
+
+    // The blur passes of the board shadow
+    CIMAGE img( 512, 512 );
+    CIMAGE aux( 512, 512 );
+
+    randomImage( img, 512 * 512 );
+
+    unsigned start = GetRunningMicroSecs();
+
+    for( int ii = 0; ii < passes; ii++ )
+    {
+        refFilter( aux, img, 512, 512, FILTER_GAUSSIAN_BLUR );
+        refFilter( img, aux, 512, 512, FILTER_GAUSSIAN_BLUR );
+    }
+
+    unsigned refTime = GetRunningMicroSecs() - start;
+
+    start = GetRunningMicroSecs();
+
+    for( int ii = 0; ii < passes; ii++ )
+    {
+        aux.EfxFilter( &img, FILTER_GAUSSIAN_BLUR );
+        img.EfxFilter( &aux, FILTER_GAUSSIAN_BLUR );
+    }
+
+    unsigned time = GetRunningMicroSecs() - start;
+
+    printf( "%d blur passes on 512x512: Getpixel: %u usecs  EfxFilter: %u usecs\n",
+            passes, refTime, time );
+
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,125 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2015 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/*
+ * Compare the speed of the keyword lookups of DSNLEXER: the generated
+ * switch of PCB_LEXER and the KEYWORD_MAP hashtable, by lexing a *.kicad_pcb
+ * file with both.
+ *
+ * usage: dsnlexer_test <file.kicad_pcb> [repeat count]
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <vector>
+
+#include <common.h>
+#include <pcb_lexer.h>
+
+
+/// Lex the whole file, return the count of keyword tokens
+static int lexFile( DSNLEXER& aLexer )
+{
+    int keywords = 0;
+    int tok;
+
+    while( ( tok = aLexer.NextTok() ) != DSN_EOF )
+    {
+        if( tok >= 0 )
+            ++keywords;
+    }
+
+    return keywords;
+}
+
+
+int main( int argc, char** argv )
+{
+    if( argc < 2 )
+    {
+        fprintf( stderr, "usage: %s <file.kicad_pcb> [repeat count]\n", argv[0] );
+        return 1;
+    }
+
+    int repeat = argc > 2 ? atoi( argv[2] ) : 10;
+
+    // Same keywords as PCB_LEXER, but looked up through the hashtable since
+    // no KEYWORD_FINDER is given to DSNLEXER.
+    std::vector<KEYWORD> keywords;
+
+    for( int tok = 0; strcmp( PCB_LEXER::TokenName( (PCB_KEYS_T::T) tok ), "token too big" ); ++tok )
+    {
+        KEYWORD kw = { PCB_LEXER::TokenName( (PCB_KEYS_T::T) tok ), tok };
+        keywords.push_back( kw );
+    }
+
+    try
+    {
+        unsigned hashTime = 0;
+        unsigned switchTime = 0;
+        int      hashCount = 0;
+        int      switchCount = 0;
+
+        for( int i = 0; i < repeat; ++i )
+        {
+            FILE*    fp = fopen( argv[1], "rt" );
+
+            if( !fp )
+            {
+                fprintf( stderr, "cannot open %s\n", argv[1] );
+                return 1;
+            }
+
+            unsigned start = GetRunningMicroSecs();
+            DSNLEXER hashLexer( &keywords[0], keywords.size(), fp, FROM_UTF8( argv[1] ) );
+
+            hashCount = lexFile( hashLexer );
+            hashTime += GetRunningMicroSecs() - start;
+
+            fp = fopen( argv[1], "rt" );
+
+            if( !fp )
+            {
+                fprintf( stderr, "cannot open %s\n", argv[1] );
+                return 1;
+            }
+
+            start = GetRunningMicroSecs();
+            PCB_LEXER switchLexer( fp, FROM_UTF8( argv[1] ) );
+
+            switchCount = lexFile( switchLexer );
+            switchTime += GetRunningMicroSecs() - start;
+        }
+
+        printf( "hashtable: %d keywords, %u usecs\n", hashCount, hashTime / repeat );
+        printf( "switch:    %d keywords, %u usecs\n", switchCount, switchTime / repeat );
+
+        return hashCount == switchCount ? 0 : 1;
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        fprintf( stderr, "%s\n", TO_UTF8( ioe.errorText ) );
+        return 1;
+    }
+}
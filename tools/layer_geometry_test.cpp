@@ -0,0 +1,199 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2015 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/*
+ * Build the 3D viewer geometry of copper layers without OpenGL context, the way
+ * EDA_3D_CANVAS::buildBoard3DView() does it: random tracks and pads are merged, the
+ * holes removed, and the result triangulated by S3D_LAYER_GEOMETRY.
+ * Checks the area of the triangles against the area of the polygons, and compares
+ * the time of a build layer after layer and of a parallel build (when built with OpenMP).
+ *
+ * usage: layer_geometry_test [layer count] [track count by layer]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+
+#include <common.h>
+#include <PolyLine.h>
+#include <polygon_set.h>
+#include <convert_basic_shapes_to_polygon.h>
+#include <3d_layer_geometry.h>
+
+
+static const int    MM = 1000000;          // pcbnew internal units are nanometers
+static const double BIU_TO_3D = 1.0 / MM;   // 3D units are mm in this test
+
+
+/// @return a random value from 0 to aMax - 1 (RAND_MAX may be only 32767)
+static int randInt( int aMax )
+{
+    return int( ( (unsigned) rand() * 32768u + (unsigned) rand() ) % (unsigned) aMax );
+}
+
+
+/// The polygons of a layer, and its triangles
+struct TEST_LAYER
+{
+    CPOLYGONS_LIST      m_Polys;
+    S3D_LAYER_GEOMETRY  m_Geometry;
+    double              m_Area;         // area of the merged polygons, in mm2
+};
+
+
+static void buildLayer( TEST_LAYER& aLayer, const CPOLYGONS_LIST& aHoles )
+{
+    POLYGON_SET polyset;
+    POLYGON_SET holes;
+
+    polyset.AddOutlines( aLayer.m_Polys );
+    holes.AddOutlines( aHoles );
+    polyset.BooleanSubtract( holes );
+
+    aLayer.m_Area = 0.0;
+
+    for( int ii = 0; ii < polyset.ContourCount(); ii++ )
+        aLayer.m_Area += ClipperLib::Area( polyset.GetPaths()[ii] ) * BIU_TO_3D * BIU_TO_3D;
+
+    // A polygon area without thickness, to compare the areas
+    aLayer.m_Geometry.Clear();
+    aLayer.m_Geometry.AddSolidHorizontalPolygonSet( polyset, 0, 0, BIU_TO_3D, 1.0f );
+}
+
+
+/// @return the area of the triangles of aGeometry, in mm2
+static double trianglesArea( const S3D_LAYER_GEOMETRY& aGeometry )
+{
+    const std::vector<float>&    vertices = aGeometry.GetVertices();
+    const std::vector<unsigned>& indices = aGeometry.GetIndices();
+    double                       area = 0.0;
+
+    for( unsigned ii = 0; ii < indices.size(); ii += 3 )
+    {
+        const float* a = &vertices[indices[ii] * 3];
+        const float* b = &vertices[indices[ii + 1] * 3];
+        const float* c = &vertices[indices[ii + 2] * 3];
+
+        area += fabs( ( b[0] - a[0] ) * ( c[1] - a[1] ) - ( c[0] - a[0] ) * ( b[1] - a[1] ) ) / 2;
+    }
+
+    return area;
+}
+
+
+int main( int argc, char** argv )
+{
+    int layerCount = argc > 1 ? atoi( argv[1] ) : 8;
+    int trackCount = argc > 2 ? atoi( argv[2] ) : 5000;
+    int boardSize = 100 * MM;
+    int segcount = 18;
+    double correction = 1.0 / cos( M_PI / ( segcount * 2.0 ) );
+
+    srand( 1 );
+
+    // Through holes, common to all layers
+    CPOLYGONS_LIST holes;
+
+    for( int ii = 0; ii < trackCount / 10; ii++ )
+    {
+        wxPoint pos( randInt( boardSize ), randInt( boardSize ) );
+        TransformCircleToPolygon( holes, pos, int( 0.4 * MM ), 12 );
+    }
+
+    std::vector<TEST_LAYER> layers( layerCount );
+
+    for( int layer = 0; layer < layerCount; layer++ )
+    {
+        CPOLYGONS_LIST& polys = layers[layer].m_Polys;
+
+        for( int ii = 0; ii < trackCount; ii++ )
+        {
+            wxPoint start( randInt( boardSize ), randInt( boardSize ) );
+            wxPoint end( start.x + randInt( 10 * MM ), start.y + randInt( 10 * MM ) );
+
+            TransformRoundedEndsSegmentToPolygon( polys, start, end, segcount,
+                                                  int( 0.25 * MM * correction ) );
+        }
+
+        for( int ii = 0; ii < trackCount / 5; ii++ )
+        {
+            wxPoint pos( randInt( boardSize ), randInt( boardSize ) );
+            TransformCircleToPolygon( polys, pos, int( 0.8 * MM * correction ), segcount );
+        }
+    }
+
+    // Layer after layer
+    unsigned start = GetRunningMicroSecs();
+
+    for( int ii = 0; ii < layerCount; ii++ )
+        buildLayer( layers[ii], holes );
+
+    unsigned serialTime = GetRunningMicroSecs() - start;
+
+    std::vector<unsigned> triangleCounts;
+
+    for( int ii = 0; ii < layerCount; ii++ )
+        triangleCounts.push_back( layers[ii].m_Geometry.GetTriangleCount() );
+
+    // All layers together
+    start = GetRunningMicroSecs();
+
+    #ifdef USE_OPENMP
+    #pragma omp parallel for schedule(dynamic)
+    #endif /* USE_OPENMP */
+
+    for( int ii = 0; ii < layerCount; ii++ )
+        buildLayer( layers[ii], holes );
+
+    unsigned parallelTime = GetRunningMicroSecs() - start;
+
+    int errors = 0;
+
+    for( int ii = 0; ii < layerCount; ii++ )
+    {
+        const TEST_LAYER& layer = layers[ii];
+        double            area = trianglesArea( layer.m_Geometry );
+
+        printf( "layer %d: %u triangles, polygon area %.3f mm2, triangle area %.3f mm2\n",
+                ii, layer.m_Geometry.GetTriangleCount(), layer.m_Area, area );
+
+        if( fabs( area - layer.m_Area ) > layer.m_Area * 1e-6 )
+        {
+            printf( "  the triangles do not cover the polygons\n" );
+            errors++;
+        }
+
+        if( layer.m_Geometry.GetTriangleCount() != triangleCounts[ii] )
+        {
+            printf( "  the parallel build gives %u triangles instead of %u\n",
+                    layer.m_Geometry.GetTriangleCount(), triangleCounts[ii] );
+            errors++;
+        }
+    }
+
+    printf( "layer after layer: %u usecs  parallel: %u usecs\n", serialTime, parallelTime );
+
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,119 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2015 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/*
+ * Checks that ParseDouble() gives the same doubles as strtod() in the C locale for
+ * nanometer BIUs written as millimeters, the way the board writers do it (see
+ * test-nm-biu-to-ascii-mm-round-tripping.cpp), and compares their speed.
+ *
+ * usage: parse_double_test [value count]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+
+#include <common.h>
+#include <kicad_string.h>
+
+
+static std::string biuFmt( int aValue )
+{
+    double  engUnits = aValue / 1e6;
+    char    temp[48];
+    int     len;
+
+    if( engUnits != 0.0 && fabs( engUnits ) <= 0.0001 )
+    {
+        len = snprintf( temp, sizeof( temp ), "%.10f", engUnits );
+
+        while( --len > 0 && temp[len] == '0' )
+            temp[len] = '\0';
+
+        ++len;
+    }
+    else
+    {
+        len = snprintf( temp, sizeof( temp ), "%.10g", engUnits );
+    }
+
+    return std::string( temp, len );
+}
+
+
+int main( int argc, char** argv )
+{
+    LOCALE_IO   toggle;     // strtod() needs the C locale, ParseDouble() does not
+
+    int count = argc > 1 ? atoi( argv[1] ) : 1000000;
+
+    std::vector<std::string> values;
+
+    srand( 1 );
+
+    for( int i = 0; i < count; ++i )
+    {
+        // coordinates of up to +/- 1 meter, RAND_MAX may be only 32767
+        unsigned r = (unsigned) rand() * 32768u + (unsigned) rand();
+        int biu = int( r % 2000000001u ) - 1000000000;
+        values.push_back( biuFmt( biu ) );
+    }
+
+    unsigned    mismatches = 0;
+    double      sum = 0.0;
+
+    unsigned start = GetRunningMicroSecs();
+
+    for( int i = 0; i < count; ++i )
+        sum += strtod( values[i].c_str(), NULL );
+
+    unsigned strtodTime = GetRunningMicroSecs() - start;
+
+    start = GetRunningMicroSecs();
+
+    for( int i = 0; i < count; ++i )
+        sum += ParseDouble( values[i].c_str() );
+
+    unsigned parseTime = GetRunningMicroSecs() - start;
+
+    for( int i = 0; i < count; ++i )
+    {
+        const char* text = values[i].c_str();
+        double      expected = strtod( text, NULL );
+        double      result = ParseDouble( text );
+
+        if( memcmp( &expected, &result, sizeof( double ) ) )
+        {
+            printf( "%s: strtod:%.17g ParseDouble:%.17g\n", text, expected, result );
+            ++mismatches;
+        }
+    }
+
+    printf( "strtod: %u usecs  ParseDouble: %u usecs  (%g)\n", strtodTime, parseTime, sum );
+    printf( "mismatches:%u\n", mismatches );
+
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,260 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2015 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/*
+ * Reads the "point" and "coordIndex" lists of VRML files with VRML_READER, the way
+ * the VRML parsers of the 3D viewer do it, and with the stdio functions (fgetc, ungetc
+ * and fscanf) they used before.  Checks both give the same vertices and indices, and
+ * compares their speed.
+ * Without file names, a model of random vertices and triangles is written and read.
+ *
+ * usage: vrml_reader_test [VRML files]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include <common.h>
+#include <vrml_aux.h>
+
+
+/// The lists read from a file
+struct MODEL_LISTS
+{
+    std::vector<glm::vec3>  m_points;
+    std::vector<int>        m_indices;
+};
+
+
+// The stdio based reading, as it was done in vrml_aux.cpp and vrml_v2_modelparser.cpp
+
+static int stdioSkipGetChar( FILE* File )
+{
+    int c;
+
+    do
+    {
+        if( ( c = fgetc( File ) ) == EOF )
+            return EOF;
+
+        if( c == '#' )
+        {
+            do
+            {
+                if( ( c = fgetc( File ) ) == EOF )
+                    return EOF;
+            } while( (c != '\n') &&  (c != '\r') && (c != 0) && (c != ',') );
+
+            c = ' ';
+        }
+    } while( (c == ' ') || (c == '\t') || (c == '{') || (c == '[') || (c == '\n')
+             || (c == '\r') || (c == 0) || (c == ',') );
+
+    return c;
+}
+
+
+static bool stdioGetNextTag( FILE* File, char* tag, size_t len )
+{
+    int c = stdioSkipGetChar( File );
+
+    if( c == EOF )
+        return false;
+
+    tag[0] = c;
+    tag[1] = 0;
+
+    if( (c != '}') && (c != ']') )
+    {
+        char* dst = &tag[1];
+
+        while( --len > 1 && fscanf( File, "%c", dst ) == 1 )
+        {
+            if( (*dst == ' ') || (*dst == '[') || (*dst == '{')
+                || (*dst == '\t') || (*dst == '\n')|| (*dst == '\r') )
+                break;
+
+            dst++;
+        }
+
+        *dst = 0;
+
+        c = stdioSkipGetChar( File );
+
+        if( c != EOF )
+            ungetc( c, File );
+    }
+
+    return true;
+}
+
+
+static void stdioRead( const char* aFilename, MODEL_LISTS& aLists )
+{
+    FILE* file = fopen( aFilename, "rt" );
+
+    if( !file )
+        return;
+
+    char text[128];
+
+    while( stdioGetNextTag( file, text, sizeof( text ) ) )
+    {
+        if( strcmp( text, "point" ) == 0 )
+        {
+            glm::vec3 v;
+
+            while( fscanf( file, "%e %e %e", &v.x, &v.y, &v.z ) == 3 )
+            {
+                aLists.m_points.push_back( v );
+
+                int c = stdioSkipGetChar( file );
+
+                if( c != EOF )
+                    ungetc( c, file );
+            }
+        }
+        else if( strcmp( text, "coordIndex" ) == 0 )
+        {
+            int index;
+
+            while( fscanf( file, "%d, ", &index ) == 1 )
+                aLists.m_indices.push_back( index );
+        }
+    }
+
+    fclose( file );
+}
+
+
+static void readerRead( const char* aFilename, MODEL_LISTS& aLists )
+{
+    VRML_READER reader;
+
+    if( !reader.Open( FROM_UTF8( aFilename ) ) )
+        return;
+
+    char text[128];
+
+    while( GetNextTag( &reader, text, sizeof( text ) ) )
+    {
+        if( strcmp( text, "point" ) == 0 )
+        {
+            std::vector<glm::vec3> points;
+
+            ParseVertexList( &reader, points );
+            aLists.m_points.insert( aLists.m_points.end(), points.begin(), points.end() );
+        }
+        else if( strcmp( text, "coordIndex" ) == 0 )
+        {
+            int index;
+
+            while( reader.ReadInt( index ) )
+            {
+                reader.SkipChar( ',' );
+                aLists.m_indices.push_back( index );
+            }
+        }
+    }
+}
+
+
+/// Writes a VRML2 model of aCount random vertices and triangles
+static void writeModel( const char* aFilename, int aCount )
+{
+    FILE* file = fopen( aFilename, "wt" );
+
+    fprintf( file, "#VRML V2.0 utf8\n" );
+    fprintf( file, "Shape {\n  geometry IndexedFaceSet {\n    coord Coordinate {\n" );
+    fprintf( file, "      point [\n" );
+
+    for( int ii = 0; ii < aCount; ii++ )
+    {
+        fprintf( file, "        %g %g %g,\n", ( rand() - RAND_MAX / 2 ) / 1e4,
+                 ( rand() - RAND_MAX / 2 ) / 1e6, rand() / 1e8 );
+    }
+
+    fprintf( file, "      ]\n    }\n    coordIndex [\n" );
+
+    for( int ii = 0; ii < aCount; ii++ )
+    {
+        fprintf( file, "      %d, %d, %d, -1,\n", rand() % aCount, rand() % aCount,
+                 rand() % aCount );
+    }
+
+    fprintf( file, "    ]\n  }\n}\n" );
+    fclose( file );
+}
+
+
+int main( int argc, char** argv )
+{
+    std::vector<const char*> files;
+    const char*              tmpName = "vrml_reader_test.wrl";
+
+    for( int ii = 1; ii < argc; ii++ )
+        files.push_back( argv[ii] );
+
+    if( files.empty() )
+    {
+        srand( 1 );
+        writeModel( tmpName, 500000 );
+        files.push_back( tmpName );
+    }
+
+    int errors = 0;
+
+    for( unsigned ii = 0; ii < files.size(); ii++ )
+    {
+        MODEL_LISTS stdioLists;
+        MODEL_LISTS readerLists;
+
+        unsigned start = GetRunningMicroSecs();
+        stdioRead( files[ii], stdioLists );
+        unsigned stdioTime = GetRunningMicroSecs() - start;
+
+        start = GetRunningMicroSecs();
+        readerRead( files[ii], readerLists );
+        unsigned readerTime = GetRunningMicroSecs() - start;
+
+        printf( "%s: %u points, %u indices\n  stdio: %u usecs  VRML_READER: %u usecs\n",
+                files[ii], (unsigned) readerLists.m_points.size(),
+                (unsigned) readerLists.m_indices.size(), stdioTime, readerTime );
+
+        if( stdioLists.m_points != readerLists.m_points
+            || stdioLists.m_indices != readerLists.m_indices )
+        {
+            printf( "  stdio reading gives %u points, %u indices, or different values\n",
+                    (unsigned) stdioLists.m_points.size(),
+                    (unsigned) stdioLists.m_indices.size() );
+            errors++;
+        }
+    }
+
+    if( argc < 2 )
+        remove( tmpName );
+
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,219 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2015 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/*
+ * Compare the speed of the polygon calculations of a zone fill, done the old way with
+ * KI_POLYGON_SET (boost::polygon) and with POLYGON_SET (Clipper): a zone with a cutout
+ * is deflated by half the min thickness, pads and tracks with clearance are removed
+ * from it, and the result is fractured to be stored in a CPOLYGONS_LIST.
+ * The filled areas of both ways are compared.
+ * Zones with overlapping cutouts, and with a cutout crossing the outline, are also
+ * checked against their exact area.
+ *
+ * usage: zone_fill_test [pad count]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include <common.h>
+#include <PolyLine.h>
+#include <polygon_set.h>
+#include <convert_basic_shapes_to_polygon.h>
+
+
+static const int MM = 1000000;      // pcbnew internal units are nanometers
+
+
+/// @return a random value from 0 to aMax - 1 (RAND_MAX may be only 32767)
+static int randInt( int aMax )
+{
+    return int( ( (unsigned) rand() * 32768u + (unsigned) rand() ) % (unsigned) aMax );
+}
+
+
+/// @return the area of the polygons of aList, each contour being a filled outline
+static double filledArea( const CPOLYGONS_LIST& aList )
+{
+    POLYGON_SET polyset;
+    double      area = 0.0;
+
+    polyset.AddOutlines( aList );
+    polyset.Simplify();
+
+    for( int ii = 0; ii < polyset.ContourCount(); ii++ )
+        area += ClipperLib::Area( polyset.GetPaths()[ii] );
+
+    return area;
+}
+
+
+/// Appends the rectangle aX0, aY0, aX1, aY1 to aList, as a clockwise or counterclockwise contour
+static void appendRect( CPOLYGONS_LIST& aList, int aX0, int aY0, int aX1, int aY1, bool aClockwise )
+{
+    aList.Append( wxPoint( aX0, aY0 ) );
+
+    if( aClockwise )
+    {
+        aList.Append( wxPoint( aX0, aY1 ) );
+        aList.Append( wxPoint( aX1, aY1 ) );
+        aList.Append( wxPoint( aX1, aY0 ) );
+    }
+    else
+    {
+        aList.Append( wxPoint( aX1, aY0 ) );
+        aList.Append( wxPoint( aX1, aY1 ) );
+        aList.Append( wxPoint( aX0, aY1 ) );
+    }
+
+    aList.CloseLastContour();
+}
+
+
+/// @return true if the zone outline aZoneOutline (with cutouts) fills aExpectedArea
+static bool testCutouts( const char* aName, const CPOLYGONS_LIST& aZoneOutline,
+                         double aExpectedArea )
+{
+    POLYGON_SET polyset;
+
+    polyset.AddPolygonWithHoles( aZoneOutline );
+    polyset.Fracture();
+
+    CPOLYGONS_LIST filled;
+    polyset.ExportTo( filled );
+
+    double area = filledArea( filled );
+    bool   ok = fabs( area - aExpectedArea ) <= 1e-9 * aExpectedArea;
+
+    printf( "%s: area %g, expected %g%s\n", aName, area, aExpectedArea, ok ? "" : " FAILED" );
+
+    return ok;
+}
+
+
+int main( int argc, char** argv )
+{
+    int padCount = argc > 1 ? atoi( argv[1] ) : 2000;
+    int boardSize = 100 * MM;
+    int margin = int( 0.125 * MM );
+
+    // The zone: a square with a round cutout
+    CPOLYGONS_LIST zoneOutline;
+
+    zoneOutline.Append( wxPoint( 0, 0 ) );
+    zoneOutline.Append( wxPoint( boardSize, 0 ) );
+    zoneOutline.Append( wxPoint( boardSize, boardSize ) );
+    zoneOutline.Append( wxPoint( 0, boardSize ) );
+    zoneOutline.CloseLastContour();
+    TransformCircleToPolygon( zoneOutline, wxPoint( boardSize / 2, boardSize / 2 ),
+                              boardSize / 10, 32 );
+
+    // Pads and tracks, with their clearance
+    CPOLYGONS_LIST holes;
+
+    srand( 1 );
+
+    for( int ii = 0; ii < padCount; ii++ )
+    {
+        wxPoint pos( randInt( boardSize ), randInt( boardSize ) );
+        wxPoint end( pos.x + randInt( 5 * MM ) - int( 2.5 * MM ),
+                     pos.y + randInt( 5 * MM ) - int( 2.5 * MM ) );
+
+        TransformCircleToPolygon( holes, pos, int( 0.8 * MM ), 16 );
+        TransformRoundedEndsSegmentToPolygon( holes, pos, end, 16, int( 0.45 * MM ) );
+    }
+
+    // Old way: boost::polygon, and conversions from and to CPOLYGONS_LIST
+    unsigned start = GetRunningMicroSecs();
+
+    KI_POLYGON_SET solidAreas;
+    KI_POLYGON_SET outlineHoles;
+    KI_POLYGON_SET padHoles;
+
+    zoneOutline.ExportTo( solidAreas );
+
+    while( solidAreas.size() > 1 )
+    {
+        outlineHoles.push_back( solidAreas.back() );
+        solidAreas.pop_back();
+    }
+
+    solidAreas -= margin;
+    outlineHoles += margin;
+    solidAreas -= outlineHoles;
+
+    holes.ExportTo( padHoles );
+    solidAreas -= padHoles;
+
+    CPOLYGONS_LIST boostFilled;
+    boostFilled.ImportFrom( solidAreas );
+
+    unsigned boostTime = GetRunningMicroSecs() - start;
+
+    // New way: POLYGON_SET
+    start = GetRunningMicroSecs();
+
+    POLYGON_SET polyset;
+    POLYGON_SET polysetHoles;
+
+    polyset.AddPolygonWithHoles( zoneOutline );
+    polyset.Inflate( -margin, 16 );
+    polysetHoles.AddOutlines( holes );
+    polyset.BooleanSubtract( polysetHoles );
+    polyset.Fracture();
+
+    CPOLYGONS_LIST clipperFilled;
+    polyset.ExportTo( clipperFilled );
+
+    unsigned clipperTime = GetRunningMicroSecs() - start;
+
+    double boostArea = filledArea( boostFilled );
+    double clipperArea = filledArea( clipperFilled );
+
+    printf( "boost::polygon: %u usecs, %u corners, area %g\n",
+            boostTime, boostFilled.GetCornersCount(), boostArea );
+    printf( "POLYGON_SET:    %u usecs, %u corners, area %g\n",
+            clipperTime, clipperFilled.GetCornersCount(), clipperArea );
+
+    // Cutouts are subtracted, whatever their orientation, even where they overlap or
+    // go outside the outline: a 10 mm square zone, with 2 mm square cutouts
+    bool ok = true;
+    CPOLYGONS_LIST overlapping;
+
+    appendRect( overlapping, 0, 0, 10 * MM, 10 * MM, false );
+    appendRect( overlapping, 1 * MM, 1 * MM, 3 * MM, 3 * MM, true );
+    appendRect( overlapping, 2 * MM, 2 * MM, 4 * MM, 4 * MM, false );
+    ok &= testCutouts( "overlapping cutouts", overlapping, 93.0 * MM * MM );
+
+    CPOLYGONS_LIST crossing;
+
+    appendRect( crossing, 0, 0, 10 * MM, 10 * MM, true );
+    appendRect( crossing, 9 * MM, 1 * MM, 11 * MM, 3 * MM, false );
+    ok &= testCutouts( "cutout crossing the outline", crossing, 98.0 * MM * MM );
+
+    // The deflate of the outline is done with round corners by Clipper
+    ok &= fabs( boostArea - clipperArea ) <= 1e-4 * boostArea;
+
+    return ok ? 0 : 1;
+}